@@ -0,0 +1,18 @@
+#
+# Apache Arrow and Parquet
+#
+
+find_package(Arrow CONFIG REQUIRED)
+if (ARROW_VERSION VERSION_LESS "15.0.0")
+    message(FATAL_ERROR "Arrow plugin requires Apache Arrow 15.0 or later, "
+        "found ${ARROW_VERSION}.")
+endif()
+find_package(Parquet CONFIG REQUIRED)
+set(ARROW_LIBRARIES Arrow::arrow_shared Parquet::parquet_shared)
+
+# C++ standard required by the Arrow headers.
+if (ARROW_VERSION VERSION_LESS "23.0.0")
+    set(ARROW_CXX_STANDARD 17)
+else()
+    set(ARROW_CXX_STANDARD 20)
+endif()
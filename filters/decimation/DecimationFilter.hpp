@@ -63,6 +63,8 @@ private:
     virtual void processOptions(const Options& options);
     void ready(PointTableRef table)
         { m_index = 0; }
+    bool streamable() const
+        { return true; }
     bool processOne(PointRef& point);
     PointViewSet run(PointViewPtr view);
     void decimate(PointView& input, PointView& output);
@@ -114,11 +114,10 @@ PointViewSet DividerFilter::run(PointViewPtr inView)
     {
         point_count_t limit = ((inView->size() - 1) / m_size) + 1;
         unsigned viewNum = 0;
-        for (PointId i = 0; i < inView->size();)
+        for (PointId i = 0; i < inView->size(); i += limit)
         {
-            views[viewNum]->appendPoint(*inView, i++);
-            if (i % limit == 0)
-                viewNum++;
+            point_count_t count = std::min(limit, inView->size() - i);
+            views[viewNum++]->appendPoints(*inView, i, count);
         }
     }
     else // RoundRobin
@@ -0,0 +1,362 @@
+/******************************************************************************
+* Copyright (c) 2015, Howard Butler (howard@hobu.co)
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+#include "OutlierFilter.hpp"
+
+#include <pdal/PDALUtils.hpp>
+#include <pdal/PointView.hpp>
+#include <pdal/pdal_macros.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace pdal
+{
+
+static PluginInfo const s_info = PluginInfo(
+    "filters.outlier",
+    "Statistical and radius outlier removal",
+    "http://pdal.io/stages/filters.outlier.html" );
+
+CREATE_STATIC_PLUGIN(1, 0, OutlierFilter, Filter, s_info)
+
+std::string OutlierFilter::getName() const { return s_info.name; }
+
+namespace
+{
+
+// Number of points whose neighbors are searched by a thread at a time.
+const point_count_t c_batchSize = 4096;
+
+} // unnamed namespace
+
+Options OutlierFilter::getDefaultOptions()
+{
+    Options options;
+    options.add("method", "statistical",
+        "Outlier detection method: 'statistical' or 'radius'");
+    options.add("mean_k", 8, "Mean number of neighbors");
+    options.add("multiplier", 2, "Standard deviation threshold");
+    options.add("radius", 1.0, "Radius of neighbor search");
+    options.add("min_k", 2, "Minimum number of neighbors in radius");
+    options.add("classify", true, "Apply classification labels?");
+    options.add("extract", false, "Extract inliers?");
+    options.add("threads", 1, "Number of threads used to search neighbors");
+    options.add("tile_size", 0, "Size of tiles indexed separately");
+    options.add("halo", 1.0, "Overlap of indexed tiles.  Defaults to the "
+        "radius; required for the statistical method when tiling");
+    return options;
+}
+
+
+void OutlierFilter::processOptions(const Options& options)
+{
+    std::string method = Utils::tolower(
+        options.getValueOrDefault<std::string>("method", "statistical"));
+    if (method == "statistical")
+        m_method = Method::Statistical;
+    else if (method == "radius")
+        m_method = Method::Radius;
+    else
+    {
+        std::ostringstream oss;
+        oss << getName() << ": Invalid 'method' option: '" << method <<
+            "'.  Must be 'statistical' or 'radius'.";
+        throw pdal_error(oss.str());
+    }
+
+    m_meanK = options.getValueOrDefault<int>("mean_k", 8);
+    m_multiplier = options.getValueOrDefault<double>("multiplier", 2);
+    m_radius = options.getValueOrDefault<double>("radius", 1.0);
+    m_minK = options.getValueOrDefault<int>("min_k", 2);
+    m_classify = options.getValueOrDefault<bool>("classify", true);
+    m_extract = options.getValueOrDefault<bool>("extract", false);
+    m_threads = options.getValueOrDefault<int>("threads", 1);
+    m_tileSize = options.getValueOrDefault<double>("tile_size", 0);
+
+    // Neighbors of points in the radius method are never farther away than
+    // the radius, so that's the natural halo.  There's no such bound on the
+    // distance to the mean_k-th neighbor, so the user has to pick one.
+    if (m_tileSize > 0 && m_method == Method::Statistical &&
+        !options.hasOption("halo"))
+    {
+        std::ostringstream oss;
+        oss << getName() << ": Option 'halo' is required when 'tile_size' "
+            "is set with the statistical method.";
+        throw pdal_error(oss.str());
+    }
+    m_halo = options.getValueOrDefault<double>("halo", m_radius);
+
+    if (m_meanK < 1)
+    {
+        std::ostringstream oss;
+        oss << getName() << ": Option 'mean_k' must be at least 1.";
+        throw pdal_error(oss.str());
+    }
+    if (m_radius <= 0)
+    {
+        std::ostringstream oss;
+        oss << getName() << ": Option 'radius' must be greater than 0.";
+        throw pdal_error(oss.str());
+    }
+    Utils::checkThreads(getName(), m_threads);
+    if (m_tileSize > 0 && (m_halo < 0 || m_halo > m_tileSize))
+    {
+        std::ostringstream oss;
+        oss << getName() << ": Option 'halo' must be between 0 and "
+            "'tile_size'.";
+        throw pdal_error(oss.str());
+    }
+}
+
+
+void OutlierFilter::addDimensions(PointLayoutPtr layout)
+{
+    layout->registerDim(Dimension::Id::Classification);
+}
+
+
+PointViewSet OutlierFilter::run(PointViewPtr input)
+{
+    PointViewSet viewSet;
+    const point_count_t count = input->size();
+    if (!count)
+    {
+        viewSet.insert(input);
+        return viewSet;
+    }
+
+    // For each point, the mean distance to its neighbors (statistical) or
+    // the number of neighbors in the radius (radius).
+    std::vector<double> metrics(count);
+    if (m_tileSize <= 0)
+    {
+        KD3Index index(*input);
+        index.build();
+
+        point_count_t numBatches = (count + c_batchSize - 1) / c_batchSize;
+        Utils::parallelFor(numBatches, m_threads, [&](size_t batch)
+        {
+            PointId begin = batch * c_batchSize;
+            PointId end = (std::min)(begin + c_batchSize, count);
+            computeMetrics(index, *input, begin, end, nullptr, metrics);
+        });
+    }
+    else
+    {
+        std::vector<std::vector<PointId>> coreIds;
+        std::vector<PointViewPtr> tiles = makeTiles(input, coreIds);
+
+        log()->get(LogLevel::Debug2) << getName() << ": Searching " <<
+            tiles.size() << " tiles." << std::endl;
+        Utils::parallelFor(tiles.size(), m_threads, [&](size_t tile)
+        {
+            KD3Index index(*tiles[tile]);
+            index.build();
+            computeMetrics(index, *tiles[tile], 0, coreIds[tile].size(),
+                &coreIds[tile], metrics);
+        });
+    }
+
+    std::vector<char> outlier = findOutliers(metrics);
+    point_count_t numOutliers = std::count(outlier.begin(), outlier.end(), 1);
+
+    if (numOutliers == count)
+    {
+        log()->get(LogLevel::Warning) << "Requested filter would remove all "
+            "points. Try increasing the multiplier.\n";
+        viewSet.insert(input);
+        return viewSet;
+    }
+    if (!numOutliers)
+        log()->get(LogLevel::Warning) << "Filtered cloud has no outliers!\n";
+    if (!(m_classify || m_extract))
+        log()->get(LogLevel::Warning) << "Must choose --classify or "
+            "--extract\n";
+
+    if (m_classify)
+    {
+        log()->get(LogLevel::Debug2) << "Labeled " << numOutliers <<
+            " outliers as noise!\n";
+
+        // set the classification label of outliers as 7 (corresponding to
+        // ASPRS LAS specification for low point/noise)
+        for (PointId idx = 0; idx < count; ++idx)
+            if (outlier[idx])
+                input->setField(Dimension::Id::Classification, idx, 7);
+    }
+
+    if (m_extract)
+    {
+        log()->get(LogLevel::Debug2) << "Extracted " <<
+            (count - numOutliers) << " inliers!\n";
+
+        PointViewPtr output = input->makeNew();
+        for (PointId idx = 0; idx < count; ++idx)
+            if (!outlier[idx])
+                output->appendPoint(*input, idx);
+        viewSet.insert(output);
+    }
+    else
+        viewSet.insert(input);
+    return viewSet;
+}
+
+
+// Split the view into square tiles in X and Y.  Each returned view holds
+// the points of a tile followed by the points of neighboring tiles that
+// are within the halo distance of it.  The IDs of the tile's own points in
+// the input view are returned in 'coreIds'.
+std::vector<PointViewPtr> OutlierFilter::makeTiles(PointViewPtr view,
+    std::vector<std::vector<PointId>>& coreIds)
+{
+    BOX2D bounds;
+    view->calculateBounds(bounds);
+    int cols = (int)std::floor((bounds.maxx - bounds.minx) / m_tileSize) + 1;
+    int rows = (int)std::floor((bounds.maxy - bounds.miny) / m_tileSize) + 1;
+
+    std::vector<std::vector<PointId>> core(cols * rows);
+    std::vector<std::vector<PointId>> halo(cols * rows);
+    for (PointId idx = 0; idx < view->size(); ++idx)
+    {
+        double x = view->getFieldAs<double>(Dimension::Id::X, idx);
+        double y = view->getFieldAs<double>(Dimension::Id::Y, idx);
+        int col = (int)std::floor((x - bounds.minx) / m_tileSize);
+        int row = (int)std::floor((y - bounds.miny) / m_tileSize);
+        core[row * cols + col].push_back(idx);
+
+        for (int r = (std::max)(row - 1, 0);
+            r <= (std::min)(row + 1, rows - 1); ++r)
+            for (int c = (std::max)(col - 1, 0);
+                c <= (std::min)(col + 1, cols - 1); ++c)
+            {
+                if (r == row && c == col)
+                    continue;
+                double minx = bounds.minx + c * m_tileSize;
+                double miny = bounds.miny + r * m_tileSize;
+                double dx = (std::max)(0.0, (std::max)(minx - x,
+                    x - (minx + m_tileSize)));
+                double dy = (std::max)(0.0, (std::max)(miny - y,
+                    y - (miny + m_tileSize)));
+                if (dx <= m_halo && dy <= m_halo)
+                    halo[r * cols + c].push_back(idx);
+            }
+    }
+
+    // Views are created up front since creating them isn't thread-safe.
+    // They refer to the input's points; no point data is copied.
+    std::vector<PointViewPtr> tiles;
+    for (size_t i = 0; i < core.size(); ++i)
+    {
+        if (core[i].empty())
+            continue;
+        PointViewPtr tile = view->makeNew();
+        for (PointId idx : core[i])
+            tile->appendPoint(*view, idx);
+        for (PointId idx : halo[i])
+            tile->appendPoint(*view, idx);
+        tiles.push_back(tile);
+        coreIds.push_back(std::move(core[i]));
+        std::vector<PointId>().swap(halo[i]);
+    }
+    return tiles;
+}
+
+
+// Compute the metric for points [begin, end) of 'view' and store it in
+// 'metrics' at the point's ID or, if 'ids' is provided, at ids[point].
+void OutlierFilter::computeMetrics(const KD3Index& index,
+    const PointView& view, PointId begin, PointId end,
+    const std::vector<PointId> *ids, std::vector<double>& metrics)
+{
+    std::vector<PointId> indices;
+    std::vector<double> sqrDists;
+
+    for (PointId idx = begin; idx < end; ++idx)
+    {
+        double x = view.getFieldAs<double>(Dimension::Id::X, idx);
+        double y = view.getFieldAs<double>(Dimension::Id::Y, idx);
+        double z = view.getFieldAs<double>(Dimension::Id::Z, idx);
+
+        double metric = 0;
+        if (m_method == Method::Statistical)
+        {
+            // The nearest neighbor is the point itself.
+            index.knnSearch(x, y, z, m_meanK + 1, &indices, &sqrDists);
+            for (size_t i = 1; i < sqrDists.size(); ++i)
+                metric += std::sqrt(sqrDists[i]);
+            if (sqrDists.size() > 1)
+                metric /= (sqrDists.size() - 1);
+        }
+        else
+            metric = (double)index.radius(x, y, z, m_radius).size() - 1;
+
+        metrics[ids ? (*ids)[idx] : idx] = metric;
+    }
+}
+
+
+std::vector<char> OutlierFilter::findOutliers(
+    const std::vector<double>& metrics)
+{
+    std::vector<char> outlier(metrics.size());
+
+    if (m_method == Method::Radius)
+    {
+        for (size_t i = 0; i < metrics.size(); ++i)
+            outlier[i] = (metrics[i] < m_minK);
+        return outlier;
+    }
+
+    double sum = 0;
+    double sqSum = 0;
+    for (double d : metrics)
+    {
+        sum += d;
+        sqSum += d * d;
+    }
+    double n = (double)metrics.size();
+    double mean = sum / n;
+    double variance = n > 1 ? (sqSum - sum * sum / n) / (n - 1) : 0;
+    double threshold = mean + m_multiplier * std::sqrt(variance);
+
+    log()->get(LogLevel::Debug2) << getName() << ": Mean neighbor distance " <<
+        mean << ", threshold " << threshold << "." << std::endl;
+    for (size_t i = 0; i < metrics.size(); ++i)
+        outlier[i] = (metrics[i] > threshold);
+    return outlier;
+}
+
+
+} // pdal
@@ -0,0 +1,96 @@
+/******************************************************************************
+* Copyright (c) 2015, Howard Butler (howard@hobu.co)
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+#pragma once
+
+#include <pdal/Filter.hpp>
+#include <pdal/KDIndex.hpp>
+#include <pdal/plugin.hpp>
+
+#include <functional>
+
+extern "C" int32_t OutlierFilter_ExitFunc();
+extern "C" PF_ExitFunc OutlierFilter_InitPlugin();
+
+namespace pdal
+{
+
+// Identify outliers either statistically, from the mean distance of each
+// point to its nearest neighbors, or by counting the neighbors of each
+// point within a radius.  Outliers are classified as noise and/or removed.
+class PDAL_DLL OutlierFilter : public Filter
+{
+public:
+    OutlierFilter()
+        {}
+
+    static void * create();
+    static int32_t destroy(void *);
+    std::string getName() const;
+
+    Options getDefaultOptions();
+
+private:
+    enum class Method
+    {
+        Statistical,
+        Radius
+    };
+
+    Method m_method;
+    int m_meanK;
+    double m_multiplier;
+    double m_radius;
+    int m_minK;
+    bool m_classify;
+    bool m_extract;
+    int m_threads;
+    double m_tileSize;
+    double m_halo;
+
+    virtual void processOptions(const Options& options);
+    virtual void addDimensions(PointLayoutPtr layout);
+    virtual PointViewSet run(PointViewPtr view);
+    std::vector<PointViewPtr> makeTiles(PointViewPtr view,
+        std::vector<std::vector<PointId>>& coreIds);
+    void computeMetrics(const KD3Index& index, const PointView& view,
+        PointId begin, PointId end, const std::vector<PointId> *ids,
+        std::vector<double>& metrics);
+    std::vector<char> findOutliers(const std::vector<double>& metrics);
+
+    OutlierFilter& operator=(const OutlierFilter&); // not implemented
+    OutlierFilter(const OutlierFilter&); // not implemented
+};
+
+} // pdal
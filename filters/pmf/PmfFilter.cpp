@@ -0,0 +1,286 @@
+/******************************************************************************
+* Copyright (c) 2015, Howard Butler (howard@hobu.co)
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+#include "PmfFilter.hpp"
+
+#include <pdal/PDALUtils.hpp>
+#include <pdal/PointView.hpp>
+#include <pdal/pdal_macros.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace pdal
+{
+
+static PluginInfo const s_info = PluginInfo(
+    "filters.pmf",
+    "Progressive morphological filter",
+    "http://pdal.io/stages/filters.pmf.html" );
+
+CREATE_STATIC_PLUGIN(1, 0, PmfFilter, Filter, s_info)
+
+std::string PmfFilter::getName() const { return s_info.name; }
+
+Options PmfFilter::getDefaultOptions()
+{
+    Options options;
+    options.add("max_window_size", 33, "Maximum window size");
+    options.add("slope", 1, "Slope");
+    options.add("max_distance", 2.5, "Maximum distance");
+    options.add("initial_distance", 0.15, "Initial distance");
+    options.add("cell_size", 1, "Cell Size");
+    options.add("classify", true, "Apply classification labels?");
+    options.add("extract", false, "Extract ground returns?");
+    options.add("threads", 1, "Number of threads used to filter the grid");
+    return options;
+}
+
+
+void PmfFilter::processOptions(const Options& options)
+{
+    m_maxWindowSize = options.getValueOrDefault<double>("max_window_size", 33);
+    m_slope = options.getValueOrDefault<double>("slope", 1);
+    m_maxDistance = options.getValueOrDefault<double>("max_distance", 2.5);
+    m_initialDistance =
+        options.getValueOrDefault<double>("initial_distance", 0.15);
+    m_cellSize = options.getValueOrDefault<double>("cell_size", 1);
+    m_classify = options.getValueOrDefault<bool>("classify", true);
+    m_extract = options.getValueOrDefault<bool>("extract", false);
+    m_threads = options.getValueOrDefault<int>("threads", 1);
+
+    if (m_cellSize <= 0)
+    {
+        std::ostringstream oss;
+        oss << getName() << ": Option 'cell_size' must be greater than 0.";
+        throw pdal_error(oss.str());
+    }
+    Utils::checkThreads(getName(), m_threads);
+}
+
+
+void PmfFilter::addDimensions(PointLayoutPtr layout)
+{
+    layout->registerDim(Dimension::Id::Classification);
+}
+
+
+PointViewSet PmfFilter::run(PointViewPtr input)
+{
+    std::vector<PointId> ground = findGround(*input);
+
+    PointViewSet viewSet;
+    if (ground.empty())
+        log()->get(LogLevel::Debug2) << "Filtered cloud has no ground "
+            "returns!\n";
+    if (!(m_classify || m_extract))
+        log()->get(LogLevel::Debug2) << "Must choose --classify or "
+            "--extract\n";
+
+    if (m_classify)
+    {
+        log()->get(LogLevel::Debug2) << "Labeled " << ground.size() <<
+            " ground returns!\n";
+
+        // set the classification label of ground returns as 2
+        // (corresponding to ASPRS LAS specification)
+        for (PointId idx : ground)
+            input->setField(Dimension::Id::Classification, idx, 2);
+    }
+
+    if (m_extract)
+    {
+        log()->get(LogLevel::Debug2) << "Extracted " << ground.size() <<
+            " ground returns!\n";
+
+        // The output view refers to the ground points of the input; no
+        // point data is copied.
+        PointViewPtr output = input->makeNew();
+        for (PointId idx : ground)
+            output->appendPoint(*input, idx);
+        viewSet.insert(output);
+    }
+    else
+        viewSet.insert(input);
+
+    return viewSet;
+}
+
+
+std::vector<PointId> PmfFilter::findGround(PointView& view)
+{
+    std::vector<PointId> ground;
+    const point_count_t count = view.size();
+    if (!count)
+        return ground;
+
+    BOX2D bounds;
+    view.calculateBounds(bounds);
+    size_t cols = (size_t)std::floor((bounds.maxx - bounds.minx) /
+        m_cellSize) + 1;
+    size_t rows = (size_t)std::floor((bounds.maxy - bounds.miny) /
+        m_cellSize) + 1;
+
+    // Each point's cell and elevation are looked up once and reused by
+    // every iteration.
+    std::vector<size_t> cells(count);
+    std::vector<double> zs(count);
+    runRanges(count, [&](size_t first, size_t last)
+    {
+        for (PointId idx = first; idx < last; ++idx)
+        {
+            double x = view.getFieldAs<double>(Dimension::Id::X, idx);
+            double y = view.getFieldAs<double>(Dimension::Id::Y, idx);
+            size_t col = (size_t)std::floor((x - bounds.minx) / m_cellSize);
+            size_t row = (size_t)std::floor((y - bounds.miny) / m_cellSize);
+            cells[idx] = row * cols + col;
+            zs[idx] = view.getFieldAs<double>(Dimension::Id::Z, idx);
+        }
+    });
+
+    // Window sizes grow exponentially and the height threshold grows
+    // with the change in window size, as in the PCL implementation.
+    std::vector<double> windowSizes;
+    std::vector<double> thresholds;
+    double windowSize = 0;
+    for (int iteration = 0; windowSize < m_maxWindowSize; ++iteration)
+    {
+        windowSize = m_cellSize * (2 * std::pow(2.0, iteration) + 1);
+        double threshold = m_initialDistance;
+        if (iteration > 0)
+            threshold += m_slope * (windowSize - windowSizes.back()) *
+                m_cellSize;
+        windowSizes.push_back(windowSize);
+        thresholds.push_back((std::min)(threshold, m_maxDistance));
+    }
+
+    ground.resize(count);
+    for (PointId idx = 0; idx < count; ++idx)
+        ground[idx] = idx;
+
+    std::vector<double> grid(cols * rows);
+    for (size_t i = 0; i < windowSizes.size(); ++i)
+    {
+        std::fill(grid.begin(), grid.end(),
+            std::numeric_limits<double>::quiet_NaN());
+        for (PointId idx : ground)
+            grid[cells[idx]] = std::fmin(grid[cells[idx]], zs[idx]);
+
+        int half = (int)(windowSizes[i] / m_cellSize / 2);
+        openGrid(grid, cols, rows, half);
+
+        std::vector<char> keep(ground.size());
+        runRanges(ground.size(), [&](size_t first, size_t last)
+        {
+            for (size_t j = first; j < last; ++j)
+            {
+                PointId idx = ground[j];
+                keep[j] = (zs[idx] - grid[cells[idx]] < thresholds[i]);
+            }
+        });
+
+        size_t kept = 0;
+        for (size_t j = 0; j < ground.size(); ++j)
+            if (keep[j])
+                ground[kept++] = ground[j];
+        ground.resize(kept);
+
+        log()->get(LogLevel::Debug2) << getName() << ": Window " <<
+            windowSizes[i] << ", threshold " << thresholds[i] << ", " <<
+            kept << " ground points." << std::endl;
+    }
+    return ground;
+}
+
+
+// Morphological opening (erosion followed by dilation) of the grid with a
+// square window of (2 * half + 1) cells.  A square window is separable, so
+// each operation is done as a pass along the rows followed by a pass along
+// the columns.  Empty cells (NaN) are ignored.
+void PmfFilter::openGrid(std::vector<double>& grid, size_t cols, size_t rows,
+    int half)
+{
+    std::vector<double> temp(grid.size());
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+
+    auto pass = [&](const std::vector<double>& src, std::vector<double>& dst,
+        bool alongRows, bool erode)
+    {
+        runRanges(rows, [&](size_t first, size_t last)
+        {
+            for (size_t r = first; r < last; ++r)
+                for (size_t c = 0; c < cols; ++c)
+                {
+                    size_t pos = alongRows ? c : r;
+                    size_t size = alongRows ? cols : rows;
+                    size_t begin = pos < (size_t)half ? 0 : pos - half;
+                    size_t end = (std::min)(pos + half + 1, size);
+
+                    double v = nan;
+                    for (size_t p = begin; p < end; ++p)
+                    {
+                        double s = alongRows ? src[r * cols + p] :
+                            src[p * cols + c];
+                        v = erode ? std::fmin(v, s) : std::fmax(v, s);
+                    }
+                    dst[r * cols + c] = v;
+                }
+        });
+    };
+
+    pass(grid, temp, true, true);
+    pass(temp, grid, false, true);
+    pass(grid, temp, true, false);
+    pass(temp, grid, false, false);
+}
+
+
+void PmfFilter::runRanges(size_t count,
+    std::function<void(size_t, size_t)> func)
+{
+    if (count == 0)
+        return;
+    size_t numThreads = (std::min)((size_t)m_threads, count);
+    size_t perThread = (count + numThreads - 1) / numThreads;
+    size_t numRanges = (count + perThread - 1) / perThread;
+
+    Utils::parallelFor(numRanges, numRanges, [&](size_t range)
+    {
+        size_t first = range * perThread;
+        func(first, (std::min)(first + perThread, count));
+    });
+}
+
+} // pdal
@@ -219,6 +219,19 @@ void StatsFilter::extractMetadata(PointTableRef table)
 }
 
 
+// Add the statistics gathered by a filter configured like this one over a
+// different set of points.  Must be called after the filter is prepared.
+void StatsFilter::merge(const StatsFilter& other)
+{
+    for (auto& p : other.m_stats)
+    {
+        auto si = m_stats.find(p.first);
+        if (si != m_stats.end())
+            si->second.merge(p.second);
+    }
+}
+
+
 const Summary& StatsFilter::getStats(Dimension::Id::Enum dim) const
 {
     for (auto di = m_stats.begin(); di != m_stats.end(); ++di)
@@ -95,6 +95,19 @@ public:
             m_values[value]++;
     }
 
+    // Combine with a summary of a different set of values.
+    void merge(const Summary& s)
+    {
+        if (s.m_cnt == 0)
+            return;
+        m_min = (std::min)(m_min, s.m_min);
+        m_max = (std::max)(m_max, s.m_max);
+        m_cnt += s.m_cnt;
+        m_avg += (s.m_avg - m_avg) * s.m_cnt / m_cnt;
+        for (auto& v : s.m_values)
+            m_values[v.first] += v.second;
+    }
+
 private:
     std::string m_name;
     EnumType m_enumerate;
@@ -120,12 +133,15 @@ public:
     std::string getName() const;
 
     const stats::Summary& getStats(Dimension::Id::Enum d) const;
+    void merge(const StatsFilter& other);
     void reset();
 
 private:
     StatsFilter& operator=(const StatsFilter&); // not implemented
     StatsFilter(const StatsFilter&); // not implemented
     virtual void processOptions(const Options& options);
+    virtual bool streamable() const
+        { return true; }
     virtual bool processOne(PointRef& point);
     virtual void prepared(PointTableRef table);
     virtual void done(PointTableRef table);
@@ -0,0 +1,168 @@
+/******************************************************************************
+* Copyright (c) 2015, Howard Butler (howard@hobu.co)
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+#include "VoxelDownsizeFilter.hpp"
+
+#include <pdal/PDALUtils.hpp>
+#include <pdal/PointView.hpp>
+#include <pdal/pdal_macros.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace pdal
+{
+
+static PluginInfo const s_info = PluginInfo(
+    "filters.voxeldownsize",
+    "Keep the first point in each voxel",
+    "http://pdal.io/stages/filters.voxeldownsize.html" );
+
+CREATE_STATIC_PLUGIN(1, 0, VoxelDownsizeFilter, Filter, s_info)
+
+std::string VoxelDownsizeFilter::getName() const { return s_info.name; }
+
+Options VoxelDownsizeFilter::getDefaultOptions()
+{
+    Options options;
+    options.add("leaf_x", 1.0, "Voxel size in X");
+    options.add("leaf_y", 1.0, "Voxel size in Y");
+    options.add("leaf_z", 1.0, "Voxel size in Z");
+    options.add("threads", 1, "Number of threads used to assign voxels");
+    return options;
+}
+
+
+void VoxelDownsizeFilter::processOptions(const Options& options)
+{
+    m_leafX = options.getValueOrDefault<double>("leaf_x", 1.0);
+    m_leafY = options.getValueOrDefault<double>("leaf_y", 1.0);
+    m_leafZ = options.getValueOrDefault<double>("leaf_z", 1.0);
+    if (m_leafX <= 0 || m_leafY <= 0 || m_leafZ <= 0)
+    {
+        std::ostringstream oss;
+        oss << getName() << ": Options 'leaf_x', 'leaf_y' and 'leaf_z' "
+            "must be greater than 0.";
+        throw pdal_error(oss.str());
+    }
+    m_threads = options.getValueOrDefault<int>("threads", 1);
+    Utils::checkThreads(getName(), m_threads);
+}
+
+
+VoxelDownsizeFilter::Voxel VoxelDownsizeFilter::voxel(double x, double y,
+    double z) const
+{
+    return Voxel { (int64_t)std::floor(x / m_leafX),
+        (int64_t)std::floor(y / m_leafY), (int64_t)std::floor(z / m_leafZ) };
+}
+
+
+bool VoxelDownsizeFilter::processOne(PointRef& point)
+{
+    double x = point.getFieldAs<double>(Dimension::Id::X);
+    double y = point.getFieldAs<double>(Dimension::Id::Y);
+    double z = point.getFieldAs<double>(Dimension::Id::Z);
+
+    return m_voxels.insert(voxel(x, y, z)).second;
+}
+
+
+PointViewSet VoxelDownsizeFilter::run(PointViewPtr inView)
+{
+    const point_count_t count = inView->size();
+    const int numThreads =
+        (int)(std::max)((point_count_t)1,
+            (std::min)((point_count_t)m_threads, count));
+
+    std::vector<Voxel> voxels(count);
+    std::vector<size_t> hashes(count);
+
+    auto assign = [&](PointId begin, PointId end)
+    {
+        VoxelHash hash;
+        for (PointId idx = begin; idx < end; ++idx)
+        {
+            double x = inView->getFieldAs<double>(Dimension::Id::X, idx);
+            double y = inView->getFieldAs<double>(Dimension::Id::Y, idx);
+            double z = inView->getFieldAs<double>(Dimension::Id::Z, idx);
+            voxels[idx] = voxel(x, y, z);
+            hashes[idx] = hash(voxels[idx]);
+        }
+    };
+
+    // Each thread owns the voxels whose hash maps to it, so no voxel is
+    // seen by two threads and the first point of every voxel is found
+    // without locking.
+    std::vector<std::vector<PointId>> kept(numThreads);
+    auto select = [&](int thread)
+    {
+        VoxelSet seen;
+        for (PointId idx = 0; idx < count; ++idx)
+            if (hashes[idx] % numThreads == (size_t)thread &&
+                    seen.insert(voxels[idx]).second)
+                kept[thread].push_back(idx);
+    };
+
+    point_count_t chunk = (count + numThreads - 1) / numThreads;
+    Utils::parallelFor(numThreads, numThreads, [&](size_t i)
+    {
+        PointId begin = (std::min)((point_count_t)i * chunk, count);
+        assign(begin, (std::min)(begin + chunk, count));
+    });
+    Utils::parallelFor(numThreads, numThreads, [&](size_t i)
+    {
+        select((int)i);
+    });
+
+    std::vector<PointId> ids;
+    for (auto& k : kept)
+        ids.insert(ids.end(), k.begin(), k.end());
+    std::sort(ids.begin(), ids.end());
+
+    // The output view refers to the kept points of the input; no point
+    // data is copied.
+    PointViewPtr outView = inView->makeNew();
+    for (PointId idx : ids)
+        outView->appendPoint(*inView, idx);
+
+    log()->get(LogLevel::Debug2) << getName() << ": Kept " <<
+        outView->size() << " of " << count << " points." << std::endl;
+
+    PointViewSet viewSet;
+    viewSet.insert(outView);
+    return viewSet;
+}
+
+} // pdal
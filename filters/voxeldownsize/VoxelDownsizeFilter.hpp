@@ -0,0 +1,106 @@
+/******************************************************************************
+* Copyright (c) 2015, Howard Butler (howard@hobu.co)
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+#pragma once
+
+#include <pdal/Filter.hpp>
+#include <pdal/plugin.hpp>
+
+#include <unordered_set>
+
+extern "C" int32_t VoxelDownsizeFilter_ExitFunc();
+extern "C" PF_ExitFunc VoxelDownsizeFilter_InitPlugin();
+
+namespace pdal
+{
+
+// Keep the first point that falls in each voxel.  The kept points are
+// the original points, so all of their dimensions are retained.
+class PDAL_DLL VoxelDownsizeFilter : public Filter
+{
+public:
+    VoxelDownsizeFilter()
+        {}
+
+    static void * create();
+    static int32_t destroy(void *);
+    std::string getName() const;
+
+    Options getDefaultOptions();
+
+private:
+    struct Voxel
+    {
+        int64_t m_x;
+        int64_t m_y;
+        int64_t m_z;
+
+        bool operator==(const Voxel& other) const
+        {
+            return m_x == other.m_x && m_y == other.m_y && m_z == other.m_z;
+        }
+    };
+
+    struct VoxelHash
+    {
+        size_t operator()(const Voxel& v) const
+        {
+            size_t h = std::hash<int64_t>()(v.m_x);
+            h = h * 31 + std::hash<int64_t>()(v.m_y);
+            return h * 31 + std::hash<int64_t>()(v.m_z);
+        }
+    };
+
+    typedef std::unordered_set<Voxel, VoxelHash> VoxelSet;
+
+    double m_leafX;
+    double m_leafY;
+    double m_leafZ;
+    int m_threads;
+    VoxelSet m_voxels;
+
+    virtual void processOptions(const Options& options);
+    virtual void ready(PointTableRef table)
+        { m_voxels.clear(); }
+    virtual bool streamable() const
+        { return true; }
+    virtual bool processOne(PointRef& point);
+    virtual PointViewSet run(PointViewPtr view);
+    Voxel voxel(double x, double y, double z) const;
+
+    VoxelDownsizeFilter& operator=(const VoxelDownsizeFilter&); // not implemented
+    VoxelDownsizeFilter(const VoxelDownsizeFilter&); // not implemented
+};
+
+} // pdal
@@ -0,0 +1,104 @@
+/******************************************************************************
+* Copyright (c) 2015, Howard Butler (howard@hobu.co)
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+#pragma once
+
+#include <pdal/pdal_internal.hpp>
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace pdal
+{
+
+/// Source of the memory blocks in which a PointTable stores point data.
+/// Blocks returned by allocate() are zero-filled.  An allocator may be shared
+/// by several tables and must be safe to use from multiple threads.
+class PDAL_DLL BlockAllocator
+{
+public:
+    virtual ~BlockAllocator()
+    {}
+
+    virtual char *allocate(std::size_t size) = 0;
+    virtual void release(char *block, std::size_t size) = 0;
+};
+typedef std::shared_ptr<BlockAllocator> BlockAllocatorPtr;
+
+/// Allocate blocks from the heap and free them when released.
+class PDAL_DLL HeapBlockAllocator : public BlockAllocator
+{
+public:
+    virtual char *allocate(std::size_t size);
+    virtual void release(char *block, std::size_t size);
+};
+
+/// Keep released blocks and hand them out again rather than returning them
+/// to the system, so that processing many similarly sized point sets in one
+/// process doesn't repeatedly fault in fresh memory.  With huge pages,
+/// blocks are mapped directly and the system is asked to back them with
+/// transparent huge pages where supported.
+class PDAL_DLL PoolBlockAllocator : public BlockAllocator
+{
+public:
+    /// \param hugePages  Request huge pages for new blocks.
+    /// \param maxPooled  Maximum number of bytes held in released blocks,
+    ///   0 for no limit.  Blocks released beyond the limit are freed.
+    PoolBlockAllocator(bool hugePages = false, std::size_t maxPooled = 0);
+    virtual ~PoolBlockAllocator();
+
+    virtual char *allocate(std::size_t size);
+    virtual void release(char *block, std::size_t size);
+
+    /// Number of bytes currently held in released blocks.
+    std::size_t pooled() const;
+
+private:
+    char *create(std::size_t size);
+    void destroy(char *block, std::size_t size);
+
+    bool m_hugePages;
+    std::size_t m_maxPooled;
+    std::size_t m_pooled;
+    std::map<std::size_t, std::vector<char *>> m_free;
+    mutable std::mutex m_mutex;
+
+    PoolBlockAllocator(const PoolBlockAllocator&); // not implemented
+    PoolBlockAllocator& operator=(const PoolBlockAllocator&); // not implemented
+};
+
+} // namespace pdal
@@ -48,8 +48,10 @@
 #endif
 
 #include <pdal/Dimension.hpp>
+#include <pdal/util/IStream.hpp>
 #include <pdal/util/OStream.hpp>
 
+#include <limits>
 #include <map>
 #include <vector>
 
@@ -231,14 +233,17 @@ public:
 
     void compress(const char *inbuf)
     {
-        // First time through.
         if (!m_encoder || !m_compressor)
         {
-            // Get the position 
-            m_chunkInfoPos = m_stream.tellp();
-            // Seek over the chunk info offset value
-            m_stream.seekp(sizeof(uint64_t), std::ios::cur);
-            m_chunkOffset = m_stream.tellp();
+            // First time through.
+            if (m_chunkTable.empty())
+            {
+                // Get the position 
+                m_chunkInfoPos = m_stream.tellp();
+                // Seek over the chunk info offset value
+                m_stream.seekp(sizeof(uint64_t), std::ios::cur);
+                m_chunkOffset = m_stream.tellp();
+            }
             resetCompressor();
         }
         else if (m_chunkPointsWritten == m_chunksize)
@@ -250,13 +255,26 @@ public:
         m_chunkPointsWritten++;
     }
 
-    void done()
+    // End the current chunk so that the next point starts a new one.
+    // Only useful with a variable chunk size.
+    void chunk()
     {
-        // Close and clear the point encoder.
+        if (!m_encoder || !m_chunkPointsWritten)
+            return;
         m_encoder->done();
         m_encoder.reset();
-
         newChunk();
+    }
+
+    void done()
+    {
+        // Close and clear the point encoder.
+        if (m_encoder)
+        {
+            m_encoder->done();
+            m_encoder.reset();
+            newChunk();
+        }
 
         // Save our current position.  Go to the location where we need
         // to write the chunk table offset at the beginning of the point data.
@@ -278,10 +296,21 @@ public:
         laszip::compressors::integer compressor(32, 2);
         compressor.init();
 
+        // Tables of variable-sized chunks also hold the point count of
+        // each chunk.
+        bool variable =
+            (m_chunksize == (std::numeric_limits<uint32_t>::max)());
         uint32_t predictor = 0;
-        for (uint32_t offset : m_chunkTable)
+        uint32_t countPredictor = 0;
+        for (size_t i = 0; i < m_chunkTable.size(); ++i)
         {
-            offset = htole32(offset);
+            if (variable)
+            {
+                uint32_t count = htole32(m_chunkCounts[i]);
+                compressor.compress(encoder, countPredictor, count, 0);
+                countPredictor = count;
+            }
+            uint32_t offset = htole32(m_chunkTable[i]);
             compressor.compress(encoder, predictor, offset, 1);
             predictor = offset;
         }
@@ -301,6 +330,7 @@ private:
     {
         std::streampos offset = m_stream.tellp();
         m_chunkTable.push_back((uint32_t)(offset - m_chunkOffset));
+        m_chunkCounts.push_back(m_chunkPointsWritten);
         m_chunkOffset = offset;
         m_chunkPointsWritten = 0;
     }
@@ -315,6 +345,7 @@ private:
     std::streampos m_chunkInfoPos;
     std::streampos m_chunkOffset;
     std::vector<uint32_t> m_chunkTable;
+    std::vector<uint32_t> m_chunkCounts;
 };
 
 
@@ -355,26 +386,46 @@ private:
 class LazPerfVlrDecompressor
 {
 public:
+    // Decompress the point data that starts at 'pointOffset' with the
+    // chunk table offset.
     LazPerfVlrDecompressor(std::istream& stream, const char *vlrData,
         std::streamoff pointOffset) :
         m_stream(stream), m_inputStream(stream), m_chunksize(0),
-        m_chunkPointsRead(0)
+        m_chunkPointsRead(0), m_chunk(0)
     {
         laszip::io::laz_vlr zipvlr(vlrData);
         m_chunksize = zipvlr.chunk_size;
         m_schema = laszip::io::laz_vlr::to_schema(zipvlr);
+        if (m_chunksize == (std::numeric_limits<uint32_t>::max)())
+            readChunkCounts(pointOffset);
+        m_stream.clear();
         m_stream.seekg(pointOffset + sizeof(int64_t));
     }
 
+    // Decompress only the chunk of 'chunkCount' points that starts at
+    // 'chunkOffset'.
+    LazPerfVlrDecompressor(std::istream& stream, const char *vlrData,
+        std::streamoff chunkOffset, uint32_t chunkCount) :
+        m_stream(stream), m_inputStream(stream), m_chunksize(chunkCount),
+        m_chunkPointsRead(0), m_chunk(0)
+    {
+        laszip::io::laz_vlr zipvlr(vlrData);
+        m_schema = laszip::io::laz_vlr::to_schema(zipvlr);
+        m_stream.clear();
+        m_stream.seekg(chunkOffset);
+    }
+
     size_t pointSize() const
         { return (size_t)m_schema.size_in_bytes(); }
 
     void decompress(char *outbuf)
     {
-        if (m_chunkPointsRead == m_chunksize || !m_decoder || !m_decompressor)
+        if (!m_decoder || !m_decompressor)
+            resetDecompressor();
+        else if (m_chunkPointsRead == chunkSize())
         {
+            m_chunk++;
             resetDecompressor();
-            m_chunkPointsRead = 0;
         }
         m_decompressor->decompress(outbuf);
         m_chunkPointsRead++;
@@ -386,6 +437,48 @@ private:
         m_decoder.reset(new Decoder(m_inputStream));
         m_decompressor =
             laszip::factory::build_decompressor(*m_decoder, m_schema);
+        m_chunkPointsRead = 0;
+    }
+
+    uint32_t chunkSize() const
+    {
+        return m_chunk < m_chunkCounts.size() ?
+            m_chunkCounts[m_chunk] : m_chunksize;
+    }
+
+    // Variable-sized chunks are ended by the point counts stored in the
+    // chunk table along with the chunk sizes.
+    void readChunkCounts(std::streamoff pointOffset)
+    {
+        ILeStream in(&m_stream);
+        uint64_t chunkTablePos;
+        m_stream.seekg(pointOffset);
+        in >> chunkTablePos;
+
+        uint32_t version;
+        uint32_t numChunks;
+        m_stream.seekg(chunkTablePos);
+        in >> version >> numChunks;
+        if (!m_stream)
+            throw pdal_error("Unable to read LAZperf chunk table.");
+
+        InputStream inputStream(m_stream);
+        Decoder decoder(inputStream);
+        laszip::decompressors::integer decompressor(32, 2);
+        decoder.readInitBytes();
+        decompressor.init();
+
+        uint32_t predictor = 0;
+        uint32_t countPredictor = 0;
+        for (uint32_t i = 0; i < numChunks; ++i)
+        {
+            uint32_t count = (uint32_t)decompressor.decompress(decoder,
+                countPredictor, 0);
+            countPredictor = count;
+            m_chunkCounts.push_back(le32toh(count));
+            predictor = (uint32_t)decompressor.decompress(decoder,
+                predictor, 1);
+        }
     }
 
     typedef laszip::io::__ifstream_wrapper<std::istream> InputStream;
@@ -400,6 +493,8 @@ private:
     Schema m_schema;
     uint32_t m_chunksize;
     uint32_t m_chunkPointsRead;
+    size_t m_chunk;
+    std::vector<uint32_t> m_chunkCounts;
 };
 
 #else
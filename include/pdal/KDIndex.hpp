@@ -182,6 +182,25 @@ public:
         return output;
     }
 
+    // Find the k nearest neighbors of a position along with their square
+    // distances, nearest first.  Searches don't modify the index, so
+    // they may be run concurrently once the index is built.
+    void knnSearch(double x, double y, double z, point_count_t k,
+        std::vector<PointId> *indices, std::vector<double> *sqr_dists) const
+    {
+        k = std::min(m_buf.size(), k);
+        indices->resize(k);
+        sqr_dists->resize(k);
+        if (!k)
+            return;
+        nanoflann::KNNResultSet<double, PointId, point_count_t> resultSet(k);
+
+        resultSet.init(&(*indices)[0], &(*sqr_dists)[0]);
+
+        double pt[] = { x, y, z };
+        m_index->findNeighbors(resultSet, pt, nanoflann::SearchParams(10));
+    }
+
     std::vector<PointId> radius(double x, double y, double z, double r) const
     {
         std::vector<PointId> output;
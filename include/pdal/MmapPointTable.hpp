@@ -0,0 +1,97 @@
+/******************************************************************************
+* Copyright (c) 2015, Howard Butler (howard@hobu.co)
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+#pragma once
+
+#include <pdal/PointTable.hpp>
+
+#include <string>
+#include <vector>
+
+namespace pdal
+{
+
+/// A point table whose storage lives in a memory-mapped temporary file
+/// rather than on the heap.  Blocks of points are mapped as they're
+/// added.  Once more than the resident budget has been written, the
+/// oldest blocks are released from memory.  Their data remains in the
+/// file and is paged back in when accessed, so pipelines that can't
+/// stream can process more points than fit in memory.
+///
+/// The temporary file is removed as soon as it's created, so no spill
+/// file remains after the table is destroyed or the process exits.
+class PDAL_DLL MmapPointTable : public SimplePointTable
+{
+public:
+    /// \param dir  Directory for the spill file.  If empty, TMPDIR or
+    ///     /tmp is used.
+    /// \param residentBytes  Approximate amount of point data to keep
+    ///     in memory while points are added.
+    MmapPointTable(const std::string& dir = "",
+        std::size_t residentBytes = 1024 * 1024 * 1024);
+    virtual ~MmapPointTable();
+
+    virtual bool supportsView() const
+        { return true; }
+
+protected:
+    virtual char *getPoint(PointId idx);
+
+private:
+    // Point storage.
+    std::vector<char *> m_blocks;
+    point_count_t m_numPts;
+    static const point_count_t m_blockPtCnt = 65536;
+
+    std::string m_dir;
+    std::size_t m_residentBytes;
+    std::size_t m_residentBlocks;
+    std::size_t m_blockBytes;
+    int m_fd;
+
+    // Point data operations.
+    virtual PointId addPoint();
+
+    void openFile();
+    void addBlock();
+    void prefetch(std::size_t block);
+    void release(std::size_t block);
+
+    PointLayout m_layout;
+
+    MmapPointTable& operator=(const MmapPointTable&); // not implemented
+    MmapPointTable(const MmapPointTable&); // not implemented
+};
+
+} // namespace pdal
@@ -44,6 +44,8 @@
 #include <pdal/util/Inserter.hpp>
 #include <pdal/util/Extractor.hpp>
 
+#include <functional>
+
 #ifndef WIN32
 #include <sys/fcntl.h>
 #include <unistd.h>
@@ -439,9 +441,39 @@ inline void writeProgress(int fd, const std::string& type,
 
 std::string PDAL_DLL toJSON(const MetadataNode& m);
 void PDAL_DLL toJSON(const MetadataNode& m, std::ostream& o);
+std::string PDAL_DLL toJSONLine(const MetadataNode& m);
 std::string PDAL_DLL toJSON(const Options& opts);
 void PDAL_DLL toJSON(const Options& opts, std::ostream& o);
 
+/**
+  Throw if a 'threads' option value is less than one.
+
+  \param owner  Name of the stage or kernel that owns the option.
+  \param threads  Option value.
+*/
+inline void checkThreads(const std::string& owner, int threads)
+{
+    if (threads < 1)
+    {
+        std::ostringstream oss;
+        oss << owner << ": Option 'threads' must be at least 1.";
+        throw pdal_error(oss.str());
+    }
+}
+
+/**
+  Call a function for each index in [0, count) using up to 'threads'
+  threads.  Indices are handed out in increasing order.  If a call throws,
+  no further indices are handed out and the first exception is rethrown
+  once all threads have finished.
+
+  \param count  Number of indices.
+  \param threads  Maximum number of threads.
+  \param fn  Function called with each index.
+*/
+void PDAL_DLL parallelFor(size_t count, size_t threads,
+    const std::function<void(size_t)>& fn);
+
 } // namespace Utils
 } // namespace pdal
 
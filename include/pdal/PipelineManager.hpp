@@ -49,15 +49,17 @@ class PDAL_DLL PipelineManager
 {
 public:
     PipelineManager() : m_tablePtr(new PointTable()), m_table(*m_tablePtr),
-            m_progressFd(-1)
+            m_progressFd(-1), m_executed(false), m_profiling(false)
         {}
     PipelineManager(int progressFd) : m_tablePtr(new PointTable()),
-            m_table(*m_tablePtr), m_progressFd(progressFd)
+            m_table(*m_tablePtr), m_progressFd(progressFd), m_executed(false),
+            m_profiling(false)
         {}
-    PipelineManager(PointTableRef table) : m_table(table), m_progressFd(-1)
+    PipelineManager(PointTableRef table) : m_table(table), m_progressFd(-1),
+            m_executed(false), m_profiling(false)
         {}
     PipelineManager(PointTableRef table, int progressFd) : m_table(table),
-            m_progressFd(progressFd)
+            m_progressFd(progressFd), m_executed(false), m_profiling(false)
         {}
 
     bool readPipeline(std::istream& input);
@@ -77,6 +79,8 @@ public:
         { return m_stages.empty() ? nullptr : m_stages.back(); }
 
     void prepare() const;
+    // Run the pipeline.  When run again, the point table is reset and
+    // its storage reused, invalidating the views from the previous run.
     point_count_t execute();
 
     // Get the resulting point views.
@@ -89,6 +93,13 @@ public:
 
     MetadataNode getMetadata() const;
 
+    // Turn collection of execution statistics on or off for all stages,
+    // including those added later.
+    void setProfiling(bool profiling);
+
+    // Get the execution statistics of each stage.
+    MetadataNode getProfile() const;
+
 private:
     StageFactory m_factory;
     std::unique_ptr<PointTable> m_tablePtr;
@@ -98,6 +109,8 @@ private:
 
     std::vector<Stage*> m_stages; // stage observer, never owner
     int m_progressFd;
+    bool m_executed;
+    bool m_profiling;
 
     PipelineManager& operator=(const PipelineManager&); // not implemented
     PipelineManager(const PipelineManager&); // not implemented
@@ -65,6 +65,16 @@ class PDAL_DLL PluginManager
     typedef std::vector<PF_ExitFunc> ExitFuncVec;
     typedef std::map<std::string, PF_RegisterParams> RegistrationInfoMap;
 
+    // A plugin stage known from the manifest but not necessarily loaded.
+    struct ManifestEntry
+    {
+        std::string path;
+        int type;
+        std::string description;
+        std::string link;
+    };
+    typedef std::map<std::string, ManifestEntry> ManifestMap;
+
 public:
     PluginManager();
     ~PluginManager();
@@ -86,6 +96,10 @@ private:
     bool loadByPath(const std::string & path, PF_PluginType type);
     bool libraryLoaded(const std::string& path);
     void loadAll(const std::string& pluginDirectory, int type);
+    bool readManifest(const std::string& filename, const StringList& dirs);
+    void buildManifest(const std::string& filename, const StringList& dirs,
+        int type);
+    bool manifestLoad(const std::string& objectType);
     bool l_initializePlugin(PF_InitFunc initFunc);
     void *l_createObject(const std::string& objectType);
     bool l_registerObject(const std::string& name,
@@ -103,6 +117,9 @@ private:
     DynamicLibraryMap m_dynamicLibraryMap;
     ExitFuncVec m_exitFuncVec;
     RegistrationInfoMap m_plugins;
+    ManifestMap m_manifest;
+    int m_manifestTypes;
+    bool m_manifestValid;
     std::mutex m_mutex;
 
     // Disable copy/assignment.
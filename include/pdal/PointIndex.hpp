@@ -0,0 +1,159 @@
+/******************************************************************************
+* Copyright (c) 2015, Howard Butler (howard@hobu.co)
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+#pragma once
+
+#include <pdal/pdal_internal.hpp>
+
+#include <vector>
+
+namespace pdal
+{
+
+// Maps the position of a point in a view to the ID of the point in
+// its table.  Views that are an unmodified, contiguous slice of a table
+// (the common case for readers and for partitioning filters) are stored
+// as a start ID and a count.  The index falls back to an explicit list
+// of IDs the first time a non-contiguous ID is added or an entry is
+// changed.
+class PointIndex
+{
+public:
+    PointIndex() : m_start(0), m_size(0), m_isRange(true)
+    {}
+
+    point_count_t size() const
+        { return m_size; }
+    bool empty() const
+        { return m_size == 0; }
+    bool isRange() const
+        { return m_isRange; }
+
+    PointId operator[](PointId pos) const
+        { return m_isRange ? m_start + pos : m_ids[pos]; }
+
+    void set(PointId pos, PointId id)
+    {
+        if (m_isRange)
+        {
+            if (id == m_start + pos)
+                return;
+            expand(m_size);
+        }
+        m_ids[pos] = id;
+    }
+
+    void push_back(PointId id)
+    {
+        if (m_isRange)
+        {
+            if (m_size == 0)
+                m_start = id;
+            if (id == m_start + m_size)
+            {
+                m_size++;
+                return;
+            }
+            expand(m_size + 1);
+        }
+        m_ids.push_back(id);
+        m_size++;
+    }
+
+    // Append the IDs at positions [pos, pos + count) of another index.
+    void append(const PointIndex& src, PointId pos, point_count_t count)
+    {
+        if (count == 0)
+            return;
+        if (src.m_isRange)
+        {
+            appendRange(src.m_start + pos, count);
+            return;
+        }
+        if (m_isRange)
+            expand(m_size + count);
+        else
+            m_ids.reserve(m_size + count);
+        m_ids.insert(m_ids.end(), src.m_ids.begin() + pos,
+            src.m_ids.begin() + pos + count);
+        m_size += count;
+    }
+
+    // Append the IDs [start, start + count).
+    void appendRange(PointId start, point_count_t count)
+    {
+        if (m_isRange && (m_size == 0 || start == m_start + m_size))
+        {
+            if (m_size == 0)
+                m_start = start;
+            m_size += count;
+            return;
+        }
+        if (m_isRange)
+            expand(m_size + count);
+        else
+            m_ids.reserve(m_size + count);
+        for (PointId id = start; id < start + count; ++id)
+            m_ids.push_back(id);
+        m_size += count;
+    }
+
+    // Drop entries past 'size'.
+    void truncate(point_count_t size)
+    {
+        if (size >= m_size)
+            return;
+        if (!m_isRange)
+            m_ids.resize(size);
+        m_size = size;
+    }
+
+private:
+    PointId m_start;
+    point_count_t m_size;
+    bool m_isRange;
+    std::vector<PointId> m_ids;
+
+    // Switch from a range to an explicit list of IDs with room for
+    // 'capacity' entries.
+    void expand(point_count_t capacity)
+    {
+        m_ids.reserve(capacity);
+        for (PointId id = m_start; id < m_start + m_size; ++id)
+            m_ids.push_back(id);
+        m_isRange = false;
+    }
+};
+
+} // namespace pdal
@@ -37,6 +37,7 @@
 #include <set>
 #include <vector>
 
+#include "pdal/BlockAllocator.hpp"
 #include "pdal/SpatialReference.hpp"
 #include "pdal/Dimension.hpp"
 #include "pdal/PointContainer.hpp"
@@ -91,6 +92,9 @@ public:
     }
     virtual bool supportsView() const
         { return false; }
+    /// Discard the point data so that the table's storage can be reused.
+    virtual void reset()
+        {}
 
     MetadataNode privateMetadata(const std::string& name);
 
@@ -144,16 +148,32 @@ class PDAL_DLL PointTable : public SimplePointTable
 private:
     // Point storage.
     std::vector<char *> m_blocks;
+    std::size_t m_blockSize;
     point_count_t m_numPts;
     static const point_count_t m_blockPtCnt = 65536;
+    BlockAllocatorPtr m_allocator;
 
 public:
-    PointTable() : SimplePointTable(m_layout), m_numPts(0)
+    PointTable() : SimplePointTable(m_layout), m_blockSize(0), m_numPts(0),
+            m_allocator(new HeapBlockAllocator)
+        {}
+    PointTable(BlockAllocatorPtr allocator) : SimplePointTable(m_layout),
+            m_blockSize(0), m_numPts(0), m_allocator(allocator)
         {}
     virtual ~PointTable();
     virtual bool supportsView() const
         { return true; }
 
+    /// Remove all points, dimensions, metadata and spatial references so
+    /// that the table can be used for another pipeline.  Allocated blocks
+    /// are kept and reused.  Views of the table must not be used after a
+    /// reset.
+    virtual void reset();
+
+    /// Give blocks that aren't holding points back to the allocator until
+    /// no more than \a maxBytes of storage are kept.
+    void trim(std::size_t maxBytes);
+
 protected:
     virtual char *getPoint(PointId idx);
 
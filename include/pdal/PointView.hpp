@@ -37,6 +37,7 @@
 #include <pdal/util/Bounds.hpp>
 #include <pdal/pdal_internal.hpp>
 #include <pdal/PointContainer.hpp>
+#include <pdal/PointIndex.hpp>
 #include <pdal/PointLayout.hpp>
 #include <pdal/PointRef.hpp>
 #include <pdal/PointTable.hpp>
@@ -45,7 +46,6 @@
 #include <queue>
 #include <set>
 #include <vector>
-#include <deque>
 
 #ifdef PDAL_COMPILER_MSVC
 #  pragma warning(disable: 4244)  // conversion from 'type1' to 'type2', possible loss of data
@@ -90,16 +90,10 @@ public:
         { return m_size == 0; }
 
     inline void appendPoint(const PointView& buffer, PointId id);
+    inline void appendPoints(const PointView& buffer, PointId first,
+        point_count_t count);
     void append(const PointView& buf)
-    {
-        // We use size() instead of the index end because temp points
-        // might have been placed at the end of the buffer.
-        auto thisEnd = m_index.begin() + size();
-        auto bufEnd = buf.m_index.begin() + buf.size();
-        m_index.insert(thisEnd, buf.m_index.begin(), bufEnd);
-        m_size += buf.size();
-        clearTemps();
-    }
+        { appendPoints(buf, 0, buf.size()); }
 
     /// Return a new point view with the same point table as this
     /// point buffer.
@@ -258,7 +252,7 @@ public:
 
 protected:
     PointTableRef m_pointTable;
-    std::deque<PointId> m_index;
+    PointIndex m_index;
     // The index might be larger than the size to support temporary point
     // references.
     point_count_t m_size;
@@ -548,6 +542,21 @@ inline void PointView::appendPoint(const PointView& buffer, PointId id)
 }
 
 
+// Append the points at positions [first, first + count) of 'buffer'.
+// A contiguous run of points appended to an empty or contiguous view
+// keeps the view's index as a range.
+inline void PointView::appendPoints(const PointView& buffer, PointId first,
+    point_count_t count)
+{
+    // We truncate to size() because temp points might have been placed
+    // at the end of the index.
+    m_index.truncate(size());
+    clearTemps();
+    m_index.append(buffer.m_index, first, count);
+    m_size += count;
+}
+
+
 // Make a temporary copy of a point by adding an entry to the index.
 inline PointId PointView::getTemp(PointId id)
 {
@@ -556,7 +565,7 @@ inline PointId PointView::getTemp(PointId id)
     {
         newid = m_temps.front();
         m_temps.pop();
-        m_index[newid] = m_index[id];
+        m_index.set(newid, m_index[id]);
     }
     else
     {
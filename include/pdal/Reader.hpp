@@ -49,14 +49,26 @@ class PDAL_DLL Reader : public Stage
 public:
     typedef std::function<void(PointView&, PointId)> PointReadFunc;
 
-    Reader() : m_count(std::numeric_limits<point_count_t>::max())
+    Reader() : m_start(0), m_count(std::numeric_limits<point_count_t>::max())
     {}
 
     void setReadCb(PointReadFunc cb)
         { m_cb = cb; }
 
+    /**
+      Determine whether the reader can begin reading at the point given by
+      the "start" option without reading the points that precede it.
+      Valid once the stage has been initialized by \ref prepare or
+      \ref preview.
+
+      \return  Whether the reader can seek to a point efficiently.
+    */
+    virtual bool canSeek() const
+        { return false; }
+
 protected:
     std::string m_filename;
+    point_count_t m_start;
     point_count_t m_count;
     PointReadFunc m_cb;
 
@@ -71,6 +83,9 @@ private:
         return viewSet;
     }
     virtual void readerProcessOptions(const Options& options);
+    // Whether the reader honors the "start" option.
+    virtual bool supportsStart() const
+        { return false; }
     virtual point_count_t read(PointViewPtr /*view*/, point_count_t /*num*/)
         { return 0; }
 };
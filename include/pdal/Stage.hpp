@@ -48,6 +48,7 @@
 #include <pdal/PointView.hpp>
 #include <pdal/QuickInfo.hpp>
 #include <pdal/SpatialReference.hpp>
+#include <pdal/StageProfile.hpp>
 
 namespace pdal
 {
@@ -140,6 +141,15 @@ public:
     */
     void execute(StreamPointTable& table);
 
+    /**
+      Determine whether this stage and all of its inputs support streaming
+      mode, so that the pipeline can be run with \ref execute on a
+      StreamPointTable.
+
+      \return  Whether the pipeline ending at this stage can be streamed.
+    */
+    bool pipelineStreamable() const;
+
     /**
       Set the spatial reference of a stage.
 
@@ -264,6 +274,24 @@ public:
     MetadataNode getMetadata() const
         { return m_metadata; }
 
+    /**
+      Turn collection of timing, I/O and memory statistics on or off.
+      Point and view counts are always collected.
+
+      \param profiling  Whether to collect statistics.
+    */
+    void setProfiling(bool profiling)
+        { m_profile.setEnabled(profiling); }
+
+    /**
+      Get the execution statistics of the stage from the most recent
+      execution.
+
+      \return  Stage's execution statistics.
+    */
+    const StageProfile& getProfile() const
+        { return m_profile; }
+
     /**
       Serialize a stage by inserting apporpritate data into the provided
       MetadataNode.  Used to dump a pipeline specification in a portable
@@ -287,6 +315,7 @@ private:
     std::vector<Stage *> m_inputs;
     LogPtr m_log;
     SpatialReference m_spatialReference;
+    StageProfile m_profile;
 
     Stage& operator=(const Stage&); // not implemented
     Stage(const Stage&); // not implemented
@@ -374,6 +403,15 @@ private:
         throw pdal_error(oss.str());
     }
 
+    /**
+      Determine whether this stage supports streaming mode.  Implement in
+      subclasses that implement \ref processOne.
+
+      \return  Whether the stage supports streaming mode.
+    */
+    virtual bool streamable() const
+        { return false; }
+
     /**
       Process all points in a view.  Implement in subclass.
 
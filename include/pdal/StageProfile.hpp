@@ -0,0 +1,138 @@
+/******************************************************************************
+* Copyright (c) 2015, Howard Butler (howard@hobu.co)
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+#pragma once
+
+#include <pdal/pdal_internal.hpp>
+#include <pdal/Metadata.hpp>
+
+#include <chrono>
+#include <ctime>
+
+namespace pdal
+{
+
+/**
+  Execution statistics of a stage.  Stages record the time spent in each
+  phase of execution along with the points and views that pass through
+  them.  Statistics are reset when a stage is prepared.  Timing, I/O and
+  memory are only collected when profiling has been enabled, since reading
+  them costs system calls for every batch of points in stream mode.
+*/
+class PDAL_DLL StageProfile
+{
+public:
+    enum Phase
+    {
+        Ready,
+        Run,
+        ProcessOne,
+        Done,
+        NumPhases
+    };
+
+    /**
+      Records the time and I/O of a phase from construction until
+      destruction.  Does nothing if profiling isn't enabled.
+    */
+    class PDAL_DLL Timer
+    {
+    public:
+        Timer(StageProfile& profile, Phase phase);
+        ~Timer();
+
+    private:
+        StageProfile& m_profile;
+        Phase m_phase;
+        std::chrono::steady_clock::time_point m_wallStart;
+        std::clock_t m_cpuStart;
+        uint64_t m_readStart;
+        uint64_t m_writeStart;
+    };
+
+    StageProfile() : m_enabled(false)
+        { reset(); }
+
+    /**
+      Turn collection of timing, I/O and memory statistics on or off.
+    */
+    void setEnabled(bool enabled)
+        { m_enabled = enabled; }
+    bool enabled() const
+        { return m_enabled; }
+
+    void reset();
+
+    void addPointsIn(point_count_t count)
+        { m_pointsIn += count; }
+    void addPointsOut(point_count_t count)
+        { m_pointsOut += count; }
+    void addViews(point_count_t count)
+        { m_views += count; }
+
+    /**
+      Whether anything has been recorded since the last reset.
+    */
+    bool empty() const;
+
+    /**
+      Convert the statistics to metadata.
+
+      \param name  Name of the metadata node to create.
+      \return  Metadata node containing the statistics.
+    */
+    MetadataNode toMetadata(const std::string& name = "profile") const;
+
+private:
+    struct PhaseStats
+    {
+        double m_wallTime;
+        double m_cpuTime;
+        point_count_t m_calls;
+        uint64_t m_bytesRead;
+        uint64_t m_bytesWritten;
+    };
+
+    PhaseStats m_phases[NumPhases];
+    point_count_t m_pointsIn;
+    point_count_t m_pointsOut;
+    point_count_t m_views;
+    uint64_t m_peakMemory;
+    bool m_enabled;
+
+    static void ioCounts(uint64_t& bytesRead, uint64_t& bytesWritten);
+    static uint64_t peakMemory();
+};
+
+} // namespace pdal
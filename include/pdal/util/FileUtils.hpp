@@ -116,6 +116,10 @@ namespace FileUtils
     /// Return the filename stripped of the extension.  . and .. are returned
     /// unchanged.
     PDAL_DLL std::string stem(const std::string& path);
+
+    /// Return the names of files matching a shell wildcard pattern.
+    /// On Windows the pattern is only matched literally.
+    PDAL_DLL StringList glob(const std::string& pattern);
 }
 
 } // namespace pdal
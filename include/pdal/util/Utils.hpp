@@ -383,6 +383,33 @@ namespace Utils
     */
     PDAL_DLL std::string hexDump(const char *buf, size_t count);
 
+    /**
+      Write a double in fixed notation with the requested number of digits
+      after the decimal point, without using iostreams or the locale.
+      The output is identical to that of a stream with std::fixed set and
+      the stream precision set to \ref precision.  Values whose rounding
+      can't be determined exactly with integer arithmetic are formatted
+      with snprintf(), and the locale's decimal point is replaced with '.'.
+
+      \param v  Value to format.
+      \param precision  Number of digits after the decimal point.
+      \param buf  Buffer to which the text is written.  No terminating null
+        is written.  The buffer must hold at least
+        \ref fixedBufSize(precision) characters.
+      \return  Pointer to the position after the last character written.
+    */
+    PDAL_DLL char *formatFixed(double v, int precision, char *buf);
+
+    /**
+      Return the buffer size needed to format any double with
+      \ref formatFixed().
+
+      \param precision  Number of digits after the decimal point.
+      \return  Required buffer size.
+    */
+    inline size_t fixedBufSize(int precision)
+        { return 320 + (size_t)std::max(precision, 0); }
+
     /**
       Count the number of characters in a string that meet a predicate.
 
@@ -35,98 +35,63 @@
 #include "BpfCompressor.hpp"
 
 #include <pdal/pdal_internal.hpp>
+#include <pdal/PDALUtils.hpp>
 
 namespace pdal
 {
 
-void BpfCompressor::startBlock()
+// Queue a block for compression.  The data is taken from 'raw', which is
+// left empty.  Queued blocks are compressed and written once there is a
+// block for each thread.
+void BpfCompressor::addBlock(std::vector<char>& raw)
 {
-    // Initialize the stream.
-    m_strm.zalloc = Z_NULL;
-    m_strm.zfree = Z_NULL;
-    m_strm.opaque = Z_NULL;
-    if (deflateInit(&m_strm, Z_DEFAULT_COMPRESSION) != Z_OK)
-        throw pdal_error("Could not initialize BPF compressor.");
-
-    m_rawSize = 0;
-    m_compressedSize = 0;
-    uint32_t rawSize = 0;
-    uint32_t compressedSize = 0;
-
-    // Initiailize the streambuf with the backing buffer.
-    m_charbuf.initialize(m_inbuf.data(), m_inbuf.size());
-
-    // Note our position so that we can rewind here.
-    m_blockStart.mark();
-    m_out << rawSize << compressedSize;
-
-    // Make a new stream from our charbuf and push it so that future writes
-    // to our stream go to the backing vector.
-    m_out.pushStream(new std::ostream(&m_charbuf));
+    Block& b = m_blocks[m_numBlocks++];
+    b.m_raw.clear();
+    b.m_raw.swap(raw);
+    if (m_numBlocks == m_blocks.size())
+        flush();
 }
 
 
-void BpfCompressor::compress()
+// Compress all queued blocks and write them in order.
+void BpfCompressor::flush()
 {
-    // Note our position so that we know how much we've written.
-    std::size_t rawWritten = m_out.position();
+    Utils::parallelFor(m_numBlocks, m_numBlocks,
+        [this](size_t i){ compress(m_blocks[i]); });
 
-    // Pop our temp stream so that we can write the real output file.
-    m_out.popStream();
-
-    m_rawSize += rawWritten;
-
-    // Deflate the data in the buffer and write it to the output stream.
-    m_strm.avail_in = rawWritten;
-    m_strm.next_in = (unsigned char *)m_inbuf.data();
-    m_strm.avail_out = CHUNKSIZE;
-    m_strm.next_out = m_tmpbuf;
-    while (m_strm.avail_in)
+    for (size_t i = 0; i < m_numBlocks; ++i)
     {
-        int ret = ::deflate(&m_strm, Z_NO_FLUSH);
-        size_t written = CHUNKSIZE - m_strm.avail_out;
-        m_compressedSize += written;
-        m_out.put(m_tmpbuf, written);
-        m_strm.avail_out = CHUNKSIZE;
-        m_strm.next_out = m_tmpbuf;
+        Block& b = m_blocks[i];
+        if (!b.m_ok)
+            throw pdal_error("Couldn't compress BPF data block.");
+        m_out << (uint32_t)b.m_raw.size() << (uint32_t)b.m_compressed.size();
+        m_out.put(b.m_compressed.data(), b.m_compressed.size());
     }
-
-    // All data has been written.  Reinitialize input buffer's streambuf and
-    // push it.
-    m_charbuf.initialize(m_inbuf.data(), m_inbuf.size());
-    m_out.pushStream(new std::ostream(&m_charbuf));
+    m_numBlocks = 0;
 }
 
 
-void BpfCompressor::finish()
+void BpfCompressor::compress(Block& b)
 {
-    // Pop our special stream so that we can write the the file.
-    m_out.popStream();
-
-    // Deflate and write the result to the output file.
-    int ret = Z_OK;
-    while (ret == Z_OK)
-    {
-        ret = ::deflate(&m_strm, Z_FINISH);
-        size_t written = CHUNKSIZE - m_strm.avail_out;
-        m_compressedSize += written;
-        m_out.put(m_tmpbuf, written);
-        m_strm.avail_out = CHUNKSIZE;
-        m_strm.next_out = m_tmpbuf;
-    }
-    if (ret != Z_STREAM_END)
-        throw pdal_error("Couldn't close BPF compression stream.");
-    deflateEnd(&m_strm);
-
-    // Mark our position so that we can get back here.
-    OStreamMarker blockEnd(m_out);
-
-    // Rewind to the start of the block and write the size bytes.
-    m_blockStart.rewind();
-    m_out << (uint32_t)m_rawSize << (uint32_t)m_compressedSize;
-
-    // Set the position back to the end of the block.
-    blockEnd.rewind();
+    z_stream strm;
+
+    strm.zalloc = Z_NULL;
+    strm.zfree = Z_NULL;
+    strm.opaque = Z_NULL;
+    b.m_ok = false;
+    if (deflateInit(&strm, Z_DEFAULT_COMPRESSION) != Z_OK)
+        return;
+
+    // deflateBound() guarantees that a single call will finish the stream.
+    b.m_compressed.resize(deflateBound(&strm, b.m_raw.size()));
+    strm.avail_in = b.m_raw.size();
+    strm.next_in = (unsigned char *)b.m_raw.data();
+    strm.avail_out = b.m_compressed.size();
+    strm.next_out = b.m_compressed.data();
+    int ret = ::deflate(&strm, Z_FINISH);
+    b.m_compressed.resize(b.m_compressed.size() - strm.avail_out);
+    deflateEnd(&strm);
+    b.m_ok = (ret == Z_STREAM_END);
 }
-   
+
 } // namespace pdal
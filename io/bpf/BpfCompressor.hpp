@@ -34,37 +34,41 @@
 
 #pragma once
 
-#include <ostream>
+#include <vector>
 #include <zlib.h>
 
-#include <pdal/util/Charbuf.hpp>
 #include <pdal/util/OStream.hpp>
 
 namespace pdal
 {
 
+// Compresses blocks of raw point data and writes them to the output stream
+// as BPF compressed blocks (raw size, compressed size, deflated data).
+// Each block is an independent deflate stream, so queued blocks are
+// compressed concurrently and then written in the order they were added.
 class BpfCompressor
 {
 public:
-    BpfCompressor(OLeStream& out, size_t maxSize) :
-        m_out(out), m_inbuf(maxSize), m_blockStart(out), m_rawSize(0),
-        m_compressedSize(0)
+    BpfCompressor(OLeStream& out, int threads) :
+        m_out(out), m_blocks(threads < 1 ? 1 : threads), m_numBlocks(0)
     {}
-    void startBlock();
-    void finish();
-    void compress();
-   
+
+    void addBlock(std::vector<char>& raw);
+    void flush();
+
 private:
-    static const int CHUNKSIZE = 1000000;
+    struct Block
+    {
+        std::vector<char> m_raw;
+        std::vector<unsigned char> m_compressed;
+        bool m_ok;
+    };
 
     OLeStream& m_out;
-    Charbuf m_charbuf;
-    std::vector<char> m_inbuf;
-    z_stream m_strm;
-    unsigned char m_tmpbuf[CHUNKSIZE];
-    OStreamMarker m_blockStart;
-    size_t m_rawSize;
-    size_t m_compressedSize;
+    std::vector<Block> m_blocks;
+    size_t m_numBlocks;
+
+    static void compress(Block& block);
 };
 
 } // namespace pdal
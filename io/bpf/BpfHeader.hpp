@@ -87,6 +87,12 @@ struct BpfMuellerMatrix
         y = (x * m_vals[4] + y * m_vals[5] + z * m_vals[6] + m_vals[7]) / w;
         z = (x * m_vals[8] + y * m_vals[9] + z * m_vals[10] + m_vals[11]) / w;
     }
+
+    void apply(double *x, double *y, double *z, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+            apply(x[i], y[i], z[i]);
+    }
 };
 ILeStream& operator >> (ILeStream& stream, BpfMuellerMatrix& m);
 OLeStream& operator << (OLeStream& stream, BpfMuellerMatrix& m);
@@ -37,6 +37,7 @@
 #include <zlib.h>
 
 #include <pdal/Options.hpp>
+#include <pdal/PDALUtils.hpp>
 #include <pdal/pdal_export.hpp>
 #include <pdal/pdal_macros.hpp>
 
@@ -54,10 +55,21 @@ CREATE_STATIC_PLUGIN(1, 0, BpfReader, Reader, s_info)
 
 std::string BpfReader::getName() const { return s_info.name; }
 
-void BpfReader::processOptions(const Options&)
+namespace
+{
+
+// Number of points read from the file at once in standard mode.
+const point_count_t ChunkSize = 65536;
+
+} // unnamed namespace
+
+
+void BpfReader::processOptions(const Options& options)
 {
     if (m_filename.empty())
         throw pdal_error("Can't read BPF file without filename.");
+    m_threads = options.getValueOrDefault<int>("threads", 1);
+    Utils::checkThreads(getName(), m_threads);
 
     // Logfile doesn't get set until options are processed.
     m_header.setLog(log());
@@ -227,21 +239,16 @@ void BpfReader::ready(PointTableRef)
 {
     m_stream.open(m_filename);
     m_stream.seek(m_header.m_len);
-    m_index = 0;
-    m_start = m_stream.position();
+    m_index = (std::min)(m_start, numPoints());
+    m_dataStart = m_stream.position();
     if (m_header.m_compression)
     {
         m_deflateBuf.resize(numPoints() * m_dims.size() * sizeof(float));
-        size_t index = 0;
-        size_t bytesRead = 0;
-        do
-        {
-            bytesRead = readBlock(m_deflateBuf, index);
-            index += bytesRead;
-        } while (bytesRead > 0 && index < m_deflateBuf.size());
-        m_charbuf.initialize(m_deflateBuf.data(), m_deflateBuf.size(), m_start);
+        inflateBlocks();
+        m_charbuf.initialize(m_deflateBuf.data(), m_deflateBuf.size(), m_dataStart);
         m_stream.pushStream(new std::istream(&m_charbuf));
     }
+    m_blockData.resize(m_dims.size());
 }
 
 
@@ -254,6 +261,9 @@ void BpfReader::done(PointTableRef)
 
 bool BpfReader::processOne(PointRef& point)
 {
+    if (eof() || m_index - m_start >= m_count)
+        return false;
+
     switch (m_header.m_pointFormat)
     {
     case BpfFormat::PointMajor:
@@ -266,7 +276,7 @@ bool BpfReader::processOne(PointRef& point)
         readByteMajor(point);
         break;
     }
-    return !eof() && (m_index < m_count);
+    return true;
 }
 
 
@@ -285,21 +295,60 @@ point_count_t BpfReader::read(PointViewPtr data, point_count_t count)
 }
 
 
-size_t BpfReader::readBlock(std::vector<char>& outBuf, size_t index)
+// Compressed blocks are independent deflate streams, so we read as many
+// blocks as we have threads and inflate them concurrently into their
+// place in the output buffer.
+void BpfReader::inflateBlocks()
 {
-    uint32_t finalBytes;
-    uint32_t compressBytes;
-
-    m_stream >> finalBytes;
-    m_stream >> compressBytes;
+    struct Block
+    {
+        std::vector<char> m_in;
+        size_t m_outPos;
+        size_t m_outSize;
+        int m_result;
+    };
 
-    std::vector<char> in(compressBytes);
+    std::vector<Block> blocks(m_threads);
+    size_t index = 0;
+    bool done = false;
+    while (!done && index < m_deflateBuf.size())
+    {
+        size_t numBlocks = 0;
+        for (; numBlocks < blocks.size() && index < m_deflateBuf.size();
+            ++numBlocks)
+        {
+            uint32_t finalBytes;
+            uint32_t compressBytes;
+
+            m_stream >> finalBytes;
+            m_stream >> compressBytes;
+            if (!m_stream || finalBytes > m_deflateBuf.size() - index)
+                break;
+
+            Block& b = blocks[numBlocks];
+            b.m_in.resize(compressBytes);
+            m_stream.get(b.m_in);
+            b.m_outPos = index;
+            b.m_outSize = finalBytes;
+            index += finalBytes;
+        }
 
-    // Fill the input bytes from the stream.
-    m_stream.get(in);
-    int ret = inflate(in.data(), compressBytes,
-        outBuf.data() + index, finalBytes);
-    return (ret ? 0 : finalBytes);
+        auto inflateBlock = [this](Block& b)
+        {
+            b.m_result = inflate(b.m_in.data(), b.m_in.size(),
+                m_deflateBuf.data() + b.m_outPos, b.m_outSize);
+        };
+
+        Utils::parallelFor(numBlocks, numBlocks,
+            [&](size_t i){ inflateBlock(blocks[i]); });
+
+        // Stop at the first block that failed or was empty.
+        if (numBlocks < blocks.size())
+            done = true;
+        for (size_t i = 0; i < numBlocks; ++i)
+            if (blocks[i].m_result || blocks[i].m_outSize == 0)
+                done = true;
+    }
 }
 
 
@@ -341,35 +390,24 @@ void BpfReader::readPointMajor(PointRef& point)
 point_count_t BpfReader::readPointMajor(PointViewPtr view, point_count_t count)
 {
     PointId nextId = view->size();
-    PointId idx = m_index;
     point_count_t numRead = 0;
-    seekPointMajor(idx);
-    while (numRead < count && idx < numPoints())
-    {
-        for (size_t d = 0; d < m_dims.size(); ++d)
-        {
-            float f;
+    const size_t numDims = m_dims.size();
 
-            m_stream >> f;
-            view->setField(m_dims[d].m_id, nextId, f + m_dims[d].m_offset);
-        }
-
-        // Transformation only applies to X, Y and Z
-        double x = view->getFieldAs<double>(Dimension::Id::X, nextId);
-        double y = view->getFieldAs<double>(Dimension::Id::Y, nextId);
-        double z = view->getFieldAs<double>(Dimension::Id::Z, nextId);
-        m_header.m_xform.apply(x, y, z);
-        view->setField(Dimension::Id::X, nextId, x);
-        view->setField(Dimension::Id::Y, nextId, y);
-        view->setField(Dimension::Id::Z, nextId, z);
-        if (m_cb)
-            m_cb(*view, nextId);
-
-        idx++;
-        numRead++;
-        nextId++;
+    seekPointMajor(m_index);
+    while (point_count_t cnt = blockCount(numRead, count))
+    {
+        readFloats(cnt * numDims);
+        const float *f = m_floatBuf.data();
+        for (size_t d = 0; d < numDims; ++d)
+            m_blockData[d].resize(cnt);
+        for (point_count_t i = 0; i < cnt; ++i)
+            for (size_t d = 0; d < numDims; ++d)
+                m_blockData[d][i] = *f++ + m_dims[d].m_offset;
+        setBlock(view, nextId, cnt);
+        m_index += cnt;
+        numRead += cnt;
+        nextId += cnt;
     }
-    m_index = idx;
     return numRead;
 }
 
@@ -407,40 +445,26 @@ void BpfReader::readDimMajor(PointRef& point)
 
 point_count_t BpfReader::readDimMajor(PointViewPtr data, point_count_t count)
 {
-    PointId idx(0);
-    PointId startId = data->size();
+    PointId nextId = data->size();
     point_count_t numRead = 0;
-    for (size_t d = 0; d < m_dims.size(); ++d)
+
+    // Read a run of each dimension's values, then move to the next chunk.
+    while (point_count_t cnt = blockCount(numRead, count))
     {
-        idx = m_index;
-        PointId nextId = startId;
-        numRead = 0;
-        seekDimMajor(d, idx);
-        for (; numRead < count && idx < numPoints(); idx++, numRead++, nextId++)
+        for (size_t d = 0; d < m_dims.size(); ++d)
         {
-            float f;
-
-            m_stream >> f;
-            data->setField(m_dims[d].m_id, nextId, f + m_dims[d].m_offset);
+            seekDimMajor(d, m_index);
+            readFloats(cnt);
+            std::vector<double>& vals = m_blockData[d];
+            vals.resize(cnt);
+            for (point_count_t i = 0; i < cnt; ++i)
+                vals[i] = m_floatBuf[i] + m_dims[d].m_offset;
         }
+        setBlock(data, nextId, cnt);
+        m_index += cnt;
+        numRead += cnt;
+        nextId += cnt;
     }
-    m_index = idx;
-
-    // Transformation only applies to X, Y and Z
-    for (PointId idx = startId; idx < data->size(); idx++)
-    {
-        double x = data->getFieldAs<double>(Dimension::Id::X, idx);
-        double y = data->getFieldAs<double>(Dimension::Id::Y, idx);
-        double z = data->getFieldAs<double>(Dimension::Id::Z, idx);
-        m_header.m_xform.apply(x, y, z);
-        data->setField(Dimension::Id::X, idx, x);
-        data->setField(Dimension::Id::Y, idx, y);
-        data->setField(Dimension::Id::Z, idx, z);
-
-        if (m_cb)
-            m_cb(*data, idx);
-    }
-
     return numRead;
 }
 
@@ -487,71 +511,101 @@ void BpfReader::readByteMajor(PointRef& point)
 
 point_count_t BpfReader::readByteMajor(PointViewPtr data, point_count_t count)
 {
-    PointId idx(0);
-    PointId startId = data->size();
+    PointId nextId = data->size();
     point_count_t numRead = 0;
+    std::vector<uint8_t> bytes;
+    std::vector<uint32_t> words;
 
-    // We need a temp buffer for the point data
-    union uu
+    while (point_count_t cnt = blockCount(numRead, count))
     {
-        float f;
-        uint32_t u32;
-    };
-    std::unique_ptr<union uu> uArr(
-        new uu[std::min(count, numPoints() - m_index)]);
-
-    for (size_t d = 0; d < m_dims.size(); ++d)
-    {
-        for (size_t b = 0; b < sizeof(float); ++b)
+        bytes.resize(cnt);
+        for (size_t d = 0; d < m_dims.size(); ++d)
         {
-            idx = m_index;
-            numRead = 0;
-            PointId nextId = startId;
-            seekByteMajor(d, b, idx);
+            words.assign(cnt, 0);
+            for (size_t b = 0; b < sizeof(float); ++b)
+            {
+                seekByteMajor(d, b, m_index);
+                m_stream.get(bytes.data(), cnt);
+                for (point_count_t i = 0; i < cnt; ++i)
+                    words[i] |= ((uint32_t)bytes[i] << (b * CHAR_BIT));
+            }
 
-            for (;numRead < count && idx < numPoints();
-                idx++, numRead++, nextId++)
+            std::vector<double>& vals = m_blockData[d];
+            vals.resize(cnt);
+            for (point_count_t i = 0; i < cnt; ++i)
             {
-                union uu& u = *(uArr.get() + numRead);
-
-                if (b == 0)
-                    u.u32 = 0;
-                uint8_t u8;
-                m_stream >> u8;
-                u.u32 |= ((uint32_t)u8 << (b * CHAR_BIT));
-                if (b == 3)
-                {
-                    u.f += m_dims[d].m_offset;
-                    data->setField(m_dims[d].m_id, nextId, u.f);
-                }
+                float f;
+                std::memcpy(&f, &words[i], sizeof(f));
+                f += m_dims[d].m_offset;
+                vals[i] = f;
             }
         }
+        setBlock(data, nextId, cnt);
+        m_index += cnt;
+        numRead += cnt;
+        nextId += cnt;
     }
-    m_index = idx;
+    return numRead;
+}
 
-    // Transformation only applies to X, Y and Z
-    for (PointId idx = startId; idx < data->size(); idx++)
+
+// Number of points to read in the next chunk.
+point_count_t BpfReader::blockCount(point_count_t numRead,
+    point_count_t count) const
+{
+    if (numRead >= count || m_index >= numPoints())
+        return 0;
+    return (std::min)(ChunkSize,
+        (std::min)(count - numRead, numPoints() - m_index));
+}
+
+
+// Read little-endian floats from the current stream position.
+void BpfReader::readFloats(point_count_t count)
+{
+    m_floatBuf.resize(count);
+    m_stream.get((char *)m_floatBuf.data(), count * sizeof(float));
+    uint32_t *u = reinterpret_cast<uint32_t *>(m_floatBuf.data());
+    for (point_count_t i = 0; i < count; ++i)
+        u[i] = le32toh(u[i]);
+}
+
+
+// Apply the transformation to X, Y and Z of a block of points and set
+// all the dimension values in the view.
+void BpfReader::setBlock(PointViewPtr view, PointId startId,
+    point_count_t count)
+{
+    double *x = nullptr;
+    double *y = nullptr;
+    double *z = nullptr;
+    for (size_t d = 0; d < m_dims.size(); ++d)
     {
-        double x = data->getFieldAs<double>(Dimension::Id::X, idx);
-        double y = data->getFieldAs<double>(Dimension::Id::Y, idx);
-        double z = data->getFieldAs<double>(Dimension::Id::Z, idx);
-        m_header.m_xform.apply(x, y, z);
-        data->setField(Dimension::Id::X, idx, x);
-        data->setField(Dimension::Id::Y, idx, y);
-        data->setField(Dimension::Id::Z, idx, z);
+        if (m_dims[d].m_id == Dimension::Id::X)
+            x = m_blockData[d].data();
+        else if (m_dims[d].m_id == Dimension::Id::Y)
+            y = m_blockData[d].data();
+        else if (m_dims[d].m_id == Dimension::Id::Z)
+            z = m_blockData[d].data();
+    }
+    if (x && y && z)
+        m_header.m_xform.apply(x, y, z, count);
 
+    for (point_count_t i = 0; i < count; ++i)
+    {
+        PointId id = startId + i;
+        for (size_t d = 0; d < m_dims.size(); ++d)
+            view->setField(m_dims[d].m_id, id, m_blockData[d][i]);
         if (m_cb)
-            m_cb(*data, idx);
+            m_cb(*view, id);
     }
-
-    return numRead;
 }
 
 
 void BpfReader::seekPointMajor(PointId ptIdx)
 {
     std::streamoff offset = ptIdx * sizeof(float) * m_dims.size();
-    m_stream.seek(m_start + offset);
+    m_stream.seek(m_dataStart + offset);
 }
 
 
@@ -559,7 +613,7 @@ void BpfReader::seekDimMajor(size_t dimIdx, PointId ptIdx)
 {
     std::streamoff offset = ((sizeof(float) * dimIdx * numPoints()) +
         (sizeof(float) * ptIdx));
-    m_stream.seek(m_start + offset);
+    m_stream.seek(m_dataStart + offset);
 }
 
 
@@ -569,7 +623,7 @@ void BpfReader::seekByteMajor(size_t dimIdx, size_t byteIdx, PointId ptIdx)
         (dimIdx * numPoints() * sizeof(float)) +
         (byteIdx * numPoints()) +
         ptIdx;
-    m_stream.seek(m_start + offset);
+    m_stream.seek(m_dataStart + offset);
 }
 
 
@@ -64,6 +64,8 @@ public:
 
     virtual point_count_t numPoints() const
         {  return (point_count_t)m_header.m_numPts; }
+    virtual bool canSeek() const
+        { return !m_header.m_compression; }
 private:
     ILeStream m_stream;
     BpfHeader m_header;
@@ -74,19 +76,29 @@ private:
     BpfPolarHeader m_polarHeader;
     std::vector<BpfPolarFrame> m_polarFrames;
     /// Stream position at the beginning of point records.
-    std::streampos m_start;
+    std::streampos m_dataStart;
     /// Index of the next point to read.
     point_count_t m_index;
     /// Buffer for deflated data.
     std::vector<char> m_deflateBuf;
     /// Streambuf for deflated data.
     Charbuf m_charbuf;
+    /// Number of threads to use when inflating data.
+    int m_threads;
+    /// Per-dimension values for a block of points being read.
+    std::vector<std::vector<double>> m_blockData;
+    /// Buffer for raw data read from the stream.
+    std::vector<float> m_floatBuf;
 
     virtual void processOptions(const Options& options);
     virtual QuickInfo inspect();
     virtual void initialize();
     virtual void addDimensions(PointLayoutPtr Layout);
     virtual void ready(PointTableRef table);
+    virtual bool streamable() const
+        { return true; }
+    virtual bool supportsStart() const
+        { return true; }
     virtual bool processOne(PointRef& point);
     virtual point_count_t read(PointViewPtr data, point_count_t num);
     virtual void done(PointTableRef table);
@@ -102,10 +114,14 @@ private:
     point_count_t readDimMajor(PointViewPtr data, point_count_t count);
     void readByteMajor(PointRef& point);
     point_count_t readByteMajor(PointViewPtr data, point_count_t count);
-    size_t readBlock(std::vector<char>& outBuf, size_t index);
+    void inflateBlocks();
     bool eof();
 
-    int inflate(char *inbuf, size_t insize, char *outbuf, size_t outsize);
+    static int inflate(char *inbuf, size_t insize, char *outbuf,
+        size_t outsize);
+    void readFloats(point_count_t count);
+    point_count_t blockCount(point_count_t numRead, point_count_t count) const;
+    void setBlock(PointViewPtr view, PointId startId, point_count_t count);
 
     void seekPointMajor(PointId ptIdx);
     void seekDimMajor(size_t dimIdx, PointId ptIdx);
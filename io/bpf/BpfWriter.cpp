@@ -35,11 +35,11 @@
 #include "BpfWriter.hpp"
 
 #include <pdal/Options.hpp>
+#include <pdal/PDALUtils.hpp>
 #include <pdal/pdal_export.hpp>
 
 #include <zlib.h>
 
-#include "BpfCompressor.hpp"
 #include <pdal/pdal_macros.hpp>
 
 namespace pdal
@@ -56,6 +56,20 @@ CREATE_STATIC_PLUGIN(1, 0, BpfWriter, Writer, s_info)
 
 std::string BpfWriter::getName() const { return s_info.name; }
 
+namespace
+{
+
+char *putFloat(char *pos, float f)
+{
+    uint32_t u;
+    std::memcpy(&u, &f, sizeof(u));
+    u = htole32(u);
+    std::memcpy(pos, &u, sizeof(u));
+    return pos + sizeof(u);
+}
+
+} // unnamed namespace
+
 Options BpfWriter::getDefaultOptions()
 {
     Options ops;
@@ -66,6 +80,7 @@ Options BpfWriter::getDefaultOptions()
         "non-interleaved(\"dimension\"), interleaved(\"point\") or "
         "byte-segregated(\"byte\")");
     ops.add("coord_id", 0, "Coordinate ID (UTM zone).");
+    ops.add("threads", 1, "Number of threads used for compression");
     return ops;
 }
 
@@ -75,6 +90,8 @@ void BpfWriter::processOptions(const Options& options)
     bool compression = options.getValueOrDefault("compression", false);
     m_header.m_compression = compression ? BpfCompression::Zlib :
         BpfCompression::None;
+    m_threads = options.getValueOrDefault<int>("threads", 1);
+    Utils::checkThreads(getName(), m_threads);
 
     std::string encodedHeader =
         options.getValueOrDefault<std::string>("header_data");
@@ -253,89 +270,73 @@ void BpfWriter::writePointMajor(const PointView* data)
     // for 255 dimensions.
     size_t blockpoints = std::min<point_count_t>(10000UL, data->size());
 
-    // For compression we're going to write to a buffer so that it can be
-    // compressed before it's written to the file stream.
-    BpfCompressor compressor(m_stream,
-        blockpoints * sizeof(float) * m_dims.size());
+    BpfCompressor compressor(m_stream, m_threads);
+    std::vector<char> block;
     PointId idx = 0;
     while (idx < data->size())
     {
-        if (m_header.m_compression)
-            compressor.startBlock();
-        size_t blockId;
-        for (blockId = 0; idx < data->size() && blockId < blockpoints;
-            ++idx, ++blockId)
-        {
+        size_t count = std::min<point_count_t>(blockpoints,
+            data->size() - idx);
+        block.resize(count * sizeof(float) * m_dims.size());
+        char *pos = block.data();
+        for (size_t blockId = 0; blockId < count; ++idx, ++blockId)
             for (auto & bpfDim : m_dims)
-            {
-                double d = getAdjustedValue(data, bpfDim, idx);
-                m_stream << (float)d;
-            }
-        }
-        if (m_header.m_compression)
-        {
-            compressor.compress();
-            compressor.finish();
-        }
+                pos = putFloat(pos, (float)getAdjustedValue(data, bpfDim, idx));
+        writeBlock(compressor, block);
     }
+    compressor.flush();
 }
 
 
 void BpfWriter::writeDimMajor(const PointView* data)
 {
-    // We're going to pretend for now that we only even have one point buffer.
-    BpfCompressor compressor(m_stream, data->size() * sizeof(float));
+    // Each dimension is written as a separate block, so the dimensions
+    // can be compressed concurrently.
+    BpfCompressor compressor(m_stream, m_threads);
+    std::vector<char> block;
 
     for (auto & bpfDim : m_dims)
     {
-
-        if (m_header.m_compression)
-            compressor.startBlock();
+        block.resize(data->size() * sizeof(float));
+        char *pos = block.data();
         for (PointId idx = 0; idx < data->size(); ++idx)
-        {
-            double d = getAdjustedValue(data, bpfDim, idx);
-            m_stream << (float)d;
-        }
-        if (m_header.m_compression)
-        {
-            compressor.compress();
-            compressor.finish();
-        }
+            pos = putFloat(pos, (float)getAdjustedValue(data, bpfDim, idx));
+        writeBlock(compressor, block);
     }
+    compressor.flush();
 }
 
 
 void BpfWriter::writeByteMajor(const PointView* data)
 {
-    union
-    {
-        float f;
-        uint32_t u32;
-    } uu;
-
-    // We're going to pretend for now that we only ever have one point buffer.
-    BpfCompressor compressor(m_stream,
-        data->size() * sizeof(float) * m_dims.size());
+    BpfCompressor compressor(m_stream, m_threads);
+    std::vector<char> block(data->size() * sizeof(float) * m_dims.size());
+    std::vector<uint32_t> words(data->size());
+    char *pos = block.data();
 
-    if (m_header.m_compression)
-        compressor.startBlock();
     for (auto & bpfDim : m_dims)
     {
-        for (size_t b = 0; b < sizeof(float); b++)
+        for (PointId idx = 0; idx < data->size(); ++idx)
         {
-            for (PointId idx = 0; idx < data->size(); ++idx)
-            {
-                uu.f = (float)getAdjustedValue(data, bpfDim, idx);
-                uint8_t u8 = (uint8_t)(uu.u32 >> (b * CHAR_BIT));
-                m_stream << u8;
-            }
+            float f = (float)getAdjustedValue(data, bpfDim, idx);
+            std::memcpy(&words[idx], &f, sizeof(f));
         }
+        for (size_t b = 0; b < sizeof(float); b++)
+            for (PointId idx = 0; idx < data->size(); ++idx)
+                *pos++ = (char)(uint8_t)(words[idx] >> (b * CHAR_BIT));
     }
+    writeBlock(compressor, block);
+    compressor.flush();
+}
+
+
+// Write a block of raw point data, compressing it if requested.
+void BpfWriter::writeBlock(BpfCompressor& compressor, std::vector<char>& block)
+{
     if (m_header.m_compression)
-    {
-        compressor.compress();
-        compressor.finish();
-    }
+        compressor.addBlock(block);
+    else
+        m_stream.put(block.data(), block.size());
 }
 
 
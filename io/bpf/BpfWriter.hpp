@@ -37,6 +37,7 @@
 
 #pragma once
 
+#include "BpfCompressor.hpp"
 #include "BpfHeader.hpp"
 
 #include <pdal/pdal_export.hpp>
@@ -67,6 +68,7 @@ private:
     BpfDimensionList m_dims;
     std::vector<uint8_t> m_extraData;
     std::vector<BpfUlemFile> m_bundledFiles;
+    int m_threads;
 
     virtual void processOptions(const Options& options);
     virtual void prepared(PointTableRef table);
@@ -81,7 +83,7 @@ private:
     void writePointMajor(const PointView* data);
     void writeDimMajor(const PointView* data);
     void writeByteMajor(const PointView* data);
-    void writeCompressedBlock(char *buf, size_t size);
+    void writeBlock(BpfCompressor& compressor, std::vector<char>& block);
 };
 
 } // namespace pdal
@@ -34,6 +34,7 @@
 
 #include "DerivativeWriter.hpp"
 
+#include <pdal/PDALUtils.hpp>
 #include <pdal/PointView.hpp>
 #include <pdal/util/Utils.hpp>
 #include <pdal/pdal_macros.hpp>
@@ -66,6 +67,8 @@ std::string DerivativeWriter::getName() const
 
 const double c_pi = 3.14159265358979323846; /*!< PI value */
 const float c_background = FLT_MIN;
+// Number of cells in each window of rows written to an output raster.
+const size_t c_windowCells = 4 * 1024 * 1024;
 
 DerivativeWriter::DerivativeWriter()
 {
@@ -77,6 +80,8 @@ void DerivativeWriter::processOptions(const Options& ops)
 {
     m_GRID_DIST_X = ops.getValueOrDefault<double>("grid_dist_x", 15.0);
     m_GRID_DIST_Y = ops.getValueOrDefault<double>("grid_dist_y", 15.0);
+    m_threads = ops.getValueOrDefault<int>("threads", 1);
+    Utils::checkThreads(getName(), m_threads);
     handleFilenameTemplate();
 
     // maybe we eventually introduce an option to do more than slope
@@ -174,50 +179,13 @@ Options DerivativeWriter::getDefaultOptions()
     options.add("grid_dist_x", 15.0, "X grid distance");
     options.add("grid_dist_y", 15.0, "Y grid distance");
     options.add("primitive_type", "slope_d8", "Primitive type");
+    options.add("threads", 1, "Number of threads used to compute rasters");
 
     return options;
 }
 
-double DerivativeWriter::GetNeighbor(Eigen::MatrixXd* data, int row, int col,
-    Direction d)
-{
-    double val;
-    switch (d)
-    {
-        case NORTH:
-            val = ((*data)(row-1, col));
-            break;
-        case SOUTH:
-            val = ((*data)(row+1, col));
-            break;
-        case EAST:
-            val = ((*data)(row, col+1));
-            break;
-        case WEST:
-            val = ((*data)(row, col-1));
-            break;
-        case NORTHEAST:
-            val = ((*data)(row-1, col+1));
-            break;
-        case NORTHWEST:
-            val = ((*data)(row-1, col-1));
-            break;
-        case SOUTHEAST:
-            val = ((*data)(row+1, col+1));
-            break;
-        case SOUTHWEST:
-            val = ((*data)(row+1, col-1));
-            break;
-        default:
-            val = ((*data)(row, col));
-            break;
-    }
-    return val;
-}
-
-
-double DerivativeWriter::determineSlopeFD(Eigen::MatrixXd* data, int row,
-        int col, double postSpacing, double valueToIgnore)
+double DerivativeWriter::determineSlopeFD(const Neighborhood& nb,
+    double postSpacing, double valueToIgnore)
 {
     double tSlopeVal = valueToIgnore;
     double tSlopeValDegree = valueToIgnore;
@@ -225,11 +193,11 @@ double DerivativeWriter::determineSlopeFD(Eigen::MatrixXd* data, int row,
     double mean = 0.0;
     unsigned int nvals = 0;
 
-    double val = static_cast<double>((*data)(row, col));
-    double north = GetNeighbor(data, row, col, NORTH);
-    double south = GetNeighbor(data, row, col, SOUTH);
-    double east = GetNeighbor(data, row, col, EAST);
-    double west = GetNeighbor(data, row, col, WEST);
+    double val = nb.center;
+    double north = nb.north;
+    double south = nb.south;
+    double east = nb.east;
+    double west = nb.west;
 
     auto accumulate = [&nvals, &mean, valueToIgnore](double val)
     {
@@ -266,26 +234,26 @@ double DerivativeWriter::determineSlopeFD(Eigen::MatrixXd* data, int row,
 }
 
 
-double DerivativeWriter::determineSlopeD8(Eigen::MatrixXd* data, int row,
-        int col, double postSpacing, double valueToIgnore)
+double DerivativeWriter::determineSlopeD8(const Neighborhood& nb,
+    double postSpacing, double valueToIgnore)
 {
     double tPhi1 = 1.0f;
     double tPhi2 = sqrt(2.0f);
     double tSlopeVal = valueToIgnore;
     double tSlopeValDegree = valueToIgnore;
 
-    double val = static_cast<double>((*data)(row, col));
+    double val = nb.center;
     if (val == valueToIgnore)
         return val;
 
-    double north = GetNeighbor(data, row, col, NORTH);
-    double south = GetNeighbor(data, row, col, SOUTH);
-    double east = GetNeighbor(data, row, col, EAST);
-    double west = GetNeighbor(data, row, col, WEST);
-    double northeast = GetNeighbor(data, row, col, NORTHEAST);
-    double northwest = GetNeighbor(data, row, col, NORTHWEST);
-    double southeast = GetNeighbor(data, row, col, SOUTHEAST);
-    double southwest = GetNeighbor(data, row, col, SOUTHWEST);
+    double north = nb.north;
+    double south = nb.south;
+    double east = nb.east;
+    double west = nb.west;
+    double northeast = nb.northeast;
+    double northwest = nb.northwest;
+    double southeast = nb.southeast;
+    double southwest = nb.southwest;
 
     auto checkVal = [val, &tSlopeVal, valueToIgnore, postSpacing]
         (double neighbor, double phi)
@@ -315,17 +283,17 @@ double DerivativeWriter::determineSlopeD8(Eigen::MatrixXd* data, int row,
 }
 
 
-double DerivativeWriter::determineAspectFD(Eigen::MatrixXd* data, int row,
-        int col, double postSpacing, double valueToIgnore)
+double DerivativeWriter::determineAspectFD(const Neighborhood& nb,
+    double postSpacing, double valueToIgnore)
 {
     double mean = 0.0;
     unsigned int nvals = 0;
 
-    double val = static_cast<double>((*data)(row, col));
-    double north = GetNeighbor(data, row, col, NORTH);
-    double south = GetNeighbor(data, row, col, SOUTH);
-    double east = GetNeighbor(data, row, col, EAST);
-    double west = GetNeighbor(data, row, col, WEST);
+    double val = nb.center;
+    double north = nb.north;
+    double south = nb.south;
+    double east = nb.east;
+    double west = nb.west;
 
     auto accumulate = [&nvals, &mean, valueToIgnore](double val)
     {
@@ -353,12 +321,13 @@ double DerivativeWriter::determineAspectFD(Eigen::MatrixXd* data, int row,
     double zY = (north - south) / (2 * postSpacing);
     double p = (zX * zX) + (zY * zY);
 
-    return 180.0 - std::atan(zY/zX) + 90.0 * (zX / std::fabs(zX));
+    return 180.0 - std::atan(zY / zX) * (180.0 / c_pi) +
+        90.0 * (zX / std::fabs(zX));
 }
 
 
-double DerivativeWriter::determineAspectD8(Eigen::MatrixXd* data, int row,
-        int col, double postSpacing)
+double DerivativeWriter::determineAspectD8(const Neighborhood& nb,
+    double postSpacing)
 {
     double tPhi1 = 1.0f;
     double tPhi2 = sqrt(2.0f);
@@ -368,12 +337,12 @@ double DerivativeWriter::determineAspectD8(Eigen::MatrixXd* data, int row,
 //     int tNextY, tNextX;
     unsigned int j = 0;
 
-    tVal = (*data)(row, col);
+    tVal = nb.center;
     if (tVal == std::numeric_limits<double>::max())
         return tVal;
 
     //North
-    nextTVal = GetNeighbor(data, row, col, NORTH);
+    nextTVal = nb.north;
     if (nextTVal < std::numeric_limits<double>::max())
     {
         tN = (tVal - nextTVal) / (tH * tPhi1);
@@ -384,7 +353,7 @@ double DerivativeWriter::determineAspectD8(Eigen::MatrixXd* data, int row,
         }
     }
     //South
-    nextTVal = GetNeighbor(data, row, col, SOUTH);
+    nextTVal = nb.south;
     if (nextTVal < std::numeric_limits<double>::max())
     {
         tS = (tVal - nextTVal) / (tH * tPhi1);
@@ -395,7 +364,7 @@ double DerivativeWriter::determineAspectD8(Eigen::MatrixXd* data, int row,
         }
     }
     //East
-    nextTVal = GetNeighbor(data, row, col, EAST);
+    nextTVal = nb.east;
     if (nextTVal < std::numeric_limits<double>::max())
     {
         tE = (tVal - nextTVal) / (tH * tPhi1);
@@ -406,7 +375,7 @@ double DerivativeWriter::determineAspectD8(Eigen::MatrixXd* data, int row,
         }
     }
     //West
-    nextTVal = GetNeighbor(data, row, col, WEST);
+    nextTVal = nb.west;
     if (nextTVal < std::numeric_limits<double>::max())
     {
         tW = (tVal - nextTVal) / (tH * tPhi1);
@@ -417,7 +386,7 @@ double DerivativeWriter::determineAspectD8(Eigen::MatrixXd* data, int row,
         }
     }
     //NorthEast
-    nextTVal = GetNeighbor(data, row, col, NORTHEAST);
+    nextTVal = nb.northeast;
     if (nextTVal < std::numeric_limits<double>::max())
     {
         tNE = (tVal - nextTVal) / (tH * tPhi2);
@@ -428,7 +397,7 @@ double DerivativeWriter::determineAspectD8(Eigen::MatrixXd* data, int row,
         }
     }
     //NorthWest
-    nextTVal = GetNeighbor(data, row, col, NORTHWEST);
+    nextTVal = nb.northwest;
     if (nextTVal < std::numeric_limits<double>::max())
     {
         tNW = (tVal - nextTVal) / (tH * tPhi2);
@@ -439,7 +408,7 @@ double DerivativeWriter::determineAspectD8(Eigen::MatrixXd* data, int row,
         }
     }
     //SouthEast
-    nextTVal = GetNeighbor(data, row, col, SOUTHEAST);
+    nextTVal = nb.southeast;
     if (nextTVal < std::numeric_limits<double>::max())
     {
         tSE = (tVal - nextTVal) / (tH * tPhi2);
@@ -450,7 +419,7 @@ double DerivativeWriter::determineAspectD8(Eigen::MatrixXd* data, int row,
         }
     }
     //SouthWest
-    nextTVal = GetNeighbor(data, row, col, SOUTHWEST);
+    nextTVal = nb.southwest;
     if (nextTVal < std::numeric_limits<double>::max())
     {
         tSW = (tVal - nextTVal) / (tH * tPhi2);
@@ -467,8 +436,8 @@ double DerivativeWriter::determineAspectD8(Eigen::MatrixXd* data, int row,
     return tSlopeValDegree;
 }
 
-int DerivativeWriter::determineCatchmentAreaD8(Eigen::MatrixXd* data,
-        Eigen::MatrixXd* area, int row, int col, double postSpacing)
+int DerivativeWriter::determineCatchmentAreaD8(DemMatrix* data,
+        DemMatrix* area, int row, int col, double postSpacing)
 {
     if ((*area)(row, col) > 0)
     {
@@ -695,8 +664,8 @@ int DerivativeWriter::determineCatchmentAreaD8(Eigen::MatrixXd* data,
     return 0;
 }
 
-double DerivativeWriter::determineHillshade(Eigen::MatrixXd* data, int row,
-        int col, double zenithRad, double azimuthRad, double postSpacing)
+double DerivativeWriter::determineHillshade(const Neighborhood& nb,
+    double zenithRad, double azimuthRad, double postSpacing)
 {
     //ABELL - tEVar not currently used.
     //double tAVar, tBVar, tCVar, tDVar, tEVar, tFVar, tGVar, tHVar, tIVar;
@@ -704,15 +673,15 @@ double DerivativeWriter::determineHillshade(Eigen::MatrixXd* data, int row,
     double tDZDX, tDZDY, tSlopeRad, tAspectRad = 0.0;
     double tHillShade;
 
-    tAVar = GetNeighbor(data, row, col, NORTHWEST);
-    tBVar = GetNeighbor(data, row, col, NORTH);
-    tCVar = GetNeighbor(data, row, col, NORTHWEST);
-    tDVar = GetNeighbor(data, row, col, WEST);
-    //tEVar = (double)(*data)(row, col);
-    tFVar = GetNeighbor(data, row, col, EAST);
-    tGVar = GetNeighbor(data, row, col, SOUTHWEST);
-    tHVar = GetNeighbor(data, row, col, SOUTH);
-    tIVar = GetNeighbor(data, row, col, SOUTHEAST);
+    tAVar = nb.northwest;
+    tBVar = nb.north;
+    tCVar = nb.northeast;
+    tDVar = nb.west;
+    //tEVar = nb.center;
+    tFVar = nb.east;
+    tGVar = nb.southwest;
+    tHVar = nb.south;
+    tIVar = nb.southeast;
 
     tDZDX = ((tCVar + 2 * tFVar + tIVar) - (tAVar + 2 * tDVar + tGVar)) /
             (8 * postSpacing);
@@ -753,21 +722,21 @@ double DerivativeWriter::determineHillshade(Eigen::MatrixXd* data, int row,
 }
 
 
-double DerivativeWriter::determineContourCurvature(Eigen::MatrixXd* data,
-        int row, int col, double postSpacing, double valueToIgnore)
+double DerivativeWriter::determineContourCurvature(const Neighborhood& nb,
+    double postSpacing, double valueToIgnore)
 {
     double mean = 0.0;
     unsigned int nvals = 0;
 
-    double value = static_cast<double>((*data)(row, col));
-    double north = GetNeighbor(data, row, col, NORTH);
-    double south = GetNeighbor(data, row, col, SOUTH);
-    double east = GetNeighbor(data, row, col, EAST);
-    double west = GetNeighbor(data, row, col, WEST);
-    double northeast = GetNeighbor(data, row, col, NORTHEAST);
-    double northwest = GetNeighbor(data, row, col, NORTHWEST);
-    double southeast = GetNeighbor(data, row, col, SOUTHEAST);
-    double southwest = GetNeighbor(data, row, col, SOUTHWEST);
+    double value = nb.center;
+    double north = nb.north;
+    double south = nb.south;
+    double east = nb.east;
+    double west = nb.west;
+    double northeast = nb.northeast;
+    double northwest = nb.northwest;
+    double southeast = nb.southeast;
+    double southwest = nb.southwest;
 
     auto accumulate = [&nvals, &mean, valueToIgnore](double val)
     {
@@ -812,21 +781,21 @@ double DerivativeWriter::determineContourCurvature(Eigen::MatrixXd* data,
 }
 
 
-double DerivativeWriter::determineProfileCurvature(Eigen::MatrixXd* data,
-        int row, int col, double postSpacing, double valueToIgnore)
+double DerivativeWriter::determineProfileCurvature(const Neighborhood& nb,
+    double postSpacing, double valueToIgnore)
 {
     double mean = 0.0;
     unsigned int nvals = 0;
 
-    double value = static_cast<double>((*data)(row, col));
-    double north = GetNeighbor(data, row, col, NORTH);
-    double south = GetNeighbor(data, row, col, SOUTH);
-    double east = GetNeighbor(data, row, col, EAST);
-    double west = GetNeighbor(data, row, col, WEST);
-    double northeast = GetNeighbor(data, row, col, NORTHEAST);
-    double northwest = GetNeighbor(data, row, col, NORTHWEST);
-    double southeast = GetNeighbor(data, row, col, SOUTHEAST);
-    double southwest = GetNeighbor(data, row, col, SOUTHWEST);
+    double value = nb.center;
+    double north = nb.north;
+    double south = nb.south;
+    double east = nb.east;
+    double west = nb.west;
+    double northeast = nb.northeast;
+    double northwest = nb.northwest;
+    double southeast = nb.southeast;
+    double southwest = nb.southwest;
 
     auto accumulate = [&nvals, &mean, valueToIgnore](double val)
     {
@@ -871,21 +840,21 @@ double DerivativeWriter::determineProfileCurvature(Eigen::MatrixXd* data,
 }
 
 
-double DerivativeWriter::determineTangentialCurvature(Eigen::MatrixXd* data,
-        int row, int col, double postSpacing, double valueToIgnore)
+double DerivativeWriter::determineTangentialCurvature(const Neighborhood& nb,
+    double postSpacing, double valueToIgnore)
 {
     double mean = 0.0;
     unsigned int nvals = 0;
 
-    double value = static_cast<double>((*data)(row, col));
-    double north = GetNeighbor(data, row, col, NORTH);
-    double south = GetNeighbor(data, row, col, SOUTH);
-    double east = GetNeighbor(data, row, col, EAST);
-    double west = GetNeighbor(data, row, col, WEST);
-    double northeast = GetNeighbor(data, row, col, NORTHEAST);
-    double northwest = GetNeighbor(data, row, col, NORTHWEST);
-    double southeast = GetNeighbor(data, row, col, SOUTHEAST);
-    double southwest = GetNeighbor(data, row, col, SOUTHWEST);
+    double value = nb.center;
+    double north = nb.north;
+    double south = nb.south;
+    double east = nb.east;
+    double west = nb.west;
+    double northeast = nb.northeast;
+    double northwest = nb.northwest;
+    double southeast = nb.southeast;
+    double southwest = nb.southwest;
 
     auto accumulate = [&nvals, &mean, valueToIgnore](double val)
     {
@@ -930,21 +899,21 @@ double DerivativeWriter::determineTangentialCurvature(Eigen::MatrixXd* data,
 }
 
 
-double DerivativeWriter::determineTotalCurvature(Eigen::MatrixXd* data, int row,
-        int col, double postSpacing, double valueToIgnore)
+double DerivativeWriter::determineTotalCurvature(const Neighborhood& nb,
+    double postSpacing, double valueToIgnore)
 {
     double mean = 0.0;
     unsigned int nvals = 0;
 
-    double value = static_cast<double>((*data)(row, col));
-    double north = GetNeighbor(data, row, col, NORTH);
-    double south = GetNeighbor(data, row, col, SOUTH);
-    double east = GetNeighbor(data, row, col, EAST);
-    double west = GetNeighbor(data, row, col, WEST);
-    double northeast = GetNeighbor(data, row, col, NORTHEAST);
-    double northwest = GetNeighbor(data, row, col, NORTHWEST);
-    double southeast = GetNeighbor(data, row, col, SOUTHEAST);
-    double southwest = GetNeighbor(data, row, col, SOUTHWEST);
+    double value = nb.center;
+    double north = nb.north;
+    double south = nb.south;
+    double east = nb.east;
+    double west = nb.west;
+    double northeast = nb.northeast;
+    double northwest = nb.northwest;
+    double southeast = nb.southeast;
+    double southwest = nb.southwest;
 
     auto accumulate = [&nvals, &mean, valueToIgnore](double val)
     {
@@ -1033,261 +1002,116 @@ GDALDataset* DerivativeWriter::createFloat32GTIFF(std::string filename,
 }
 
 
-void DerivativeWriter::writeSlope(Eigen::MatrixXd* tDemData,
-        const PointViewPtr data, PrimitiveType method,
-        const std::string& filename)
+template<typename CellFunc>
+void DerivativeWriter::writeRaster(const std::string& filename, float border,
+    CellFunc cellFunc)
 {
-    BOX2D& extent = getBounds();
-
-    // use the max grid size as the post spacing
-    double tPostSpacing = std::max(m_GRID_DIST_X, m_GRID_DIST_Y);
-
     GDALDataset *mpDstDS;
     mpDstDS = createFloat32GTIFF(filename, m_GRID_SIZE_X, m_GRID_SIZE_Y);
 
     // if we have a valid file
-    if (mpDstDS)
-    {
-        // loop over the raster and determine max slope at each location
-        int tXStart = 1, tXEnd = m_GRID_SIZE_X - 1;
-        int tYStart = 1, tYEnd = m_GRID_SIZE_Y - 1;
-        float *poRasterData = new float[m_GRID_SIZE_X*m_GRID_SIZE_Y];
-        for (uint32_t i=0; i<m_GRID_SIZE_X*m_GRID_SIZE_Y; i++)
-        {
-            poRasterData[i] = c_background;
-        }
-
-        #pragma omp parallel for
-        for (int tXOut = tXStart; tXOut < tXEnd; tXOut++)
-        {
-            int tXIn = tXOut;
-            for (int tYOut = tYStart; tYOut < tYEnd; tYOut++)
-            {
-                int tYIn = tYOut;
+    if (!mpDstDS)
+        return;
 
-                float tSlopeValDegree(0);
+    GDALRasterBand *tBand = mpDstDS->GetRasterBand(1);
+    tBand->SetNoDataValue((double)c_background);
 
-                //Compute Slope Value
-                switch (method)
-                {
-                    case SLOPE_D8:
-                        tSlopeValDegree = (float)determineSlopeD8(tDemData,
-                                          tYOut, tXOut, tPostSpacing,
-                                          c_background);
-                        break;
-
-                    case SLOPE_FD:
-                        tSlopeValDegree = (double)determineSlopeFD(tDemData,
-                                          tYOut, tXOut, tPostSpacing,
-                                          c_background);
-                        break;
-                    default:
-                        assert(false);
-                        return;
-                }
+    // The raster is computed and written a window of rows at a time so that
+    // the output never needs to be held in memory.
+    const int cols = m_GRID_SIZE_X;
+    const int rows = m_GRID_SIZE_Y;
+    const int windowRows = (std::max)(1, (std::min)(rows,
+        (int)(c_windowCells / (std::max)(cols, 1))));
+    std::vector<float> window((size_t)windowRows * cols);
 
-                poRasterData[(tYIn * m_GRID_SIZE_X) + tXIn] =
-                    std::tan(tSlopeValDegree*c_pi/180.0)*100.0;
-            }
-        }
+    for (int top = 0; top < rows; top += windowRows)
+    {
+        int numRows = (std::min)(windowRows, rows - top);
 
-        // write the data
-        if (poRasterData)
+        auto computeRows = [&](int begin, int end)
         {
-            GDALRasterBand *tBand = mpDstDS->GetRasterBand(1);
-
-            tBand->SetNoDataValue((double)c_background);
+            for (int row = begin; row < end; ++row)
+            {
+                float *out = window.data() + (size_t)(row - top) * cols;
+                bool edge = (row == 0 || row == rows - 1);
+                for (int col = 0; col < cols; ++col)
+                    out[col] = (edge || col == 0 || col == cols - 1) ?
+                        border : cellFunc(row, col);
+            }
+        };
+        runRows(top, top + numRows, computeRows);
 
-            if (m_GRID_SIZE_X > 0 && m_GRID_SIZE_Y > 0)
-// #define STR_HELPER(x) #x
-// #define STR(x) STR_HELPER(x)
-//
-// #pragma message "content of GDAL_VERSION_MAJOR:" STR(GDAL_VERSION_MAJOR)
 #if GDAL_VERSION_MAJOR <= 1
-                tBand->RasterIO(GF_Write, 0, 0, m_GRID_SIZE_X, m_GRID_SIZE_Y,
-                                poRasterData, m_GRID_SIZE_X, m_GRID_SIZE_Y,
-                                GDT_Float32, 0, 0);
+        tBand->RasterIO(GF_Write, 0, top, cols, numRows, window.data(),
+            cols, numRows, GDT_Float32, 0, 0);
 #else
-
-                int ret = tBand->RasterIO(GF_Write, 0, 0, m_GRID_SIZE_X, m_GRID_SIZE_Y,
-                                          poRasterData, m_GRID_SIZE_X, m_GRID_SIZE_Y,
-                                          GDT_Float32, 0, 0, 0);
+        tBand->RasterIO(GF_Write, 0, top, cols, numRows, window.data(),
+            cols, numRows, GDT_Float32, 0, 0, 0);
 #endif
-        }
-
-        GDALClose((GDALDatasetH) mpDstDS);
-
-        delete [] poRasterData;
     }
+
+    GDALClose((GDALDatasetH) mpDstDS);
 }
 
 
-void DerivativeWriter::writeAspect(Eigen::MatrixXd* tDemData,
-    const PointViewPtr data, PrimitiveType method, const std::string& filename)
+void DerivativeWriter::runRows(int begin, int end,
+    std::function<void(int, int)> func)
 {
-    BOX2D& extent = getBounds();
-
-    // use the max grid size as the post spacing
-    double tPostSpacing = std::max(m_GRID_DIST_X, m_GRID_DIST_Y);
+    int numRows = end - begin;
+    int numThreads = (std::max)(1, (std::min)(m_threads, numRows));
+    int rowsPerThread = (numRows + numThreads - 1) / numThreads;
+    int numBands = (numRows + rowsPerThread - 1) / rowsPerThread;
 
-    GDALDataset *mpDstDS;
-    mpDstDS = createFloat32GTIFF(filename, m_GRID_SIZE_X, m_GRID_SIZE_Y);
-
-    // if we have a valid file
-    if (mpDstDS)
+    Utils::parallelFor(numBands, numBands, [&](size_t band)
     {
-        // loop over the raster and determine max slope at each location
-        int tXStart = 1, tXEnd = m_GRID_SIZE_X - 1;
-        int tYStart = 1, tYEnd = m_GRID_SIZE_Y - 1;
-        float *poRasterData = new float[m_GRID_SIZE_X*m_GRID_SIZE_Y];
-        for (uint32_t i=0; i<m_GRID_SIZE_X*m_GRID_SIZE_Y; i++)
-        {
-            poRasterData[i] = 0;    // Initialize all elements to zero.
-        }
-
-        #pragma omp parallel for
-        for (int tXOut = tXStart; tXOut < tXEnd; tXOut++)
-        {
-            int tXIn = tXOut;
-            for (int tYOut = tYStart; tYOut < tYEnd; tYOut++)
-            {
-                int tYIn = tYOut;
-
-                float tSlopeValDegree(0);
-
-                //Compute Aspect Value
-                switch (method)
-                {
-                    case ASPECT_D8:
-                        tSlopeValDegree = (float)determineAspectD8(tDemData,
-                                          tYOut, tXOut, tPostSpacing);
-                        break;
-                    case ASPECT_FD:
-                        tSlopeValDegree = (float)determineAspectFD(tDemData,
-                                tYOut, tXOut, tPostSpacing, c_background);
-                        break;
-                    default:
-                        assert(false);
-                        return;
-                }
-
-                if (tSlopeValDegree == std::numeric_limits<double>::max())
-                    poRasterData[(tYIn * m_GRID_SIZE_X) + tXIn] = c_background;
-                else
-                    poRasterData[(tYIn * m_GRID_SIZE_X) + tXIn] =
-                        tSlopeValDegree;
-            }
-        }
-
-        // write the data
-        if (poRasterData)
-        {
-            GDALRasterBand *tBand = mpDstDS->GetRasterBand(1);
-
-            tBand->SetNoDataValue((double)c_background);
-
-            if (m_GRID_SIZE_X > 0 && m_GRID_SIZE_Y > 0)
-#if GDAL_VERSION_MAJOR <= 1
-                tBand->RasterIO(GF_Write, 0, 0, m_GRID_SIZE_X, m_GRID_SIZE_Y,
-                                poRasterData, m_GRID_SIZE_X, m_GRID_SIZE_Y,
-                                GDT_Float32, 0, 0);
-#else
-                int ret = tBand->RasterIO(GF_Write, 0, 0, m_GRID_SIZE_X, m_GRID_SIZE_Y,
-                                          poRasterData, m_GRID_SIZE_X, m_GRID_SIZE_Y,
-                                          GDT_Float32, 0, 0, 0);
-#endif
-        }
-
-        GDALClose((GDALDatasetH) mpDstDS);
-
-        delete [] poRasterData;
-    }
+        int first = begin + (int)band * rowsPerThread;
+        func(first, (std::min)(first + rowsPerThread, end));
+    });
 }
 
 
-void DerivativeWriter::writeCatchmentArea(Eigen::MatrixXd* tDemData,
+void DerivativeWriter::writeCatchmentArea(DemMatrix* tDemData,
         const PointViewPtr data, const std::string& filename)
 {
-    Eigen::MatrixXd area(m_GRID_SIZE_Y, m_GRID_SIZE_X);
+    DemMatrix area(m_GRID_SIZE_Y, m_GRID_SIZE_X);
     area.setZero();
 
-    BOX2D& extent = getBounds();
-
     // use the max grid size as the post spacing
     double tPostSpacing = std::max(m_GRID_DIST_X, m_GRID_DIST_Y);
 
-    GDALDataset *mpDstDS;
-    mpDstDS = createFloat32GTIFF(filename, m_GRID_SIZE_X, m_GRID_SIZE_Y);
-
-    // if we have a valid file
-    if (mpDstDS)
-    {
-        // loop over the raster and determine max slope at each location
-        int tXStart = 1, tXEnd = m_GRID_SIZE_X - 1;
-        int tYStart = 1, tYEnd = m_GRID_SIZE_Y - 1;
-        float *poRasterData = new float[m_GRID_SIZE_X*m_GRID_SIZE_Y];
-        for (uint32_t i=0; i<m_GRID_SIZE_X*m_GRID_SIZE_Y; i++)
-        {
-            poRasterData[i] = c_background;    // Initialize all elements to zero.
-        }
-
-
-        int tXOut = tXStart;
-        int tYOut = tYStart;
-        //for (int tXOut = tXStart; tXOut < tXEnd; tXOut++)
-        //{
-        //    for (int tYOut = tYStart; tYOut < tYEnd; tYOut++)
-        //    {
-        //Compute Aspect Value
-        //switch (method)
-        //{
-        //case AD8:
-        //tSlopeValDegree = (float)determineAspectD8(tDemData, tYOut, tXOut, tPostSpacing);
-        //break;
-        //
-        //case SFD:
-        //  tSlopeValDegree = (float)determineAspectFD(tDemData, tYOut, tXOut, tPostSpacing, c_background);
-        //break;
-        //}
-        area(tYOut, tXOut) = determineCatchmentAreaD8(tDemData, &area, tYOut,
-                             tXOut, tPostSpacing);
-        //    }
-        // }
-
-        #pragma omp parallel for
-        for (int tXOut = tXStart; tXOut < tXEnd; tXOut++)
-        {
-            for (int tYOut = tYStart; tYOut < tYEnd; tYOut++)
-            {
-                poRasterData[(tYOut * m_GRID_SIZE_X) + tXOut] = area(tYOut, tXOut);
-            }
-        }
-
-        //stretchData(poRasterData);
-
-        // write the data
-        if (poRasterData)
-        {
-            GDALRasterBand *tBand = mpDstDS->GetRasterBand(1);
+    if (m_GRID_SIZE_X < 3 || m_GRID_SIZE_Y < 3)
+        return;
 
-            tBand->SetNoDataValue((double)c_background);
+    int tXOut = 1;
+    int tYOut = 1;
+    //for (int tXOut = tXStart; tXOut < tXEnd; tXOut++)
+    //{
+    //    for (int tYOut = tYStart; tYOut < tYEnd; tYOut++)
+    //    {
+    //Compute Aspect Value
+    //switch (method)
+    //{
+    //case AD8:
+    //tSlopeValDegree = (float)determineAspectD8(tDemData, tYOut, tXOut, tPostSpacing);
+    //break;
+    //
+    //case SFD:
+    //  tSlopeValDegree = (float)determineAspectFD(tDemData, tYOut, tXOut, tPostSpacing, c_background);
+    //break;
+    //}
+    area(tYOut, tXOut) = determineCatchmentAreaD8(tDemData, &area, tYOut,
+                         tXOut, tPostSpacing);
+    //    }
+    // }
 
-            if (m_GRID_SIZE_X > 0 && m_GRID_SIZE_Y > 0)
-#if GDAL_VERSION_MAJOR <= 1
-                tBand->RasterIO(GF_Write, 0, 0, m_GRID_SIZE_X, m_GRID_SIZE_Y,
-                                poRasterData, m_GRID_SIZE_X, m_GRID_SIZE_Y,
-                                GDT_Float32, 0, 0);
-#else
-                int ret = tBand->RasterIO(GF_Write, 0, 0, m_GRID_SIZE_X, m_GRID_SIZE_Y,
-                                          poRasterData, m_GRID_SIZE_X, m_GRID_SIZE_Y,
-                                          GDT_Float32, 0, 0, 0);
-#endif
-        }
+    //stretchData(poRasterData);
 
-        GDALClose((GDALDatasetH) mpDstDS);
+    auto catchment = [&area](int row, int col) -> float
+    {
+        return area(row, col);
+    };
 
-        delete [] poRasterData;
-    }
+    writeRaster(filename, c_background, catchment);
 }
 
 // void DerivativeWriter::stretchData(float *data)
@@ -1354,188 +1178,169 @@ void DerivativeWriter::writeCatchmentArea(Eigen::MatrixXd* tDemData,
 // }
 
 
-void DerivativeWriter::writeHillshade(Eigen::MatrixXd* tDemData,
-    const PointViewPtr data, const std::string& filename)
+float DerivativeWriter::computePrimitive(PrimitiveType type,
+    const Neighborhood& nb)
 {
-    BOX2D& extent = getBounds();
-
-    // use the max grid size as the post spacing
-    double tPostSpacing = std::max(m_GRID_DIST_X, m_GRID_DIST_Y);
+    float val(0);
 
-    GDALDataset *mpDstDS;
-    mpDstDS = createFloat32GTIFF(filename, m_GRID_SIZE_X, m_GRID_SIZE_Y);
-
-    // if we have a valid file
-    if (mpDstDS)
+    switch (type)
     {
-        // loop over the raster and determine max slope at each location
-        int tXStart = 1, tXEnd = m_GRID_SIZE_X - 1;
-        int tYStart = 1, tYEnd = m_GRID_SIZE_Y - 1;
-        float *poRasterData = new float[m_GRID_SIZE_X*m_GRID_SIZE_Y];
-        for (uint32_t i=0; i<m_GRID_SIZE_X*m_GRID_SIZE_Y; i++)
-        {
-            poRasterData[i] = 0;    // Initialize all elements to zero.
-        }
-
-        // Parameters for hill shade
-        double illumAltitudeDegree = 45.0;
-        double illumAzimuthDegree = 315.0;
-        double tZenithRad = (90 - illumAltitudeDegree) * (c_pi / 180.0);
-        double tAzimuthMath = 360.0 - illumAzimuthDegree + 90;
-
-        if (tAzimuthMath >= 360.0)
+        case SLOPE_D8:
+        case SLOPE_FD:
         {
-            tAzimuthMath = tAzimuthMath - 360.0;
+            float tSlopeValDegree = (type == SLOPE_D8) ?
+                (float)determineSlopeD8(nb, m_postSpacing, c_background) :
+                (float)determineSlopeFD(nb, m_postSpacing, c_background);
+            val = std::tan(tSlopeValDegree*c_pi/180.0)*100.0;
+            break;
         }
-
-        double tAzimuthRad = tAzimuthMath * (c_pi / 180.0);
-
-        double min_val = std::numeric_limits<double>::max();
-        double max_val = -std::numeric_limits<double>::max();
-
-        #pragma omp parallel for
-        for (int tXOut = tXStart; tXOut < tXEnd; tXOut++)
+        case ASPECT_D8:
+        case ASPECT_FD:
         {
-            for (int tYOut = tYStart; tYOut < tYEnd; tYOut++)
-            {
-                //Compute Slope Value
-                float tSlopeValDegree = (float)determineHillshade(tDemData,
-                                        tYOut, tXOut, tZenithRad, tAzimuthRad,
-                                        tPostSpacing);
-
-                if (tSlopeValDegree == std::numeric_limits<double>::max())
-                    poRasterData[(tYOut * m_GRID_SIZE_X) + tXOut] = c_background;
-                else
-                    poRasterData[(tYOut * m_GRID_SIZE_X) + tXOut] = tSlopeValDegree;
-
-                if (tSlopeValDegree < min_val) min_val = tSlopeValDegree;
-                if (tSlopeValDegree > max_val) max_val = tSlopeValDegree;
-            }
+            float tSlopeValDegree = (type == ASPECT_D8) ?
+                (float)determineAspectD8(nb, m_postSpacing) :
+                (float)determineAspectFD(nb, m_postSpacing, c_background);
+            val = (tSlopeValDegree == std::numeric_limits<double>::max()) ?
+                c_background : tSlopeValDegree;
+            break;
         }
-
-        // stretchData(poRasterData);
-
-        // write the data
-        if (poRasterData)
+        case HILLSHADE:
         {
-            GDALRasterBand *tBand = mpDstDS->GetRasterBand(1);
-
-            tBand->SetNoDataValue((double)c_background);
-
-            if (m_GRID_SIZE_X > 0 && m_GRID_SIZE_Y > 0)
-#if GDAL_VERSION_MAJOR <= 1
-                tBand->RasterIO(GF_Write, 0, 0, m_GRID_SIZE_X, m_GRID_SIZE_Y,
-                                poRasterData, m_GRID_SIZE_X, m_GRID_SIZE_Y,
-                                GDT_Float32, 0, 0);
-#else
-
-                int ret = tBand->RasterIO(GF_Write, 0, 0, m_GRID_SIZE_X, m_GRID_SIZE_Y,
-                                          poRasterData, m_GRID_SIZE_X, m_GRID_SIZE_Y,
-                                          GDT_Float32, 0, 0, 0);
-#endif
+            float tSlopeValDegree = (float)determineHillshade(nb,
+                m_zenithRad, m_azimuthRad, m_postSpacing);
+            val = (tSlopeValDegree == std::numeric_limits<double>::max()) ?
+                c_background : tSlopeValDegree;
+            break;
         }
-
-        GDALClose((GDALDatasetH) mpDstDS);
-
-        delete [] poRasterData;
+        case CONTOUR_CURVATURE:
+            val = static_cast<float>(determineContourCurvature(nb,
+                m_postSpacing, c_background));
+            break;
+        case PROFILE_CURVATURE:
+            val = static_cast<float>(determineProfileCurvature(nb,
+                m_postSpacing, c_background));
+            break;
+        case TANGENTIAL_CURVATURE:
+            val = static_cast<float>(determineTangentialCurvature(nb,
+                m_postSpacing, c_background));
+            break;
+        case TOTAL_CURVATURE:
+            val = static_cast<float>(determineTotalCurvature(nb,
+                m_postSpacing, c_background));
+            break;
+        default:
+            assert(false);
+            break;
     }
+    return val;
 }
 
 
-void DerivativeWriter::writeCurvature(Eigen::MatrixXd* tDemData,
-    const PointViewPtr data, PrimitiveType curveType, double valueToIgnore,
-    const std::string& filename)
+void DerivativeWriter::writeStencilPrimitives(DemMatrix& dem,
+    const std::vector<TypeOutput>& outputs)
 {
-    BOX2D& extent = getBounds();
-
-    // use the max grid size as the post spacing
-    double tPostSpacing = std::max(m_GRID_DIST_X, m_GRID_DIST_Y);
-
-    GDALDataset *mpDstDS;
-    mpDstDS = createFloat32GTIFF(filename, m_GRID_SIZE_X, m_GRID_SIZE_Y);
-
-    // if we have a valid file
-    if (!mpDstDS)
-        return;
+    struct Output
+    {
+        PrimitiveType m_type;
+        float m_border;
+        GDALDataset *m_dataset;
+        std::vector<float> m_window;
+    };
 
-    // loop over the raster and determine max slope at each location
-    int tXStart = 1, tXEnd = m_GRID_SIZE_X - 1;
-    int tYStart = 1, tYEnd = m_GRID_SIZE_Y - 1;
-    std::vector<float> poRasterData(m_GRID_SIZE_X * m_GRID_SIZE_Y);
-    for (uint32_t i=0; i<m_GRID_SIZE_X*m_GRID_SIZE_Y; i++)
+    std::vector<Output> rasters;
+    for (const TypeOutput& to : outputs)
     {
-        poRasterData[i] = c_background;
+        GDALDataset *dataset =
+            createFloat32GTIFF(to.m_filename, m_GRID_SIZE_X, m_GRID_SIZE_Y);
+        // if we have a valid file
+        if (!dataset)
+            continue;
+        dataset->GetRasterBand(1)->SetNoDataValue((double)c_background);
+
+        Output out;
+        out.m_type = to.m_type;
+        // Edges of aspect and hillshade rasters are set to zero.
+        out.m_border = (to.m_type == ASPECT_D8 || to.m_type == ASPECT_FD ||
+            to.m_type == HILLSHADE) ? 0 : c_background;
+        out.m_dataset = dataset;
+        rasters.push_back(out);
     }
+    if (rasters.empty())
+        return;
 
-#pragma omp parallel for
-    for (int tXOut = tXStart; tXOut < tXEnd; tXOut++)
+    // All the primitives are computed in a single sweep of the DEM.  Each
+    // cell's neighborhood is loaded once and used for every primitive.
+    // Each window of rows is split among the threads and then written to
+    // every raster.
+    const int cols = m_GRID_SIZE_X;
+    const int rows = m_GRID_SIZE_Y;
+    const int windowRows = (std::max)(1, (std::min)(rows,
+        (int)(c_windowCells / rasters.size() / (std::max)(cols, 1))));
+    for (Output& out : rasters)
+        out.m_window.resize((size_t)windowRows * cols);
+
+    for (int top = 0; top < rows; top += windowRows)
     {
-        int tXIn = tXOut;
-        for (int tYOut = tYStart; tYOut < tYEnd; tYOut++)
-        {
-            int tYIn = tYOut;
+        int numRows = (std::min)(windowRows, rows - top);
 
-            double curve(0);
-
-            //Compute Slope Value
-            switch (curveType)
+        auto computeRows = [&](int begin, int end)
+        {
+            Neighborhood nb;
+            for (int row = begin; row < end; ++row)
             {
-                case CONTOUR_CURVATURE:
-                    curve = determineContourCurvature(tDemData,
-                            tYOut, tXOut,
-                            tPostSpacing,
-                            c_background);
-                    break;
-
-                case PROFILE_CURVATURE:
-                    curve = determineProfileCurvature(tDemData,
-                            tYOut, tXOut,
-                            tPostSpacing,
-                            c_background);
-                    break;
+                size_t offset = (size_t)(row - top) * cols;
+                if (row == 0 || row == rows - 1)
+                {
+                    for (Output& out : rasters)
+                        std::fill(out.m_window.begin() + offset,
+                            out.m_window.begin() + offset + cols,
+                            out.m_border);
+                    continue;
+                }
 
-                case TANGENTIAL_CURVATURE:
-                    curve = determineTangentialCurvature(tDemData,
-                            tYOut, tXOut,
-                            tPostSpacing,
-                            c_background);
-                    break;
+                for (Output& out : rasters)
+                {
+                    out.m_window[offset] = out.m_border;
+                    out.m_window[offset + cols - 1] = out.m_border;
+                }
 
-                case TOTAL_CURVATURE:
-                    curve = determineTotalCurvature(tDemData,
-                            tYOut, tXOut,
-                            tPostSpacing,
-                            c_background);
-                    break;
-                default:
-                    assert(false);
-                    return;
+                const double *up = dem.data() + (size_t)(row - 1) * cols;
+                const double *cur = up + cols;
+                const double *down = cur + cols;
+                for (int col = 1; col < cols - 1; ++col)
+                {
+                    nb.northwest = up[col - 1];
+                    nb.north = up[col];
+                    nb.northeast = up[col + 1];
+                    nb.west = cur[col - 1];
+                    nb.center = cur[col];
+                    nb.east = cur[col + 1];
+                    nb.southwest = down[col - 1];
+                    nb.south = down[col];
+                    nb.southeast = down[col + 1];
+                    for (Output& out : rasters)
+                        out.m_window[offset + col] =
+                            computePrimitive(out.m_type, nb);
+                }
             }
+        };
+        runRows(top, top + numRows, computeRows);
 
-            poRasterData[(tYOut * m_GRID_SIZE_X) + tXOut] =
-                static_cast<float>(curve);
-        }
-    }
-
-    //stretchData(poRasterData);
-
-    // write the data
-    GDALRasterBand *tBand = mpDstDS->GetRasterBand(1);
-
-    tBand->SetNoDataValue((double)c_background);
-
-    int ret;
-    if (m_GRID_SIZE_X > 0 && m_GRID_SIZE_Y > 0)
+        for (Output& out : rasters)
+        {
+            GDALRasterBand *tBand = out.m_dataset->GetRasterBand(1);
 #if GDAL_VERSION_MAJOR <= 1
-        ret = tBand->RasterIO(GF_Write, 0, 0, m_GRID_SIZE_X, m_GRID_SIZE_Y,
-                poRasterData.data(), m_GRID_SIZE_X, m_GRID_SIZE_Y,
-                GDT_Float32, 0, 0);
+            tBand->RasterIO(GF_Write, 0, top, cols, numRows,
+                out.m_window.data(), cols, numRows, GDT_Float32, 0, 0);
 #else
-        ret = tBand->RasterIO(GF_Write, 0, 0, m_GRID_SIZE_X, m_GRID_SIZE_Y,
-            poRasterData.data(), m_GRID_SIZE_X, m_GRID_SIZE_Y,
-            GDT_Float32, 0, 0, 0);
+            tBand->RasterIO(GF_Write, 0, top, cols, numRows,
+                out.m_window.data(), cols, numRows, GDT_Float32, 0, 0, 0);
 #endif
-    GDALClose((GDALDatasetH) mpDstDS);
+        }
+    }
+
+    for (Output& out : rasters)
+        GDALClose((GDALDatasetH) out.m_dataset);
 }
 
 
@@ -1562,162 +1367,186 @@ void DerivativeWriter::write(const PointViewPtr data)
     double yMax = extent.miny + m_GRID_SIZE_Y * m_GRID_DIST_Y;
     log()->get(LogLevel::Debug4) << yMax << ", " << extent.maxy << std::endl;
 
-    // need to create the min DEM
-    Eigen::MatrixXd tDemData(m_GRID_SIZE_Y, m_GRID_SIZE_X);
-    tDemData.setConstant(c_background);
-    for (PointId idx = 0; idx < data->size(); ++idx)
+    // need to create the min DEM.  It's held in memory in full, eight bytes
+    // per cell; only the output rasters are windowed.
+    DemMatrix tDemData(m_GRID_SIZE_Y, m_GRID_SIZE_X);
+    binPoints(*data, tDemData);
+    fillGaps(tDemData);
+
+    // use the max grid size as the post spacing
+    m_postSpacing = std::max(m_GRID_DIST_X, m_GRID_DIST_Y);
+
+    // Parameters for hill shade
+    double illumAltitudeDegree = 45.0;
+    double illumAzimuthDegree = 315.0;
+    m_zenithRad = (90 - illumAltitudeDegree) * (c_pi / 180.0);
+    double tAzimuthMath = 360.0 - illumAzimuthDegree + 90;
+    if (tAzimuthMath >= 360.0)
+        tAzimuthMath = tAzimuthMath - 360.0;
+    m_azimuthRad = tAzimuthMath * (c_pi / 180.0);
+
+    std::vector<TypeOutput> stencilOutputs;
+    for (TypeOutput& to : m_primitiveTypes)
     {
-        double x = data->getFieldAs<double>(Dimension::Id::X, idx);
-        double y = data->getFieldAs<double>(Dimension::Id::Y, idx);
-        double z = data->getFieldAs<double>(Dimension::Id::Z, idx);
+        if (to.m_type == CATCHMENT_AREA)
+            writeCatchmentArea(&tDemData, data, to.m_filename);
+        else
+            stencilOutputs.push_back(to);
+    }
+    writeStencilPrimitives(tDemData, stencilOutputs);
+}
 
-        auto clamp = [](double t, double min, double max)
+void DerivativeWriter::binPoints(const PointView& view, DemMatrix& dem)
+{
+    BOX2D& extent = getBounds();
+    double yMax = extent.miny + m_GRID_SIZE_Y * m_GRID_DIST_Y;
+
+    const int sizeX = m_GRID_SIZE_X;
+    const int sizeY = m_GRID_SIZE_Y;
+
+    auto binRange = [&](DemMatrix& grid, PointId begin, PointId end)
+    {
+        auto clamp = [](int t, int min, int max)
         {
             return ((t < min) ? min : ((t > max) ? max : t));
         };
 
-        int xIndex = clamp(static_cast<int>(floor((x - extent.minx) / m_GRID_DIST_X)), 0, m_GRID_SIZE_X-1);
-        int yIndex = clamp(static_cast<int>(floor((yMax - y) / m_GRID_DIST_Y)), 0, m_GRID_SIZE_Y-1);
-
-        double tDemValue = tDemData(yIndex, xIndex);
-
-        if (tDemValue == c_background)
+        grid.setConstant(c_background);
+        for (PointId idx = begin; idx < end; ++idx)
         {
-            tDemData(yIndex, xIndex) = z;
-        }
-        else
-        {
-            if (z > tDemValue)
-                tDemData(yIndex, xIndex) = z;
+            double x = view.getFieldAs<double>(Dimension::Id::X, idx);
+            double y = view.getFieldAs<double>(Dimension::Id::Y, idx);
+            double z = view.getFieldAs<double>(Dimension::Id::Z, idx);
+
+            int xIndex = clamp(static_cast<int>(
+                floor((x - extent.minx) / m_GRID_DIST_X)), 0, sizeX - 1);
+            int yIndex = clamp(static_cast<int>(
+                floor((yMax - y) / m_GRID_DIST_Y)), 0, sizeY - 1);
+
+            double& tDemValue = grid(yIndex, xIndex);
+            if (tDemValue == c_background || z > tDemValue)
+                tDemValue = z;
         }
+    };
+
+    const point_count_t count = view.size();
+    const int numThreads = (int)(std::min)((point_count_t)m_threads, count);
+    if (numThreads <= 1)
+    {
+        binRange(dem, 0, count);
+        return;
     }
 
-    auto CleanRasterScanLine = [](Eigen::MatrixXd data, Eigen::VectorXd datarow,
-                                  int mDim, int row, bool* prevSetCols,
-                                  bool* curSetCols)
+    // Each thread bins its share of the points into its own grid.  The
+    // partial grids are then merged into the DEM a band of rows per thread.
+    std::vector<DemMatrix> partials(numThreads - 1,
+        DemMatrix(sizeY, sizeX));
+    point_count_t perThread = (count + numThreads - 1) / numThreads;
+    Utils::parallelFor(numThreads, numThreads, [&](size_t i)
     {
+        DemMatrix& grid = (i == 0) ? dem : partials[i - 1];
+        PointId begin = (std::min)((point_count_t)i * perThread, count);
+        PointId end = (std::min)(begin + perThread, count);
+        binRange(grid, begin, end);
+    });
 
-        auto InterpolateRasterPixelScanLine = [](Eigen::MatrixXd data, int mDim,
-                                              int x, int y, bool* prevSetCols)
-        {
-            int yMinus, yPlus, xMinus, xPlus;
-            float tInterpValue;
-            bool tPrevInterp;
-
-            yMinus = y - 1;
-            yPlus = y + 1;
-            xMinus = x - 1;
-            xPlus = x + 1;
-
-            //North
-            tInterpValue = data(yMinus, x);
-            tPrevInterp = prevSetCols[x];
-            if (tInterpValue != c_background && tPrevInterp != true)
-                return tInterpValue;
-
-            //South
-            tInterpValue = data(yPlus, x);
-            if (tInterpValue != c_background)
-                return tInterpValue;
-
-            //East
-            tInterpValue = data(y, xPlus);
-            if (tInterpValue != c_background)
-                return tInterpValue;
-
-            //West
-            tInterpValue = data(y, xMinus);
-            if (tInterpValue != c_background)
-                return tInterpValue;
-
-            //NorthWest
-            tInterpValue = data(yMinus, xMinus);
-            tPrevInterp = prevSetCols[xMinus];
-            if (tInterpValue != c_background && tPrevInterp != true)
-                return tInterpValue;
-
-            //NorthWest
-            tInterpValue = data(yMinus, xPlus);
-            tPrevInterp = prevSetCols[xPlus];
-            if (tInterpValue != c_background && tPrevInterp != true)
-                return tInterpValue;
-
-            //SouthWest
-            tInterpValue = data(yPlus, xMinus);
-            if (tInterpValue != c_background)
-                return tInterpValue;
-
-            //SouthEast
-            tInterpValue = data(yPlus, xPlus);
-            if (tInterpValue != c_background)
-                return tInterpValue;
-
-            return 0.0f;
-        };
+    auto mergeRows = [&](int begin, int end)
+    {
+        for (const DemMatrix& grid : partials)
+            for (int row = begin; row < end; ++row)
+            {
+                double *dst = dem.data() + (size_t)row * sizeX;
+                const double *src = grid.data() + (size_t)row * sizeX;
+                for (int col = 0; col < sizeX; ++col)
+                    if (src[col] != c_background &&
+                        (dst[col] == c_background || src[col] > dst[col]))
+                        dst[col] = src[col];
+            }
+    };
+    runRows(0, sizeY, mergeRows);
+}
 
-        float tInterpValue;
-        float tValue;
 
-        int y = row;
-        for (int x = 1; x < mDim-1; ++x)
-        {
-            tValue = datarow(x);
+void DerivativeWriter::fillGaps(DemMatrix& dem)
+{
+    const int sizeX = m_GRID_SIZE_X;
+    const int sizeY = m_GRID_SIZE_Y;
+    if (sizeX < 3 || sizeY < 3)
+        return;
 
-            if (tValue == c_background)
-            {
-                tInterpValue = InterpolateRasterPixelScanLine(data, mDim, x, y,
-                               prevSetCols);
-                if (tInterpValue != c_background)
+    // Empty cells are filled from the first populated neighbor, checked in
+    // the order below.  Only cells that were populated before filling are
+    // used, so rows are filled in place from copies of the original rows
+    // above and below.
+    auto fillRow = [sizeX](double *row, const double *north,
+        const double *center, const double *south)
+    {
+        for (int x = 1; x < sizeX - 1; ++x)
+        {
+            if (center[x] != c_background)
+                continue;
+
+            const double candidates[] = {
+                north[x], south[x], center[x + 1], center[x - 1],
+                north[x - 1], north[x + 1], south[x - 1], south[x + 1] };
+            for (double v : candidates)
+                if (v != c_background)
                 {
-                    curSetCols[x] = true;
-                    datarow(x) = tInterpValue;
+                    row[x] = v;
+                    break;
                 }
-            }
         }
     };
 
-    {
-        std::unique_ptr<bool> prevSetCols(new bool[m_GRID_SIZE_X]);
-        std::unique_ptr<bool> curSetCols(new bool[m_GRID_SIZE_X]);
+    // Each band of rows needs the original values of the rows bordering
+    // it, which may be filled by another thread, so save them first.
+    const int numRows = sizeY - 2;
+    const int numThreads = (std::max)(1, (std::min)(m_threads, numRows));
+    const int rowsPerThread = (numRows + numThreads - 1) / numThreads;
 
-        for (uint32_t y = 1; y < m_GRID_SIZE_Y-1; ++y)
-        {
-            CleanRasterScanLine(tDemData, tDemData.row(1), m_GRID_SIZE_X, y,
-                prevSetCols.get(), curSetCols.get());
-            memcpy(prevSetCols.get(), curSetCols.get(), m_GRID_SIZE_X);
-            memset(curSetCols.get(), 0, m_GRID_SIZE_X);
-        }
+    std::vector<std::vector<double>> borders;
+    for (int first = 1; first < sizeY - 1; first += rowsPerThread)
+    {
+        int last = (std::min)(first + rowsPerThread, sizeY - 1);
+        const double *north = dem.data() + (size_t)(first - 1) * sizeX;
+        const double *south = dem.data() + (size_t)last * sizeX;
+        borders.push_back(std::vector<double>(north, north + sizeX));
+        borders.push_back(std::vector<double>(south, south + sizeX));
     }
 
-    for (TypeOutput& to : m_primitiveTypes)
+    auto fillRows = [&](int first, int last)
     {
-        switch (to.m_type)
+        size_t band = (first - 1) / rowsPerThread;
+        std::vector<double> north(borders[2 * band]);
+        std::vector<double> center(dem.data() + (size_t)first * sizeX,
+            dem.data() + (size_t)(first + 1) * sizeX);
+        std::vector<double> south(sizeX);
+
+        for (int y = first; y < last; ++y)
         {
-        case SLOPE_D8:
-        case SLOPE_FD:
-            writeSlope(&tDemData, data, to.m_type, to.m_filename);
-            break;
-        case ASPECT_D8:
-        case ASPECT_FD:
-            writeAspect(&tDemData, data, to.m_type, to.m_filename);
-            break;
-        case HILLSHADE:
-            writeHillshade(&tDemData, data, to.m_filename);
-            break;
-        case CONTOUR_CURVATURE:
-        case PROFILE_CURVATURE:
-        case TANGENTIAL_CURVATURE:
-        case TOTAL_CURVATURE:
-            writeCurvature(&tDemData, data, to.m_type, c_background,
-                to.m_filename);
-            break;
-        case CATCHMENT_AREA:
-            writeCatchmentArea(&tDemData, data, to.m_filename);
-            break;
+            if (y + 1 == last)
+                south = borders[2 * band + 1];
+            else
+            {
+                const double *next = dem.data() + (size_t)(y + 1) * sizeX;
+                std::copy(next, next + sizeX, south.begin());
+            }
+            fillRow(dem.data() + (size_t)y * sizeX, north.data(),
+                center.data(), south.data());
+            north.swap(center);
+            center.swap(south);
         }
-    }
+    };
+
+    const size_t numBands = borders.size() / 2;
+    Utils::parallelFor(numBands, numBands, [&](size_t band)
+    {
+        int first = 1 + (int)band * rowsPerThread;
+        fillRows(first, (std::min)(first + rowsPerThread, sizeY - 1));
+    });
 }
 
+
 void DerivativeWriter::calculateGridSizes()
 {
     BOX2D& extent = getBounds();
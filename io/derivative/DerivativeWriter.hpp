@@ -39,6 +39,7 @@
 
 #include <Eigen/Core>
 
+#include <functional>
 #include <string>
 
 #include "gdal_priv.h" // For File I/O
@@ -67,16 +68,18 @@ class PDAL_DLL DerivativeWriter : public Writer
         CATCHMENT_AREA
     };
 
-    enum Direction
+    // Values of a DEM cell and its eight neighbors.
+    struct Neighborhood
     {
-        NORTH,
-        SOUTH,
-        EAST,
-        WEST,
-        NORTHEAST,
-        NORTHWEST,
-        SOUTHEAST,
-        SOUTHWEST
+        double center;
+        double north;
+        double south;
+        double east;
+        double west;
+        double northeast;
+        double northwest;
+        double southeast;
+        double southwest;
     };
 
     struct TypeOutput
@@ -85,6 +88,10 @@ class PDAL_DLL DerivativeWriter : public Writer
         std::string m_filename;
     };
 
+    // The DEM is stored row-major so that scan lines are contiguous.
+    typedef Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic,
+        Eigen::RowMajor> DemMatrix;
+
 public:
     static void * create();
     static int32_t destroy(void *);
@@ -111,43 +118,46 @@ private:
 
     std::string generateFilename(const std::string& primName) const;
     void calculateGridSizes();
-    double determineSlopeFD(Eigen::MatrixXd* data, int row, int col,
+    void binPoints(const PointView& view, DemMatrix& dem);
+    void fillGaps(DemMatrix& dem);
+    void runRows(int begin, int end, std::function<void(int, int)> func);
+    template<typename CellFunc>
+    void writeRaster(const std::string& filename, float border,
+        CellFunc cellFunc);
+    double determineSlopeFD(const Neighborhood& nb,
                             double postSpacing, double valueToIgnore);
-    double determineSlopeD8(Eigen::MatrixXd* data, int row, int col,
+    double determineSlopeD8(const Neighborhood& nb,
                             double postSpacing, double valueToIgnore);
-    double determineAspectFD(Eigen::MatrixXd* data, int row, int col,
+    double determineAspectFD(const Neighborhood& nb,
                              double postSpacing, double valueToIgnore);
-    double determineAspectD8(Eigen::MatrixXd* data, int row, int col,
+    double determineAspectD8(const Neighborhood& nb,
                              double postSpacing);
-    int determineCatchmentAreaD8(Eigen::MatrixXd* data, Eigen::MatrixXd* area,
+    int determineCatchmentAreaD8(DemMatrix* data, DemMatrix* area,
                                  int row, int col, double postSpacing);
-    double determineContourCurvature(Eigen::MatrixXd* data, int row, int col,
+    double determineContourCurvature(const Neighborhood& nb,
                                      double postSpacing, double valueToIgnore);
-    double determineProfileCurvature(Eigen::MatrixXd* data, int row, int col,
+    double determineProfileCurvature(const Neighborhood& nb,
                                      double postSpacing, double valueToIgnore);
-    double determineTangentialCurvature(Eigen::MatrixXd* data, int row, int col,
+    double determineTangentialCurvature(const Neighborhood& nb,
                                         double postSpacing, double valueToIgnore);
-    double determineTotalCurvature(Eigen::MatrixXd* data, int row, int col,
+    double determineTotalCurvature(const Neighborhood& nb,
                                    double postSpacing, double valueToIgnore);
-    double determineHillshade(Eigen::MatrixXd* data, int row, int col,
+    double determineHillshade(const Neighborhood& nb,
                               double zenithRad, double azimuthRad,
                               double postSpacing);
-    double GetNeighbor(Eigen::MatrixXd* data, int row, int col, Direction d);
-    void writeSlope(Eigen::MatrixXd* dem, const PointViewPtr cloud,
-        PrimitiveType method, const std::string& filename);
-    void writeAspect(Eigen::MatrixXd* dem, const PointViewPtr cloud,
-        PrimitiveType method, const std::string& filename);
-    void writeCatchmentArea(Eigen::MatrixXd* dem, const PointViewPtr cloud,
-        const std::string& filename);
-    void writeHillshade(Eigen::MatrixXd* dem, const PointViewPtr cloud,
-        const std::string& filename);
-    void writeCurvature(Eigen::MatrixXd* dem, const PointViewPtr cloud,
-        PrimitiveType curveType, double valueToIgnore,
+    void writeCatchmentArea(DemMatrix* dem, const PointViewPtr cloud,
         const std::string& filename);
+    float computePrimitive(PrimitiveType type, const Neighborhood& nb);
+    void writeStencilPrimitives(DemMatrix& dem,
+        const std::vector<TypeOutput>& outputs);
     GDALDataset* createFloat32GTIFF(std::string filename, int cols, int rows);
     void stretchData(float *data);
 
     uint64_t m_pointCount;
+    int m_threads;
+    double m_postSpacing;
+    double m_zenithRad;
+    double m_azimuthRad;
     uint32_t m_GRID_SIZE_X;
     uint32_t m_GRID_SIZE_Y;
     double m_GRID_DIST_X;
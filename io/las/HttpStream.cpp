@@ -0,0 +1,480 @@
+/******************************************************************************
+* Copyright (c) 2015, Howard Butler (howard@hobu.co)
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+#include "HttpStream.hpp"
+
+#include <cstring>
+#include <limits>
+#include <sstream>
+
+#ifndef WIN32
+#include <netdb.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <unistd.h>
+#endif
+
+#include <pdal/util/Utils.hpp>
+
+namespace pdal
+{
+
+namespace
+{
+
+// Redirects followed for a single request.
+const int MaxRedirects = 5;
+
+// Value of a header field in the header block of a response, or an empty
+// string.
+std::string headerValue(const std::string& headers, const std::string& name)
+{
+    std::istringstream in(headers);
+    std::string line;
+    while (std::getline(in, line))
+    {
+        size_t colon = line.find(':');
+        if (colon == std::string::npos)
+            continue;
+        if (Utils::iequals(line.substr(0, colon), name))
+        {
+            std::string value = line.substr(colon + 1);
+            Utils::trim(value);
+            return value;
+        }
+    }
+    return std::string();
+}
+
+} // unnamed namespace
+
+#ifndef WIN32
+
+// A connection to a server that may carry several requests in turn.
+// Received data is buffered so that the response can be read by line.
+class HttpRangeBuf::Connection
+{
+public:
+    Connection(const std::string& host, const std::string& port,
+        const std::string& url) : m_fd(-1), m_buf(8192), m_pos(0), m_end(0)
+    {
+        addrinfo hints;
+        memset(&hints, 0, sizeof(hints));
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+
+        addrinfo *addrs;
+        if (getaddrinfo(host.c_str(), port.c_str(), &hints, &addrs) != 0)
+            throw pdal_error("Unable to resolve host for '" + url + "'.");
+        for (addrinfo *a = addrs; a; a = a->ai_next)
+        {
+            m_fd = socket(a->ai_family, a->ai_socktype, a->ai_protocol);
+            if (m_fd < 0)
+                continue;
+            if (connect(m_fd, a->ai_addr, a->ai_addrlen) == 0)
+                break;
+            close(m_fd);
+            m_fd = -1;
+        }
+        freeaddrinfo(addrs);
+        if (m_fd < 0)
+            throw pdal_error("Unable to connect to server for '" + url +
+                "'.");
+    }
+
+    ~Connection()
+    {
+        if (m_fd >= 0)
+            close(m_fd);
+    }
+
+    void send(const std::string& s)
+    {
+        // A server that has closed the connection shouldn't kill us
+        // with SIGPIPE.
+#ifdef MSG_NOSIGNAL
+        const int flags = MSG_NOSIGNAL;
+#else
+        const int flags = 0;
+#endif
+        const char *pos = s.data();
+        size_t left = s.size();
+        while (left)
+        {
+            ssize_t cnt = ::send(m_fd, pos, left, flags);
+            if (cnt <= 0)
+                throw pdal_error("Error sending HTTP request.");
+            pos += cnt;
+            left -= cnt;
+        }
+    }
+
+    // Read a line, without its line ending.
+    std::string readLine()
+    {
+        std::string line;
+        while (true)
+        {
+            if (m_pos == m_end && !fill())
+                throw pdal_error("Connection closed reading HTTP response.");
+            char c = m_buf[m_pos++];
+            if (c == '\n')
+                break;
+            line += c;
+        }
+        if (line.size() && line.back() == '\r')
+            line.pop_back();
+        return line;
+    }
+
+    // Read 'count' bytes into 'dst', or discard them if 'dst' is NULL.
+    // Returns the number read, which is less than 'count' only if the
+    // server closed the connection.
+    size_t read(char *dst, size_t count)
+    {
+        size_t total = 0;
+        while (total < count)
+        {
+            if (m_pos == m_end && !fill())
+                break;
+            size_t cnt = (std::min)(count - total, m_end - m_pos);
+            if (dst)
+                memcpy(dst + total, m_buf.data() + m_pos, cnt);
+            m_pos += cnt;
+            total += cnt;
+        }
+        return total;
+    }
+
+private:
+    bool fill()
+    {
+        ssize_t cnt = ::recv(m_fd, m_buf.data(), m_buf.size(), 0);
+        if (cnt < 0)
+            throw pdal_error("Error reading HTTP response.");
+        m_pos = 0;
+        m_end = (size_t)cnt;
+        return cnt > 0;
+    }
+
+    int m_fd;
+    std::vector<char> m_buf;
+    size_t m_pos;
+    size_t m_end;
+};
+
+#else
+
+class HttpRangeBuf::Connection
+{};
+
+#endif // WIN32
+
+
+bool HttpRangeBuf::isUrl(const std::string& filename)
+{
+    return Utils::startsWith(Utils::tolower(filename), "http://");
+}
+
+
+HttpRangeBuf::HttpRangeBuf(const std::string& url, size_t blockSize) :
+    m_size(0), m_blockSize(blockSize), m_bufStart(0)
+{
+    setUrl(url);
+
+    m_buf.resize(m_blockSize);
+    invalidate(0);
+
+    // Requesting the first byte also gets us the size of the file.
+    fetch(0, 1, m_buf.data());
+}
+
+
+HttpRangeBuf::~HttpRangeBuf()
+{}
+
+
+void HttpRangeBuf::setUrl(const std::string& url)
+{
+    if (!isUrl(url))
+        throw pdal_error("Unsupported URL '" + url + "'.  Only 'http://' "
+            "URLs can be read.");
+
+    m_url = url;
+    m_port = "80";
+    std::string hostPort = url.substr(7);
+    size_t slash = hostPort.find('/');
+    if (slash != std::string::npos)
+    {
+        m_path = hostPort.substr(slash);
+        hostPort = hostPort.substr(0, slash);
+    }
+    else
+        m_path = "/";
+    size_t colon = hostPort.find(':');
+    m_host = hostPort.substr(0, colon);
+    if (colon != std::string::npos)
+        m_port = hostPort.substr(colon + 1);
+}
+
+
+void HttpRangeBuf::invalidate(uint64_t pos)
+{
+    m_bufStart = pos;
+    setg(m_buf.data(), m_buf.data(), m_buf.data());
+}
+
+
+// Fetch 'count' bytes starting at 'start' into 'dst'.
+size_t HttpRangeBuf::fetch(uint64_t start, size_t count, char *dst)
+{
+#ifdef WIN32
+    throw pdal_error("Reading from '" + m_url + "' isn't supported on "
+        "this platform.");
+#else
+    for (int redirects = 0; redirects <= MaxRedirects; ++redirects)
+    {
+        std::ostringstream req;
+        req << "GET " << m_path << " HTTP/1.1\r\n" <<
+            "Host: " << m_host << "\r\n" <<
+            "Range: bytes=" << start << "-" << (start + count - 1) <<
+            "\r\n\r\n";
+
+        std::string headers;
+        int status = request(req.str(), headers);
+        if (status == 206)
+        {
+            std::string range = headerValue(headers, "Content-Range");
+            size_t slash = range.find('/');
+            if (slash != std::string::npos && range.substr(slash + 1) != "*")
+                m_size = std::stoull(range.substr(slash + 1));
+            return readBody(headers, dst, count);
+        }
+
+        std::string location = headerValue(headers, "Location");
+        readBody(headers, NULL, 0);
+        if ((status == 301 || status == 302 || status == 303 ||
+            status == 307 || status == 308) && location.size())
+        {
+            // Relative locations are on the same server.
+            if (location[0] == '/')
+                location = "http://" + m_host + ":" + m_port + location;
+            setUrl(location);
+            m_conn.reset();
+            continue;
+        }
+
+        std::ostringstream oss;
+        if (status == 200)
+            oss << "Server for '" << m_url << "' doesn't support range "
+                "requests.";
+        else
+            oss << "HTTP request for '" << m_url << "' failed with status " <<
+                status << ".";
+        throw pdal_error(oss.str());
+    }
+    throw pdal_error("Too many redirects reading '" + m_url + "'.");
+#endif
+}
+
+
+// Send a request and read the status and headers of the response.  A
+// kept-alive connection that the server has since closed is replaced.
+int HttpRangeBuf::request(const std::string& req, std::string& headers)
+{
+#ifdef WIN32
+    return 0;
+#else
+    std::string statusLine;
+    while (true)
+    {
+        bool reused = (bool)m_conn;
+        if (!m_conn)
+            m_conn.reset(new Connection(m_host, m_port, m_url));
+        try
+        {
+            m_conn->send(req);
+            statusLine = m_conn->readLine();
+            break;
+        }
+        catch (pdal_error&)
+        {
+            m_conn.reset();
+            if (!reused)
+                throw;
+        }
+    }
+
+    int status = 0;
+    std::istringstream in(statusLine);
+    std::string version;
+    in >> version >> status;
+
+    headers.clear();
+    std::string line;
+    while ((line = m_conn->readLine()).size())
+        headers += line + "\n";
+    return status;
+#endif
+}
+
+
+// Read the body of a response, storing at most 'count' bytes of it in
+// 'dst'.  The rest is discarded so that the connection can be reused.
+size_t HttpRangeBuf::readBody(const std::string& headers, char *dst,
+    size_t count)
+{
+#ifdef WIN32
+    return 0;
+#else
+    size_t total = 0;
+    auto consume = [&](size_t cnt)
+    {
+        size_t keep = (std::min)(cnt, count - total);
+        size_t got = m_conn->read(dst ? dst + total : NULL, keep);
+        total += got;
+        if (got == keep && cnt > keep)
+            got += m_conn->read(NULL, cnt - keep);
+        return got == cnt;
+    };
+
+    bool keepAlive =
+        !Utils::iequals(headerValue(headers, "Connection"), "close");
+    if (Utils::iequals(headerValue(headers, "Transfer-Encoding"), "chunked"))
+    {
+        while (true)
+        {
+            size_t size = std::stoul(m_conn->readLine(), NULL, 16);
+            if (size == 0)
+                break;
+            if (!consume(size))
+                throw pdal_error("Connection closed reading HTTP response.");
+            m_conn->readLine();
+        }
+        // Trailing headers end with an empty line.
+        while (m_conn->readLine().size())
+            ;
+    }
+    else
+    {
+        std::string length = headerValue(headers, "Content-Length");
+        if (length.size())
+            consume((size_t)std::stoull(length));
+        else
+        {
+            // The body ends when the server closes the connection.
+            consume((std::numeric_limits<size_t>::max)());
+            keepAlive = false;
+        }
+    }
+    if (!keepAlive)
+        m_conn.reset();
+    return total;
+#endif
+}
+
+
+HttpRangeBuf::int_type HttpRangeBuf::underflow()
+{
+    if (gptr() < egptr())
+        return traits_type::to_int_type(*gptr());
+
+    uint64_t pos = position();
+    if (pos >= m_size)
+        return traits_type::eof();
+
+    size_t count = (size_t)(std::min)((uint64_t)m_blockSize, m_size - pos);
+    count = fetch(pos, count, m_buf.data());
+    m_bufStart = pos;
+    setg(m_buf.data(), m_buf.data(), m_buf.data() + count);
+    if (count == 0)
+        return traits_type::eof();
+    return traits_type::to_int_type(*gptr());
+}
+
+
+std::streamsize HttpRangeBuf::xsgetn(char *s, std::streamsize count)
+{
+    // Use what's buffered.
+    std::streamsize avail = (std::min)(count,
+        (std::streamsize)(egptr() - gptr()));
+    memcpy(s, gptr(), (size_t)avail);
+    gbump((int)avail);
+    s += avail;
+    count -= avail;
+
+    // Get large reads directly.
+    if ((size_t)count > m_blockSize)
+    {
+        uint64_t pos = position();
+        size_t want = (size_t)(std::min)((uint64_t)count,
+            m_size > pos ? m_size - pos : 0);
+        size_t got = want ? fetch(pos, want, s) : 0;
+        invalidate(pos + got);
+        return avail + got;
+    }
+    return avail + std::streambuf::xsgetn(s, count);
+}
+
+
+HttpRangeBuf::pos_type HttpRangeBuf::seekoff(off_type off,
+    std::ios_base::seekdir dir, std::ios_base::openmode which)
+{
+    int64_t target;
+    if (dir == std::ios_base::beg)
+        target = off;
+    else if (dir == std::ios_base::cur)
+        target = (int64_t)position() + off;
+    else
+        target = (int64_t)m_size + off;
+    if (!(which & std::ios_base::in) || target < 0 ||
+        target > (int64_t)m_size)
+        return pos_type(off_type(-1));
+
+    uint64_t pos = (uint64_t)target;
+    if (pos >= m_bufStart && pos <= m_bufStart + (egptr() - eback()))
+        setg(eback(), eback() + (pos - m_bufStart), egptr());
+    else
+        invalidate(pos);
+    return pos_type(target);
+}
+
+
+HttpRangeBuf::pos_type HttpRangeBuf::seekpos(pos_type pos,
+    std::ios_base::openmode which)
+{
+    return seekoff(off_type(pos), std::ios_base::beg, which);
+}
+
+} // namespace pdal
@@ -0,0 +1,106 @@
+/******************************************************************************
+* Copyright (c) 2015, Howard Butler (howard@hobu.co)
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+#include <pdal/pdal_internal.hpp>
+
+namespace pdal
+{
+
+// Stream buffer over a file served by an HTTP server.  Data is fetched
+// with a ranged GET request for each block that's read, so only the parts
+// of the file that are used are transferred.  Reads larger than a block
+// are requested in one piece.  Requests are made over a single kept-alive
+// connection and redirects are followed.  Only plain "http://" URLs are
+// supported, and the server must honor byte ranges.
+class PDAL_DLL HttpRangeBuf : public std::streambuf
+{
+public:
+    HttpRangeBuf(const std::string& url, size_t blockSize = 65536);
+    ~HttpRangeBuf();
+
+    uint64_t size() const
+        { return m_size; }
+    static bool isUrl(const std::string& filename);
+
+protected:
+    virtual int_type underflow();
+    virtual std::streamsize xsgetn(char *s, std::streamsize count);
+    virtual pos_type seekoff(off_type off, std::ios_base::seekdir dir,
+        std::ios_base::openmode which = std::ios_base::in);
+    virtual pos_type seekpos(pos_type pos,
+        std::ios_base::openmode which = std::ios_base::in);
+
+private:
+    class Connection;
+
+    std::string m_url;
+    std::string m_host;
+    std::string m_port;
+    std::string m_path;
+    uint64_t m_size;
+    size_t m_blockSize;
+    std::vector<char> m_buf;
+    uint64_t m_bufStart;   // File offset of the start of m_buf.
+    std::unique_ptr<Connection> m_conn;
+
+    uint64_t position() const
+        { return m_bufStart + (gptr() - eback()); }
+    void setUrl(const std::string& url);
+    void invalidate(uint64_t pos);
+    size_t fetch(uint64_t start, size_t count, char *dst);
+    int request(const std::string& req, std::string& headers);
+    size_t readBody(const std::string& headers, char *dst, size_t count);
+};
+
+
+class PDAL_DLL HttpIStream : public std::istream
+{
+public:
+    HttpIStream(const std::string& url) : std::istream(NULL), m_buf(url)
+        { init(&m_buf); }
+
+private:
+    HttpRangeBuf m_buf;
+};
+
+} // namespace pdal
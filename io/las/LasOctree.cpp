@@ -0,0 +1,191 @@
+/******************************************************************************
+* Copyright (c) 2015, Howard Butler (howard@hobu.co)
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+#include "LasOctree.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include <pdal/util/Extractor.hpp>
+#include <pdal/util/Inserter.hpp>
+
+namespace pdal
+{
+
+namespace
+{
+
+const size_t HeaderSize = 5 * sizeof(double) + sizeof(uint32_t);
+const size_t NodeSize = 4 * sizeof(int32_t) + sizeof(uint64_t) +
+    2 * sizeof(uint32_t);
+
+int32_t cellIndex(double pos, double min, double width, int32_t limit)
+{
+    int32_t i = (int32_t)std::floor((pos - min) / width);
+    return (std::max)(0, (std::min)(i, limit - 1));
+}
+
+} // unnamed namespace
+
+
+void LasOctree::initialize(const BOX3D& bounds, double rootSpacing,
+    double minSpacing)
+{
+    m_minX = bounds.minx;
+    m_minY = bounds.miny;
+    m_minZ = bounds.minz;
+    m_size = (std::max)(bounds.maxx - bounds.minx,
+        (std::max)(bounds.maxy - bounds.miny, bounds.maxz - bounds.minz));
+    if (m_size <= 0)
+        m_size = 1;
+    // Grow the cube slightly so that points on the maximum edges fall
+    // inside it.
+    m_size *= 1.000001;
+    m_spacing = (rootSpacing > 0) ? rootSpacing : m_size / 128;
+
+    // Each axis of the grid must fit in 21 bits so that a cell can be
+    // identified by a single 64-bit value.
+    m_maxDepth = 0;
+    while (m_maxDepth < MaxDepth &&
+        spacing(m_maxDepth + 1) >= minSpacing &&
+        m_size / spacing(m_maxDepth + 1) < (1 << 21))
+        m_maxDepth++;
+
+    m_cells.clear();
+    m_cells.resize(m_maxDepth + 1);
+    m_nodes.clear();
+}
+
+
+OctreeKey LasOctree::assign(double x, double y, double z)
+{
+    for (int d = 0; d <= m_maxDepth; ++d)
+    {
+        double s = spacing(d);
+        int32_t limit = (int32_t)std::ceil(m_size / s);
+        uint64_t cx = cellIndex(x, m_minX, s, limit);
+        uint64_t cy = cellIndex(y, m_minY, s, limit);
+        uint64_t cz = cellIndex(z, m_minZ, s, limit);
+
+        // The deepest level takes whatever is left.
+        if (d == m_maxDepth ||
+            m_cells[d].insert((cx << 42) | (cy << 21) | cz).second)
+        {
+            double width = m_size / (1 << d);
+            return OctreeKey(d, cellIndex(x, m_minX, width, 1 << d),
+                cellIndex(y, m_minY, width, 1 << d),
+                cellIndex(z, m_minZ, width, 1 << d));
+        }
+    }
+    return OctreeKey();
+}
+
+
+BOX3D LasOctree::bounds(const OctreeKey& key) const
+{
+    double width = m_size / (1 << key.m_d);
+    return BOX3D(m_minX + key.m_x * width, m_minY + key.m_y * width,
+        m_minZ + key.m_z * width, m_minX + (key.m_x + 1) * width,
+        m_minY + (key.m_y + 1) * width, m_minZ + (key.m_z + 1) * width);
+}
+
+
+OctreeNodeList LasOctree::select(const BOX3D& bounds, double resolution) const
+{
+    // Read down to the first depth at which points are no farther apart
+    // than the resolution.
+    int maxDepth = (std::numeric_limits<int>::max)();
+    if (resolution > 0)
+    {
+        maxDepth = 0;
+        while (spacing(maxDepth) > resolution && maxDepth < MaxDepth)
+            maxDepth++;
+    }
+
+    OctreeNodeList nodes;
+    for (auto& n : m_nodes)
+    {
+        if (n.m_key.m_d > maxDepth)
+            continue;
+        BOX3D b = this->bounds(n.m_key);
+        if (b.minx <= bounds.maxx && b.maxx >= bounds.minx &&
+            b.miny <= bounds.maxy && b.maxy >= bounds.miny &&
+            b.minz <= bounds.maxz && b.maxz >= bounds.minz)
+            nodes.push_back(n);
+    }
+    return nodes;
+}
+
+
+std::vector<uint8_t> LasOctree::pack() const
+{
+    std::vector<uint8_t> data(HeaderSize + m_nodes.size() * NodeSize);
+    LeInserter out(data.data(), data.size());
+
+    out << m_minX << m_minY << m_minZ << m_size << m_spacing;
+    out << (uint32_t)m_nodes.size();
+    for (auto& n : m_nodes)
+        out << n.m_key.m_d << n.m_key.m_x << n.m_key.m_y << n.m_key.m_z <<
+            n.m_offset << n.m_byteSize << n.m_pointCount;
+    return data;
+}
+
+
+void LasOctree::unpack(const char *data, size_t size)
+{
+    if (size < HeaderSize)
+        throw pdal_error("Invalid octree hierarchy record.");
+
+    LeExtractor in(data, size);
+    uint32_t count;
+    in >> m_minX >> m_minY >> m_minZ >> m_size >> m_spacing >> count;
+    if (size < HeaderSize + count * NodeSize)
+        throw pdal_error("Invalid octree hierarchy record.");
+
+    m_nodes.resize(count);
+    uint64_t firstPoint = 0;
+    for (auto& n : m_nodes)
+    {
+        in >> n.m_key.m_d >> n.m_key.m_x >> n.m_key.m_y >> n.m_key.m_z >>
+            n.m_offset >> n.m_byteSize >> n.m_pointCount;
+        n.m_firstPoint = firstPoint;
+        firstPoint += n.m_pointCount;
+    }
+    m_maxDepth = 0;
+    m_cells.clear();
+}
+
+} // namespace pdal
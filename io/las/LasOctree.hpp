@@ -0,0 +1,142 @@
+/******************************************************************************
+* Copyright (c) 2015, Howard Butler (howard@hobu.co)
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <unordered_set>
+#include <vector>
+
+#include <pdal/pdal_internal.hpp>
+#include <pdal/util/Bounds.hpp>
+
+namespace pdal
+{
+
+static const char OCTREE_USER_ID[] = "pdal_octree";
+static const uint16_t OCTREE_HIERARCHY_RECORD_ID = 1000;
+
+// Position of a node in the octree: its depth and its index along each
+// axis among the nodes of that depth.
+struct OctreeKey
+{
+    OctreeKey() : m_d(0), m_x(0), m_y(0), m_z(0)
+    {}
+    OctreeKey(int32_t d, int32_t x, int32_t y, int32_t z) :
+        m_d(d), m_x(x), m_y(y), m_z(z)
+    {}
+
+    int32_t m_d;
+    int32_t m_x;
+    int32_t m_y;
+    int32_t m_z;
+
+    bool operator<(const OctreeKey& other) const
+    {
+        if (m_d != other.m_d)
+            return m_d < other.m_d;
+        if (m_x != other.m_x)
+            return m_x < other.m_x;
+        if (m_y != other.m_y)
+            return m_y < other.m_y;
+        return m_z < other.m_z;
+    }
+};
+
+// A node as stored in the hierarchy record.  Nodes are stored in the order
+// in which their points appear in the file.
+struct OctreeNode
+{
+    OctreeNode() : m_offset(0), m_byteSize(0), m_pointCount(0),
+        m_firstPoint(0)
+    {}
+
+    OctreeKey m_key;
+    uint64_t m_offset;      // File offset of the node's point data.
+    uint32_t m_byteSize;    // Size of the node's point data.
+    uint32_t m_pointCount;
+    uint64_t m_firstPoint;  // Index of the node's first point (not stored).
+};
+typedef std::vector<OctreeNode> OctreeNodeList;
+
+// Level-of-detail octree over the points of a LAS file.  Each node holds
+// at most one point in each cell of a grid whose spacing halves with each
+// level, so reading the nodes down to some depth gives a subset of the
+// points at a known resolution.
+class PDAL_DLL LasOctree
+{
+public:
+    static const int MaxDepth = 14;
+
+    LasOctree() : m_size(0), m_spacing(0), m_maxDepth(0)
+    {}
+
+    // Set up the octree to hold points within 'bounds'.  A 'spacing' of 0
+    // divides the root node's grid into 128 cells along its longest edge.
+    // The depth is limited where cells become smaller than 'minSpacing'.
+    void initialize(const BOX3D& bounds, double rootSpacing,
+        double minSpacing);
+
+    // Find the node that should hold a point, claiming its grid cell.
+    OctreeKey assign(double x, double y, double z);
+
+    double spacing(int depth) const
+        { return m_spacing / (1 << depth); }
+    BOX3D bounds(const OctreeKey& key) const;
+
+    OctreeNodeList& nodes()
+        { return m_nodes; }
+    const OctreeNodeList& nodes() const
+        { return m_nodes; }
+
+    // Nodes that overlap 'bounds' and whose depth is needed to reach
+    // 'resolution'.  A resolution of 0 selects nodes of all depths.
+    OctreeNodeList select(const BOX3D& bounds, double resolution) const;
+
+    std::vector<uint8_t> pack() const;
+    void unpack(const char *data, size_t size);
+
+private:
+    double m_minX;
+    double m_minY;
+    double m_minZ;
+    double m_size;
+    double m_spacing;
+    int m_maxDepth;
+    OctreeNodeList m_nodes;
+    std::vector<std::unordered_set<uint64_t>> m_cells;
+};
+
+} // namespace pdal
@@ -91,6 +91,34 @@ void LasReader::processOptions(const Options& options)
     // Set case-corrected value.
     m_compression = compression;
 
+    m_bounds = BOX3D();
+    if (options.hasOption("bounds"))
+    {
+        try
+        {
+            m_bounds = options.getValueOrDefault<BOX3D>("bounds");
+        }
+        catch (Option::cant_convert)
+        {
+            try
+            {
+                BOX2D b = options.getValueOrDefault<BOX2D>("bounds");
+                m_bounds = BOX3D(b.minx, b.miny,
+                    std::numeric_limits<double>::lowest(), b.maxx, b.maxy,
+                    (std::numeric_limits<double>::max)());
+            }
+            catch (Option::cant_convert)
+            {
+                throw pdal_error("readers.las: Invalid 'bounds' option.  "
+                    "Format: '([xmin,xmax],[ymin,ymax],[zmin,zmax])'.");
+            }
+        }
+    }
+    m_resolution = options.getValueOrDefault("resolution", 0.0);
+    int threads = options.getValueOrDefault("threads", 1);
+    Utils::checkThreads(getName(), threads);
+    m_threads = (size_t)threads;
+
     m_error.setFilename(m_filename);
 }
 
@@ -168,6 +196,16 @@ void LasReader::initializeLocal(PointTableRef table, MetadataNode& m)
         }
         readExtraBytesVlr();
     }
+    VariableLengthRecord *vlr =
+        findVlr(OCTREE_USER_ID, OCTREE_HIERARCHY_RECORD_ID);
+    m_hasOctree = (vlr != NULL);
+    if (m_hasOctree)
+        m_octree.unpack(vlr->data(), (size_t)vlr->dataLen());
+    else if (!m_bounds.empty() || m_resolution > 0)
+        throw pdal_error("readers.las: The 'bounds' and 'resolution' "
+            "options can only be used with files written with the "
+            "'octree' option.");
+
     setSrsFromVlrs(m);
     MetadataNode forward = table.privateMetadata("lasforward");
     extractHeaderMetadata(forward, m);
@@ -179,10 +217,17 @@ void LasReader::initializeLocal(PointTableRef table, MetadataNode& m)
 
 void LasReader::ready(PointTableRef table)
 {
+    m_error.setLog(log());
+    if (m_hasOctree)
+    {
+        readyOctree();
+        return;
+    }
+
     createStream();
     std::istream *stream(m_streamIf->m_istream);
 
-    m_index = 0;
+    m_index = (std::min)(m_start, getNumPoints());
     if (m_lasHeader.compressed())
     {
 #ifdef PDAL_HAVE_LASZIP
@@ -210,6 +255,18 @@ void LasReader::ready(PointTableRef table)
                     throw pdal_error(oss.str());
                 }
             }
+            // With chunked data this jumps to the chunk containing the
+            // point.  Otherwise LASzip decompresses up to it.
+            if (m_index && !eof() && !m_unzipper->seek(m_index))
+            {
+                std::ostringstream oss;
+                const char* err = m_unzipper->get_error();
+                if (err == NULL)
+                    err = "(unknown error)";
+                oss << "Failed to seek to point " << m_index <<
+                    " in LASzip stream: " << std::string(err);
+                throw pdal_error(oss.str());
+            }
         }
 #endif
 
@@ -221,6 +278,10 @@ void LasReader::ready(PointTableRef table)
             m_decompressor.reset(new LazPerfVlrDecompressor(*stream,
                 vlr->data(), m_lasHeader.pointOffset()));
             m_decompressorBuf.resize(m_decompressor->pointSize());
+            // LAZperf can't seek, so skip points by decompressing them.
+            if (!eof())
+                for (point_count_t i = 0; i < m_index; ++i)
+                    m_decompressor->decompress(m_decompressorBuf.data());
         }
 #endif
 
@@ -230,12 +291,215 @@ void LasReader::ready(PointTableRef table)
 #endif
     }
     else
-        stream->seekg(m_lasHeader.pointOffset());
+        stream->seekg(m_lasHeader.pointOffset() +
+            (uint64_t)m_index * m_lasHeader.pointLen());
 
     m_error.setLog(log());
 }
 
 
+// Select the octree nodes to read.  Nodes are decompressed as needed, as
+// many at a time as there are threads.
+void LasReader::readyOctree()
+{
+    BOX3D all(std::numeric_limits<double>::lowest(),
+        std::numeric_limits<double>::lowest(),
+        std::numeric_limits<double>::lowest(),
+        (std::numeric_limits<double>::max)(),
+        (std::numeric_limits<double>::max)(),
+        (std::numeric_limits<double>::max)());
+    m_nodes = m_octree.select(m_bounds.empty() ? all : m_bounds,
+        m_resolution);
+    log()->get(LogLevel::Debug) << getName() << ": Reading " <<
+        m_nodes.size() << " of " << m_octree.nodes().size() <<
+        " octree nodes." << std::endl;
+
+    // Skip whole nodes that precede the first point to read.
+    m_nodeIdx = 0;
+    m_nodeSkip = m_start;
+    while (m_nodeIdx < m_nodes.size() &&
+        m_nodeSkip >= m_nodes[m_nodeIdx].m_pointCount)
+        m_nodeSkip -= m_nodes[m_nodeIdx++].m_pointCount;
+
+    m_nodeStreams.clear();
+    m_nodeStreams.resize((std::min)(m_threads, m_nodes.size()));
+    m_nodeBufs.clear();
+    m_bufIdx = 0;
+    m_bufPos = 0;
+    m_numRead = 0;
+}
+
+
+// Read the points of a node into a buffer, using the stream and
+// decompressor of one thread.
+void LasReader::readNode(const OctreeNode& node, NodeStream& ns,
+    std::vector<char>& buf)
+{
+    size_t pointLen = m_lasHeader.pointLen();
+    buf.resize(node.m_pointCount * pointLen);
+
+    if (!ns.m_streamIf)
+    {
+        ns.m_streamIf.reset(new LasStreamIf(m_filename));
+        if (!ns.m_streamIf->m_istream)
+            throw pdal_error("readers.las: Unable to open '" + m_filename +
+                "'.");
+    }
+    std::istream& stream(*ns.m_streamIf->m_istream);
+
+    if (!m_lasHeader.compressed())
+    {
+        stream.seekg(node.m_offset);
+        stream.read(buf.data(), buf.size());
+        if (stream.gcount() != (std::streamsize)buf.size())
+            throw pdal_error("readers.las: Unable to read octree node "
+                "points from '" + m_filename + "'.");
+        return;
+    }
+
+#ifdef PDAL_HAVE_LASZIP
+    if (m_compression == "LASZIP")
+    {
+        if (!ns.m_unzipper)
+        {
+            VariableLengthRecord *vlr = findVlr(LASZIP_USER_ID,
+                LASZIP_RECORD_ID);
+            ns.m_zipPoint.reset(new ZipPoint(vlr));
+            ns.m_unzipper.reset(new LASunzipper());
+            stream.seekg(m_lasHeader.pointOffset(), std::ios::beg);
+            if (!ns.m_unzipper->open(stream, ns.m_zipPoint->GetZipper()))
+                throw pdal_error("Failed to open LASzip stream.");
+        }
+
+        // Nodes are stored as chunks, so this jumps to the start of one.
+        bool ok = ns.m_unzipper->seek(node.m_firstPoint);
+        char *pos = buf.data();
+        for (uint32_t i = 0; ok && i < node.m_pointCount; ++i)
+        {
+            ok = ns.m_unzipper->read(ns.m_zipPoint->m_lz_point);
+            memcpy(pos, ns.m_zipPoint->m_lz_point_data.data(), pointLen);
+            pos += pointLen;
+        }
+        if (!ok)
+        {
+            const char* err = ns.m_unzipper->get_error();
+            throw pdal_error(std::string("Error reading compressed point "
+                "data: ") + (err ? err : "(unknown error)"));
+        }
+    }
+#endif
+
+#ifdef PDAL_HAVE_LAZPERF
+    if (m_compression == "LAZPERF")
+    {
+        // Each node is a chunk of its own.
+        VariableLengthRecord *vlr = findVlr(LASZIP_USER_ID,
+            LASZIP_RECORD_ID);
+        LazPerfVlrDecompressor decompressor(stream, vlr->data(),
+            node.m_offset, node.m_pointCount);
+        char *pos = buf.data();
+        for (uint32_t i = 0; i < node.m_pointCount; ++i)
+        {
+            decompressor.decompress(pos);
+            pos += pointLen;
+        }
+    }
+#endif
+
+#if !defined(PDAL_HAVE_LAZPERF) && !defined(PDAL_HAVE_LASZIP)
+    throw pdal_error("Can't read compressed file without LASzip or "
+        "LAZperf decompression library.");
+#endif
+}
+
+
+// Decompress the next group of nodes in parallel.
+void LasReader::readNodes()
+{
+    size_t count = (std::min)(m_nodeStreams.size(),
+        m_nodes.size() - m_nodeIdx);
+    m_nodeBufs.resize(count);
+
+    Utils::parallelFor(count, count, [&](size_t i)
+    {
+        readNode(m_nodes[m_nodeIdx + i], m_nodeStreams[i], m_nodeBufs[i]);
+    });
+
+    m_nodeIdx += count;
+    m_bufIdx = 0;
+    m_bufPos = m_nodeSkip;
+    m_nodeSkip = 0;
+}
+
+
+// Load the next point of the selected nodes that's within the bounds.
+bool LasReader::nextNodePoint(PointRef& point)
+{
+    size_t pointLen = m_lasHeader.pointLen();
+    const LasHeader& h = m_lasHeader;
+
+    while (m_numRead < m_count)
+    {
+        if (m_bufIdx < m_nodeBufs.size() &&
+            m_bufPos >= m_nodeBufs[m_bufIdx].size() / pointLen)
+        {
+            m_bufIdx++;
+            m_bufPos = 0;
+        }
+        if (m_bufIdx >= m_nodeBufs.size())
+        {
+            if (m_nodeIdx >= m_nodes.size())
+                return false;
+            readNodes();
+            continue;
+        }
+
+        char *pos = m_nodeBufs[m_bufIdx].data() + m_bufPos++ * pointLen;
+
+        // Check the bounds before touching the point so that a point
+        // that's rejected doesn't get added to the view.
+        if (!m_bounds.empty())
+        {
+            int32_t xi, yi, zi;
+            LeExtractor istream(pos, pointLen);
+            istream >> xi >> yi >> zi;
+            if (!m_bounds.contains(xi * h.scaleX() + h.offsetX(),
+                yi * h.scaleY() + h.offsetY(), zi * h.scaleZ() + h.offsetZ()))
+                continue;
+        }
+        loadPoint(point, pos, pointLen);
+        m_numRead++;
+        return true;
+    }
+    return false;
+}
+
+
+bool LasReader::canSeek() const
+{
+    if (!m_lasHeader.compressed())
+        return true;
+#ifdef PDAL_HAVE_LASZIP
+    // Compressed data can be entered part-way through only if the
+    // compressor reset itself at the start of each chunk.
+    if (m_compression == "LASZIP")
+    {
+        for (const VariableLengthRecord& vlr : m_vlrs)
+        {
+            if (!vlr.matches(LASZIP_USER_ID, LASZIP_RECORD_ID))
+                continue;
+            LASzip zip;
+            if (!zip.unpack((const unsigned char *)vlr.data(),
+                (int)vlr.dataLen()))
+                return false;
+            return zip.chunk_size != (std::numeric_limits<U32>::max)();
+        }
+    }
+#endif
+    return false;
+}
+
+
 Options LasReader::getDefaultOptions()
 {
     Options options;
@@ -613,7 +877,10 @@ void LasReader::addDimensions(PointLayoutPtr layout)
 
 bool LasReader::processOne(PointRef& point)
 {
-    if (m_index >= getNumPoints())
+    if (m_hasOctree)
+        return nextNodePoint(point);
+
+    if (m_index >= getNumPoints() || m_index - m_start >= m_count)
         return false;
 
     size_t pointLen = m_lasHeader.pointLen();
@@ -663,6 +930,22 @@ bool LasReader::processOne(PointRef& point)
 
 point_count_t LasReader::read(PointViewPtr view, point_count_t count)
 {
+    if (m_hasOctree)
+    {
+        point_count_t numRead = 0;
+        while (numRead < count)
+        {
+            PointId id = view->size();
+            PointRef point = view->point(id);
+            if (!nextNodePoint(point))
+                break;
+            if (m_cb)
+                m_cb(*view, id);
+            numRead++;
+        }
+        return numRead;
+    }
+
     size_t pointLen = m_lasHeader.pointLen();
     count = std::min(count, getNumPoints() - m_index);
 
@@ -926,6 +1209,8 @@ void LasReader::done(PointTableRef)
     m_unzipper.reset();
 #endif
     m_streamIf.reset();
+    m_nodeStreams.clear();
+    m_nodeBufs.clear();
 }
 
 } // namespace pdal
@@ -39,8 +39,10 @@
 #include <pdal/Compression.hpp>
 #include <pdal/Reader.hpp>
 
+#include "HttpStream.hpp"
 #include "LasError.hpp"
 #include "LasHeader.hpp"
+#include "LasOctree.hpp"
 #include "LasUtils.hpp"
 #include "ZipPoint.hpp"
 
@@ -66,11 +68,18 @@ protected:
 
     public:
         LasStreamIf(const std::string& filename)
-            { m_istream = FileUtils::openFile(filename); }
+        {
+            if (HttpRangeBuf::isUrl(filename))
+                m_istream = new HttpIStream(filename);
+            else
+                m_istream = FileUtils::openFile(filename);
+        }
 
         ~LasStreamIf()
         {
-            if (m_istream)
+            if (dynamic_cast<HttpIStream *>(m_istream))
+                delete m_istream;
+            else if (m_istream)
                 FileUtils::closeFile(m_istream);
         }
 
@@ -79,7 +88,9 @@ protected:
 
     friend class NitfReader;
 public:
-    LasReader() : pdal::Reader(), m_index(0)
+    LasReader() : pdal::Reader(), m_index(0), m_hasOctree(false),
+        m_resolution(0), m_threads(1), m_nodeIdx(0), m_nodeSkip(0),
+        m_bufIdx(0), m_bufPos(0), m_numRead(0)
         {}
 
     static void * create();
@@ -91,6 +102,7 @@ public:
         { return m_lasHeader; }
     point_count_t getNumPoints() const
         { return m_lasHeader.pointCount(); }
+    virtual bool canSeek() const;
 
 protected:
     virtual void createStream()
@@ -110,6 +122,14 @@ protected:
     std::unique_ptr<LasStreamIf> m_streamIf;
 
 private:
+    // Stream and decompressor used by one thread to read octree nodes.
+    struct NodeStream
+    {
+        std::unique_ptr<LasStreamIf> m_streamIf;
+        std::unique_ptr<ZipPoint> m_zipPoint;
+        std::unique_ptr<LASunzipper> m_unzipper;
+    };
+
     LasError m_error;
     LasHeader m_lasHeader;
     std::unique_ptr<ZipPoint> m_zipPoint;
@@ -121,6 +141,20 @@ private:
     std::vector<ExtraDim> m_extraDims;
     std::string m_compression;
 
+    LasOctree m_octree;
+    bool m_hasOctree;
+    BOX3D m_bounds;
+    double m_resolution;
+    size_t m_threads;
+    OctreeNodeList m_nodes;         // Nodes selected for reading.
+    size_t m_nodeIdx;               // Next node to decompress.
+    point_count_t m_nodeSkip;       // Points to skip in the next node.
+    std::vector<NodeStream> m_nodeStreams;
+    std::vector<std::vector<char>> m_nodeBufs;
+    size_t m_bufIdx;
+    point_count_t m_bufPos;
+    point_count_t m_numRead;
+
     virtual void processOptions(const Options& options);
     virtual void initialize(PointTableRef table)
         { initializeLocal(table, m_metadata); }
@@ -137,6 +171,10 @@ private:
     virtual QuickInfo inspect();
     virtual void ready(PointTableRef table);
     virtual point_count_t read(PointViewPtr view, point_count_t count);
+    virtual bool streamable() const
+        { return true; }
+    virtual bool supportsStart() const
+        { return true; }
     virtual bool processOne(PointRef& point);
     virtual void done(PointTableRef table);
     virtual bool eof()
@@ -148,6 +186,11 @@ private:
     point_count_t readFileBlock(
             std::vector<char>& buf,
             point_count_t maxPoints);
+    void readyOctree();
+    void readNode(const OctreeNode& node, NodeStream& ns,
+        std::vector<char>& buf);
+    void readNodes();
+    bool nextNodePoint(PointRef& point);
 
     LasReader& operator=(const LasReader&); // not implemented
     LasReader(const LasReader&); // not implemented
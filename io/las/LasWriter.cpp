@@ -34,6 +34,7 @@
 
 #include "LasWriter.hpp"
 
+#include <cmath>
 #include <iostream>
 
 #include <pdal/Compression.hpp>
@@ -62,7 +63,9 @@ CREATE_STATIC_PLUGIN(1, 0, LasWriter, Writer, s_info)
 
 std::string LasWriter::getName() const { return s_info.name; }
 
-LasWriter::LasWriter() : m_ostream(NULL), m_compression(LasCompression::None)
+LasWriter::LasWriter() : m_ostream(NULL), m_compression(LasCompression::None),
+    m_octree(false), m_octreeSpacing(0), m_streamTable(NULL),
+    m_xformPending(false), m_xformPoints(100000), m_heldCount(0)
 {
     m_majorVersion.setDefault(1);
     m_minorVersion.setDefault(2);
@@ -117,6 +120,8 @@ Options LasWriter::getDefaultOptions()
     options.add("creation_year", year, "4-digit year value for file");
     options.add("extra_dims", "", "Extra dimensions not part of the LAS "
         "point format to be added to each point.");
+    options.add("auto_xform_points", 100000, "Number of points examined "
+        "to choose an 'auto' scale or offset when streaming.");
 
     return options;
 }
@@ -151,6 +156,23 @@ void LasWriter::processOptions(const Options& options)
 
     fillForwardList(options);
     getHeaderOptions(options);
+
+    m_xformPoints = options.getValueOrDefault<point_count_t>(
+        "auto_xform_points", 100000);
+    if (m_xformPoints == 0)
+        throw pdal_error("writers.las: Option 'auto_xform_points' must be "
+            "greater than 0.");
+
+    m_octree = options.getValueOrDefault("octree", false);
+    m_octreeSpacing = options.getValueOrDefault("octree_spacing", 0.0);
+    if (m_octree)
+    {
+        // The hierarchy is stored in an extended VLR, which needs LAS 1.4.
+        if (m_minorVersion.valSet() && m_minorVersion.val() < 4)
+            throw pdal_error("writers.las: Octree output requires LAS "
+                "version 1.4.");
+        m_minorVersion.setVal(4);
+    }
 }
 
 
@@ -292,6 +314,7 @@ void LasWriter::readyTable(PointTableRef table)
 {
     m_forwardMetadata = table.privateMetadata("lasforward");
     setExtraBytesVlr();
+    m_streamTable = &table;
 }
 
 
@@ -361,6 +384,15 @@ void LasWriter::prepOutput(std::ostream *outStream, const SpatialReference& srs)
     // interface.
     m_pointBuf.resize(m_lasHeader.pointLen());
 
+    // When streaming, an auto scale/offset is chosen once some points
+    // have been seen.
+    m_xformPending = m_xXform.m_autoOffset || m_xXform.m_autoScale ||
+        m_yXform.m_autoOffset || m_yXform.m_autoScale ||
+        m_zXform.m_autoOffset || m_zXform.m_autoScale;
+    m_heldPoints.clear();
+    m_heldCount = 0;
+    m_heldBounds.clear();
+
     m_error.setLog(log());
 }
 
@@ -658,6 +690,10 @@ void LasWriter::readyLasZipCompression()
     m_zipPoint.reset(new ZipPoint(m_lasHeader.pointFormat(),
         m_lasHeader.pointLen()));
     m_zipper.reset(new LASzipper());
+    // Octree nodes are written as chunks of varying size.
+    if (m_octree)
+        m_zipPoint->GetZipper()->set_chunk_size(
+            (std::numeric_limits<U32>::max)());
     // Note: this will make the VLR count in the header incorrect, but we
     // rewrite that bit in finishOutput() to fix it up.
     std::vector<uint8_t> data = m_zipPoint->vlrData();
@@ -669,8 +705,8 @@ void LasWriter::readyLasZipCompression()
 void LasWriter::readyLazPerfCompression()
 {
 #ifdef PDAL_HAVE_LAZPERF
-    if (m_lasHeader.versionAtLeast(1, 4))
-        throw pdal_error("Can't write version 1.4 output with LAZperf.");
+    if (m_lasHeader.has14Format())
+        throw pdal_error("Can't write LAS 1.4 point formats with LAZperf.");
 
     laszip::factory::record_schema schema;
     schema.push(laszip::factory::record_item::POINT10);
@@ -679,6 +715,9 @@ void LasWriter::readyLazPerfCompression()
     if (m_lasHeader.hasColor())
         schema.push(laszip::factory::record_item::RGB12);
     laszip::io::laz_vlr zipvlr = laszip::io::laz_vlr::from_schema(schema);
+    // Octree nodes are written as chunks of varying size.
+    if (m_octree)
+        zipvlr.chunk_size = (std::numeric_limits<uint32_t>::max)();
     std::vector<uint8_t> data(zipvlr.size());
     zipvlr.extract((char *)data.data());
     addVlr(LASZIP_USER_ID, LASZIP_RECORD_ID, "http://laszip.org", data);
@@ -709,7 +748,25 @@ void LasWriter::openCompression()
 
 bool LasWriter::processOne(PointRef& point)
 {
-    //ABELL - Need to do something about auto offset.
+    if (m_octree)
+        throw pdal_error("writers.las: Octree output can't be written "
+            "in stream mode.");
+
+    // An auto scale/offset can't be chosen from a single point, so hold
+    // points until enough have been seen.
+    if (m_xformPending)
+    {
+        holdPoint(point);
+        if (m_heldCount >= m_xformPoints)
+            releasePoints(point);
+        return true;
+    }
+    return writePoint(point);
+}
+
+
+bool LasWriter::writePoint(PointRef& point)
+{
     LeInserter ostream(m_pointBuf.data(), m_pointBuf.size());
 
     if (!fillPointBuf(point, ostream))
@@ -725,12 +782,82 @@ bool LasWriter::processOne(PointRef& point)
 }
 
 
+// Save a copy of a point's data until the scale/offset is known.
+void LasWriter::holdPoint(PointRef& point)
+{
+    PointLayoutPtr layout = m_streamTable->layout();
+    size_t pointSize = layout->pointSize();
+
+    m_heldPoints.resize(m_heldPoints.size() + pointSize);
+    point.getPackedData(layout->dimTypes(),
+        m_heldPoints.data() + m_heldPoints.size() - pointSize);
+    m_heldCount++;
+
+    m_heldBounds.grow(point.getFieldAs<double>(Dimension::Id::X),
+        point.getFieldAs<double>(Dimension::Id::Y),
+        point.getFieldAs<double>(Dimension::Id::Z));
+}
+
+
+// Choose the scale/offset from the held points and write them, using
+// 'point' to hold the data of each in turn.
+void LasWriter::releasePoints(PointRef& point)
+{
+    // Later points may fall outside the bounds of those held, so center
+    // the offset on them and pick a scale at which they span only a
+    // sixteenth of the integer range.  X and Y share an extent since a
+    // narrow strip of points says little about the extent of the rest.
+    double xyExt = (std::max)(m_heldBounds.maxx - m_heldBounds.minx,
+        m_heldBounds.maxy - m_heldBounds.miny);
+    auto setXForm = [](XForm& xform, double min, double max, double ext)
+    {
+        if (xform.m_autoOffset)
+            xform.m_offset = (min + max) / 2;
+        ext = (std::max)(ext, (std::max)(std::fabs(max - xform.m_offset),
+            std::fabs(min - xform.m_offset)) * 2);
+        if (xform.m_autoScale && ext > 0)
+            xform.m_scale = ext * 8 / (std::numeric_limits<int32_t>::max)();
+    };
+    setXForm(m_xXform, m_heldBounds.minx, m_heldBounds.maxx, xyExt);
+    setXForm(m_yXform, m_heldBounds.miny, m_heldBounds.maxy, xyExt);
+    setXForm(m_zXform, m_heldBounds.minz, m_heldBounds.maxz,
+        m_heldBounds.maxz - m_heldBounds.minz);
+    m_xformPending = false;
+
+    log()->get(LogLevel::Debug) << getName() << ": Chose scale (" <<
+        m_xXform.m_scale << ", " << m_yXform.m_scale << ", " <<
+        m_zXform.m_scale << ") and offset (" << m_xXform.m_offset << ", " <<
+        m_yXform.m_offset << ", " << m_zXform.m_offset << ") from " <<
+        m_heldCount << " points." << std::endl;
+
+    DimTypeList dims = m_streamTable->layout()->dimTypes();
+    size_t pointSize = m_streamTable->layout()->pointSize();
+    const char *pos = m_heldPoints.data();
+    for (point_count_t i = 0; i < m_heldCount; ++i)
+    {
+        point.setPackedData(dims, pos);
+        writePoint(point);
+        pos += pointSize;
+    }
+    m_heldPoints.clear();
+    m_heldPoints.shrink_to_fit();
+    m_heldCount = 0;
+}
+
+
 void LasWriter::writeView(const PointViewPtr view)
 {
     Utils::writeProgress(m_progressFd, "READYVIEW",
         std::to_string(view->size()));
     setAutoXForm(view);
 
+    // Octree nodes are written once all the points for the file are known.
+    if (m_octree)
+    {
+        m_octreeViews.push_back(view);
+        return;
+    }
+
     size_t pointLen = m_lasHeader.pointLen();
 
     // Make a buffer of at most a meg.
@@ -944,6 +1071,13 @@ point_count_t LasWriter::fillWriteBuf(const PointView& view,
 
 void LasWriter::doneFile()
 {
+    // Write any points still held when the stream ended before enough
+    // points were seen to choose the scale/offset.
+    if (m_heldCount)
+    {
+        PointRef point(*m_streamTable, 0);
+        releasePoints(point);
+    }
     finishOutput();
     Utils::writeProgress(m_progressFd, "DONEFILE", m_curFilename);
     m_curFilename.clear();
@@ -952,8 +1086,112 @@ void LasWriter::doneFile()
 }
 
 
+// Arrange the points collected for the file into an octree and write each
+// node's points as a separate chunk, shallowest nodes first.  The node
+// locations are stored in the hierarchy EVLR.
+void LasWriter::writeOctree()
+{
+    BOX3D bounds;
+    for (auto& view : m_octreeViews)
+    {
+        BOX3D b;
+        view->calculateBounds(b);
+        bounds.grow(b);
+    }
+
+    // There's no point in cells smaller than the precision of the points.
+    double minSpacing = (std::min)(m_xXform.m_scale,
+        (std::min)(m_yXform.m_scale, m_zXform.m_scale));
+    LasOctree octree;
+    octree.initialize(bounds, m_octreeSpacing, minSpacing);
+
+    typedef std::pair<size_t, PointId> PointLoc;
+    std::map<OctreeKey, std::vector<PointLoc>> nodes;
+    for (size_t vi = 0; vi < m_octreeViews.size(); ++vi)
+    {
+        PointView& view = *m_octreeViews[vi];
+        for (PointId idx = 0; idx < view.size(); ++idx)
+        {
+            OctreeKey key = octree.assign(
+                view.getFieldAs<double>(Dimension::Id::X, idx),
+                view.getFieldAs<double>(Dimension::Id::Y, idx),
+                view.getFieldAs<double>(Dimension::Id::Z, idx));
+            nodes[key].push_back(PointLoc(vi, idx));
+        }
+    }
+
+    size_t pointLen = m_lasHeader.pointLen();
+    m_pointBuf.resize(pointLen);
+
+    // Compressed point data starts with the offset of the chunk table.
+    uint64_t offset = m_lasHeader.pointOffset();
+    if (m_compression != LasCompression::None)
+        offset += sizeof(uint64_t);
+    for (auto& n : nodes)
+    {
+        uint32_t count = 0;
+        for (auto& loc : n.second)
+        {
+            PointRef point = m_octreeViews[loc.first]->point(loc.second);
+            LeInserter ostream(m_pointBuf.data(), pointLen);
+            if (!fillPointBuf(point, ostream))
+                continue;
+            if (m_compression == LasCompression::LasZip)
+                writeLasZipBuf(m_pointBuf.data(), pointLen, 1);
+            else if (m_compression == LasCompression::LazPerf)
+                writeLazPerfBuf(m_pointBuf.data(), pointLen, 1);
+            else
+                m_ostream->write(m_pointBuf.data(), pointLen);
+            count++;
+        }
+        if (!count)
+            continue;
+        endChunk();
+
+        OctreeNode node;
+        node.m_key = n.first;
+        node.m_offset = offset;
+        offset = (uint64_t)m_ostream->tellp();
+        node.m_byteSize = (uint32_t)(offset - node.m_offset);
+        node.m_pointCount = count;
+        octree.nodes().push_back(node);
+    }
+    m_octreeViews.clear();
+
+    std::vector<uint8_t> data = octree.pack();
+    deleteVlr(OCTREE_USER_ID, OCTREE_HIERARCHY_RECORD_ID);
+    m_eVlrs.push_back(ExtVariableLengthRecord(OCTREE_USER_ID,
+        OCTREE_HIERARCHY_RECORD_ID, "Octree hierarchy", data));
+}
+
+
+// Finish the compressed chunk being written, so that the next point is
+// compressed independently of those before it.
+void LasWriter::endChunk()
+{
+#ifdef PDAL_HAVE_LASZIP
+    if (m_compression == LasCompression::LasZip && !m_zipper->chunk())
+    {
+        std::ostringstream oss;
+        const char* err = m_zipper->get_error();
+        if (err == NULL)
+            err = "(unknown error)";
+        oss << "Error writing chunk: " << std::string(err);
+        throw pdal_error(oss.str());
+    }
+#endif
+#ifdef PDAL_HAVE_LAZPERF
+    if (m_compression == LasCompression::LazPerf)
+        m_compressor->chunk();
+#endif
+}
+
+
 void LasWriter::finishOutput()
 {
+    if (m_octree)
+        writeOctree();
+
     if (m_compression == LasCompression::LasZip)
         finishLasZipOutput();
     else if (m_compression == LasCompression::LazPerf)
@@ -965,6 +1203,9 @@ void LasWriter::finishOutput()
 
     OLeStream out(m_ostream);
 
+    m_lasHeader.setEVlrOffset(m_eVlrs.size() ?
+        (uint64_t)m_ostream->tellp() : 0);
+    m_lasHeader.setEVlrCount(m_eVlrs.size());
     for (auto vi = m_eVlrs.begin(); vi != m_eVlrs.end(); ++vi)
     {
         ExtVariableLengthRecord evlr = *vi;
@@ -41,6 +41,7 @@
 #include "HeaderVal.hpp"
 #include "LasError.hpp"
 #include "LasHeader.hpp"
+#include "LasOctree.hpp"
 #include "LasUtils.hpp"
 #include "SummaryData.hpp"
 #include "ZipPoint.hpp"
@@ -102,6 +103,15 @@ private:
     bool m_forwardVlrs;
     LasCompression::Enum m_compression;
     std::vector<char> m_pointBuf;
+    bool m_octree;
+    double m_octreeSpacing;
+    std::vector<PointViewPtr> m_octreeViews;
+    BasePointTable *m_streamTable;
+    bool m_xformPending;          // Streaming auto scale/offset not yet set.
+    point_count_t m_xformPoints;  // Points to examine for auto scale/offset.
+    std::vector<char> m_heldPoints;
+    point_count_t m_heldCount;
+    BOX3D m_heldBounds;
 
     NumHeaderVal<uint8_t, 1, 1> m_majorVersion;
     NumHeaderVal<uint8_t, 1, 4> m_minorVersion;
@@ -131,9 +141,15 @@ private:
     virtual void readyFile(const std::string& filename,
         const SpatialReference& srs);
     virtual void writeView(const PointViewPtr view);
+    virtual bool streamable() const
+        { return !m_octree; }
     virtual bool processOne(PointRef& point);
     virtual void doneFile();
 
+    bool writePoint(PointRef& point);
+    void holdPoint(PointRef& point);
+    void releasePoints(PointRef& point);
+
     void fillForwardList(const Options& options);
     void getHeaderOptions(const Options& options);
     template <typename T>
@@ -146,6 +162,8 @@ private:
         std::vector<char>& buf);
     void writeLasZipBuf(char *data, size_t pointLen, point_count_t numPts);
     void writeLazPerfBuf(char *data, size_t pointLen, point_count_t numPts);
+    void writeOctree();
+    void endChunk();
     void setVlrsFromMetadata(MetadataNode& forward);
     MetadataNode findVlrMetadata(MetadataNode node, uint16_t recordId,
         const std::string& userId);
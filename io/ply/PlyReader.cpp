@@ -38,6 +38,8 @@
 
 #include <pdal/PointView.hpp>
 #include <pdal/pdal_macros.hpp>
+#include <pdal/util/FileUtils.hpp>
+#include <pdal/util/portable_endian.hpp>
 
 namespace pdal
 {
@@ -128,6 +130,33 @@ int readPlyCallback(p_ply_argument argument)
 }
 
 
+Dimension::Type::Enum plyType(const std::string& name)
+{
+    using namespace Dimension::Type;
+
+    if (name == "char" || name == "int8")
+        return Signed8;
+    if (name == "uchar" || name == "uint8")
+        return Unsigned8;
+    if (name == "short" || name == "int16")
+        return Signed16;
+    if (name == "ushort" || name == "uint16")
+        return Unsigned16;
+    if (name == "int" || name == "int32")
+        return Signed32;
+    if (name == "uint" || name == "uint32")
+        return Unsigned32;
+    if (name == "float" || name == "float32")
+        return Float;
+    if (name == "double" || name == "float64")
+        return Double;
+    return None;
+}
+
+
+// Number of vertex records read from the file at once.
+const size_t RecordBlockSize = 65536;
+
 }
 
 
@@ -149,6 +178,14 @@ std::string PlyReader::getName() const
 PlyReader::PlyReader()
     : m_ply(nullptr)
     , m_vertexDimensions()
+    , m_fixedRecords(false)
+    , m_dataOffset(0)
+    , m_recordSize(0)
+    , m_vertexCount(0)
+    , m_stream(nullptr)
+    , m_bufPos(0)
+    , m_bufEnd(0)
+    , m_index(0)
 {}
 
 
@@ -203,6 +240,77 @@ void PlyReader::initialize()
         }
     }
     ply_close(ply);
+    m_fixedRecords = readRecordLayout();
+}
+
+
+// Determine whether the vertex data can be read directly as fixed-size
+// records rather than through rply callbacks.  The file must be binary
+// little-endian, the vertex element must be the first element and it may
+// not contain list properties.
+bool PlyReader::readRecordLayout()
+{
+    std::istream *in = FileUtils::openFile(m_filename);
+    if (!in)
+        return false;
+
+    bool littleEndian = false;
+    bool inVertex = false;
+    bool fixed = false;
+    std::string line;
+
+    m_recordSize = 0;
+    m_recordProps.clear();
+    while (std::getline(*in, line))
+    {
+        Utils::trimTrailing(line);
+        StringList words = Utils::split2(line, ' ');
+        if (words.empty() || words[0] == "comment" || words[0] == "obj_info")
+            continue;
+        if (words[0] == "format")
+            littleEndian = (words.size() > 1 &&
+                words[1] == "binary_little_endian");
+        else if (words[0] == "element")
+        {
+            // Elements following the vertex element don't matter.
+            if (fixed)
+            {
+                inVertex = false;
+                continue;
+            }
+            // Only the first element can be read as fixed-size records.
+            if (words.size() != 3 || words[1] != "vertex")
+                break;
+            inVertex = true;
+            fixed = true;
+            m_vertexCount = std::stoull(words[2]);
+        }
+        else if (words[0] == "property" && inVertex)
+        {
+            Dimension::Type::Enum type = Dimension::Type::None;
+            if (words.size() == 3)
+                type = plyType(words[1]);
+            if (type == Dimension::Type::None)
+            {
+                fixed = false;
+                break;
+            }
+            auto di = m_vertexDimensions.find(words[2]);
+            if (di != m_vertexDimensions.end())
+                m_recordProps.push_back({di->second, type, m_recordSize});
+            m_recordSize += Dimension::size(type);
+        }
+        else if (words[0] == "end_header")
+        {
+            m_dataOffset = in->tellg();
+            FileUtils::closeFile(in);
+            return littleEndian && fixed && m_recordSize;
+        }
+        else if (inVertex)
+            inVertex = false;
+    }
+    FileUtils::closeFile(in);
+    return false;
 }
 
 
@@ -217,12 +325,131 @@ void PlyReader::addDimensions(PointLayoutPtr layout)
 
 void PlyReader::ready(PointTableRef table)
 {
-    m_ply = openPly(m_filename);
+    if (m_fixedRecords)
+    {
+        m_stream = FileUtils::openFile(m_filename);
+        if (!m_stream)
+        {
+            std::stringstream ss;
+            ss << "Unable to open file " << m_filename << " for reading.";
+            throw pdal_error(ss.str());
+        }
+        m_stream->seekg(m_dataOffset);
+        m_buf.resize(RecordBlockSize * m_recordSize);
+        m_bufPos = 0;
+        m_bufEnd = 0;
+        m_index = 0;
+    }
+    else
+        m_ply = openPly(m_filename);
+}
+
+
+// Return a pointer to the next vertex record, reading a block of records
+// from the file when the buffer is exhausted.
+const char *PlyReader::nextRecord()
+{
+    if (m_bufPos == m_bufEnd)
+    {
+        point_count_t remaining = m_vertexCount - m_index;
+        size_t count = (size_t)(std::min)((point_count_t)RecordBlockSize,
+            remaining);
+        m_stream->read(m_buf.data(), count * m_recordSize);
+        m_bufPos = 0;
+        m_bufEnd = (size_t)m_stream->gcount() / m_recordSize * m_recordSize;
+        if (m_bufEnd == 0)
+        {
+            std::stringstream ss;
+            ss << "Error reading " << m_filename << ": unexpected end of "
+                "vertex data.";
+            throw pdal_error(ss.str());
+        }
+    }
+    const char *rec = m_buf.data() + m_bufPos;
+    m_bufPos += m_recordSize;
+    m_index++;
+    return rec;
+}
+
+
+namespace
+{
+
+// Copy a little-endian value of the given type to host order.
+inline const void *hostValue(const char *pos, Dimension::Type::Enum type,
+    Everything& e)
+{
+    switch (Dimension::size(type))
+    {
+    case 2:
+        std::memcpy(&e.u16, pos, 2);
+        e.u16 = le16toh(e.u16);
+        break;
+    case 4:
+        std::memcpy(&e.u32, pos, 4);
+        e.u32 = le32toh(e.u32);
+        break;
+    case 8:
+        std::memcpy(&e.u64, pos, 8);
+        e.u64 = le64toh(e.u64);
+        break;
+    default:
+        std::memcpy(&e.u8, pos, 1);
+        break;
+    }
+    return &e;
+}
+
+} // unnamed namespace
+
+
+bool PlyReader::processOne(PointRef& point)
+{
+    if (!m_fixedRecords)
+    {
+        std::ostringstream oss;
+        oss << getName() << ": Point streaming is only supported for "
+            "binary little-endian files without vertex list properties.";
+        throw pdal_error(oss.str());
+    }
+    if (m_index >= m_vertexCount || m_index >= m_count)
+        return false;
+
+    const char *rec = nextRecord();
+    Everything e;
+    for (const RecordProperty& p : m_recordProps)
+        point.setField(p.m_dim, p.m_type,
+            hostValue(rec + p.m_offset, p.m_type, e));
+    return true;
+}
+
+
+point_count_t PlyReader::readRecords(PointViewPtr view, point_count_t num)
+{
+    PointId idx = view->size();
+    point_count_t cnt = 0;
+    Everything e;
+
+    while (cnt < num && m_index < m_vertexCount)
+    {
+        const char *rec = nextRecord();
+        for (const RecordProperty& p : m_recordProps)
+            view->setField(p.m_dim, p.m_type, idx,
+                hostValue(rec + p.m_offset, p.m_type, e));
+        if (m_cb)
+            m_cb(*view, idx);
+        idx++;
+        cnt++;
+    }
+    return cnt;
 }
 
 
 point_count_t PlyReader::read(PointViewPtr view, point_count_t num)
 {
+    if (m_fixedRecords)
+        return readRecords(view, num);
+
     CallbackContext context;
     context.view = view;
     context.dimensionMap = m_vertexDimensions;
@@ -248,6 +475,12 @@ point_count_t PlyReader::read(PointViewPtr view, point_count_t num)
 
 void PlyReader::done(PointTableRef table)
 {
+    if (m_fixedRecords)
+    {
+        FileUtils::closeFile(m_stream);
+        m_stream = nullptr;
+        return;
+    }
     if (!ply_close(m_ply))
     {
         std::stringstream ss;
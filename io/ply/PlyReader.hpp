@@ -34,7 +34,9 @@
 
 #pragma once
 
+#include <istream>
 #include <string>
+#include <vector>
 
 #include "rply.h"
 
@@ -66,15 +68,41 @@ public:
     static Dimension::IdList getDefaultDimensions();
 
 private:
+    // Location of a vertex property in a fixed-size binary vertex record.
+    struct RecordProperty
+    {
+        Dimension::Id::Enum m_dim;
+        Dimension::Type::Enum m_type;
+        size_t m_offset;
+    };
+
     virtual void initialize();
     virtual void addDimensions(PointLayoutPtr layout);
     virtual void ready(PointTableRef table);
+    virtual bool streamable() const
+        { return m_fixedRecords; }
+    virtual bool processOne(PointRef& point);
     virtual point_count_t read(PointViewPtr view, point_count_t num);
     virtual void done(PointTableRef table);
 
+    bool readRecordLayout();
+    point_count_t readRecords(PointViewPtr view, point_count_t num);
+    const char *nextRecord();
+
     p_ply m_ply;
     DimensionMap m_vertexDimensions;
 
+    // Binary little-endian fast path state.
+    bool m_fixedRecords;
+    std::streamoff m_dataOffset;
+    size_t m_recordSize;
+    point_count_t m_vertexCount;
+    std::vector<RecordProperty> m_recordProps;
+    std::istream *m_stream;
+    std::vector<char> m_buf;
+    size_t m_bufPos;
+    size_t m_bufEnd;
+    point_count_t m_index;
 };
 }
 
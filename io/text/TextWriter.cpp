@@ -36,6 +36,7 @@
 
 #include <pdal/pdal_export.hpp>
 #include <pdal/PointView.hpp>
+#include <pdal/PDALUtils.hpp>
 #include <pdal/util/Algorithm.hpp>
 #include <pdal/pdal_macros.hpp>
 
@@ -79,6 +80,9 @@ Options TextWriter::getDefaultOptions()
         "lines");
     options.add("quote_header", true, "Write dimension names in quotes");
     options.add("filename", "", "Filename to write CSV file to");
+    options.add("precision", 3, "Number of digits written after the "
+        "decimal point");
+    options.add("threads", 1, "Number of threads used to format points");
 
     return options;
 }
@@ -109,14 +113,13 @@ void TextWriter::processOptions(const Options& ops)
     m_quoteHeader = ops.getValueOrDefault<bool>("quote_header", true);
     m_packRgb = ops.getValueOrDefault<bool>("pack_rgb", true);
     m_precision = ops.getValueOrDefault<int>("precision", 3);
+    m_threads = ops.getValueOrDefault<int>("threads", 1);
+    Utils::checkThreads(getName(), m_threads);
 }
 
 
 void TextWriter::ready(PointTableRef table)
 {
-    m_stream->precision(m_precision);
-    *m_stream << std::fixed;
-
     // Find the dimensions listed and put them on the id list.
     StringList dimNames = Utils::split2(m_dimOrder, ',');
     for (std::string dim : dimNames)
@@ -142,6 +145,9 @@ void TextWriter::ready(PointTableRef table)
             if (!Utils::contains(m_dims, *di))
                 m_dims.push_back(*di);
     }
+    for (auto di = m_dims.begin(); di != m_dims.end(); ++di)
+        m_dimNames.push_back(table.layout()->dimName(*di));
+    m_bufs.resize(m_threads);
 
     if (!m_writeHeader)
         log()->get(LogLevel::Debug) << "Not writing header" << std::endl;
@@ -197,52 +203,115 @@ void TextWriter::writeCSVHeader(PointTableRef table)
     *m_stream << m_newline;
 }
 
-void TextWriter::writeCSVBuffer(const PointViewPtr view)
+void TextWriter::formatCSVRows(const PointView& view, PointId begin,
+    PointId end, std::string& out) const
 {
-    for (PointId idx = 0; idx < view->size(); ++idx)
+    std::vector<char> buf(Utils::fixedBufSize(m_precision));
+
+    for (PointId idx = begin; idx < end; ++idx)
     {
         for (auto di = m_dims.begin(); di != m_dims.end(); ++di)
         {
             if (di != m_dims.begin())
-                *m_stream << m_delimiter;
-            *m_stream << view->getFieldAs<double>(*di, idx);
+                out += m_delimiter;
+            char *pos = formatValue(view, *di, idx, buf.data());
+            out.append(buf.data(), pos);
         }
-        *m_stream << m_newline;
+        out += m_newline;
     }
 }
 
-void TextWriter::writeGeoJSONBuffer(const PointViewPtr view)
+
+void TextWriter::formatGeoJSONRows(const PointView& view, PointId begin,
+    PointId end, std::string& out) const
 {
     using namespace Dimension;
 
-    for (PointId idx = 0; idx < view->size(); ++idx)
+    std::vector<char> buf(3 * Utils::fixedBufSize(m_precision));
+    char *pos;
+
+    for (PointId idx = begin; idx < end; ++idx)
     {
         if (idx)
-            *m_stream << ",";
+            out += ",";
 
-        *m_stream << "{ \"type\":\"Feature\",\"geometry\": "
+        out += "{ \"type\":\"Feature\",\"geometry\": "
             "{ \"type\": \"Point\", \"coordinates\": [";
-        *m_stream << view->getFieldAs<double>(Id::X, idx) << ",";
-        *m_stream << view->getFieldAs<double>(Id::Y, idx) << ",";
-        *m_stream << view->getFieldAs<double>(Id::Z, idx) << "]},";
+        pos = formatValue(view, Id::X, idx, buf.data());
+        *pos++ = ',';
+        pos = formatValue(view, Id::Y, idx, pos);
+        *pos++ = ',';
+        pos = formatValue(view, Id::Z, idx, pos);
+        out.append(buf.data(), pos);
+        out += "]},";
 
-        *m_stream << "\"properties\": {";
+        out += "\"properties\": {";
 
-        for (auto di = m_dims.begin(); di != m_dims.end(); ++di)
+        for (size_t i = 0; i < m_dims.size(); ++i)
         {
-            if (di != m_dims.begin())
-                *m_stream << ",";
-
-            *m_stream << "\"" << view->dimName(*di) << "\":";
-            *m_stream << "\"";
-            *m_stream << view->getFieldAs<double>(*di, idx);
-            *m_stream <<"\"";
+            if (i)
+                out += ",";
+
+            out += "\"";
+            out += m_dimNames[i];
+            out += "\":\"";
+            pos = formatValue(view, m_dims[i], idx, buf.data());
+            out.append(buf.data(), pos);
+            out += "\"";
         }
-        *m_stream << "}"; // end properties
-        *m_stream << "}"; // end feature
+        out += "}"; // end properties
+        out += "}"; // end feature
+    }
+}
+
+
+// Format rows in blocks, each thread taking a block.  The formatted blocks
+// are written in order once all threads have finished.
+void TextWriter::writeRows(const PointViewPtr view, bool geojson)
+{
+    const point_count_t blockSize = 65536;
+
+    auto format = [this, &view, geojson](PointId begin, PointId end,
+        std::string& out)
+    {
+        out.clear();
+        if (geojson)
+            formatGeoJSONRows(*view, begin, end, out);
+        else
+            formatCSVRows(*view, begin, end, out);
+    };
+
+    PointId idx = 0;
+    while (idx < view->size())
+    {
+        size_t numBufs = (std::min)((point_count_t)m_bufs.size(),
+            (view->size() - idx + blockSize - 1) / blockSize);
+        Utils::parallelFor(numBufs, numBufs, [&](size_t i)
+        {
+            PointId begin = idx + i * blockSize;
+            PointId end = (std::min)(begin + blockSize, view->size());
+            format(begin, end, m_bufs[i]);
+        });
+        for (size_t i = 0; i < numBufs; ++i)
+            m_stream->write(m_bufs[i].data(), m_bufs[i].size());
+        idx = (std::min)(idx + (point_count_t)numBufs * blockSize,
+            view->size());
     }
 }
 
+
+void TextWriter::writeCSVBuffer(const PointViewPtr view)
+{
+    writeRows(view, false);
+}
+
+
+void TextWriter::writeGeoJSONBuffer(const PointViewPtr view)
+{
+    writeRows(view, true);
+}
+
+
 void TextWriter::write(const PointViewPtr view)
 {
     if (m_outputType == "CSV")
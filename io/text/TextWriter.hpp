@@ -37,6 +37,7 @@
 #include <pdal/pdal_export.hpp>
 #include <pdal/StageFactory.hpp>
 #include <pdal/util/FileUtils.hpp>
+#include <pdal/util/Utils.hpp>
 #include <pdal/Writer.hpp>
 #include <pdal/plugin.hpp>
 
@@ -77,6 +78,17 @@ private:
 
     void writeGeoJSONBuffer(const PointViewPtr view);
     void writeCSVBuffer(const PointViewPtr view);
+    void writeRows(const PointViewPtr view, bool geojson);
+    void formatCSVRows(const PointView& view, PointId begin, PointId end,
+        std::string& out) const;
+    void formatGeoJSONRows(const PointView& view, PointId begin, PointId end,
+        std::string& out) const;
+    char *formatValue(const PointView& view, Dimension::Id::Enum dim,
+        PointId idx, char *buf) const
+    {
+        return Utils::formatFixed(view.getFieldAs<double>(dim, idx),
+            m_precision, buf);
+    }
 
     std::string m_filename;
     std::string m_outputType;
@@ -89,9 +101,12 @@ private:
     bool m_quoteHeader;
     bool m_packRgb;
     int m_precision;
+    int m_threads;
 
     FileStreamPtr m_stream;
     Dimension::IdList m_dims;
+    std::vector<std::string> m_dimNames;
+    std::vector<std::string> m_bufs;
 
     TextWriter& operator=(const TextWriter&); // not implemented
     TextWriter(const TextWriter&); // not implemented
@@ -0,0 +1,236 @@
+/******************************************************************************
+* Copyright (c) 2015, Howard Butler (howard@hobu.co)
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+#include "TIndexMerger.hpp"
+
+#include <pdal/PDALUtils.hpp>
+#include <streamcallback/StreamCallbackFilter.hpp>
+
+namespace pdal
+{
+
+namespace
+{
+
+// Capacity of the table used when streaming points from each file.
+const point_count_t StreamCapacity = 10000;
+
+// Size of a packed point with the given dimensions.
+size_t packedSize(const DimTypeList& dims)
+{
+    size_t size = 0;
+    for (auto& dt : dims)
+        size += Dimension::size(dt.m_type);
+    return size;
+}
+
+} // unnamed namespace
+
+
+void TIndexMerger::addFile(const std::string& filename,
+    const std::string& srs)
+{
+    SourcePtr source(new Source);
+    source->m_filename = filename;
+    source->m_srs = srs;
+    m_sources.push_back(std::move(source));
+}
+
+
+Stage *TIndexMerger::createPipeline(Source& source, StageFactory& factory)
+{
+    std::string driver = factory.inferReaderDriver(source.m_filename);
+    Stage *reader = factory.createStage(driver);
+    if (!reader)
+    {
+        std::ostringstream out;
+        out << "Unable to create reader for file '" << source.m_filename <<
+            "'.";
+        throw pdal_error(out.str());
+    }
+    Options readerOptions;
+    readerOptions.add("filename", source.m_filename);
+    reader->setOptions(readerOptions);
+    Stage *premerge = reader;
+
+    bool reproject = (source.m_srs != m_tgtSrs);
+    if (m_skipUnknownSrs && (source.m_srs.empty() || m_tgtSrs.empty()))
+        reproject = false;
+    if (reproject)
+    {
+        Stage *repro = factory.createStage("filters.reprojection");
+        repro->setInput(*premerge);
+        Options reproOptions;
+        reproOptions.add("out_srs", m_tgtSrs);
+        reproOptions.add("in_srs", source.m_srs);
+        repro->setOptions(reproOptions);
+        premerge = repro;
+    }
+
+    if (!m_cropOptions.empty())
+    {
+        Stage *crop = factory.createStage("filters.crop");
+        crop->setOptions(m_cropOptions);
+        crop->setInput(*premerge);
+        premerge = crop;
+    }
+    return premerge;
+}
+
+
+void TIndexMerger::prepare(PointLayoutPtr layout)
+{
+    Utils::parallelFor(m_sources.size(), m_threads,
+        [this](size_t i){ prepareSource(*m_sources[i]); });
+
+    for (auto& source : m_sources)
+        for (size_t i = 0; i < source->m_dims.size(); ++i)
+            layout->registerOrAssignDim(source->m_names[i],
+                source->m_dims[i].m_type);
+}
+
+
+void TIndexMerger::read(PointView& view)
+{
+    // Files are read in groups so that no more than one file per thread
+    // is held in memory at a time.  Each file's pipeline exists only while
+    // the file is read.
+    for (size_t begin = 0; begin < m_sources.size(); begin += m_threads)
+    {
+        size_t end = (std::min)(begin + m_threads, m_sources.size());
+        Utils::parallelFor(end - begin, m_threads,
+            [this, begin](size_t i){ readSource(*m_sources[begin + i]); });
+        for (size_t i = begin; i < end; ++i)
+        {
+            copySource(*m_sources[i], view);
+            m_sources[i].reset();
+        }
+    }
+    m_sources.clear();
+}
+
+
+void TIndexMerger::prepareSource(Source& source)
+{
+    StageFactory factory;
+    Stage *premerge = createPipeline(source, factory);
+
+    PointTable table;
+    premerge->prepare(table);
+
+    PointLayoutPtr layout = table.layout();
+    source.m_dims = layout->dimTypes();
+    for (auto& dt : source.m_dims)
+        source.m_names.push_back(layout->dimName(dt.m_id));
+}
+
+
+void TIndexMerger::readSource(Source& source)
+{
+    const size_t pointSize = packedSize(source.m_dims);
+
+    // The dimensions of the file in the layout of a new table.
+    auto dimsIn = [&source](PointLayoutPtr layout)
+    {
+        DimTypeList dims;
+        for (size_t i = 0; i < source.m_dims.size(); ++i)
+            dims.push_back(DimType(layout->findDim(source.m_names[i]),
+                source.m_dims[i].m_type));
+        return dims;
+    };
+
+    StageFactory factory;
+    Stage *premerge = createPipeline(source, factory);
+    if (premerge->pipelineStreamable())
+    {
+        StreamCallbackFilter callback;
+        callback.setInput(*premerge);
+
+        FixedPointTable table(StreamCapacity);
+        callback.prepare(table);
+
+        DimTypeList dims = dimsIn(table.layout());
+        auto cb = [&source, &dims, pointSize](PointRef& point)
+        {
+            size_t pos = source.m_data.size();
+            source.m_data.resize(pos + pointSize);
+            point.getPackedData(dims, source.m_data.data() + pos);
+            source.m_count++;
+            return true;
+        };
+        callback.setCallback(cb);
+        callback.execute(table);
+    }
+    else
+    {
+        // Read the file into a point view and keep the points that
+        // survive the pipeline.
+        PointTable table;
+        premerge->prepare(table);
+        PointViewSet views = premerge->execute(table);
+
+        DimTypeList dims = dimsIn(table.layout());
+        for (auto& v : views)
+        {
+            size_t pos = source.m_data.size();
+            source.m_data.resize(pos + v->size() * pointSize);
+            char *buf = source.m_data.data() + pos;
+            for (PointId idx = 0; idx < v->size(); ++idx)
+            {
+                v->getPackedPoint(dims, idx, buf);
+                buf += pointSize;
+            }
+            source.m_count += v->size();
+        }
+    }
+}
+
+
+void TIndexMerger::copySource(Source& source, PointView& view)
+{
+    DimTypeList dims;
+    for (size_t i = 0; i < source.m_dims.size(); ++i)
+        dims.push_back(DimType(view.layout()->findDim(source.m_names[i]),
+            source.m_dims[i].m_type));
+    const size_t pointSize = packedSize(dims);
+
+    const char *buf = source.m_data.data();
+    for (point_count_t i = 0; i < source.m_count; ++i)
+    {
+        view.setPackedPoint(dims, view.size(), buf);
+        buf += pointSize;
+    }
+}
+
+} // namespace pdal
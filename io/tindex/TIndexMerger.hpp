@@ -0,0 +1,112 @@
+/******************************************************************************
+* Copyright (c) 2015, Howard Butler (howard@hobu.co)
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <pdal/Options.hpp>
+#include <pdal/PointTable.hpp>
+#include <pdal/PointView.hpp>
+#include <pdal/StageFactory.hpp>
+
+namespace pdal
+{
+
+// Reads the points of a set of files, each through optional reprojection
+// and cropping, and merges them into a single view.  Files are read
+// concurrently.  When a file's pipeline supports streaming, points are
+// cropped as they're read so that only the points that are kept are held
+// in memory.
+class PDAL_DLL TIndexMerger
+{
+public:
+    TIndexMerger() : m_threads(1), m_skipUnknownSrs(false)
+    {}
+
+    void setThreads(int threads)
+        { m_threads = (std::max)(threads, 1); }
+    void setTargetSrs(const std::string& srs)
+        { m_tgtSrs = srs; }
+    void setCropOptions(const Options& options)
+        { m_cropOptions = options; }
+
+    // By default a file is reprojected whenever its SRS in the index
+    // differs from the target SRS.  When set, files are only reprojected
+    // if both SRSs are set.
+    void setSkipUnknownSrs(bool skip)
+        { m_skipUnknownSrs = skip; }
+
+    // Add a file to be read.  If 'srs' differs from the target SRS, the
+    // file's points are reprojected from it.
+    void addFile(const std::string& filename, const std::string& srs);
+
+    // Register the dimensions of all the files in 'layout'.  Each file's
+    // pipeline is prepared to find its dimensions and then released.
+    void prepare(PointLayoutPtr layout);
+
+    // Read the files and append their points to 'view', in the order in
+    // which the files were added.
+    void read(PointView& view);
+
+private:
+    struct Source
+    {
+        Source() : m_count(0)
+        {}
+
+        std::string m_filename;
+        std::string m_srs;
+        DimTypeList m_dims;
+        StringList m_names;
+        std::vector<char> m_data;
+        point_count_t m_count;
+    };
+    typedef std::unique_ptr<Source> SourcePtr;
+
+    int m_threads;
+    bool m_skipUnknownSrs;
+    std::string m_tgtSrs;
+    Options m_cropOptions;
+    std::vector<SourcePtr> m_sources;
+
+    Stage *createPipeline(Source& source, StageFactory& factory);
+    void prepareSource(Source& source);
+    void readSource(Source& source);
+    void copySource(Source& source, PointView& view);
+};
+
+} // namespace pdal
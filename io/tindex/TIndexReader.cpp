@@ -34,6 +34,7 @@
 
 #include "TIndexReader.hpp"
 #include <pdal/GDALUtils.hpp>
+#include <pdal/PDALUtils.hpp>
 #include <pdal/pdal_macros.hpp>
 
 namespace pdal
@@ -67,6 +68,8 @@ Options TIndexReader::getDefaultOptions()
     options.add(t_srs);
     Option srs_column("srs_column", "", "Column to use for SRS");
     options.add(srs_column);
+    Option threads("threads", 1, "Number of files to read concurrently");
+    options.add(threads);
     return options;
 }
 
@@ -150,6 +153,8 @@ void TIndexReader::processOptions(const Options& options)
     m_filterSRS = options.getValueOrDefault<std::string>("filter_srs");
     m_attributeFilter = options.getValueOrDefault<std::string>("where");
     m_dialect = options.getValueOrDefault<std::string>("dialect", "OGRSQL");
+    m_threads = options.getValueOrDefault<int>("threads", 1);
+    Utils::checkThreads(getName(), m_threads);
 
     m_out_ref.reset(new gdal::SpatialRef());
 }
@@ -161,6 +166,8 @@ void TIndexReader::addDimensions(PointLayoutPtr layout)
     layout->registerDim(pdal::Dimension::Id::X);
     layout->registerDim(pdal::Dimension::Id::Y);
     layout->registerDim(pdal::Dimension::Id::Z);
+
+    m_merger.prepare(layout);
 }
 
 
@@ -248,58 +255,26 @@ void TIndexReader::initialize()
         }
     }
 
-    Options cropOptions;
+    // WKT is set even if we're using a bounding box for filtering, so
+    // can be used as a test here.
     if (m_wkt.size())
+    {
+        Options cropOptions;
         cropOptions.add("polygon", m_wkt);
+        m_merger.setCropOptions(cropOptions);
+        log()->get(LogLevel::Debug3) << "Cropping data with wkt '"
+                                     << m_wkt << "'" << std::endl;
+    }
+    m_merger.setTargetSrs(m_tgtSrsString);
+    m_merger.setSkipUnknownSrs(true);
+    m_merger.setThreads(m_threads);
 
     for (auto f : getFiles())
     {
         log()->get(LogLevel::Debug) << "Adding file "
                                     << f.m_filename
-                                    << " to merge filter" <<std::endl;
-
-        std::string driver = m_factory.inferReaderDriver(f.m_filename);
-        Stage *reader = m_factory.createStage(driver);
-        if (!reader)
-        {
-            std::stringstream out;
-            out << "Unable to create reader for file '"
-                << f.m_filename << "'.";
-            throw pdal_error(out.str());
-        }
-        Options readerOptions;
-        readerOptions.add("filename", f.m_filename);
-        reader->setOptions(readerOptions);
-        Stage *premerge = reader;
-
-        if (m_tgtSrsString != f.m_srs &&
-            (m_tgtSrsString.size() && f.m_srs.size()))
-        {
-            Stage *repro = m_factory.createStage("filters.reprojection");
-            repro->setInput(*reader);
-            Options reproOptions;
-            reproOptions.add("out_srs", m_tgtSrsString);
-            reproOptions.add("in_srs", f.m_srs);
-            log()->get(LogLevel::Debug2) << "Repro = "
-                                         << m_tgtSrsString << "/"
-                                         << f.m_srs << "!\n";
-            repro->setOptions(reproOptions);
-            premerge = repro;
-        }
-
-        // WKT is set even if we're using a bounding box for filtering, so
-        // can be used as a test here.
-        if (!m_wkt.empty())
-        {
-            Stage *crop = m_factory.createStage("filters.crop");
-            crop->setOptions(cropOptions);
-            crop->setInput(*premerge);
-            log()->get(LogLevel::Debug3) << "Cropping data with wkt '"
-                                         << m_wkt << "'" << std::endl;
-            premerge = crop;
-        }
-
-        m_merge.setInput(*premerge);
+                                    << " to merge" <<std::endl;
+        m_merger.addFile(f.m_filename, f.m_srs);
     }
 
     if (m_sql.size())
@@ -317,16 +292,13 @@ void TIndexReader::initialize()
 }
 
 
-void TIndexReader::ready(PointTableRef table)
+PointViewSet TIndexReader::run(PointViewPtr view)
 {
-    m_merge.prepare(table);
-    m_pvSet = m_merge.execute(table);
-}
+    m_merger.read(*view);
 
-
-PointViewSet TIndexReader::run(PointViewPtr)
-{
-    return m_pvSet;
+    PointViewSet viewSet;
+    viewSet.insert(view);
+    return viewSet;
 }
 
 } // namespace pdal
@@ -37,11 +37,11 @@
 #include <pdal/PointView.hpp>
 #include <pdal/Reader.hpp>
 #include <pdal/GlobalEnvironment.hpp>
-#include <merge/MergeFilter.hpp>
-#include <pdal/StageFactory.hpp>
 #include <pdal/GDALUtils.hpp>
 #include <pdal/plugin.hpp>
 
+#include "TIndexMerger.hpp"
+
 extern "C" int32_t TIndexReader_ExitFunc();
 extern "C" PF_ExitFunc TIndexReader_InitPlugin();
 
@@ -67,7 +67,7 @@ class PDAL_DLL TIndexReader : public pdal::Reader
     };
 
 public:
-    TIndexReader() : m_dataset(NULL) , m_layer(NULL)
+    TIndexReader() : m_dataset(NULL) , m_layer(NULL), m_threads(1)
         {}
 
     static void * create();
@@ -82,7 +82,6 @@ private:
     virtual void addDimensions(PointLayoutPtr layout);
     virtual void processOptions(const Options& options);
     virtual void initialize();
-    virtual void ready(PointTableRef table);
     virtual PointViewSet run(PointViewPtr view);
 
     std::string m_layerName;
@@ -101,9 +100,8 @@ private:
     void *m_dataset;
     void *m_layer;
 
-    StageFactory m_factory;
-    MergeFilter m_merge;
-    PointViewSet m_pvSet;
+    int m_threads;
+    TIndexMerger m_merger;
 
     std::vector<FileInfo> getFiles();
     FieldIndexes getFields();
@@ -35,16 +35,22 @@
 #include "InfoKernel.hpp"
 
 #include <algorithm>
+#include <mutex>
+#include <set>
 
 #include <pdal/KDIndex.hpp>
 #include <pdal/PipelineWriter.hpp>
 #include <pdal/PDALUtils.hpp>
 #include <pdal/pdal_config.hpp>
+#include <pdal/PluginManager.hpp>
 #include <pdal/StageFactory.hpp>
 #ifdef PDAL_HAVE_LIBXML2
 #include <pdal/XMLSchema.hpp>
 #endif
 #include <pdal/pdal_macros.hpp>
+#include <pdal/Reader.hpp>
+
+#include <stats/StatsFilter.hpp>
 
 namespace pdal
 {
@@ -58,8 +64,24 @@ CREATE_STATIC_PLUGIN(1, 0, InfoKernel, Kernel, s_info)
 
 std::string InfoKernel::getName() const { return s_info.name; }
 
+namespace
+{
+
+// Number of points held in memory at once when streaming.
+const point_count_t StreamCapacity = 10000;
+
+// Smallest range of points worth handing to a thread of its own.
+const point_count_t MinRangeSize = 1000000;
+
+} // unnamed namespace
+
+
 InfoKernel::InfoKernel()
-    : m_showStats(false)
+    : m_multiFile(false)
+    , m_threads(1)
+    , m_minRangeSize(MinRangeSize)
+    , m_aggregate(false)
+    , m_showStats(false)
     , m_showSchema(false)
     , m_showAll(false)
     , m_showMetadata(false)
@@ -67,6 +89,8 @@ InfoKernel::InfoKernel()
     , m_showSummary(false)
     , m_needPoints(false)
     , m_statsStage(NULL)
+    , m_hexbinStage(NULL)
+    , m_reader(NULL)
 {}
 
 
@@ -74,8 +98,15 @@ void InfoKernel::validateSwitches(ProgramArgs& args)
 {
     int functions = 0;
 
-    if (!m_usestdin && m_inputFile.empty())
+    // Several files are summarized when given a list or a wildcard.
+    m_multiFile = m_inputList.size() || m_aggregate ||
+        m_inputFile.find_first_of("*?[") != std::string::npos;
+
+    if (!m_usestdin && m_inputFile.empty() && m_inputList.empty())
         throw pdal_error("No input file specified.");
+    Utils::checkThreads(getName(), m_threads);
+    if (m_minRangeSize < 1)
+        throw pdal_error("'min-range-size' option must be at least 1.");
 
     // All isn't really all.
     if (m_showAll)
@@ -119,6 +150,9 @@ void InfoKernel::validateSwitches(ProgramArgs& args)
     if (m_showSummary && functions > 1)
         throw pdal_error("--summary option incompatible with other "
             "specified options.");
+    if (m_multiFile && !m_showSummary)
+        throw pdal_error("Multiple input files are only supported with "
+            "the --summary option.");
 }
 
 
@@ -143,6 +177,15 @@ void InfoKernel::addSwitches(ProgramArgs& args)
     args.add("pipeline-serialization", "Output file for pipeline serialization",
          m_pipelineFile);
     args.add("summary", "dump summary of the info", m_showSummary);
+    args.add("input-list", "File containing the names of files to "
+        "summarize, one per line ('STDIN' for standard input)", m_inputList);
+    args.add("threads", "Number of threads used to summarize files or "
+        "compute statistics", m_threads, 1);
+    args.add("min-range-size", "Smallest number of points for which "
+        "statistics are computed in a thread of its own", m_minRangeSize,
+        MinRangeSize).setHidden();
+    args.add("aggregate", "Summarize all the input files together after "
+        "summarizing each", m_aggregate);
     args.add("metadata", "dump file metadata info", m_showMetadata);
     args.add("pointcloudschema", "dump PointCloudSchema XML output",
         m_PointCloudSchemaOutput).setHidden();
@@ -336,7 +379,10 @@ MetadataNode InfoKernel::run(const std::string& filename)
     else
     {
         applyExtraStageOptionsRecursive(m_manager->getStage());
-        if (m_needPoints || m_showMetadata)
+        if (m_needPoints && m_pointIndexes.empty() && m_queryPoint.empty() &&
+            m_manager->getStage()->pipelineStreamable())
+            streamPoints(filename);
+        else if (m_needPoints || m_showMetadata)
             m_manager->execute();
         else
             m_manager->prepare();
@@ -350,12 +396,12 @@ MetadataNode InfoKernel::run(const std::string& filename)
 void InfoKernel::dump(MetadataNode& root)
 {
     if (m_showSchema)
-        root.add(Utils::toMetadata(m_manager->pointTable()).clone("schema"));
+        root.add(Utils::toMetadata(pointTable()).clone("schema"));
 
     if (m_PointCloudSchemaOutput.size() > 0)
     {
 #ifdef PDAL_HAVE_LIBXML2
-        XMLSchema schema(m_manager->pointTable().layout());
+        XMLSchema schema(pointTable().layout());
 
         std::ostream *out = FileUtils::createFile(m_PointCloudSchemaOutput);
         std::string xml(schema.xml());
@@ -391,11 +437,106 @@ void InfoKernel::dump(MetadataNode& root)
         root.add(m_reader->getMetadata().clone("metadata"));
 
     if (m_boundary)
-    {
-        PointViewSet viewSet = m_manager->views();
-        assert(viewSet.size() == 1);
         root.add(m_hexbinStage->getMetadata().clone("boundary"));
+}
+
+
+// The table holding the pipeline's layout and metadata.
+BasePointTable& InfoKernel::pointTable()
+{
+    if (m_streamTable)
+        return *m_streamTable;
+    return m_manager->pointTable();
+}
+
+
+// Run the pipeline a table's worth of points at a time so that memory use
+// doesn't depend on the size of the input.  When only statistics are needed
+// and the reader can seek, ranges of points are summarized in parallel
+// and the results merged into those of the pipeline's stats filter.
+void InfoKernel::streamPoints(const std::string& filename)
+{
+    Stage *stage = m_manager->getStage();
+    m_streamTable.reset(new FixedPointTable(StreamCapacity));
+
+    Reader *reader = dynamic_cast<Reader *>(m_reader);
+    point_count_t numPoints = 0;
+    point_count_t ranges = 1;
+    if (reader && m_threads > 1 && !m_boundary)
+    {
+        // Don't override a range the user has requested.
+        Options ops = extraStageOptions(reader->getName());
+        QuickInfo qi;
+        if (!ops.hasOption("start") && !ops.hasOption("count"))
+            qi = reader->preview();
+        if (qi.valid() && reader->canSeek())
+        {
+            numPoints = qi.m_pointCount;
+            ranges = (std::min)((point_count_t)m_threads,
+                numPoints / m_minRangeSize);
+        }
+    }
+
+    if (ranges > 1)
+    {
+        // The pipeline's own reader is positioned past the last point so
+        // that only the ranges contribute to the statistics.
+        Options ops;
+        ops.add("start", numPoints);
+        reader->addOptions(ops);
     }
+    stage->prepare(*m_streamTable);
+    if (ranges > 1)
+        statsByRange(filename, numPoints, ranges);
+    stage->execute(*m_streamTable);
+}
+
+
+// Compute statistics on each of 'ranges' contiguous ranges of points in
+// its own thread and merge the results into the pipeline's stats filter.
+void InfoKernel::statsByRange(const std::string& filename,
+    point_count_t numPoints, point_count_t ranges)
+{
+    std::string driver = m_reader->getName();
+    point_count_t rangeSize = numPoints / ranges +
+        ((numPoints % ranges) ? 1 : 0);
+
+    std::vector<std::unique_ptr<Stage>> readers;
+    std::vector<std::unique_ptr<Stage>> filters;
+    for (point_count_t i = 0; i < ranges; ++i)
+    {
+        readers.emplace_back(
+            static_cast<Stage *>(PluginManager::createObject(driver)));
+        filters.emplace_back(
+            static_cast<Stage *>(PluginManager::createObject("filters.stats")));
+        if (!readers.back() || !filters.back())
+            throw pdal_error("Couldn't create stages to compute statistics.");
+
+        Options ro;
+        ro.add("filename", filename);
+        ro.add("start", i * rangeSize);
+        ro.add("count", rangeSize);
+        readers.back()->setOptions(ro);
+        readers.back()->addOptions(extraStageOptions(driver));
+
+        Options so;
+        if (m_dimensions.size())
+            so.add("dimensions", m_dimensions);
+        filters.back()->setOptions(so);
+        filters.back()->addOptions(extraStageOptions("filters.stats"));
+        filters.back()->setInput(*readers.back());
+    }
+
+    Utils::parallelFor(filters.size(), filters.size(), [&](size_t i)
+    {
+        FixedPointTable table(StreamCapacity);
+        filters[i]->prepare(table);
+        filters[i]->execute(table);
+    });
+
+    StatsFilter *stats = static_cast<StatsFilter *>(m_statsStage);
+    for (auto& f : filters)
+        stats->merge(static_cast<StatsFilter&>(*f));
 }
 
 
@@ -459,8 +600,127 @@ MetadataNode InfoKernel::dumpQuery(PointViewPtr inView) const
 }
 
 
+StringList InfoKernel::inputFiles()
+{
+    StringList files;
+
+    if (m_inputFile.size())
+    {
+        StringList matches = FileUtils::glob(m_inputFile);
+        if (matches.empty())
+            throw pdal_error("No files match '" + m_inputFile + "'.");
+        files.insert(files.end(), matches.begin(), matches.end());
+    }
+
+    if (m_inputList.size())
+    {
+        std::istream *in = FileUtils::openFile(m_inputList, false);
+        if (!in)
+            throw pdal_error("Can't open input list '" + m_inputList + "'.");
+        std::string line;
+        while (std::getline(*in, line))
+        {
+            Utils::trimLeading(line);
+            Utils::trimTrailing(line);
+            if (line.size())
+                files.push_back(line);
+        }
+        FileUtils::closeFile(in);
+    }
+    return files;
+}
+
+
+// Read only what's needed for a summary, without a pipeline.
+QuickInfo InfoKernel::quickInfo(const std::string& filename)
+{
+    std::string driver = StageFactory::inferReaderDriver(filename);
+    if (driver.empty())
+        throw pdal_error("Cannot determine input file type of " + filename);
+
+    std::unique_ptr<Stage> reader(
+        static_cast<Stage *>(PluginManager::createObject(driver)));
+    if (!reader)
+        throw pdal_error("Couldn't create reader stage of type '" +
+            driver + "'.");
+
+    Options ro;
+    ro.add("filename", filename);
+    reader->setOptions(ro);
+    reader->addOptions(extraStageOptions(driver));
+
+    QuickInfo qi = reader->preview();
+    if (!qi.valid())
+        throw pdal_error("Summary information isn't available for " +
+            driver + ".");
+    return qi;
+}
+
+
+// Write a line of JSON with the summary of each file, as each completes,
+// followed by an aggregate summary if requested.
+void InfoKernel::summarizeFiles(const StringList& files)
+{
+    std::mutex mutex;
+
+    QuickInfo total;
+    std::set<std::string> dims;
+    point_count_t numFiles(0);
+    point_count_t numErrors(0);
+
+    Utils::parallelFor(files.size(), m_threads, [&](size_t i)
+    {
+        MetadataNode root;
+        root.add("filename", files[i]);
+
+        QuickInfo qi;
+        try
+        {
+            qi = quickInfo(files[i]);
+            root.add(dumpSummary(qi).clone("summary"));
+        }
+        catch (std::exception& err)
+        {
+            root.add("error", err.what());
+        }
+        std::string line = Utils::toJSONLine(root);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        std::cout << line << std::endl;
+        if (qi.valid())
+        {
+            numFiles++;
+            total.m_pointCount += qi.m_pointCount;
+            total.m_bounds.grow(qi.m_bounds);
+            dims.insert(qi.m_dimNames.begin(), qi.m_dimNames.end());
+        }
+        else
+            numErrors++;
+    });
+
+    if (m_aggregate)
+    {
+        total.m_dimNames.assign(dims.begin(), dims.end());
+        MetadataNode summary = dumpSummary(total);
+        summary.add("num_files", numFiles);
+        summary.add("num_errors", numErrors);
+
+        MetadataNode root;
+        root.add(summary.clone("aggregate"));
+        root.add("pdal_version", pdal::GetFullVersionString());
+        std::cout << Utils::toJSONLine(root) << std::endl;
+    }
+}
+
+
 int InfoKernel::execute()
 {
+    if (m_multiFile)
+    {
+        summarizeFiles(inputFiles());
+        return 0;
+    }
+
     std::string filename = m_usestdin ? std::string("STDIN") : m_inputFile;
     setup(filename);
     MetadataNode root = run(filename);
@@ -80,8 +80,20 @@ private:
     MetadataNode dumpSummary(const QuickInfo& qi);
     MetadataNode dumpQuery(PointViewPtr inView) const;
     PipelineManagerPtr makePipeline(const std::string& filename, bool noPoints);
+    StringList inputFiles();
+    QuickInfo quickInfo(const std::string& filename);
+    void summarizeFiles(const StringList& files);
+    void streamPoints(const std::string& filename);
+    void statsByRange(const std::string& filename, point_count_t numPoints,
+        point_count_t ranges);
+    BasePointTable& pointTable();
 
     std::string m_inputFile;
+    std::string m_inputList;
+    bool m_multiFile;
+    int m_threads;
+    point_count_t m_minRangeSize;
+    bool m_aggregate;
     bool m_showStats;
     bool m_showSchema;
     bool m_showAll;
@@ -101,6 +113,7 @@ private:
 
     MetadataNode m_tree;
     PipelineManagerPtr m_manager;
+    std::unique_ptr<FixedPointTable> m_streamTable;
 };
 
 } // namespace pdal
@@ -52,7 +52,8 @@ CREATE_STATIC_PLUGIN(1, 0, PipelineKernel, Kernel, s_info)
 
 std::string PipelineKernel::getName() const { return s_info.name; }
 
-PipelineKernel::PipelineKernel() : m_validate(false), m_progressFd(-1)
+PipelineKernel::PipelineKernel() : m_validate(false), m_progressFd(-1),
+    m_spillMemory(1024), m_profile(false)
 {}
 
 
@@ -63,6 +64,9 @@ void PipelineKernel::validateSwitches(ProgramArgs& args)
 
     if (m_inputFile.empty())
         throw pdal_error("Input filename required.");
+
+    if (m_spillMemory < 1)
+        throw pdal_error("Spill memory must be at least 1 megabyte.");
 }
 
 
@@ -80,6 +84,12 @@ void PipelineKernel::addSwitches(ProgramArgs& args)
         m_progressFile);
     args.add("pointcloudschema", "dump PointCloudSchema XML output",
         m_PointCloudSchemaOutput).setHidden();
+    args.add("spill-dir", "Store point data in a memory-mapped file in "
+        "this directory instead of in memory", m_spillDir);
+    args.add("spill-memory", "Megabytes of point data to keep in memory "
+        "when using a spill file", m_spillMemory, 1024);
+    args.add("profile", "Write execution statistics of each stage as JSON "
+        "to standard output", m_profile);
 }
 
 int PipelineKernel::execute()
@@ -89,18 +99,33 @@ int PipelineKernel::execute()
     if (m_progressFile.size())
         m_progressFd = Utils::openProgress(m_progressFile);
 
-    pdal::PipelineManager manager(m_progressFd);
+    std::unique_ptr<BasePointTable> table;
+    std::unique_ptr<PipelineManager> managerPtr;
+    if (m_spillDir.size())
+    {
+        table.reset(new MmapPointTable(m_spillDir,
+            (std::size_t)m_spillMemory * 1024 * 1024));
+        managerPtr.reset(new PipelineManager(*table, m_progressFd));
+    }
+    else
+        managerPtr.reset(new PipelineManager(m_progressFd));
+    PipelineManager& manager(*managerPtr);
+
     bool isWriter = manager.readPipeline(m_inputFile);
     if (!isWriter)
         throw pdal_error("Pipeline file does not contain a writer. "
             "Use 'pdal info' to read the data.");
 
     applyExtraStageOptionsRecursive(manager.getStage());
+    manager.setProfiling(m_profile);
     manager.execute();
 
     if (m_pipelineFile.size() > 0)
         PipelineWriter::writePipeline(manager.getStage(), m_pipelineFile);
 
+    if (m_profile)
+        Utils::toJSON(manager.getProfile(), std::cout);
+
     if (m_PointCloudSchemaOutput.size() > 0)
     {
 #ifdef PDAL_HAVE_LIBXML2
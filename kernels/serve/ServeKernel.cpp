@@ -0,0 +1,450 @@
+/******************************************************************************
+* Copyright (c) 2015, Howard Butler (howard@hobu.co)
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+#include "ServeKernel.hpp"
+
+#include <pdal/PDALUtils.hpp>
+#include <pdal/PipelineManager.hpp>
+#include <pdal/pdal_macros.hpp>
+
+#ifndef WIN32
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+namespace pdal
+{
+
+static PluginInfo const s_info = PluginInfo(
+    "kernels.serve",
+    "Serve Kernel",
+    "http://pdal.io/kernels/kernels.serve.html" );
+
+CREATE_STATIC_PLUGIN(1, 0, ServeKernel, Kernel, s_info)
+
+std::string ServeKernel::getName() const { return s_info.name; }
+
+// A client connection.  Requests are read a line at a time and responses
+// from concurrently running jobs are serialized by the connection.
+class ServeKernel::Connection
+{
+public:
+    virtual ~Connection()
+    {}
+
+    virtual bool getline(std::string& line) = 0;
+
+    void write(const std::string& s)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        put(s);
+    }
+
+protected:
+    virtual void put(const std::string& s) = 0;
+
+private:
+    std::mutex m_mutex;
+};
+
+namespace
+{
+
+class StreamConnection : public ServeKernel::Connection
+{
+public:
+    StreamConnection(std::istream& in, std::ostream& out) :
+        m_in(in), m_out(out)
+    {}
+
+    bool getline(std::string& line)
+        { return (bool)std::getline(m_in, line); }
+
+protected:
+    void put(const std::string& s)
+        { m_out << s << std::flush; }
+
+private:
+    std::istream& m_in;
+    std::ostream& m_out;
+};
+
+#ifndef WIN32
+class SocketConnection : public ServeKernel::Connection
+{
+public:
+    SocketConnection(int fd) : m_fd(fd), m_pos(0)
+    {}
+
+    ~SocketConnection()
+        { close(m_fd); }
+
+    bool getline(std::string& line)
+    {
+        while (true)
+        {
+            auto end = m_buf.find('\n', m_pos);
+            if (end != std::string::npos)
+            {
+                line = m_buf.substr(m_pos, end - m_pos);
+                m_pos = end + 1;
+                return true;
+            }
+            m_buf.erase(0, m_pos);
+            m_pos = 0;
+
+            char buf[4096];
+            ssize_t cnt = ::read(m_fd, buf, sizeof(buf));
+            if (cnt <= 0)
+            {
+                // Return a final unterminated line.
+                line.swap(m_buf);
+                m_buf.clear();
+                return line.size();
+            }
+            m_buf.append(buf, cnt);
+        }
+    }
+
+protected:
+    void put(const std::string& s)
+    {
+#ifdef MSG_NOSIGNAL
+        const int flags = MSG_NOSIGNAL;
+#else
+        const int flags = 0;
+#endif
+        // A client that went away doesn't stop the job or the server.
+        const char *pos = s.data();
+        size_t left = s.size();
+        while (left)
+        {
+            ssize_t cnt = send(m_fd, pos, left, flags);
+            if (cnt <= 0)
+                break;
+            pos += cnt;
+            left -= cnt;
+        }
+    }
+
+private:
+    int m_fd;
+    std::string m_buf;
+    std::string::size_type m_pos;
+};
+#endif
+
+} // unnamed namespace
+
+
+ServeKernel::ServeKernel() : m_threads(1), m_profile(false),
+    m_hugePages(false), m_retainMemory(256), m_nextId(1), m_done(false)
+{}
+
+
+void ServeKernel::addSwitches(ProgramArgs& args)
+{
+    args.add("socket", "Listen for pipelines on this local (Unix domain) "
+        "socket instead of reading them from standard input", m_socket);
+    args.add("threads", "Number of pipelines to run concurrently",
+        m_threads, 1);
+    args.add("profile", "Include execution statistics of each stage in "
+        "the response", m_profile);
+    args.add("huge-pages", "Request huge pages for point storage",
+        m_hugePages);
+    args.add("retain-memory", "Megabytes of point storage each worker, and "
+        "the pool shared by the workers, keep for reuse between jobs",
+        m_retainMemory, 256);
+}
+
+
+void ServeKernel::validateSwitches(ProgramArgs& args)
+{
+    Utils::checkThreads(getName(), m_threads);
+    if (m_retainMemory < 0)
+        throw pdal_error("'retain-memory' option can't be negative.");
+#ifdef WIN32
+    if (m_socket.size())
+        throw pdal_error("'socket' option isn't supported on this platform.");
+#endif
+}
+
+
+int ServeKernel::execute()
+{
+    // Point storage released by one job is handed to the next.
+    m_allocator.reset(new PoolBlockAllocator(m_hugePages,
+        retainBytes()));
+
+    std::vector<std::thread> workers;
+    for (int i = 0; i < m_threads; ++i)
+        workers.push_back(std::thread(&ServeKernel::work, this));
+
+    if (m_socket.size())
+        serveSocket();
+    else
+        readRequests(ConnectionPtr(new StreamConnection(std::cin, std::cout)));
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_done = true;
+    }
+    m_cv.notify_all();
+    for (auto& t : workers)
+        t.join();
+    return 0;
+}
+
+
+void ServeKernel::serveSocket()
+{
+#ifndef WIN32
+    sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (m_socket.size() >= sizeof(addr.sun_path))
+        throw pdal_error("Socket name '" + m_socket + "' is too long.");
+    strncpy(addr.sun_path, m_socket.c_str(), sizeof(addr.sun_path) - 1);
+
+    // Replace a socket left behind by an earlier server, but nothing else.
+    struct stat statbuf;
+    if (stat(m_socket.c_str(), &statbuf) == 0 && S_ISSOCK(statbuf.st_mode))
+        unlink(m_socket.c_str());
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0 || bind(fd, (sockaddr *)&addr, sizeof(addr)) != 0 ||
+        listen(fd, SOMAXCONN) != 0)
+    {
+        std::string err(strerror(errno));
+        if (fd >= 0)
+            close(fd);
+        throw pdal_error("Can't listen on socket '" + m_socket + "': " +
+            err + ".");
+    }
+
+    while (true)
+    {
+        int conn = accept(fd, NULL, NULL);
+        if (conn < 0)
+        {
+            if (errno == EINTR || errno == ECONNABORTED)
+                continue;
+            std::string err(strerror(errno));
+            close(fd);
+            throw pdal_error("Error accepting connection on socket '" +
+                m_socket + "': " + err + ".");
+        }
+#ifdef SO_NOSIGPIPE
+        int on(1);
+        setsockopt(conn, SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
+#endif
+        ConnectionPtr c(new SocketConnection(conn));
+        std::thread(&ServeKernel::readRequests, this, c).detach();
+    }
+#endif
+}
+
+
+// A request is the text of a pipeline (or the name of a pipeline file)
+// terminated by a line containing only "." or by the end of input.
+void ServeKernel::readRequests(ConnectionPtr conn)
+{
+    std::string line;
+    std::string request;
+
+    while (true)
+    {
+        bool more = conn->getline(line);
+        if (line.size() && line.back() == '\r')
+            line.pop_back();
+        if (more && line != ".")
+        {
+            request += line + "\n";
+            continue;
+        }
+
+        Utils::trimLeading(request);
+        Utils::trimTrailing(request);
+        if (request.size())
+        {
+            Job job { m_nextId++, request, conn };
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_jobs.push_back(job);
+            }
+            m_cv.notify_one();
+        }
+        request.clear();
+        if (!more)
+            break;
+    }
+}
+
+
+std::size_t ServeKernel::retainBytes() const
+{
+    return (std::size_t)m_retainMemory * 1024 * 1024;
+}
+
+
+void ServeKernel::work()
+{
+    // Each worker keeps its point table, and so its storage, between jobs.
+    // Storage beyond the high-water mark is given back after a job so that
+    // one large job doesn't pin memory for the life of the server.
+    PointTable table(m_allocator);
+
+    while (true)
+    {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cv.wait(lock, [this](){ return m_done || m_jobs.size(); });
+            if (m_jobs.empty())
+                return;
+            job = m_jobs.front();
+            m_jobs.pop_front();
+        }
+        runJob(job, table);
+        table.reset();
+        table.trim(retainBytes());
+    }
+}
+
+
+void ServeKernel::runJob(Job& job, PointTable& table)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    MetadataNode running;
+    running.add("id", job.m_id);
+    running.add("status", "running");
+    respond(job, running);
+
+    // Relay stage progress messages ("TYPE:text") to the client.
+    int progress[2] = { -1, -1 };
+    std::thread relay;
+#ifndef WIN32
+    if (pipe(progress) == 0)
+    {
+        relay = std::thread([this, &job, &progress]()
+        {
+            std::string buf;
+            char c;
+            while (::read(progress[0], &c, 1) == 1)
+            {
+                if (c != '\n')
+                {
+                    buf += c;
+                    continue;
+                }
+                MetadataNode event;
+                event.add("id", job.m_id);
+                event.add("status", "progress");
+                auto pos = buf.find(':');
+                event.add("type", buf.substr(0, pos));
+                if (pos != std::string::npos)
+                    event.add("text", buf.substr(pos + 1));
+                respond(job, event);
+                buf.clear();
+            }
+        });
+    }
+#endif
+
+    MetadataNode result;
+    result.add("id", job.m_id);
+    try
+    {
+        table.reset();
+        PipelineManager manager(table, progress[1]);
+        if (job.m_pipeline[0] == '<')
+        {
+            std::istringstream in(job.m_pipeline);
+            manager.readPipeline(in);
+        }
+        else
+            manager.readPipeline(job.m_pipeline);
+        if (!manager.getStage())
+            throw pdal_error("Pipeline contains no stages.");
+
+        applyExtraStageOptionsRecursive(manager.getStage());
+        manager.setProfiling(m_profile);
+        point_count_t count = manager.execute();
+
+        result.add("status", "done");
+        result.add("points", count);
+        result.add(manager.getMetadata());
+        if (m_profile)
+            result.add(manager.getProfile());
+    }
+    catch (std::exception& err)
+    {
+        result.add("status", "error");
+        result.add("message", err.what());
+    }
+
+#ifndef WIN32
+    if (relay.joinable())
+    {
+        close(progress[1]);
+        relay.join();
+        close(progress[0]);
+    }
+#endif
+
+    std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    result.add("elapsed", elapsed.count());
+    respond(job, result);
+}
+
+
+// Each response is a single line of JSON.
+void ServeKernel::respond(Job& job, MetadataNode& event)
+{
+    job.m_conn->write(Utils::toJSONLine(event) + "\n");
+}
+
+} // namespace pdal
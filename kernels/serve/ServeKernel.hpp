@@ -0,0 +1,104 @@
+/******************************************************************************
+* Copyright (c) 2015, Howard Butler (howard@hobu.co)
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+#pragma once
+
+#include <pdal/BlockAllocator.hpp>
+#include <pdal/Kernel.hpp>
+#include <pdal/plugin.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+
+extern "C" int32_t ServeKernel_ExitFunc();
+extern "C" PF_ExitFunc ServeKernel_InitPlugin();
+
+namespace pdal
+{
+
+class MetadataNode;
+class PointTable;
+
+// Runs pipelines submitted on standard input or a local socket without
+// restarting the process, so plugins, GDAL state and parsed spatial
+// references stay loaded between jobs.
+class PDAL_DLL ServeKernel : public Kernel
+{
+public:
+    class Connection;
+    typedef std::shared_ptr<Connection> ConnectionPtr;
+
+    static void * create();
+    static int32_t destroy(void *);
+    std::string getName() const;
+    int execute();
+
+private:
+    struct Job
+    {
+        uint64_t m_id;
+        std::string m_pipeline;
+        ConnectionPtr m_conn;
+    };
+
+    ServeKernel();
+    void addSwitches(ProgramArgs& args);
+    void validateSwitches(ProgramArgs& args);
+
+    void serveSocket();
+    void readRequests(ConnectionPtr conn);
+    void work();
+    void runJob(Job& job, PointTable& table);
+    void respond(Job& job, MetadataNode& event);
+    std::size_t retainBytes() const;
+
+    std::string m_socket;
+    int m_threads;
+    bool m_profile;
+    bool m_hugePages;
+    int m_retainMemory;
+    BlockAllocatorPtr m_allocator;
+
+    std::atomic<uint64_t> m_nextId;
+    std::deque<Job> m_jobs;
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    bool m_done;
+};
+
+} // namespace pdal
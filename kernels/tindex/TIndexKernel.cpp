@@ -35,18 +35,22 @@
 #include "TIndexKernel.hpp"
 
 #ifndef WIN32
-#include <glob.h>
 #include <time.h>
 #endif
 
+#include <ctime>
+#include <exception>
 #include <memory>
+#include <set>
 #include <vector>
 
 #include <pdal/GlobalEnvironment.hpp>
 #include <pdal/KernelFactory.hpp>
 #include <pdal/util/FileUtils.hpp>
-#include <merge/MergeFilter.hpp>
+#include <buffer/BufferReader.hpp>
+#include <tindex/TIndexMerger.hpp>
 #include <pdal/PDALUtils.hpp>
+#include <pdal/PointTable.hpp>
 #include <pdal/StageFactory.hpp>
 #include <pdal/pdal_macros.hpp>
 
@@ -63,6 +67,24 @@ void setDate(OGRFeatureH feature, const tm& tyme, int fieldNumber)
 }
 
 
+// Cache entries are stored one per line as tab-separated fields, so values
+// containing either separator can't be cached.
+bool cacheable(const std::string& s)
+{
+    return s.find_first_of("\t\n\r") == std::string::npos;
+}
+
+
+// Single-line form of a set of options for use in a cache key.
+std::string optionsKey(const pdal::Options& ops)
+{
+    std::ostringstream oss;
+    for (auto& op : ops.getOptions())
+        oss << op.getName() << "=" << op.getValue<std::string>() << ";";
+    return oss.str();
+}
+
+
 } // anonymous namespace
 
 
@@ -86,6 +108,7 @@ TIndexKernel::TIndexKernel()
     , m_dataset(NULL)
     , m_layer(NULL)
     , m_fastBoundary(false)
+    , m_threads(1)
 
 {
     m_log.setLeader("pdal tindex");
@@ -95,9 +118,9 @@ TIndexKernel::TIndexKernel()
 void TIndexKernel::addSwitches(ProgramArgs& args)
 {
     args.add("tindex", "OGR-readable/writeable tile index output",
-        m_idxFilename).setOptionalPositional();
+        m_idxFilename).setPositional();
     args.add("filespec", "Build: Pattern of files to index. "
-        "Merge: Output filename", m_filespec).setPositional();
+        "Merge: Output filename", m_filespec).setOptionalPositional();
     args.add("fast_boundary", "Use extent instead of exact boundary",
         m_fastBoundary);
     args.add("lyr_name", "OGR layer name to write into datasource",
@@ -116,6 +139,10 @@ void TIndexKernel::addSwitches(ProgramArgs& args)
         "Write absolute rather than relative file paths", m_absPath);
     args.add("merge", "Whether we're merging the entries in a tindex file.",
         m_merge);
+    args.add("threads", "Number of files to read concurrently when building "
+        "index", m_threads, 1);
+    args.add("boundary_cache", "File in which to cache boundaries of "
+        "indexed files between runs", m_cacheFilename);
 }
 
 
@@ -153,6 +180,7 @@ void TIndexKernel::validateSwitches(ProgramArgs& args)
             throw pdal_error("'bounds' option not supported when building "
                 "index.");
     }
+    Utils::checkThreads(getName(), m_threads);
 }
 
 
@@ -181,22 +209,11 @@ int TIndexKernel::execute()
 
 StringList TIndexKernel::glob(std::string& path)
 {
-    StringList filenames;
+    StringList filenames = FileUtils::glob(path);
 
-#ifndef WIN32
-    glob_t glob_result;
-
-    ::glob(path.c_str(), GLOB_TILDE, NULL, &glob_result);
-    for (unsigned int i = 0; i < glob_result.gl_pathc; ++i)
-    {
-        std::string filename = glob_result.gl_pathv[i];
-        if (m_absPath)
+    if (m_absPath)
+        for (auto& filename : filenames)
             filename = FileUtils::toAbsolutePath(filename);
-        filenames.push_back(filename);
-    }
-    globfree(&glob_result);
-#endif
-
     return filenames;
 }
 
@@ -213,18 +230,26 @@ StringList readSTDIN()
 }
 
 
-bool TIndexKernel::isFileIndexed(const FieldIndexes& indexes,
-    const FileInfo& fileInfo)
+bool TIndexKernel::isFileIndexed(const std::string& filename)
 {
+    // OGR SQL takes double-quoted text as a field name, so the filename
+    // must be a single-quoted literal.
+    std::string literal;
+    for (char c : filename)
+    {
+        if (c == '\'')
+            literal += '\'';
+        literal += c;
+    }
     std::ostringstream qstring;
-    qstring << Utils::toupper(m_tileIndexColumnName) << "=\"" <<
-        fileInfo.m_filename << "\"";
+    qstring << Utils::toupper(m_tileIndexColumnName) << "='" <<
+        literal << "'";
     OGRErr err = OGR_L_SetAttributeFilter(m_layer, qstring.str().c_str());
     if (err != OGRERR_NONE)
     {
         std::ostringstream oss;
         oss << "Unable to set attribute filter for file '" <<
-             fileInfo.m_filename << "'";
+             filename << "'";
         throw pdal_error(oss.str());
     }
 
@@ -280,26 +305,164 @@ void TIndexKernel::createFile()
 
     FieldIndexes indexes = getFields();
 
-    KernelFactory factory(false);
+    // Check the index before reading anything so that files that are
+    // already indexed cost only a lookup.
+    StringList files;
+    std::set<std::string> seen;
     for (auto f : m_files)
     {
         //ABELL - Not sure why we need to get absolute path here.
         f = FileUtils::toAbsolutePath(f);
-        FileInfo info = getFileInfo(factory, f);
-        if (!isFileIndexed(indexes, info))
+        if (seen.insert(f).second && !isFileIndexed(f))
+            files.push_back(f);
+    }
+
+    loadCache();
+
+    // Files are read in chunks so that the number of file infos held in
+    // memory is bounded no matter how many files are being indexed.
+    const size_t chunkSize = m_threads * 16;
+    for (size_t start = 0; start < files.size(); start += chunkSize)
+    {
+        size_t end = (std::min)(start + chunkSize, files.size());
+        StringList chunk(files.begin() + start, files.begin() + end);
+
+        std::vector<FileInfo> infos(chunk.size());
+        std::vector<std::exception_ptr> errors(chunk.size());
+        getFileInfos(chunk, infos, errors);
+
+        // OGR layers aren't thread-safe, so features are created here, in
+        // the order in which the files were provided.
+        for (size_t i = 0; i < chunk.size(); ++i)
         {
+            if (errors[i])
+            {
+                saveCache();
+                std::rethrow_exception(errors[i]);
+            }
+
+            FileInfo& info = infos[i];
+            CacheEntry& entry = m_cache[info.m_filename];
+            entry.m_key = cacheKey(info);
+            entry.m_srs = info.m_srs;
+            entry.m_boundary = info.m_boundary;
+
             if (createFeature(indexes, info))
-                m_log.get(LogLevel::Info) << "Indexed file " << f << std::endl;
+                m_log.get(LogLevel::Info) << "Indexed file " <<
+                    info.m_filename << std::endl;
             else
                 m_log.get(LogLevel::Error) << "Failed to create feature for "
-                    "file '" << f << "'" << std::endl;
-
+                    "file '" << info.m_filename << "'" << std::endl;
         }
     }
+    saveCache();
     OGR_DS_Destroy(m_dataset);
 }
 
 
+void TIndexKernel::getFileInfos(const StringList& filenames,
+    std::vector<FileInfo>& infos, std::vector<std::exception_ptr>& errors)
+{
+    auto work = [&](size_t i)
+    {
+        try
+        {
+            infos[i] = getFileInfo(filenames[i]);
+        }
+        catch (...)
+        {
+            errors[i] = std::current_exception();
+        }
+    };
+    Utils::parallelFor(filenames.size(), m_threads, work);
+}
+
+
+std::string TIndexKernel::cacheKey(const FileInfo& fileInfo)
+{
+    char mtime[64];
+    strftime(mtime, sizeof(mtime), "%Y-%m-%dT%H:%M:%S", &fileInfo.m_mtime);
+
+    // Options given for the reader (and for hexbin when computing exact
+    // boundaries) change the result, so they're part of the key.
+    std::string driver =
+        StageFactory::inferReaderDriver(fileInfo.m_filename);
+    std::ostringstream key;
+    key << mtime << "/" << FileUtils::fileSize(fileInfo.m_filename) << "/" <<
+        (m_fastBoundary ? "fast" : "exact") << "/" << driver << ":" <<
+        optionsKey(extraStageOptions(driver));
+    if (!m_fastBoundary)
+        key << "/filters.hexbin:" <<
+            optionsKey(extraStageOptions("filters.hexbin"));
+    return key.str();
+}
+
+
+void TIndexKernel::loadCache()
+{
+    if (m_cacheFilename.empty() || !FileUtils::fileExists(m_cacheFilename))
+        return;
+
+    std::istream *in = FileUtils::openFile(m_cacheFilename, false);
+    if (!in)
+    {
+        std::ostringstream oss;
+        oss << "Unable to open boundary cache file '" << m_cacheFilename <<
+            "'.";
+        throw pdal_error(oss.str());
+    }
+
+    std::string line;
+    while (std::getline(*in, line))
+    {
+        StringList fields = Utils::split(line, '\t');
+        if (fields.size() != 4)
+        {
+            m_log.get(LogLevel::Warning) << "Ignoring invalid entry in "
+                "boundary cache file '" << m_cacheFilename << "'." <<
+                std::endl;
+            continue;
+        }
+        // Drop entries for files that have been removed so that the cache
+        // doesn't grow without bound.
+        if (!FileUtils::fileExists(fields[0]))
+            continue;
+        CacheEntry& entry = m_cache[fields[0]];
+        entry.m_key = fields[1];
+        entry.m_srs = fields[2];
+        entry.m_boundary = fields[3];
+    }
+    FileUtils::closeFile(in);
+}
+
+
+void TIndexKernel::saveCache()
+{
+    if (m_cacheFilename.empty())
+        return;
+
+    std::ostream *out = FileUtils::createFile(m_cacheFilename, false);
+    if (!out)
+    {
+        std::ostringstream oss;
+        oss << "Unable to create boundary cache file '" << m_cacheFilename <<
+            "'.";
+        throw pdal_error(oss.str());
+    }
+
+    for (auto& c : m_cache)
+    {
+        const CacheEntry& entry = c.second;
+        if (!cacheable(c.first) || !cacheable(entry.m_srs) ||
+            !cacheable(entry.m_boundary))
+            continue;
+        *out << c.first << "\t" << entry.m_key << "\t" << entry.m_srs <<
+            "\t" << entry.m_boundary << "\n";
+    }
+    FileUtils::closeFile(out);
+}
+
+
 void TIndexKernel::mergeFile()
 {
     using namespace gdal;
@@ -356,54 +519,25 @@ void TIndexKernel::mergeFile()
         OGR_F_Destroy(feature);
     }
 
-    StageFactory factory;
-
-    MergeFilter merge;
-
-    Options cropOptions;
-    if (!m_bounds.empty())
-        cropOptions.add("bounds", m_bounds);
-    else
-        cropOptions.add("polygon", m_wkt);
-
-    for (auto f : files)
+    // Files are read concurrently and cropped as they're read when
+    // possible.
+    TIndexMerger merger;
+    merger.setThreads(m_threads);
+    merger.setTargetSrs(m_tgtSrsString);
+    if (!m_wkt.empty())
     {
-        Stage *premerge = NULL;
-        std::string driver = factory.inferReaderDriver(f.m_filename);
-        Stage *reader = factory.createStage(driver);
-        if (!reader)
-        {
-            out << "Unable to create reader for file '" << f.m_filename << "'.";
-            throw pdal_error(out.str());
-        }
-        Options readerOptions;
-        readerOptions.add("filename", f.m_filename);
-        reader->setOptions(readerOptions);
-        premerge = reader;
-
-        if (m_tgtSrsString != f.m_srs)
-        {
-            Stage *repro = factory.createStage("filters.reprojection");
-            repro->setInput(*reader);
-            Options reproOptions;
-            reproOptions.add("out_srs", m_tgtSrsString);
-            reproOptions.add("in_srs", f.m_srs);
-            repro->setOptions(reproOptions);
-            premerge = repro;
-        }
-
-        // WKT is set, even if we're using a bounding box for fitering, so
-        // can be used as a test here.
-        if (!m_wkt.empty())
-        {
-            Stage *crop = factory.createStage("filters.crop");
-            crop->setOptions(cropOptions);
-            crop->setInput(*premerge);
-            premerge = crop;
-        }
-
-        merge.setInput(*premerge);
+        Options cropOptions;
+        if (!m_bounds.empty())
+            cropOptions.add("bounds", m_bounds);
+        else
+            cropOptions.add("polygon", m_wkt);
+        merger.setCropOptions(cropOptions);
     }
+    for (auto f : files)
+        merger.addFile(f.m_filename, f.m_srs);
+
+    StageFactory factory;
+    BufferReader bufferReader;
 
     std::string driver = factory.inferWriterDriver(m_filespec);
     Options factoryOptions = factory.inferWriterOptionsChanges(m_filespec);
@@ -413,7 +547,7 @@ void TIndexKernel::mergeFile()
         out << "Unable to create reader for file '" << m_filespec << "'.";
         throw pdal_error(out.str());
     }
-    writer->setInput(merge);
+    writer->setInput(bufferReader);
 
     applyExtraStageOptionsRecursive(writer);
 
@@ -427,7 +561,13 @@ void TIndexKernel::mergeFile()
     writer->addConditionalOptions(writerOptions);
 
     PointTable table;
+    merger.prepare(table.layout());
     writer->prepare(table);
+
+    PointViewPtr view(new PointView(table, SpatialReference(m_tgtSrsString)));
+    table.finalize();
+    merger.read(*view);
+    bufferReader.addView(view);
     writer->execute(table);
 }
 
@@ -513,22 +653,35 @@ bool TIndexKernel::createFeature(const FieldIndexes& indexes,
 }
 
 
-TIndexKernel::FileInfo TIndexKernel::getFileInfo(KernelFactory& factory,
-    const std::string& filename)
+TIndexKernel::FileInfo TIndexKernel::getFileInfo(const std::string& filename)
 {
     FileInfo fileInfo;
 
-    StageFactory f;
+    FileUtils::fileTimes(filename, &fileInfo.m_ctime, &fileInfo.m_mtime);
+    fileInfo.m_filename = filename;
+
+    // The cache is only modified between chunks of files, so it's safe to
+    // read it here from multiple threads.
+    auto ci = m_cache.find(filename);
+    if (ci != m_cache.end() && ci->second.m_key == cacheKey(fileInfo))
+    {
+        fileInfo.m_srs = ci->second.m_srs;
+        fileInfo.m_boundary = ci->second.m_boundary;
+        return fileInfo;
+    }
 
-    std::string driverName = f.inferReaderDriver(filename);
-    Stage *s = f.createStage(driverName);
-    Options ops;
-    ops.add("filename", filename);
-    setCommonOptions(ops);
-    s->setOptions(ops);
-    applyExtraStageOptionsRecursive(s);
     if (m_fastBoundary)
     {
+        StageFactory f;
+
+        std::string driverName = f.inferReaderDriver(filename);
+        Stage *s = f.createStage(driverName);
+        Options ops;
+        ops.add("filename", filename);
+        setCommonOptions(ops);
+        s->setOptions(ops);
+        applyExtraStageOptionsRecursive(s);
+
         QuickInfo qi = s->preview();
 
         std::stringstream polygon;
@@ -545,37 +698,58 @@ TIndexKernel::FileInfo TIndexKernel::getFileInfo(KernelFactory& factory,
             fileInfo.m_srs = qi.m_srs.getWKT();
     }
     else
-    {
-        PointTable table;
+        computeBoundary(fileInfo);
 
-        Stage *hexer = f.createStage("filters.hexbin");
-        if (! hexer)
-        {
+    return fileInfo;
+}
 
-            std::ostringstream oss;
 
-            oss << "Unable to create hexer stage to create boundaries. "
-                << "Is PDAL_DRIVER_PATH environment variable set?";
-            throw pdal_error(oss.str());
-        }
-        hexer->setInput(*s);
+void TIndexKernel::computeBoundary(FileInfo& fileInfo)
+{
+    StageFactory f;
 
-        hexer->prepare(table);
-        PointViewSet set = hexer->execute(table);
+    std::string driverName = f.inferReaderDriver(fileInfo.m_filename);
+    Stage *s = f.createStage(driverName);
+    Options ops;
+    ops.add("filename", fileInfo.m_filename);
+    setCommonOptions(ops);
+    s->setOptions(ops);
 
-        MetadataNode m = table.metadata();
-        m = m.findChild("filters.hexbin:boundary");
-        fileInfo.m_boundary = m.value();
+    Stage *hexer = f.createStage("filters.hexbin");
+    if (!hexer)
+    {
+        std::ostringstream oss;
 
-        PointViewPtr v = *set.begin();
-        if (!v->spatialReference().empty())
-            fileInfo.m_srs = v->spatialReference().getWKT();
+        oss << "Unable to create hexer stage to create boundaries. "
+            << "Is PDAL_DRIVER_PATH environment variable set?";
+        throw pdal_error(oss.str());
     }
+    hexer->setInput(*s);
+    applyExtraStageOptionsRecursive(hexer);
 
-    FileUtils::fileTimes(filename, &fileInfo.m_ctime, &fileInfo.m_mtime);
-    fileInfo.m_filename = filename;
+    // Stream the points through hexbin when the reader supports it so that
+    // the file never needs to be held in memory.
+    MetadataNode m;
+    if (hexer->pipelineStreamable())
+    {
+        FixedPointTable table(10000);
+        hexer->prepare(table);
+        hexer->execute(table);
+        m = table.metadata();
+    }
+    else
+    {
+        PointTable table;
+        hexer->prepare(table);
+        hexer->execute(table);
+        m = table.metadata();
+    }
+    m = m.findChild("filters.hexbin:boundary");
+    fileInfo.m_boundary = m.value();
 
-    return fileInfo;
+    SpatialReference srs = s->getSpatialReference();
+    if (!srs.empty())
+        fileInfo.m_srs = srs.getWKT();
 }
 
 
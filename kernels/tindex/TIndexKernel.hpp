@@ -40,6 +40,9 @@
 #include <pdal/util/FileUtils.hpp>
 #include <pdal/plugin.hpp>
 
+#include <exception>
+#include <map>
+
 
 extern "C" int32_t TIndexKernel_ExitFunc();
 extern "C" PF_ExitFunc TIndexKernel_InitPlugin();
@@ -60,6 +63,14 @@ class PDAL_DLL TIndexKernel : public Kernel
         struct tm m_mtime;
     };
 
+    struct CacheEntry
+    {
+        std::string m_key;
+        std::string m_srs;
+        std::string m_boundary;
+    };
+    typedef std::map<std::string, CacheEntry> BoundaryCache;
+
     struct FieldIndexes
     {
         int m_filename;
@@ -87,14 +98,20 @@ private:
     bool openLayer(const std::string& layerName);
     bool createLayer(const std::string& layerName);
     FieldIndexes getFields();
-    FileInfo getFileInfo(KernelFactory& factory, const std::string& filename);
+    FileInfo getFileInfo(const std::string& filename);
+    void getFileInfos(const StringList& filenames,
+        std::vector<FileInfo>& infos, std::vector<std::exception_ptr>& errors);
+    void computeBoundary(FileInfo& fileInfo);
+    std::string cacheKey(const FileInfo& fileInfo);
+    void loadCache();
+    void saveCache();
     bool createFeature(const FieldIndexes& indexes, FileInfo& info);
     gdal::Geometry prepareGeometry(const FileInfo& fileInfo);
     gdal::Geometry prepareGeometry(const std::string& wkt,
         const gdal::SpatialRef& inSrs, const gdal::SpatialRef& outSrs);
     void createFields();
 
-    bool isFileIndexed( const FieldIndexes& indexes, const FileInfo& fileInfo);
+    bool isFileIndexed(const std::string& filename);
 
     std::string m_idxFilename;
     std::string m_filespec;
@@ -113,6 +130,9 @@ private:
     std::string m_tgtSrsString;
     std::string m_assignSrsString;
     bool m_fastBoundary;
+    int m_threads;
+    std::string m_cacheFilename;
+    BoundaryCache m_cache;
 };
 
 } // namespace pdal
@@ -38,6 +38,7 @@
 #include <pdal/KernelFactory.hpp>
 #include <pdal/Options.hpp>
 #include <pdal/pdal_macros.hpp>
+#include <pdal/PDALUtils.hpp>
 #include <pdal/PipelineWriter.hpp>
 #include <pdal/PointTable.hpp>
 #include <pdal/PointView.hpp>
@@ -74,6 +75,7 @@ TranslateKernel::TranslateKernel()
     , m_pipelineOutput("")
     , m_readerType("")
     , m_writerType("")
+    , m_profile(false)
 {}
 
 void TranslateKernel::addSwitches(ProgramArgs& args)
@@ -84,6 +86,8 @@ void TranslateKernel::addSwitches(ProgramArgs& args)
     args.add("pipeline,p", "Pipeline output", m_pipelineOutput);
     args.add("reader,r", "Reader type", m_readerType);
     args.add("writer,w", "Writer type", m_writerType);
+    args.add("profile", "Write execution statistics of each stage as JSON "
+        "to standard output", m_profile);
 }
 
 int TranslateKernel::execute()
@@ -178,11 +182,15 @@ int TranslateKernel::execute()
     // be sure to recurse through any extra stage options provided by the user
     applyExtraStageOptionsRecursive(writer);
 
+    m_manager->setProfiling(m_profile);
     m_manager->execute();
 
     if (m_pipelineOutput.size() > 0)
         PipelineWriter::writePipeline(m_manager->getStage(), m_pipelineOutput);
 
+    if (m_profile)
+        Utils::toJSON(m_manager->getProfile(), std::cout);
+
     return 0;
 }
 
@@ -68,6 +68,7 @@ private:
     std::string m_readerType;
     std::vector<std::string> m_filterType;
     std::string m_writerType;
+    bool m_profile;
 
     std::unique_ptr<PipelineManager> m_manager;
 };
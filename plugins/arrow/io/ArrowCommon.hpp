@@ -0,0 +1,165 @@
+/******************************************************************************
+* Copyright (c) 2015, Howard Butler (howard@hobu.co)
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+#pragma once
+
+#include <pdal/Dimension.hpp>
+#include <pdal/pdal_types.hpp>
+#include <pdal/util/FileUtils.hpp>
+#include <pdal/util/Utils.hpp>
+
+#include <arrow/api.h>
+
+#include <memory>
+#include <string>
+
+namespace pdal
+{
+
+// Key of the schema metadata that holds the WKT spatial reference.
+static const char ARROW_SRS_KEY[] = "spatialreference";
+
+namespace ArrowFormat
+{
+enum Enum
+{
+    Ipc,
+    Parquet
+};
+}
+
+
+// Determine the file format from the "format" option, or from the file
+// extension if the option wasn't given.
+inline ArrowFormat::Enum arrowFormat(const std::string& format,
+    const std::string& filename)
+{
+    std::string f = Utils::tolower(format);
+    if (f.empty())
+    {
+        std::string ext = Utils::tolower(FileUtils::extension(filename));
+        return (ext == ".parquet" || ext == ".parq") ?
+            ArrowFormat::Parquet : ArrowFormat::Ipc;
+    }
+    if (f == "arrow" || f == "feather" || f == "ipc")
+        return ArrowFormat::Ipc;
+    if (f == "parquet")
+        return ArrowFormat::Parquet;
+    throw pdal_error("Invalid Arrow file format '" + format + "'.  Valid "
+        "values are 'arrow', 'feather' and 'parquet'.");
+}
+
+
+// Throw if an Arrow operation failed.
+inline void arrowCheck(const arrow::Status& status, const std::string& what)
+{
+    if (!status.ok())
+        throw pdal_error(what + ": " + status.ToString());
+}
+
+
+// Throw if an Arrow operation failed, otherwise return its result.
+template<typename T>
+T arrowCheck(arrow::Result<T> result, const std::string& what)
+{
+    arrowCheck(result.status(), what);
+    return std::move(result).ValueUnsafe();
+}
+
+
+// Arrow column type of a PDAL dimension type.
+inline std::shared_ptr<arrow::DataType> arrowType(Dimension::Type::Enum type)
+{
+    switch (type)
+    {
+    case Dimension::Type::Signed8:
+        return arrow::int8();
+    case Dimension::Type::Signed16:
+        return arrow::int16();
+    case Dimension::Type::Signed32:
+        return arrow::int32();
+    case Dimension::Type::Signed64:
+        return arrow::int64();
+    case Dimension::Type::Unsigned8:
+        return arrow::uint8();
+    case Dimension::Type::Unsigned16:
+        return arrow::uint16();
+    case Dimension::Type::Unsigned32:
+        return arrow::uint32();
+    case Dimension::Type::Unsigned64:
+        return arrow::uint64();
+    case Dimension::Type::Float:
+        return arrow::float32();
+    case Dimension::Type::Double:
+        return arrow::float64();
+    default:
+        return std::shared_ptr<arrow::DataType>();
+    }
+}
+
+
+// PDAL dimension type of an Arrow column type.  Booleans are read as
+// unsigned bytes.  Returns Dimension::Type::None if the column type can't
+// be represented as a dimension.
+inline Dimension::Type::Enum pdalType(const arrow::DataType& type)
+{
+    switch (type.id())
+    {
+    case arrow::Type::BOOL:
+    case arrow::Type::UINT8:
+        return Dimension::Type::Unsigned8;
+    case arrow::Type::INT8:
+        return Dimension::Type::Signed8;
+    case arrow::Type::INT16:
+        return Dimension::Type::Signed16;
+    case arrow::Type::INT32:
+        return Dimension::Type::Signed32;
+    case arrow::Type::INT64:
+        return Dimension::Type::Signed64;
+    case arrow::Type::UINT16:
+        return Dimension::Type::Unsigned16;
+    case arrow::Type::UINT32:
+        return Dimension::Type::Unsigned32;
+    case arrow::Type::UINT64:
+        return Dimension::Type::Unsigned64;
+    case arrow::Type::FLOAT:
+        return Dimension::Type::Float;
+    case arrow::Type::DOUBLE:
+        return Dimension::Type::Double;
+    default:
+        return Dimension::Type::None;
+    }
+}
+
+} // namespace pdal
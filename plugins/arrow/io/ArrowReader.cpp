@@ -0,0 +1,270 @@
+/******************************************************************************
+* Copyright (c) 2015, Howard Butler (howard@hobu.co)
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+#include "ArrowReader.hpp"
+
+#include <pdal/pdal_macros.hpp>
+
+namespace pdal
+{
+
+static PluginInfo const s_info = PluginInfo(
+    "readers.arrow",
+    "Read points from the columns of an Apache Arrow or Parquet file.",
+    "http://pdal.io/stages/readers.arrow.html" );
+
+CREATE_SHARED_PLUGIN(1, 0, ArrowReader, Reader, s_info)
+
+std::string ArrowReader::getName() const { return s_info.name; }
+
+ArrowReader::ArrowReader() : m_format(ArrowFormat::Ipc), m_numPoints(0),
+    m_batchIdx(0), m_row(0), m_index(0)
+{}
+
+
+void ArrowReader::processOptions(const Options& options)
+{
+    m_format = arrowFormat(
+        options.getValueOrDefault<std::string>("format"), m_filename);
+}
+
+
+void ArrowReader::open()
+{
+    m_file = arrowCheck(arrow::io::ReadableFile::Open(m_filename),
+        getName() + ": Couldn't open '" + m_filename + "'");
+    if (m_format == ArrowFormat::Parquet)
+    {
+        parquet::arrow::FileReaderBuilder builder;
+        arrowCheck(builder.Open(m_file),
+            getName() + ": Couldn't read Parquet file '" + m_filename + "'");
+        arrowCheck(builder.Build(&m_parquetReader),
+            getName() + ": Couldn't read Parquet file '" + m_filename + "'");
+        arrowCheck(m_parquetReader->GetSchema(&m_schema),
+            getName() + ": Couldn't read schema of '" + m_filename + "'");
+        m_numPoints =
+            m_parquetReader->parquet_reader()->metadata()->num_rows();
+    }
+    else
+    {
+        m_ipcReader = arrowCheck(
+            arrow::ipc::RecordBatchFileReader::Open(m_file),
+            getName() + ": Couldn't read Arrow file '" + m_filename + "'");
+        m_schema = m_ipcReader->schema();
+        m_numPoints = arrowCheck(m_ipcReader->CountRows(),
+            getName() + ": Couldn't read Arrow file '" + m_filename + "'");
+    }
+}
+
+
+void ArrowReader::close()
+{
+    m_batch.reset();
+    m_batchReader.reset();
+    m_ipcReader.reset();
+    m_parquetReader.reset();
+    if (m_file)
+        m_file->Close();
+    m_file.reset();
+}
+
+
+void ArrowReader::initialize()
+{
+    open();
+
+    std::shared_ptr<const arrow::KeyValueMetadata> metadata =
+        m_schema->metadata();
+    if (metadata)
+    {
+        int idx = metadata->FindKey(ARROW_SRS_KEY);
+        if (idx >= 0)
+            setSpatialReference(SpatialReference(metadata->value(idx)));
+    }
+    close();
+}
+
+
+QuickInfo ArrowReader::inspect()
+{
+    QuickInfo qi;
+
+    initialize();
+    for (auto& field : m_schema->fields())
+        if (pdalType(*field->type()) != Dimension::Type::None)
+            qi.m_dimNames.push_back(field->name());
+    qi.m_pointCount = m_numPoints;
+    qi.m_srs = getSpatialReference();
+    qi.m_valid = true;
+    return qi;
+}
+
+
+void ArrowReader::addDimensions(PointLayoutPtr layout)
+{
+    m_columns.clear();
+    for (int i = 0; i < m_schema->num_fields(); ++i)
+    {
+        const arrow::Field& field = *m_schema->field(i);
+        Dimension::Type::Enum type = pdalType(*field.type());
+        if (type == Dimension::Type::None)
+        {
+            log()->get(LogLevel::Warning) << getName() << ": Skipping "
+                "field '" << field.name() << "' of unsupported type '" <<
+                field.type()->ToString() << "'." << std::endl;
+            continue;
+        }
+
+        Column c;
+        c.m_field = i;
+        c.m_id = layout->registerOrAssignDim(field.name(), type);
+        c.m_type = type;
+        c.m_bool = (field.type()->id() == arrow::Type::BOOL);
+        c.m_pos = NULL;
+        m_columns.push_back(c);
+    }
+}
+
+
+void ArrowReader::ready(PointTableRef table)
+{
+    open();
+    if (m_format == ArrowFormat::Parquet)
+        m_batchReader = arrowCheck(m_parquetReader->GetRecordBatchReader(),
+            getName() + ": Couldn't read '" + m_filename + "'");
+    m_batchIdx = 0;
+    m_batch.reset();
+    m_row = 0;
+
+    // Skip batches that end before the first point to read.
+    m_index = 0;
+    while (nextBatch())
+    {
+        point_count_t rows = m_batch->num_rows();
+        if (m_index + rows > m_start)
+        {
+            m_row = m_start - m_index;
+            break;
+        }
+        m_index += rows;
+    }
+    m_index = m_start;
+}
+
+
+// Move to the next non-empty record batch and locate its columns.
+bool ArrowReader::nextBatch()
+{
+    m_row = 0;
+    do
+    {
+        if (m_format == ArrowFormat::Parquet)
+            m_batch = arrowCheck(m_batchReader->Next(),
+                getName() + ": Couldn't read '" + m_filename + "'");
+        else if (m_batchIdx < m_ipcReader->num_record_batches())
+            m_batch = arrowCheck(m_ipcReader->ReadRecordBatch(m_batchIdx++),
+                getName() + ": Couldn't read '" + m_filename + "'");
+        else
+            m_batch.reset();
+    } while (m_batch && m_batch->num_rows() == 0);
+
+    if (!m_batch)
+        return false;
+
+    for (auto& c : m_columns)
+    {
+        c.m_array = m_batch->column(c.m_field);
+        if (!c.m_bool)
+        {
+            std::shared_ptr<arrow::ArrayData> data = c.m_array->data();
+            c.m_pos = data->GetValues<uint8_t>(1, 0) +
+                data->offset * Dimension::size(c.m_type);
+        }
+    }
+    return true;
+}
+
+
+bool ArrowReader::processOne(PointRef& point)
+{
+    if (m_index - m_start >= m_count)
+        return false;
+    if (!m_batch || m_row >= m_batch->num_rows())
+        if (!nextBatch())
+            return false;
+
+    for (auto& c : m_columns)
+    {
+        if (c.m_array->IsNull(m_row))
+            continue;
+        if (c.m_bool)
+        {
+            uint8_t val = std::static_pointer_cast<arrow::BooleanArray>(
+                c.m_array)->Value(m_row) ? 1 : 0;
+            point.setField(c.m_id, val);
+        }
+        else
+            point.setField(c.m_id, c.m_type,
+                c.m_pos + m_row * Dimension::size(c.m_type));
+    }
+    m_row++;
+    m_index++;
+    return true;
+}
+
+
+point_count_t ArrowReader::read(PointViewPtr view, point_count_t count)
+{
+    PointId id = view->size();
+    point_count_t numRead = 0;
+    while (numRead < count)
+    {
+        PointRef point = view->point(id);
+        if (!processOne(point))
+            break;
+        if (m_cb)
+            m_cb(*view, id);
+        id++;
+        numRead++;
+    }
+    return numRead;
+}
+
+
+void ArrowReader::done(PointTableRef table)
+{
+    close();
+}
+
+} // namespace pdal
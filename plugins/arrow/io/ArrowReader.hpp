@@ -0,0 +1,105 @@
+/******************************************************************************
+* Copyright (c) 2015, Howard Butler (howard@hobu.co)
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+#pragma once
+
+#include <pdal/Reader.hpp>
+
+#include "ArrowCommon.hpp"
+
+#include <arrow/io/file.h>
+#include <arrow/ipc/reader.h>
+#include <parquet/arrow/reader.h>
+
+namespace pdal
+{
+
+class PDAL_DLL ArrowReader : public Reader
+{
+public:
+    ArrowReader();
+
+    static void * create();
+    static int32_t destroy(void *);
+    std::string getName() const;
+
+private:
+    // A field of the file mapped to a dimension.
+    struct Column
+    {
+        int m_field;
+        Dimension::Id::Enum m_id;
+        Dimension::Type::Enum m_type;
+        bool m_bool;
+        const uint8_t *m_pos;
+        std::shared_ptr<arrow::Array> m_array;
+    };
+
+    ArrowFormat::Enum m_format;
+    std::shared_ptr<arrow::io::ReadableFile> m_file;
+    std::shared_ptr<arrow::ipc::RecordBatchFileReader> m_ipcReader;
+    std::unique_ptr<parquet::arrow::FileReader> m_parquetReader;
+    std::shared_ptr<arrow::RecordBatchReader> m_batchReader;
+    std::shared_ptr<arrow::Schema> m_schema;
+    point_count_t m_numPoints;
+    std::vector<Column> m_columns;
+
+    // Position in the file.
+    int m_batchIdx;
+    std::shared_ptr<arrow::RecordBatch> m_batch;
+    int64_t m_row;
+    point_count_t m_index;
+
+    virtual void processOptions(const Options& options);
+    virtual void initialize();
+    virtual QuickInfo inspect();
+    virtual void addDimensions(PointLayoutPtr layout);
+    virtual void ready(PointTableRef table);
+    virtual point_count_t read(PointViewPtr view, point_count_t count);
+    virtual bool streamable() const
+        { return true; }
+    virtual bool supportsStart() const
+        { return true; }
+    virtual bool processOne(PointRef& point);
+    virtual void done(PointTableRef table);
+
+    void open();
+    void close();
+    bool nextBatch();
+
+    ArrowReader& operator=(const ArrowReader&); // not implemented
+    ArrowReader(const ArrowReader&); // not implemented
+};
+
+} // namespace pdal
@@ -0,0 +1,343 @@
+/******************************************************************************
+* Copyright (c) 2015, Howard Butler (howard@hobu.co)
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+#include "ArrowWriter.hpp"
+
+#include <pdal/PDALUtils.hpp>
+#include <pdal/pdal_macros.hpp>
+
+namespace pdal
+{
+
+static PluginInfo const s_info = PluginInfo(
+    "writers.arrow",
+    "Write points as columns of an Apache Arrow or Parquet file.",
+    "http://pdal.io/stages/writers.arrow.html" );
+
+CREATE_SHARED_PLUGIN(1, 0, ArrowWriter, Writer, s_info)
+
+std::string ArrowWriter::getName() const { return s_info.name; }
+
+ArrowWriter::ArrowWriter() : m_format(ArrowFormat::Ipc), m_batchSize(65536),
+    m_threads(1), m_batchCount(0)
+{}
+
+
+void ArrowWriter::processOptions(const Options& options)
+{
+    if (m_filename.empty())
+        throw pdal_error(getName() + ": Can't write without filename.");
+    m_format = arrowFormat(
+        options.getValueOrDefault<std::string>("format"), m_filename);
+    m_batchSize =
+        options.getValueOrDefault<point_count_t>("batch_size", 65536);
+    if (m_batchSize == 0)
+        throw pdal_error(getName() + ": Option 'batch_size' must be at "
+            "least 1.");
+    m_compression = Utils::tolower(
+        options.getValueOrDefault<std::string>("compression",
+            m_format == ArrowFormat::Parquet ? "snappy" : "none"));
+    m_dictDims = options.getValueOrDefault<StringList>("dictionary_dims");
+    m_threads = options.getValueOrDefault<int>("threads", 1);
+    Utils::checkThreads(getName(), m_threads);
+
+    // Check the compression name early.
+    compressionType();
+}
+
+
+arrow::Compression::type ArrowWriter::compressionType() const
+{
+    // Arrow IPC files only support LZ4 frames and ZStandard.
+    if (m_compression == "none")
+        return arrow::Compression::UNCOMPRESSED;
+    if (m_compression == "zstd")
+        return arrow::Compression::ZSTD;
+    if (m_compression == "lz4")
+        return m_format == ArrowFormat::Parquet ?
+            arrow::Compression::LZ4 : arrow::Compression::LZ4_FRAME;
+    if (m_format == ArrowFormat::Parquet)
+    {
+        if (m_compression == "snappy")
+            return arrow::Compression::SNAPPY;
+        if (m_compression == "gzip")
+            return arrow::Compression::GZIP;
+    }
+
+    std::ostringstream oss;
+    oss << getName() << ": Invalid compression '" << m_compression <<
+        "'.  Valid values are 'none', 'lz4' and 'zstd'";
+    if (m_format == ArrowFormat::Parquet)
+        oss << ", 'snappy' and 'gzip'";
+    oss << ".";
+    throw pdal_error(oss.str());
+}
+
+
+void ArrowWriter::prepared(PointTableRef table)
+{
+    PointLayoutPtr layout(table.layout());
+
+    m_dims.clear();
+    if (m_outputDims.empty())
+        m_dims = layout->dims();
+    for (auto& name : m_outputDims)
+    {
+        Dimension::Id::Enum id = layout->findDim(name);
+        if (id == Dimension::Id::Unknown)
+        {
+            std::ostringstream oss;
+            oss << getName() << ": Dimension '" << name << "' listed in "
+                "'output_dims' option does not exist.";
+            throw pdal_error(oss.str());
+        }
+        m_dims.push_back(id);
+    }
+
+    // Columns hold each dimension in its native type, so no conversion is
+    // needed when copying from the table.
+    m_types.clear();
+    std::vector<std::shared_ptr<arrow::Field>> fields;
+    for (auto id : m_dims)
+    {
+        Dimension::Type::Enum type = layout->dimType(id);
+        m_types.push_back(type);
+        fields.push_back(arrow::field(layout->dimName(id), arrowType(type),
+            false));
+    }
+    m_schema = arrow::schema(fields);
+
+    // Unless told otherwise, dictionary-encode the byte-sized integer
+    // dimensions (Classification, ReturnNumber, ...) in Parquet output.
+    if (!m_dictDims.size())
+        for (size_t i = 0; i < m_dims.size(); ++i)
+            if (Dimension::size(m_types[i]) == 1)
+                m_dictDims.push_back(layout->dimName(m_dims[i]));
+}
+
+
+void ArrowWriter::ready(PointTableRef table)
+{
+    SpatialReference srs = getSpatialReference().empty() ?
+        table.anySpatialReference() : getSpatialReference();
+    if (!srs.empty())
+        m_schema = m_schema->WithMetadata(arrow::key_value_metadata(
+            { ARROW_SRS_KEY }, { srs.getWKT() }));
+
+    m_stream = arrowCheck(arrow::io::FileOutputStream::Open(m_filename),
+        getName() + ": Couldn't open '" + m_filename + "' for output");
+    if (m_format == ArrowFormat::Parquet)
+        readyParquet();
+    else
+        readyIpc();
+    m_columns.clear();
+    m_batchCount = 0;
+}
+
+
+void ArrowWriter::readyIpc()
+{
+    arrow::ipc::IpcWriteOptions options =
+        arrow::ipc::IpcWriteOptions::Defaults();
+    arrow::Compression::type compression = compressionType();
+    if (compression != arrow::Compression::UNCOMPRESSED)
+        options.codec = arrowCheck(arrow::util::Codec::Create(compression),
+            getName() + ": Couldn't create compressor");
+    options.use_threads = (m_threads > 1);
+
+    m_ipcWriter = arrowCheck(
+        arrow::ipc::MakeFileWriter(m_stream, m_schema, options),
+        getName() + ": Couldn't write Arrow file '" + m_filename + "'");
+}
+
+
+void ArrowWriter::readyParquet()
+{
+    // Dictionary pages with run-length encoded indices are only used for
+    // the low-cardinality dimensions.  Coordinates and other high-
+    // cardinality values would overflow the dictionary anyway.
+    parquet::WriterProperties::Builder builder;
+    builder.compression(compressionType());
+    builder.max_row_group_length(m_batchSize);
+    builder.disable_dictionary();
+    for (auto& name : m_dictDims)
+        builder.enable_dictionary(name);
+
+    // Store the Arrow schema so that the spatial reference is preserved.
+    parquet::ArrowWriterProperties::Builder arrowBuilder;
+    arrowBuilder.store_schema();
+
+    m_parquetWriter = arrowCheck(
+        parquet::arrow::FileWriter::Open(*m_schema,
+            arrow::default_memory_pool(), m_stream, builder.build(),
+            arrowBuilder.build()),
+        getName() + ": Couldn't write Parquet file '" + m_filename + "'");
+}
+
+
+std::shared_ptr<arrow::Buffer> ArrowWriter::allocateColumn(size_t dimIdx,
+    point_count_t count)
+{
+    return arrowCheck(
+        arrow::AllocateBuffer(count * Dimension::size(m_types[dimIdx])),
+        getName() + ": Couldn't allocate column");
+}
+
+
+// Make a record batch of the first 'count' values of each column.
+std::shared_ptr<arrow::RecordBatch> ArrowWriter::makeBatch(
+    std::vector<std::shared_ptr<arrow::Buffer>>& columns, point_count_t count)
+{
+    std::vector<std::shared_ptr<arrow::Array>> arrays;
+    for (size_t i = 0; i < columns.size(); ++i)
+    {
+        std::shared_ptr<arrow::Buffer> buf = arrow::SliceBuffer(columns[i], 0,
+            count * Dimension::size(m_types[i]));
+        arrays.push_back(arrow::MakeArray(arrow::ArrayData::Make(
+            m_schema->field((int)i)->type(), count, { nullptr, buf }, 0)));
+    }
+    return arrow::RecordBatch::Make(m_schema, count, arrays);
+}
+
+
+// Copy points from a view into a record batch, a column at a time.
+std::shared_ptr<arrow::RecordBatch> ArrowWriter::makeBatch(
+    const PointView& view, PointId start, point_count_t count)
+{
+    std::vector<std::shared_ptr<arrow::Buffer>> columns;
+    for (size_t i = 0; i < m_dims.size(); ++i)
+    {
+        std::shared_ptr<arrow::Buffer> buf = allocateColumn(i, count);
+        size_t size = Dimension::size(m_types[i]);
+        char *pos = reinterpret_cast<char *>(buf->mutable_data());
+        for (PointId idx = start; idx < start + count; ++idx)
+        {
+            view.getField(pos, m_dims[i], m_types[i], idx);
+            pos += size;
+        }
+        columns.push_back(buf);
+    }
+    return makeBatch(columns, count);
+}
+
+
+void ArrowWriter::writeBatch(const arrow::RecordBatch& batch)
+{
+    if (m_format == ArrowFormat::Parquet)
+        arrowCheck(m_parquetWriter->WriteRecordBatch(batch),
+            getName() + ": Couldn't write record batch");
+    else
+        arrowCheck(m_ipcWriter->WriteRecordBatch(batch),
+            getName() + ": Couldn't write record batch");
+}
+
+
+// Batches are built concurrently, as many at once as we have threads, and
+// then written in order.  This limits the copied data in memory to that
+// many batches.
+void ArrowWriter::write(const PointViewPtr view)
+{
+    point_count_t numBatches = view->size() / m_batchSize +
+        ((view->size() % m_batchSize) ? 1 : 0);
+    std::vector<std::shared_ptr<arrow::RecordBatch>> batches;
+
+    for (point_count_t first = 0; first < numBatches; first += m_threads)
+    {
+        point_count_t last = (std::min)(numBatches, first + m_threads);
+        batches.assign(last - first, nullptr);
+
+        Utils::parallelFor(last - first, m_threads, [&](size_t i)
+        {
+            PointId start = (first + i) * m_batchSize;
+            point_count_t count = (std::min)(m_batchSize,
+                view->size() - start);
+            batches[i] = makeBatch(*view, start, count);
+        });
+
+        for (auto& batch : batches)
+            writeBatch(*batch);
+    }
+}
+
+
+bool ArrowWriter::processOne(PointRef& point)
+{
+    if (m_columns.empty())
+        for (size_t i = 0; i < m_dims.size(); ++i)
+            m_columns.push_back(allocateColumn(i, m_batchSize));
+
+    for (size_t i = 0; i < m_dims.size(); ++i)
+    {
+        size_t size = Dimension::size(m_types[i]);
+        char *pos = reinterpret_cast<char *>(m_columns[i]->mutable_data()) +
+            m_batchCount * size;
+        point.getField(pos, m_dims[i], m_types[i]);
+    }
+    if (++m_batchCount == m_batchSize)
+        flush();
+    return true;
+}
+
+
+// Write the points collected in streaming mode.
+void ArrowWriter::flush()
+{
+    if (m_batchCount)
+        writeBatch(*makeBatch(m_columns, m_batchCount));
+    m_columns.clear();
+    m_batchCount = 0;
+}
+
+
+void ArrowWriter::done(PointTableRef table)
+{
+    flush();
+    if (m_format == ArrowFormat::Parquet)
+    {
+        arrowCheck(m_parquetWriter->Close(),
+            getName() + ": Couldn't finish Parquet file");
+        m_parquetWriter.reset();
+    }
+    else
+    {
+        arrowCheck(m_ipcWriter->Close(),
+            getName() + ": Couldn't finish Arrow file");
+        m_ipcWriter.reset();
+    }
+    arrowCheck(m_stream->Close(), getName() + ": Couldn't close '" +
+        m_filename + "'");
+    m_stream.reset();
+}
+
+} // namespace pdal
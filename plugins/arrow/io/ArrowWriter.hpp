@@ -0,0 +1,101 @@
+/******************************************************************************
+* Copyright (c) 2015, Howard Butler (howard@hobu.co)
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+#pragma once
+
+#include <pdal/Writer.hpp>
+
+#include "ArrowCommon.hpp"
+
+#include <arrow/io/file.h>
+#include <arrow/ipc/writer.h>
+#include <parquet/arrow/writer.h>
+
+namespace pdal
+{
+
+class PDAL_DLL ArrowWriter : public Writer
+{
+public:
+    ArrowWriter();
+
+    static void * create();
+    static int32_t destroy(void *);
+    std::string getName() const;
+
+private:
+    ArrowFormat::Enum m_format;
+    point_count_t m_batchSize;
+    std::string m_compression;
+    StringList m_dictDims;
+    int m_threads;
+
+    Dimension::IdList m_dims;
+    std::vector<Dimension::Type::Enum> m_types;
+    std::shared_ptr<arrow::Schema> m_schema;
+    std::shared_ptr<arrow::io::FileOutputStream> m_stream;
+    std::shared_ptr<arrow::ipc::RecordBatchWriter> m_ipcWriter;
+    std::unique_ptr<parquet::arrow::FileWriter> m_parquetWriter;
+
+    // Columns of the batch being filled in streaming mode.
+    std::vector<std::shared_ptr<arrow::Buffer>> m_columns;
+    point_count_t m_batchCount;
+
+    virtual void processOptions(const Options& options);
+    virtual void prepared(PointTableRef table);
+    virtual void ready(PointTableRef table);
+    virtual void write(const PointViewPtr view);
+    virtual bool streamable() const
+        { return true; }
+    virtual bool processOne(PointRef& point);
+    virtual void done(PointTableRef table);
+
+    arrow::Compression::type compressionType() const;
+    void readyIpc();
+    void readyParquet();
+    std::shared_ptr<arrow::Buffer> allocateColumn(size_t dimIdx,
+        point_count_t count);
+    std::shared_ptr<arrow::RecordBatch> makeBatch(
+        std::vector<std::shared_ptr<arrow::Buffer>>& columns,
+        point_count_t count);
+    std::shared_ptr<arrow::RecordBatch> makeBatch(const PointView& view,
+        PointId start, point_count_t count);
+    void writeBatch(const arrow::RecordBatch& batch);
+    void flush();
+
+    ArrowWriter& operator=(const ArrowWriter&); // not implemented
+    ArrowWriter(const ArrowWriter&); // not implemented
+};
+
+} // namespace pdal
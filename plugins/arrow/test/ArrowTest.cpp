@@ -0,0 +1,304 @@
+/******************************************************************************
+* Copyright (c) 2015, Howard Butler (howard@hobu.co)
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+#include <pdal/pdal_test_main.hpp>
+
+#include <pdal/Filter.hpp>
+#include <pdal/PointView.hpp>
+#include <pdal/StageFactory.hpp>
+#include <pdal/util/FileUtils.hpp>
+#include <buffer/BufferReader.hpp>
+#include <las/LasReader.hpp>
+
+#include "../io/ArrowReader.hpp"
+#include "../io/ArrowWriter.hpp"
+
+#include "Support.hpp"
+
+using namespace pdal;
+
+namespace
+{
+
+PointViewPtr readLas(PointTable& table)
+{
+    Options ops;
+    ops.add("filename", Support::datapath("las/1.2-with-color.las"));
+    LasReader reader;
+    reader.setOptions(ops);
+    reader.prepare(table);
+    PointViewSet viewSet = reader.execute(table);
+    EXPECT_EQ(viewSet.size(), 1u);
+    return *viewSet.begin();
+}
+
+
+PointViewPtr readArrow(PointTable& table, const std::string& filename,
+    Options ops = Options())
+{
+    ops.add("filename", filename);
+    ArrowReader reader;
+    reader.setOptions(ops);
+    reader.prepare(table);
+    PointViewSet viewSet = reader.execute(table);
+    EXPECT_EQ(viewSet.size(), 1u);
+    return *viewSet.begin();
+}
+
+
+// Compare the points of a view read back from an Arrow file with the
+// original LAS points, starting at point 'start' of the original.
+void compare(const PointView& orig, const PointView& view, PointId start = 0)
+{
+    PointLayoutPtr origLayout(orig.layout());
+    PointLayoutPtr layout(view.layout());
+
+    for (auto id : origLayout->dims())
+    {
+        Dimension::Id::Enum viewId =
+            layout->findDim(origLayout->dimName(id));
+        ASSERT_NE(viewId, Dimension::Id::Unknown);
+        EXPECT_EQ(layout->dimType(viewId), origLayout->dimType(id));
+        for (PointId idx = 0; idx < view.size(); ++idx)
+            EXPECT_EQ(view.getFieldAs<double>(viewId, idx),
+                orig.getFieldAs<double>(id, start + idx));
+    }
+}
+
+
+void testRoundtrip(const std::string& filename, Options writerOps)
+{
+    std::string outfile(Support::temppath(filename));
+    FileUtils::deleteFile(outfile);
+
+    PointTable table;
+    PointViewPtr orig = readLas(table);
+    ASSERT_EQ(orig->size(), 1065u);
+
+    BufferReader bufferReader;
+    bufferReader.addView(orig);
+
+    writerOps.add("filename", outfile);
+    ArrowWriter writer;
+    writer.setOptions(writerOps);
+    writer.setInput(bufferReader);
+    writer.prepare(table);
+    writer.execute(table);
+
+    PointTable table2;
+    PointViewPtr view = readArrow(table2, outfile);
+    EXPECT_EQ(view->size(), orig->size());
+    compare(*orig, *view);
+    EXPECT_EQ(view->spatialReference(), orig->spatialReference());
+
+    // Read part of the file, starting in the middle of a batch.
+    Options readerOps;
+    readerOps.add("start", 450);
+    readerOps.add("count", 300);
+    PointTable table3;
+    view = readArrow(table3, outfile, readerOps);
+    EXPECT_EQ(view->size(), 300u);
+    compare(*orig, *view, 450);
+
+    FileUtils::deleteFile(outfile);
+}
+
+
+void testStreaming(const std::string& filename, Options writerOps)
+{
+    std::string outfile(Support::temppath(filename));
+    FileUtils::deleteFile(outfile);
+
+    Options readerOps;
+    readerOps.add("filename", Support::datapath("las/1.2-with-color.las"));
+    LasReader reader;
+    reader.setOptions(readerOps);
+
+    writerOps.add("filename", outfile);
+    ArrowWriter writer;
+    writer.setOptions(writerOps);
+    writer.setInput(reader);
+
+    FixedPointTable table(100);
+    writer.prepare(table);
+    writer.execute(table);
+
+    PointTable origTable;
+    PointViewPtr orig = readLas(origTable);
+
+    PointTable table2;
+    PointViewPtr view = readArrow(table2, outfile);
+    EXPECT_EQ(view->size(), orig->size());
+    compare(*orig, *view);
+
+    FileUtils::deleteFile(outfile);
+}
+
+} // unnamed namespace
+
+
+TEST(ArrowTest, infer)
+{
+    StageFactory f;
+
+    EXPECT_EQ(f.inferReaderDriver("foo.parquet"), "readers.arrow");
+    EXPECT_EQ(f.inferReaderDriver("foo.arrow"), "readers.arrow");
+    EXPECT_EQ(f.inferWriterDriver("foo.feather"), "writers.arrow");
+    EXPECT_EQ(f.inferWriterDriver("foo.parq"), "writers.arrow");
+}
+
+
+TEST(ArrowTest, roundtrip_arrow)
+{
+    Options ops;
+    ops.add("batch_size", 200);
+    testRoundtrip("arrowtest.arrow", ops);
+
+    ops.add("compression", "zstd");
+    ops.add("threads", 3);
+    testRoundtrip("arrowtest.arrow", ops);
+}
+
+
+TEST(ArrowTest, roundtrip_parquet)
+{
+    Options ops;
+    ops.add("batch_size", 200);
+    testRoundtrip("arrowtest.parquet", ops);
+
+    ops.add("compression", "zstd");
+    ops.add("threads", 3);
+    ops.add("dictionary_dims", "Classification, ReturnNumber");
+    testRoundtrip("arrowtest.parquet", ops);
+}
+
+
+TEST(ArrowTest, stream)
+{
+    Options ops;
+    ops.add("batch_size", 256);
+    testStreaming("arrowtest.arrow", ops);
+    testStreaming("arrowtest.parquet", ops);
+}
+
+
+TEST(ArrowTest, stream_read)
+{
+    std::string outfile(Support::temppath("arrowtest.parquet"));
+    FileUtils::deleteFile(outfile);
+
+    PointTable table;
+    PointViewPtr orig = readLas(table);
+    {
+        BufferReader bufferReader;
+        bufferReader.addView(orig);
+
+        Options ops;
+        ops.add("filename", outfile);
+        ops.add("batch_size", 100);
+        ArrowWriter writer;
+        writer.setOptions(ops);
+        writer.setInput(bufferReader);
+        writer.prepare(table);
+        writer.execute(table);
+    }
+
+    class Checker : public Filter
+    {
+    public:
+        Checker(const PointView& orig) : m_orig(orig), m_cnt(0)
+        {}
+
+        std::string getName() const
+            { return "checker"; }
+        point_count_t count() const
+            { return m_cnt; }
+
+    private:
+        const PointView& m_orig;
+        point_count_t m_cnt;
+
+        bool processOne(PointRef& p)
+        {
+            EXPECT_EQ(p.getFieldAs<double>(Dimension::Id::X),
+                m_orig.getFieldAs<double>(Dimension::Id::X, m_cnt));
+            EXPECT_EQ(p.getFieldAs<uint16_t>(Dimension::Id::Red),
+                m_orig.getFieldAs<uint16_t>(Dimension::Id::Red, m_cnt));
+            m_cnt++;
+            return true;
+        }
+    };
+
+    Options ops;
+    ops.add("filename", outfile);
+    ArrowReader reader;
+    reader.setOptions(ops);
+
+    Checker c(*orig);
+    c.setInput(reader);
+
+    FixedPointTable t(64);
+    c.prepare(t);
+    c.execute(t);
+    EXPECT_EQ(c.count(), orig->size());
+
+    FileUtils::deleteFile(outfile);
+}
+
+
+TEST(ArrowTest, badOptions)
+{
+    PointTable table;
+
+    Options ops;
+    ops.add("filename", Support::temppath("arrowtest.arrow"));
+    ops.add("compression", "snappy");
+    ArrowWriter writer;
+    writer.setOptions(ops);
+    EXPECT_THROW(writer.prepare(table), pdal_error);
+
+    Options ops2;
+    ops2.add("filename", Support::temppath("arrowtest.arrow"));
+    ops2.add("format", "orc");
+    ArrowWriter writer2;
+    writer2.setOptions(ops2);
+    EXPECT_THROW(writer2.prepare(table), pdal_error);
+
+    Options ops3;
+    ops3.add("filename", Support::temppath("arrowtest.arrow"));
+    ops3.add("threads", 0);
+    ArrowWriter writer3;
+    writer3.setOptions(ops3);
+    EXPECT_THROW(writer3.prepare(table), pdal_error);
+}
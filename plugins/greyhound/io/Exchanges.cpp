@@ -205,11 +205,13 @@ Read::Read(
         const PointLayoutPtr layout,
         const std::string& sessionId,
         bool compress,
-        int offset,
-        int count)
+        PointId firstId,
+        point_count_t offset,
+        point_count_t count)
     : Exchange("read")
     , m_view(view)
     , m_layout(layout)
+    , m_nextId(firstId)
     , m_initialized(false)
     , m_error(false)
     , m_pointsToRead(0)
@@ -219,8 +221,8 @@ Read::Read(
 {
     m_req["session"] = sessionId;
     m_req["compress"] = compress;
-    m_req["start"] = offset;
-    if (count != -1) m_req["count"] = count;
+    m_req["start"] = static_cast<Json::UInt64>(offset);
+    m_req["count"] = static_cast<Json::UInt64>(count);
 }
 
 bool Read::check()
@@ -263,13 +265,35 @@ std::size_t Read::numRead() const
     return m_pointsToRead;
 }
 
+void Read::writePoints(const char* pos, const point_count_t count)
+{
+    const PointId doneId(m_nextId + count);
+
+    while (m_nextId < doneId)
+    {
+        for (const auto& dim : m_layout->dims())
+        {
+            m_view->setField(
+                    dim,
+                    m_layout->dimType(dim),
+                    m_nextId,
+                    pos);
+
+            pos += m_layout->dimSize(dim);
+        }
+
+        ++m_nextId;
+    }
+}
+
 ReadUncompressed::ReadUncompressed(
         PointViewPtr view,
         const PointLayoutPtr layout,
         const std::string& sessionId,
-        int offset,
-        int count)
-    : Read(view, layout, sessionId, false, offset, count)
+        PointId firstId,
+        point_count_t offset,
+        point_count_t count)
+    : Read(view, layout, sessionId, false, firstId, offset, count)
 { }
 
 bool ReadUncompressed::done()
@@ -296,26 +320,7 @@ void ReadUncompressed::handleRx(const message_ptr message)
 
             const std::size_t wholePoints(m_data.size() / stride);
 
-            PointId nextId(m_view->size());
-            const PointId doneId(nextId + wholePoints);
-
-            const char* pos(m_data.data());
-
-            while (nextId < doneId)
-            {
-                for (const auto& dim : m_layout->dims())
-                {
-                    m_view->setField(
-                            dim,
-                            m_layout->dimType(dim),
-                            nextId,
-                            pos);
-
-                    pos += m_layout->dimSize(dim);
-                }
-
-                ++nextId;
-            }
+            writePoints(m_data.data(), wholePoints);
 
             m_numBytesReceived += rawNumBytes;
             m_data.assign(
@@ -334,58 +339,33 @@ ReadCompressed::ReadCompressed(
         PointViewPtr view,
         const PointLayoutPtr layout,
         const std::string& sessionId,
-        int offset,
-        int count)
-    : Read(view, layout, sessionId, true, offset, count)
-    , m_decompressionThread()
+        PointId firstId,
+        point_count_t offset,
+        point_count_t count)
+    : Read(view, layout, sessionId, true, firstId, offset, count)
     , m_compressionStream()
     , m_decompressor(m_compressionStream, layout->dimTypes())
     , m_done(false)
-    , m_doneCv()
-    , m_doneMutex()
+    , m_cv()
     , m_mutex()
 { }
 
 bool ReadCompressed::done()
 {
-    std::unique_lock<std::mutex> lock(m_doneMutex);
-    m_doneCv.wait(lock, [this]()->bool { return m_done; });
-    return true;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_done || m_error;
 }
 
 void ReadCompressed::handleRx(const message_ptr message)
 {
-    std::lock_guard<std::mutex> lock(m_mutex);
-    if (!m_initialized)
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (!m_initialized && !m_error)
     {
         m_initialized = check();
         if (!m_initialized) m_error = true;
 
-        m_data.resize(m_numBytes);
-
-        m_decompressionThread = std::thread([this]()->void {
-            m_decompressor.decompress(m_data.data(), m_data.size());
-
-            const char* pos(m_data.data());
-            for (PointId i(0); i < m_pointsToRead; ++i)
-            {
-                for (const auto& dim : m_layout->dims())
-                {
-                    m_view->setField(
-                            dim,
-                            m_layout->dimType(dim),
-                            i,
-                            pos);
-
-                    pos += m_layout->dimSize(dim);
-                }
-            }
-
-            m_done = true;
-            m_doneCv.notify_all();
-        });
-
-        m_decompressionThread.detach();
+        lock.unlock();
+        m_cv.notify_all();
     }
     else
     {
@@ -403,6 +383,33 @@ void ReadCompressed::handleRx(const message_ptr message)
         }
     }
 }
+
+void ReadCompressed::process()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_cv.wait(lock, [this]()->bool { return m_initialized || m_error; });
+    if (m_error) return;
+    lock.unlock();
+
+    // Decompress on the thread that started the exchange while the rest of
+    // the payload is still arriving, a block of points at a time.
+    const std::size_t pointSize(m_layout->pointSize());
+    const point_count_t blockSize(4096);
+    std::vector<char> block(blockSize * pointSize);
+
+    point_count_t remaining(m_pointsToRead);
+    while (remaining)
+    {
+        const point_count_t count(std::min(blockSize, remaining));
+
+        m_decompressor.decompress(block.data(), count * pointSize);
+        writePoints(block.data(), count);
+        remaining -= count;
+    }
+
+    lock.lock();
+    m_done = true;
+}
 #endif
 
 
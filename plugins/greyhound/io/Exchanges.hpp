@@ -38,7 +38,6 @@
 #include <vector>
 #include <mutex>
 #include <condition_variable>
-#include <thread>
 
 #include <pdal/Dimension.hpp>
 #include <pdal/Compression.hpp>
@@ -114,13 +113,17 @@ private:
 class Read : public Exchange
 {
 public:
+    // Points are written to the view starting at 'firstId'.  Points that
+    // already exist in the view are overwritten, which lets several reads
+    // fill their own ranges of a view concurrently.
     Read(
             PointViewPtr view,
             const PointLayoutPtr layout,
             const std::string& sessionId,
             bool compress,
-            int offset,
-            int count);
+            PointId firstId,
+            point_count_t offset,
+            point_count_t count);
 
     virtual bool check();
     virtual bool done() = 0;
@@ -129,8 +132,11 @@ public:
     std::size_t numRead() const;
 
 protected:
+    void writePoints(const char* pos, point_count_t count);
+
     PointViewPtr m_view;
     const PointLayoutPtr m_layout;
+    PointId m_nextId;
 
     bool m_initialized;
     bool m_error;
@@ -147,8 +153,9 @@ public:
             PointViewPtr view,
             const PointLayoutPtr,
             const std::string& sessionId,
-            int offset = 0,
-            int count = -1);
+            PointId firstId,
+            point_count_t offset,
+            point_count_t count);
 
     virtual bool done();
     virtual void handleRx(const message_ptr message);
@@ -162,23 +169,21 @@ public:
             PointViewPtr view,
             const PointLayoutPtr,
             const std::string& sessionId,
-            int offset = 0,
-            int count = -1);
+            PointId firstId,
+            point_count_t offset,
+            point_count_t count);
 
     virtual bool done();
     virtual void handleRx(const message_ptr message);
+    virtual void process();
 
 private:
-    std::thread m_decompressionThread;
-
     CompressionStream m_compressionStream;
 
     LazPerfDecompressor<CompressionStream> m_decompressor;
 
     bool m_done;
-    std::condition_variable m_doneCv;
-    std::mutex m_doneMutex;
-
+    std::condition_variable m_cv;
     std::mutex m_mutex;
 };
 #endif
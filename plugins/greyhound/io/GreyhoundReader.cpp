@@ -34,6 +34,7 @@
 
 #include "GreyhoundReader.hpp"
 #include "Exchanges.hpp"
+#include <pdal/PDALUtils.hpp>
 #include <pdal/pdal_macros.hpp>
 
 namespace pdal
@@ -56,6 +57,8 @@ GreyhoundReader::GreyhoundReader()
     , m_wsClient()
     , m_numPoints(0)
     , m_index(0)
+    , m_chunkSize(0)
+    , m_threads(1)
 { }
 
 GreyhoundReader::~GreyhoundReader()
@@ -77,6 +80,9 @@ void GreyhoundReader::processOptions(const Options& options)
 {
     m_url = options.getValueOrThrow<std::string>("url");
     m_pipelineId = options.getValueOrThrow<std::string>("pipeline_id");
+    m_chunkSize = options.getValueOrDefault<point_count_t>("chunk_size", 0);
+    m_threads = options.getValueOrDefault<int>("threads", 1);
+    Utils::checkThreads(getName(), m_threads);
 
     m_wsClient.initialize(m_url);
 }
@@ -99,6 +105,8 @@ void GreyhoundReader::addDimensions(PointLayoutPtr layout)
 
 void GreyhoundReader::ready(PointTableRef)
 {
+    m_index = 0;
+
     // Get number of points.
     exchanges::GetNumPoints numPointsExchange(m_sessionId);
     m_wsClient.exchange(numPointsExchange);
@@ -107,9 +115,75 @@ void GreyhoundReader::ready(PointTableRef)
 
 point_count_t GreyhoundReader::read(
         PointViewPtr view,
+        point_count_t count)
+{
+    count = std::min(count, m_numPoints - std::min(m_index, m_numPoints));
+    if (!count) return 0;
+
+    // Create the points up front so that chunks can be written into their
+    // own ranges of the view concurrently.
+    const PointId firstId(view->size());
+    const Dimension::Id::Enum dim(m_layout->dims().front());
+    for (PointId id(firstId); id < firstId + count; ++id)
+    {
+        view->setField(dim, id, 0);
+    }
+
+    const point_count_t chunkSize(m_chunkSize ? m_chunkSize : count);
+    const std::size_t numChunks((count + chunkSize - 1) / chunkSize);
+
+    std::vector<point_count_t> numRead(numChunks);
+
+    // Each worker takes a contiguous run of chunks and reads them over its
+    // own connection while the other workers' reads are in transit.
+    const std::size_t numThreads(
+            std::min<std::size_t>(m_threads, numChunks));
+    const std::size_t perThread((numChunks + numThreads - 1) / numThreads);
+    const std::size_t numRuns((numChunks + perThread - 1) / perThread);
+
+    Utils::parallelFor(numRuns, numRuns, [&](std::size_t run)
+    {
+        WebSocketClient client(m_url);
+
+        const std::size_t first(run * perThread);
+        const std::size_t last(std::min(first + perThread, numChunks));
+        for (std::size_t i(first); i < last; ++i)
+        {
+            const point_count_t offset(i * chunkSize);
+
+            numRead[i] = readChunk(
+                    client,
+                    view,
+                    firstId + offset,
+                    m_index + offset,
+                    std::min(chunkSize, count - offset));
+        }
+    });
+
+    for (std::size_t i(0); i < numChunks; ++i)
+    {
+        const point_count_t expected(
+                std::min(chunkSize, count - i * chunkSize));
+        if (numRead[i] != expected)
+        {
+            std::ostringstream oss;
+            oss << getName() << ": Server returned " << numRead[i] <<
+                " points for a request of " << expected << " points.";
+            throw pdal_error(oss.str());
+        }
+    }
+
+    m_index += count;
+    return count;
+}
+
+point_count_t GreyhoundReader::readChunk(
+        WebSocketClient& client,
+        PointViewPtr view,
+        const PointId firstId,
+        const point_count_t offset,
         const point_count_t count)
 {
-    // Read data.
 #ifdef PDAL_HAVE_LAZPERF
     exchanges::ReadCompressed readExchange(
 #else
@@ -118,10 +192,11 @@ point_count_t GreyhoundReader::read(
             view,
             m_layout,
             m_sessionId,
-            m_index,
+            firstId,
+            offset,
             count);
 
-    m_wsClient.exchange(readExchange);
+    client.exchange(readExchange);
     return readExchange.numRead();
 }
 
@@ -60,6 +60,8 @@ private:
     WebSocketClient m_wsClient;
     point_count_t m_numPoints;
     point_count_t m_index;
+    point_count_t m_chunkSize;
+    int m_threads;
 
     virtual void initialize();
     virtual void processOptions(const Options& options);
@@ -67,6 +69,13 @@ private:
     virtual void ready(PointTableRef table);
     virtual point_count_t read(PointViewPtr view, point_count_t count);
     virtual bool eof() const;
+
+    point_count_t readChunk(
+            WebSocketClient& client,
+            PointViewPtr view,
+            PointId firstId,
+            point_count_t offset,
+            point_count_t count);
 };
 
 } // namespace pdal
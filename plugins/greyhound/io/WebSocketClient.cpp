@@ -107,17 +107,13 @@ void WebSocketClient::exchange(WebSocketExchange& exchange)
         {
             exchange.addResponse(msg);
 
-            std::thread tDone([this, &exchange, &done]() {
-                if (exchange.done())
-                {
-                    std::unique_lock<std::mutex> lock(this->m_mutex);
-                    done = true;
-                    lock.unlock();
-                    this->m_cv.notify_all();
-                }
-            });
-
-            tDone.detach();
+            if (exchange.done())
+            {
+                std::unique_lock<std::mutex> lock(this->m_mutex);
+                done = true;
+                lock.unlock();
+                this->m_cv.notify_all();
+            }
         });
 
         websocketpp::lib::error_code ec;
@@ -128,8 +124,13 @@ void WebSocketClient::exchange(WebSocketExchange& exchange)
 
     t.detach();
 
+    exchange.process();
+
     std::unique_lock<std::mutex> lock(m_mutex);
-    m_cv.wait(lock, [&done]()->bool { return done; });
+    m_cv.wait(lock, [&done, &exchange]()->bool
+    {
+        return done || exchange.done();
+    });
 
     m_client.stop();
 
@@ -150,7 +151,7 @@ void WebSocketClient::exchange(WebSocketExchange& exchange)
             std::cout << message << std::endl;
         }
 
-        throw new pdal::pdal_error(message);
+        throw pdal::pdal_error(message);
     }
 }
 
@@ -59,9 +59,15 @@ public:
         handleRx(message);
     }
 
+    // Must not block: it's called from the network thread as each
+    // response arrives.
     virtual bool done() { return true; }
     virtual bool check() { return true; }
 
+    // Called on the thread that started the exchange while responses are
+    // being received, so that work on them can overlap with the transfer.
+    virtual void process() { }
+
 protected:
     WebSocketExchange() : m_req(), m_res() { }
     virtual void handleRx(const message_ptr) { }
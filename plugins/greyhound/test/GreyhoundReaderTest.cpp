@@ -0,0 +1,236 @@
+/******************************************************************************
+* Copyright (c) 2015, Howard Butler (howard@hobu.co)
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+#include <pdal/pdal_test_main.hpp>
+
+#include <atomic>
+#include <thread>
+
+#include <json/json.h>
+#include <websocketpp/config/asio_no_tls.hpp>
+#include <websocketpp/server.hpp>
+
+#include <pdal/Compression.hpp>
+#include <pdal/PointView.hpp>
+#include <pdal/StageFactory.hpp>
+
+using namespace pdal;
+
+namespace
+{
+
+typedef websocketpp::server<websocketpp::config::asio> asioServer;
+
+const uint16_t c_port = 38765;
+
+// Minimal stand-in for a Greyhound server that serves the points of a
+// view.  Read responses are sent in several binary frames to exercise
+// incremental decoding.
+class MockGreyhound
+{
+public:
+    MockGreyhound(PointViewPtr view) : m_view(view), m_numReads(0)
+    {
+        m_server.clear_access_channels(websocketpp::log::alevel::all);
+        m_server.clear_error_channels(websocketpp::log::elevel::all);
+        m_server.init_asio();
+        m_server.set_reuse_addr(true);
+        m_server.set_message_handler(
+            [this](websocketpp::connection_hdl hdl,
+                asioServer::message_ptr msg)
+            {
+                handle(hdl, msg);
+            });
+        m_server.listen(c_port);
+        m_server.start_accept();
+        m_thread = std::thread([this]() { m_server.run(); });
+    }
+
+    ~MockGreyhound()
+    {
+        m_server.stop_listening();
+        m_server.stop();
+        m_thread.join();
+    }
+
+    int numReads() const
+        { return m_numReads; }
+
+private:
+    void send(websocketpp::connection_hdl hdl, const Json::Value& json)
+    {
+        m_server.send(hdl, json.toStyledString(),
+            websocketpp::frame::opcode::text);
+    }
+
+    void handle(websocketpp::connection_hdl hdl,
+        asioServer::message_ptr msg)
+    {
+        Json::Value req;
+        Json::Reader reader;
+        reader.parse(msg->get_payload(), req);
+
+        const std::string command(req["command"].asString());
+        Json::Value res;
+        res["status"] = 1;
+
+        if (command == "create")
+            res["session"] = "mock";
+        else if (command == "pointsCount")
+            res["count"] = static_cast<Json::UInt64>(m_view->size());
+        else if (command == "schema")
+        {
+            for (const auto& dt : m_view->dimTypes())
+            {
+                Json::Value dim;
+                dim["name"] = m_view->dimName(dt.m_id);
+                dim["type"] = Dimension::toName(Dimension::base(dt.m_type));
+                dim["size"] = std::to_string(Dimension::size(dt.m_type));
+                res["schema"].append(dim);
+            }
+        }
+        else if (command == "read")
+        {
+            m_numReads++;
+            sendPoints(hdl, req, res);
+            return;
+        }
+        send(hdl, res);
+    }
+
+    void sendPoints(websocketpp::connection_hdl hdl, const Json::Value& req,
+        Json::Value& res)
+    {
+        const PointId start(req["start"].asUInt64());
+        const PointId end(std::min<PointId>(m_view->size(),
+            start + req["count"].asUInt64()));
+        const DimTypeList dimTypes(m_view->dimTypes());
+        const std::size_t pointSize(m_view->pointSize());
+
+        std::vector<char> raw((end - start) * pointSize);
+        for (PointId idx = start; idx < end; ++idx)
+            m_view->getPackedPoint(dimTypes, idx,
+                raw.data() + (idx - start) * pointSize);
+
+        res["numPoints"] = static_cast<Json::UInt64>(end - start);
+        res["numBytes"] = static_cast<Json::UInt64>(raw.size());
+        send(hdl, res);
+
+        std::vector<unsigned char> payload;
+        if (req["compress"].asBool())
+        {
+            LazPerfBuf buf(payload);
+            LazPerfCompressor<LazPerfBuf> compressor(buf, dimTypes);
+            compressor.compress(raw.data(), raw.size());
+            compressor.done();
+        }
+        else
+            payload.assign(raw.begin(), raw.end());
+
+        const std::size_t frameSize(1000);
+        for (std::size_t pos = 0; pos < payload.size(); pos += frameSize)
+            m_server.send(hdl, payload.data() + pos,
+                std::min(frameSize, payload.size() - pos),
+                websocketpp::frame::opcode::binary);
+    }
+
+    PointViewPtr m_view;
+    asioServer m_server;
+    std::thread m_thread;
+    std::atomic<int> m_numReads;
+};
+
+void checkRead(int threads, point_count_t chunkSize, int expectedReads)
+{
+    PointTable sourceTable;
+    sourceTable.layout()->registerDim(Dimension::Id::X);
+    sourceTable.layout()->registerDim(Dimension::Id::Y);
+    sourceTable.layout()->registerDim(Dimension::Id::Z);
+    sourceTable.finalize();
+
+    PointViewPtr source(new PointView(sourceTable));
+    for (PointId idx = 0; idx < 1000; ++idx)
+    {
+        source->setField(Dimension::Id::X, idx, idx);
+        source->setField(Dimension::Id::Y, idx, idx * 2);
+        source->setField(Dimension::Id::Z, idx, idx * 3);
+    }
+
+    MockGreyhound server(source);
+
+    Options options;
+    options.add("url", "ws://localhost:" + std::to_string(c_port));
+    options.add("pipeline_id", "mock");
+    options.add("threads", threads);
+    options.add("chunk_size", chunkSize);
+
+    PointViewSet viewSet;
+    PointTable table;
+    {
+        StageFactory f;
+        Stage* reader(f.createStage("readers.greyhound"));
+        ASSERT_TRUE(reader);
+        reader->setOptions(options);
+        reader->prepare(table);
+        viewSet = reader->execute(table);
+    }
+
+    EXPECT_EQ(server.numReads(), expectedReads);
+    ASSERT_EQ(viewSet.size(), 1u);
+    PointViewPtr view = *viewSet.begin();
+    ASSERT_EQ(view->size(), 1000u);
+    for (PointId idx = 0; idx < view->size(); ++idx)
+    {
+        EXPECT_EQ(view->getFieldAs<double>(Dimension::Id::X, idx), idx);
+        EXPECT_EQ(view->getFieldAs<double>(Dimension::Id::Y, idx), idx * 2);
+        EXPECT_EQ(view->getFieldAs<double>(Dimension::Id::Z, idx), idx * 3);
+    }
+}
+
+} // unnamed namespace
+
+TEST(GreyhoundReaderTest, single)
+{
+    checkRead(1, 0, 1);
+}
+
+TEST(GreyhoundReaderTest, chunked)
+{
+    checkRead(1, 128, 8);
+}
+
+TEST(GreyhoundReaderTest, concurrent)
+{
+    checkRead(4, 100, 10);
+}
@@ -56,6 +56,16 @@ void HexBin::processOptions(const Options& options)
     m_sampleSize = options.getValueOrDefault<uint32_t>("sample_size", 5000);
     m_density = options.getValueOrDefault<uint32_t>("threshold", 15);
     m_outputTesselation = options.getValueOrDefault<bool>("output_tesselation", false);
+    // Read as signed so that a negative value is rejected rather than
+    // wrapped.
+    int stride = options.getValueOrDefault<int>("stride", 1);
+    if (stride < 1)
+    {
+        std::ostringstream oss;
+        oss << getName() << ": Option 'stride' must be at least 1.";
+        throw pdal_error(oss.str());
+    }
+    m_stride = (uint32_t)stride;
 
     if (options.hasOption("edge_length"))
         m_edgeLength = options.getValueOrDefault<double>("edge_length", 0.0);
@@ -78,9 +88,24 @@ void HexBin::ready(PointTableRef table)
 }
 
 
+// Only every m_stride'th point is binned.  Points are counted across
+// views, so the same points are binned in standard and stream mode.
+bool HexBin::processOne(PointRef& point)
+{
+    if (m_count++ % m_stride == 0)
+    {
+        double x = point.getFieldAs<double>(Dimension::Id::X);
+        double y = point.getFieldAs<double>(Dimension::Id::Y);
+        m_grid->addPoint(x, y);
+    }
+    return true;
+}
+
+
 void HexBin::filter(PointView& view)
 {
-    for (PointId idx = 0; idx < view.size(); ++idx)
+    PointId first = (m_stride - m_count % m_stride) % m_stride;
+    for (PointId idx = first; idx < view.size(); idx += m_stride)
     {
         double x = view.getFieldAs<double>(pdal::Dimension::Id::X, idx);
         double y = view.getFieldAs<double>(pdal::Dimension::Id::Y, idx);
@@ -119,6 +144,8 @@ void HexBin::done(PointTableRef table)
         "for edge_size if you want to compute one.");
     m_metadata.add("hex_offsets", offsets.str(), "Offset of hex corners from "
         "hex centers.");
+    m_metadata.add("stride", m_stride, "Only every 'stride' point was "
+        "binned");
 
     uint32_t precision  = m_options.getValueOrDefault<uint32_t>("precision", 8);
     std::ostringstream polygon;
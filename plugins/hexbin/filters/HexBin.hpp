@@ -62,10 +62,14 @@ private:
     int32_t m_density;
     double m_edgeLength;
     bool m_outputTesselation;
+    uint32_t m_stride;
     point_count_t m_count;
 
     virtual void processOptions(const Options& options);
     virtual void ready(PointTableRef table);
+    virtual bool streamable() const
+        { return true; }
+    virtual bool processOne(PointRef& point);
     virtual void filter(PointView& view);
     virtual void done(PointTableRef table);
 
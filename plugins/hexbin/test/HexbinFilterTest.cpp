@@ -94,3 +94,67 @@ TEST(HexbinFilterTest, HexbinFilterTest_test_1)
     out.close();
     FileUtils::deleteFile(filename);
 }
+
+namespace
+{
+
+// Bins hextest.las with the given stride and returns the filter's
+// metadata as text.  In standard mode the points are split into views
+// whose size isn't a multiple of the stride.
+std::string hexbinStride(int stride, bool stream)
+{
+    StageFactory f;
+
+    Options readerOps;
+    readerOps.add("filename", Support::datapath("las/hextest.las"));
+    Stage* reader(f.createStage("readers.las"));
+    reader->setOptions(readerOps);
+
+    Options dividerOps;
+    dividerOps.add("mode", "partition");
+    dividerOps.add("capacity", 1000);
+    Stage* divider(f.createStage("filters.divider"));
+    divider->setOptions(dividerOps);
+    divider->setInput(*reader);
+
+    Options hexOps;
+    hexOps.add("output_tesselation", true);
+    hexOps.add("threshold", 1);
+    hexOps.add("edge_length", 0.666666666);
+    hexOps.add("stride", stride);
+    Stage* hexbin(f.createStage("filters.hexbin"));
+    hexbin->setOptions(hexOps);
+
+    std::ostringstream out;
+    if (stream)
+    {
+        hexbin->setInput(*reader);
+        FixedPointTable table(100);
+        hexbin->prepare(table);
+        hexbin->execute(table);
+        printChildren(out, table.metadata().findChild(hexbin->getName()));
+    }
+    else
+    {
+        hexbin->setInput(*divider);
+        PointTable table;
+        hexbin->prepare(table);
+        hexbin->execute(table);
+        printChildren(out, table.metadata().findChild(hexbin->getName()));
+    }
+    return out.str();
+}
+
+} // unnamed namespace
+
+TEST(HexbinFilterTest, stride)
+{
+    std::string standard = hexbinStride(3, false);
+    std::string stream = hexbinStride(3, true);
+    EXPECT_EQ(standard, stream);
+    EXPECT_NE(standard.find("stride : 3"), std::string::npos);
+    EXPECT_NE(standard, hexbinStride(1, false));
+
+    EXPECT_THROW(hexbinStride(0, false), pdal_error);
+    EXPECT_THROW(hexbinStride(-1, true), pdal_error);
+}
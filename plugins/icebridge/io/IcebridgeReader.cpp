@@ -56,6 +56,14 @@ namespace
         { "instrument_parameters/pulse_width",  H5::PredType::NATIVE_FLOAT },
         { "instrument_parameters/rel_time",     H5::PredType::NATIVE_FLOAT }
     };
+
+    // Number of points read from each dataset at a time.
+    const pdal::point_count_t c_chunkSize = 65536;
+
+    //All data we read for icebridge is currently 4 bytes wide.
+    const std::size_t c_valueSize = sizeof(float);
+    static_assert(sizeof(int32_t) == c_valueSize,
+        "Icebridge column values must all be the same size.");
 }
 
 namespace pdal
@@ -112,6 +120,10 @@ void IcebridgeReader::ready(PointTableRef table)
 {
     m_hdf5Handler.initialize(m_filename, hdf5Columns);
     m_index = 0;
+    m_chunkCount = 0;
+    m_chunkPos = 0;
+    m_buffers.assign(hdf5Columns.size(),
+        std::vector<char>(c_chunkSize * c_valueSize));
 }
 
 void IcebridgeReader::initialize(PointTableRef)
@@ -138,70 +150,125 @@ double IcebridgeReader::convertLongitude(double longitude)
 
 
 
-point_count_t IcebridgeReader::read(PointViewPtr view, point_count_t count)
+// Read up to 'count' points (no more than a chunk) starting at m_index from
+// every column into the column buffers.  Points are read from all columns
+// in bounded hyperslabs so that a file is never loaded whole.
+point_count_t IcebridgeReader::loadChunk(point_count_t count)
 {
-    //All data we read for icebridge is currently 4 bytes wide, so
-    //  just allocate once and forget it.
-    //This could be a huge allocation.  Perhaps we should do something
-    //  in the icebridge handler?
+    count = std::min(count, c_chunkSize);
+    count = std::min(count, m_hdf5Handler.getNumPoints() - m_index);
 
-    PointId startId = view->size();
-    point_count_t remaining = m_hdf5Handler.getNumPoints() - m_index;
-    count = std::min(count, remaining);
-
-    std::unique_ptr<unsigned char>
-        rawData(new unsigned char[count * sizeof(float)]);
-
-    //Not loving the position-linked data, but fine for now.
-    Dimension::IdList dims = getDefaultDimensions();
-    auto di = dims.begin();
-    for (auto ci = hdf5Columns.begin(); ci != hdf5Columns.end(); ++ci, ++di)
+    for (std::size_t c = 0; c < hdf5Columns.size(); ++c)
     {
-        PointId nextId = startId;
-        PointId idx = m_index;
-        const hdf5::Hdf5ColumnData& column = *ci;
-
         try
         {
-            m_hdf5Handler.getColumnEntries(rawData.get(), column.name, count,
-                m_index);
-            void *p = (void *)rawData.get();
-
-            // This is ugly but avoids a test in a tight loop.
-            if (column.predType == H5::PredType::NATIVE_FLOAT)
-            {
-                // Offset time is in ms but icebridge stores in seconds.
-                if (*di == Dimension::Id::OffsetTime)
-                {
-                    float *fval = (float *)p;
-                    for (PointId i = 0; i < count; ++i)
-                    {
-                        view->setField(*di, nextId++, *fval * 1000);
-                        fval++;
-                    }
-                }
-                else
-                {
-                    float *fval = (float *)p;
-                    for (PointId i = 0; i < count; ++i)
-                        view->setField(*di, nextId++, *fval++);
-                }
-            }
-            else if (column.predType == H5::PredType::NATIVE_INT)
-            {
-                int32_t *ival = (int32_t *)p;
-                for (PointId i = 0; i < count; ++i)
-                    view->setField(*di, nextId++, *ival++);
-            }
+            m_hdf5Handler.getColumnEntries(m_buffers[c].data(),
+                hdf5Columns[c].name, count, m_index);
         }
         catch(...)
         {
             throw icebridge_error("Error fetching column data");
         }
     }
+    m_chunkCount = count;
+    m_chunkPos = 0;
     return count;
 }
 
+
+// Set a dimension of the points of the current chunk from a column
+// buffer.
+void IcebridgeReader::setColumn(PointView& view, PointId startId,
+    std::size_t column, Dimension::Id::Enum dim)
+{
+    PointId nextId = startId;
+    const char *p = m_buffers[column].data();
+
+    // This is ugly but avoids a test in a tight loop.
+    if (hdf5Columns[column].predType == H5::PredType::NATIVE_FLOAT)
+    {
+        const float *fval = (const float *)p;
+        // Offset time is in ms but icebridge stores in seconds.
+        if (dim == Dimension::Id::OffsetTime)
+        {
+            for (PointId i = 0; i < m_chunkCount; ++i)
+                view.setField(dim, nextId++, *fval++ * 1000);
+        }
+        else
+        {
+            for (PointId i = 0; i < m_chunkCount; ++i)
+                view.setField(dim, nextId++, *fval++);
+        }
+    }
+    else if (hdf5Columns[column].predType == H5::PredType::NATIVE_INT)
+    {
+        const int32_t *ival = (const int32_t *)p;
+        for (PointId i = 0; i < m_chunkCount; ++i)
+            view.setField(dim, nextId++, *ival++);
+    }
+}
+
+
+// Get the value of a dimension for the current point of the chunk.
+double IcebridgeReader::value(std::size_t column,
+    Dimension::Id::Enum dim) const
+{
+    const char *p = m_buffers[column].data() + m_chunkPos * c_valueSize;
+
+    if (hdf5Columns[column].predType == H5::PredType::NATIVE_INT)
+        return *(const int32_t *)p;
+
+    double d = *(const float *)p;
+    // Offset time is in ms but icebridge stores in seconds.
+    if (dim == Dimension::Id::OffsetTime)
+        d *= 1000;
+    return d;
+}
+
+
+point_count_t IcebridgeReader::read(PointViewPtr view, point_count_t count)
+{
+    //Not loving the position-linked data, but fine for now.
+    Dimension::IdList dims = getDefaultDimensions();
+
+    PointId nextId = view->size();
+    point_count_t numRead = 0;
+    while (numRead < count)
+    {
+        point_count_t chunkCount = loadChunk(count - numRead);
+        if (chunkCount == 0)
+            break;
+
+        for (std::size_t c = 0; c < hdf5Columns.size(); ++c)
+            setColumn(*view, nextId, c, dims[c]);
+
+        m_chunkPos = chunkCount;
+        m_index += chunkCount;
+        nextId += chunkCount;
+        numRead += chunkCount;
+    }
+    return numRead;
+}
+
+
+bool IcebridgeReader::processOne(PointRef& point)
+{
+    if (m_index >= m_hdf5Handler.getNumPoints() || m_index >= m_count)
+        return false;
+
+    if (m_chunkPos == m_chunkCount)
+        loadChunk(c_chunkSize);
+
+    //Not loving the position-linked data, but fine for now.
+    static const Dimension::IdList dims = getDefaultDimensions();
+    for (std::size_t c = 0; c < hdf5Columns.size(); ++c)
+        point.setField(dims[c], value(c, dims[c]));
+
+    m_chunkPos++;
+    m_index++;
+    return true;
+}
+
 void IcebridgeReader::processOptions(const Options& options)
 {
     m_metadataFile =
@@ -83,15 +83,27 @@ private:
     Hdf5Handler m_hdf5Handler;
     point_count_t m_index;
 
+    // Values of the current chunk of points, one buffer per column.
+    std::vector<std::vector<char>> m_buffers;
+    point_count_t m_chunkCount;
+    point_count_t m_chunkPos;
+
     virtual void addDimensions(PointLayoutPtr layout);
     virtual void ready(PointTableRef table);
     virtual void processOptions(const Options& options);
     virtual point_count_t read(PointViewPtr view, point_count_t count);
+    virtual bool streamable() const
+        { return true; }
+    virtual bool processOne(PointRef& point);
     virtual void done(PointTableRef table);
     virtual bool eof();
     virtual void initialize(PointTableRef table);
 
     double convertLongitude(double longitude);
+    point_count_t loadChunk(point_count_t count);
+    void setColumn(PointView& view, PointId startId, std::size_t column,
+        Dimension::Id::Enum dim);
+    double value(std::size_t column, Dimension::Id::Enum dim) const;
 
     std::string m_metadataFile;
     Ilvis2MetadataReader m_mdReader;
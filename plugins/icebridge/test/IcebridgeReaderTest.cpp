@@ -38,6 +38,7 @@
 #include <pdal/PointView.hpp>
 #include <pdal/PipelineManager.hpp>
 #include <pdal/StageFactory.hpp>
+#include <streamcallback/StreamCallbackFilter.hpp>
 
 #include "Support.hpp"
 
@@ -137,6 +138,65 @@ TEST(IcebridgeReaderTest, testRead)
             0.0);           // relTime
 }
 
+TEST(IcebridgeReaderTest, testCount)
+{
+    StageFactory f;
+    Stage* reader(f.createStage("readers.icebridge"));
+    EXPECT_TRUE(reader);
+
+    Options options;
+    options.add("filename", getFilePath());
+    options.add("count", 1);
+    reader->setOptions(options);
+
+    PointTable table;
+    reader->prepare(table);
+    PointViewSet viewSet = reader->execute(table);
+    EXPECT_EQ(viewSet.size(), 1u);
+    PointViewPtr view = *viewSet.begin();
+    EXPECT_EQ(view->size(), 1u);
+    EXPECT_FLOAT_EQ(view->getFieldAs<float>(Dimension::Id::Y, 0), 82.605319);
+}
+
+TEST(IcebridgeReaderTest, testStream)
+{
+    StageFactory f;
+    Stage* reader(f.createStage("readers.icebridge"));
+    EXPECT_TRUE(reader);
+
+    Options options;
+    options.add("filename", getFilePath());
+    reader->setOptions(options);
+
+    PointTable table;
+    reader->prepare(table);
+    PointViewSet viewSet = reader->execute(table);
+    PointViewPtr view = *viewSet.begin();
+
+    const Dimension::IdList dims = view->dims();
+    point_count_t count = 0;
+    auto cb = [&count, &view, &dims](PointRef& point)
+    {
+        for (auto di = dims.begin(); di != dims.end(); ++di)
+            EXPECT_FLOAT_EQ(point.getFieldAs<float>(*di),
+                view->getFieldAs<float>(*di, count));
+        count++;
+        return true;
+    };
+
+    Stage* streamReader(f.createStage("readers.icebridge"));
+    streamReader->setOptions(options);
+
+    StreamCallbackFilter stream;
+    stream.setCallback(cb);
+    stream.setInput(*streamReader);
+
+    FixedPointTable streamTable(1);
+    stream.prepare(streamTable);
+    stream.execute(streamTable);
+    EXPECT_EQ(count, 2u);
+}
+
 TEST(IcebridgeReaderTest, testPipeline)
 {
     PipelineManager manager;
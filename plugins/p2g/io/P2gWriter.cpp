@@ -64,6 +64,26 @@ void P2gWriter::processOptions(const Options& options)
         "fill_window_size", 3);
     m_filename = options.getValueOrThrow<std::string>("filename");
 
+    try
+    {
+        m_userBounds = options.getValueOrDefault<BOX2D>("bounds", BOX2D());
+    }
+    catch (Option::cant_convert)
+    {
+        try
+        {
+            m_userBounds = options.getValueOrDefault<BOX3D>("bounds",
+                BOX3D()).to2d();
+        }
+        catch (Option::cant_convert)
+        {
+            std::ostringstream oss;
+            oss << getName() << ": Invalid bounds provided as option.  "
+                "Format: '([xmin,xmax],[ymin,ymax])'.";
+            throw pdal_error(oss.str());
+        }
+    }
+
     std::vector<Option> types = options.getOptions("output_type");
 
     if (!types.size())
@@ -114,14 +134,9 @@ void P2gWriter::processOptions(const Options& options)
 
 void P2gWriter::ready(PointTableRef table)
 {
-/*
-    double min_x = (std::numeric_limits<double>::max)();
-    double max_x = (std::numeric_limits<double>::min)();
-    double min_y = (std::numeric_limits<double>::max)();
-    double max_y = (std::numeric_limits<double>::min)();
-    setBounds(pdal::Bounds<double>(min_x, min_y, max_x, max_y));
-*/
-    if (!table.spatialReferenceUnique())
+    // A streaming table only ever holds the reader's spatial reference,
+    // and none at all if the reader doesn't have one.
+    if (table.supportsView() && !table.spatialReferenceUnique())
     {
         std::ostringstream oss;
 
@@ -129,48 +144,26 @@ void P2gWriter::ready(PointTableRef table)
             "references.";
         throw pdal_error(oss.str());
     }
-}
-
 
-Options P2gWriter::getDefaultOptions()
-{
-    Options options;
-
-    Option grid_x("grid_dist_x", 6.0, "X grid distance");
-    Option grid_y("grid_dist_y", 6.0, "Y grid distance");
-
-    double default_radius = (double) sqrt(2.0) * grid_x.getValue<double>();
-    Option radius("radius", default_radius);
-
-    Option fill_window_size("fill_window_size", 3);
-    Option dim_z("z", "Z", "Name of Z dimension to interpolate");
-    options.add(dim_z);
-    options.add(grid_x);
-    options.add(grid_y);
-    options.add(radius);
-    options.add(fill_window_size);
-    return options;
+    m_pointCount = 0;
+    m_skipCount = 0;
+    m_views.clear();
+    m_interpolator.reset();
 }
 
 
-void P2gWriter::write(const PointViewPtr view)
+// In stream mode the grid must be laid out before the first point
+// arrives, so its extent has to be given with the "bounds" option.  A
+// reader's header can't be trusted for this: filters may move points and
+// headers may be stale.
+bool P2gWriter::streamable() const
 {
-    for (point_count_t idx = 0; idx < view->size(); idx++)
-    {
-        double x = view->getFieldAs<double>(Dimension::Id::X, idx);
-        double y = view->getFieldAs<double>(Dimension::Id::Y, idx);
-        double z = view->getFieldAs<double>(Dimension::Id::Z, idx);
-        m_coordinates.push_back(Coordinate{x, y, z});
-    }
-
-    view->calculateBounds(m_bounds);
+    return !m_userBounds.empty();
 }
 
-void P2gWriter::done(PointTableRef table)
-{
-    // If we never got any points, we're done.
-    if (! m_coordinates.size()) return;
 
+void P2gWriter::createInterpolator()
+{
     m_GRID_SIZE_X = (int)(ceil((m_bounds.maxx - m_bounds.minx)/m_GRID_DIST_X)) + 1;
     m_GRID_SIZE_Y = (int)(ceil((m_bounds.maxy - m_bounds.miny)/m_GRID_DIST_Y)) + 1;
 
@@ -199,17 +192,103 @@ void P2gWriter::done(PointTableRef table)
     {
         throw p2g_error("unable to initialize interpolator");
     }
+}
 
-    for (auto coord : m_coordinates)
+
+void P2gWriter::update(double x, double y, double z)
+{
+    // Points outside of the grid would index past the interpolator's
+    // cells.
+    if (!m_bounds.contains(x, y))
     {
-        double x = coord.x - m_bounds.minx;
-        double y = coord.y - m_bounds.miny;
-        double z = coord.z;
+        m_skipCount++;
+        return;
+    }
+
+    if (m_interpolator->update(x - m_bounds.minx, y - m_bounds.miny, z) < 0)
+        throw p2g_error("interp->update() error while processing ");
+    m_pointCount++;
+}
 
-        if (m_interpolator->update(x, y, z) < 0)
-            throw p2g_error("interp->update() error while processing ");
+
+Options P2gWriter::getDefaultOptions()
+{
+    Options options;
+
+    Option grid_x("grid_dist_x", 6.0, "X grid distance");
+    Option grid_y("grid_dist_y", 6.0, "Y grid distance");
+
+    double default_radius = (double) sqrt(2.0) * grid_x.getValue<double>();
+    Option radius("radius", default_radius);
+
+    Option fill_window_size("fill_window_size", 3);
+    Option dim_z("z", "Z", "Name of Z dimension to interpolate");
+    options.add(dim_z);
+    options.add(grid_x);
+    options.add(grid_y);
+    options.add(radius);
+    options.add(fill_window_size);
+    return options;
+}
+
+
+bool P2gWriter::processOne(PointRef& point)
+{
+    if (!m_interpolator)
+    {
+        if (!streamable())
+        {
+            std::ostringstream oss;
+            oss << getName() << ": Can't write in stream mode without "
+                "the 'bounds' option.";
+            throw pdal_error(oss.str());
+        }
+        m_bounds = m_userBounds;
+        createInterpolator();
     }
 
+    update(point.getFieldAs<double>(Dimension::Id::X),
+        point.getFieldAs<double>(Dimension::Id::Y),
+        point.getFieldAs<double>(Dimension::Id::Z));
+    return true;
+}
+
+
+// The views stay alive until the pipeline is done, so hold on to them
+// rather than copying their points.  The grid is laid out from their
+// bounds once all of them are in.
+void P2gWriter::write(const PointViewPtr view)
+{
+    m_views.push_back(view);
+}
+
+
+void P2gWriter::done(PointTableRef table)
+{
+    if (m_views.size())
+    {
+        m_bounds = m_userBounds;
+        if (m_bounds.empty())
+            for (auto& view : m_views)
+                view->calculateBounds(m_bounds);
+        createInterpolator();
+        for (auto& view : m_views)
+            for (PointId idx = 0; idx < view->size(); idx++)
+                update(view->getFieldAs<double>(Dimension::Id::X, idx),
+                    view->getFieldAs<double>(Dimension::Id::Y, idx),
+                    view->getFieldAs<double>(Dimension::Id::Z, idx));
+        m_views.clear();
+    }
+
+    if (m_skipCount)
+        log()->get(LogLevel::Warning) << getName() << ": Ignored " <<
+            m_skipCount << " points outside of bounds " << m_bounds <<
+            "." << std::endl;
+
+    // If we never got any points, we're done.
+    if (!m_pointCount)
+        return;
+
     double adfGeoTransform[6];
     adfGeoTransform[0] = m_bounds.minx - 0.5*m_GRID_DIST_X;
     adfGeoTransform[1] = m_GRID_DIST_X;
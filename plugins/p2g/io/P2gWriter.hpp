@@ -65,7 +65,8 @@ class CoreInterp;
 class PDAL_DLL P2gWriter : public Writer
 {
 public:
-    P2gWriter() : m_outputTypes(0), m_outputFormat(OUTPUT_FORMAT_ARC_ASCII)
+    P2gWriter() : m_pointCount(0), m_skipCount(0), m_outputTypes(0),
+        m_outputFormat(OUTPUT_FORMAT_ARC_ASCII)
         {}
 
     static void * create();
@@ -79,11 +80,18 @@ private:
 
     virtual void processOptions(const Options& options);
     virtual void ready(PointTableRef table);
+    virtual bool streamable() const;
+    virtual bool processOne(PointRef& point);
     virtual void write(const PointViewPtr view);
     virtual void done(PointTableRef table);
 
+    void createInterpolator();
+    void update(double x, double y, double z);
+
     std::unique_ptr<OutCoreInterp> m_interpolator;
     uint64_t m_pointCount;
+    uint64_t m_skipCount;
+    std::vector<PointViewPtr> m_views;
 
     uint32_t m_GRID_SIZE_X;
     uint32_t m_GRID_SIZE_Y;
@@ -94,20 +102,12 @@ private:
     double m_RADIUS;
     unsigned int m_outputTypes;
     uint32_t m_fill_window_size;
-    BOX3D m_bounds;
+    BOX2D m_bounds;
+    BOX2D m_userBounds;
 
     std::string m_filename;
     int m_outputFormat;
     std::string m_zName;
-
-    typedef struct
-    {
-        double x;
-        double y;
-        double z;
-    } Coordinate;
-
-    std::vector<Coordinate> m_coordinates;
 };
 
 } // namespaces
@@ -0,0 +1,147 @@
+/******************************************************************************
+* Copyright (c) 2015, Howard Butler (howard@hobu.co)
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+#include <pdal/pdal_test_main.hpp>
+
+#include <fstream>
+
+#include <pdal/PointView.hpp>
+#include <pdal/StageFactory.hpp>
+#include <pdal/util/FileUtils.hpp>
+
+#include "Support.hpp"
+
+using namespace pdal;
+
+namespace
+{
+
+// Runs a ramp of 'count' points from (0, 0, 0) to (9, 9, 9) through
+// the writer and returns the name of the density grid it wrote.
+std::string writeGrid(const std::string& name, Options writerOps,
+    bool stream, point_count_t count = 10)
+{
+    std::string filename = Support::temppath(name);
+    std::string outfile = filename + ".den.asc";
+    FileUtils::deleteFile(outfile);
+
+    Options readerOps;
+    readerOps.add("bounds", BOX3D(0, 0, 0, 9, 9, 9));
+    readerOps.add("mode", "ramp");
+    readerOps.add("count", count);
+
+    StageFactory f;
+    Stage *reader(f.createStage("readers.faux"));
+    reader->setOptions(readerOps);
+
+    writerOps.add("filename", filename);
+    writerOps.add("grid_dist_x", 1.0);
+    writerOps.add("grid_dist_y", 1.0);
+    writerOps.add("output_type", "den");
+    writerOps.add("output_format", "asc");
+
+    Stage *writer(f.createStage("writers.p2g"));
+    writer->setOptions(writerOps);
+    writer->setInput(*reader);
+
+    if (stream)
+    {
+        FixedPointTable table(100);
+        writer->prepare(table);
+        writer->execute(table);
+    }
+    else
+    {
+        PointTable table;
+        writer->prepare(table);
+        writer->execute(table);
+    }
+    return outfile;
+}
+
+// Returns the value of an entry in the header of an ARC/Info ASCII grid.
+int headerValue(const std::string& filename, const std::string& key)
+{
+    std::ifstream in(filename);
+    std::string k;
+    std::string v;
+    while (in >> k >> v)
+        if (k == key)
+            return std::stoi(v);
+    return -1;
+}
+
+} // unnamed namespace
+
+TEST(P2gWriterTest, bounds)
+{
+    // Computed from the points.
+    std::string outfile = writeGrid("p2g_exact", Options(), false);
+    EXPECT_EQ(headerValue(outfile, "ncols"), 10);
+    EXPECT_EQ(headerValue(outfile, "nrows"), 10);
+    FileUtils::deleteFile(outfile);
+
+    // Points outside of the requested bounds are skipped.
+    Options ops;
+    ops.add("bounds", BOX2D(0, 0, 4, 2));
+    outfile = writeGrid("p2g_bounds", ops, false);
+    EXPECT_EQ(headerValue(outfile, "ncols"), 5);
+    EXPECT_EQ(headerValue(outfile, "nrows"), 3);
+    FileUtils::deleteFile(outfile);
+}
+
+TEST(P2gWriterTest, stream)
+{
+    std::string standard = writeGrid("p2g_standard", Options(), false, 100);
+
+    Options ops;
+    ops.add("bounds", BOX2D(0, 0, 9, 9));
+    std::string streamed = writeGrid("p2g_stream", ops, true, 100);
+
+    EXPECT_EQ(Support::diff_text_files(standard, streamed), 0u);
+    FileUtils::deleteFile(standard);
+    FileUtils::deleteFile(streamed);
+
+    // Without bounds there's no way to lay out the grid before the points
+    // arrive.
+    StageFactory f;
+    Stage *writer(f.createStage("writers.p2g"));
+    Options writerOps;
+    writerOps.add("filename", Support::temppath("p2g_nobounds"));
+    writer->setOptions(writerOps);
+    PointTable table;
+    writer->prepare(table);
+    EXPECT_FALSE(writer->pipelineStreamable());
+    EXPECT_THROW(writeGrid("p2g_nobounds", Options(), true), pdal_error);
+}
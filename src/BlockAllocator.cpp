@@ -0,0 +1,151 @@
+/******************************************************************************
+* Copyright (c) 2015, Howard Butler (howard@hobu.co)
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+#include <pdal/BlockAllocator.hpp>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#endif
+
+#include <cstring>
+#include <new>
+
+namespace pdal
+{
+
+char *HeapBlockAllocator::allocate(std::size_t size)
+{
+    char *buf = new char[size];
+    memset(buf, 0, size);
+    return buf;
+}
+
+
+void HeapBlockAllocator::release(char *block, std::size_t /*size*/)
+{
+    delete [] block;
+}
+
+
+PoolBlockAllocator::PoolBlockAllocator(bool hugePages, std::size_t maxPooled) :
+    m_hugePages(hugePages), m_maxPooled(maxPooled), m_pooled(0)
+{}
+
+
+PoolBlockAllocator::~PoolBlockAllocator()
+{
+    for (auto& f : m_free)
+        for (char *block : f.second)
+            destroy(block, f.first);
+}
+
+
+char *PoolBlockAllocator::allocate(std::size_t size)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto fi = m_free.find(size);
+        if (fi != m_free.end() && fi->second.size())
+        {
+            char *block = fi->second.back();
+            fi->second.pop_back();
+            m_pooled -= size;
+
+            // The pages are already resident, so this is much cheaper than
+            // faulting in and zeroing new ones.
+            memset(block, 0, size);
+            return block;
+        }
+    }
+    return create(size);
+}
+
+
+void PoolBlockAllocator::release(char *block, std::size_t size)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_maxPooled || m_pooled + size <= m_maxPooled)
+        {
+            m_free[size].push_back(block);
+            m_pooled += size;
+            return;
+        }
+    }
+    destroy(block, size);
+}
+
+
+std::size_t PoolBlockAllocator::pooled() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_pooled;
+}
+
+
+char *PoolBlockAllocator::create(std::size_t size)
+{
+#ifndef _WIN32
+    if (m_hugePages)
+    {
+        // Anonymous mappings are zero-filled by the system.
+        void *buf = mmap(NULL, size, PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (buf == MAP_FAILED)
+            throw std::bad_alloc();
+#ifdef MADV_HUGEPAGE
+        madvise(buf, size, MADV_HUGEPAGE);
+#endif
+        return (char *)buf;
+    }
+#endif
+    char *buf = new char[size];
+    memset(buf, 0, size);
+    return buf;
+}
+
+
+void PoolBlockAllocator::destroy(char *block, std::size_t size)
+{
+#ifndef _WIN32
+    if (m_hugePages)
+    {
+        munmap(block, size);
+        return;
+    }
+#endif
+    delete [] block;
+}
+
+} // namespace pdal
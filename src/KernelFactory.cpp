@@ -41,6 +41,7 @@
 #include <merge/MergeKernel.hpp>
 #include <pipeline/PipelineKernel.hpp>
 #include <random/RandomKernel.hpp>
+#include <serve/ServeKernel.hpp>
 #include <sort/SortKernel.hpp>
 #include <split/SplitKernel.hpp>
 #include <tindex/TIndexKernel.hpp>
@@ -60,6 +61,7 @@ KernelFactory::KernelFactory(bool no_plugins)
     PluginManager::initializePlugin(MergeKernel_InitPlugin);
     PluginManager::initializePlugin(PipelineKernel_InitPlugin);
     PluginManager::initializePlugin(RandomKernel_InitPlugin);
+    PluginManager::initializePlugin(ServeKernel_InitPlugin);
     PluginManager::initializePlugin(SortKernel_InitPlugin);
     PluginManager::initializePlugin(SplitKernel_InitPlugin);
     PluginManager::initializePlugin(TIndexKernel_InitPlugin);
@@ -0,0 +1,183 @@
+/******************************************************************************
+* Copyright (c) 2015, Howard Butler (howard@hobu.co)
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+#include <pdal/MmapPointTable.hpp>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/types.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+
+namespace pdal
+{
+
+namespace
+{
+
+void error(const std::string& msg)
+{
+    std::ostringstream oss;
+
+    oss << "MmapPointTable: " << msg << ": " << strerror(errno) << ".";
+    throw pdal_error(oss.str());
+}
+
+} // unnamed namespace
+
+
+MmapPointTable::MmapPointTable(const std::string& dir,
+        std::size_t residentBytes) : SimplePointTable(m_layout), m_numPts(0),
+    m_dir(dir), m_residentBytes(residentBytes), m_residentBlocks(0),
+    m_blockBytes(0), m_fd(-1)
+{
+#ifdef _WIN32
+    throw pdal_error("MmapPointTable: Memory-mapped point tables are not "
+        "supported on this platform.");
+#endif
+}
+
+
+MmapPointTable::~MmapPointTable()
+{
+#ifndef _WIN32
+    for (auto bi = m_blocks.begin(); bi != m_blocks.end(); ++bi)
+        munmap(*bi, m_blockBytes);
+    if (m_fd >= 0)
+        close(m_fd);
+#endif
+}
+
+
+PointId MmapPointTable::addPoint()
+{
+    if (m_numPts % m_blockPtCnt == 0)
+        addBlock();
+    return m_numPts++;
+}
+
+
+char *MmapPointTable::getPoint(PointId idx)
+{
+    std::size_t block = idx / m_blockPtCnt;
+    point_count_t offset = idx % m_blockPtCnt;
+
+    // Entering a block at its first point is the signature of a
+    // sequential pass, so ask for the following block to be read ahead.
+    if (offset == 0)
+        prefetch(block + 1);
+    return m_blocks[block] + pointsToBytes(offset);
+}
+
+
+// Create the spill file.  It's unlinked immediately so that it's removed
+// when closed, even if the process doesn't exit cleanly.
+void MmapPointTable::openFile()
+{
+#ifndef _WIN32
+    std::string dir(m_dir);
+    if (dir.empty())
+    {
+        const char *tmp = getenv("TMPDIR");
+        dir = tmp ? tmp : "/tmp";
+    }
+    std::string name = dir + "/pdal-XXXXXX";
+    std::vector<char> path(name.begin(), name.end());
+    path.push_back('\0');
+
+    m_fd = mkstemp(path.data());
+    if (m_fd < 0)
+        error("Unable to create spill file in '" + dir + "'");
+    unlink(path.data());
+
+    m_blockBytes = pointsToBytes(m_blockPtCnt);
+    m_residentBlocks = std::max<std::size_t>(m_residentBytes / m_blockBytes,
+        2);
+#endif
+}
+
+
+void MmapPointTable::addBlock()
+{
+#ifndef _WIN32
+    if (m_fd < 0)
+        openFile();
+
+    std::size_t block = m_blocks.size();
+    off_t offset = (off_t)block * m_blockBytes;
+
+    // Newly allocated file space reads as zeros, like a new block of
+    // a PointTable.
+    if (ftruncate(m_fd, offset + m_blockBytes) != 0)
+        error("Unable to extend spill file");
+    void *buf = mmap(NULL, m_blockBytes, PROT_READ | PROT_WRITE, MAP_SHARED,
+        m_fd, offset);
+    if (buf == MAP_FAILED)
+        error("Unable to map spill file");
+    madvise(buf, m_blockBytes, MADV_SEQUENTIAL);
+    m_blocks.push_back((char *)buf);
+
+    if (block >= m_residentBlocks)
+        release(block - m_residentBlocks);
+#endif
+}
+
+
+void MmapPointTable::prefetch(std::size_t block)
+{
+#ifndef _WIN32
+    if (block < m_blocks.size())
+        madvise(m_blocks[block], m_blockBytes, MADV_WILLNEED);
+#endif
+}
+
+
+// Drop the pages of a block from memory.  The mapping is shared, so the
+// data is preserved in the file and pointers into the block stay valid.
+void MmapPointTable::release(std::size_t block)
+{
+#ifndef _WIN32
+    msync(m_blocks[block], m_blockBytes, MS_ASYNC);
+    madvise(m_blocks[block], m_blockBytes, MADV_DONTNEED);
+#endif
+}
+
+} // namespace pdal
@@ -34,6 +34,11 @@
 
 #include <pdal/PDALUtils.hpp>
 
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+
 using namespace std;
 
 namespace pdal
@@ -206,6 +211,28 @@ void toJSON(const MetadataNode& m, std::ostream& o)
     o << std::endl;
 }
 
+// Write the JSON for a metadata node on a single line, as for streams of
+// JSON records.  JSON values never contain raw newlines, so removing each
+// newline and the indentation that follows it leaves the output valid.
+std::string toJSONLine(const MetadataNode& m)
+{
+    std::string json = toJSON(m);
+    std::string line;
+
+    bool indent(false);
+    for (char c : json)
+    {
+        if (c == '\n')
+            indent = true;
+        else if (!indent || c != ' ')
+        {
+            line += c;
+            indent = false;
+        }
+    }
+    return line;
+}
+
 std::string toJSON(const Options& opts)
 {
     std::ostringstream o;
@@ -221,5 +248,49 @@ void toJSON(const Options& opts, std::ostream& o)
     o << "}" << endl;
 }
 
+void parallelFor(size_t count, size_t threads,
+    const std::function<void(size_t)>& fn)
+{
+    threads = (std::min)(threads, count);
+    if (threads <= 1)
+    {
+        for (size_t i = 0; i < count; ++i)
+            fn(i);
+        return;
+    }
+
+    std::atomic<size_t> next(0);
+    std::atomic<bool> failed(false);
+    std::exception_ptr error;
+    std::mutex mutex;
+
+    auto work = [&]()
+    {
+        size_t i;
+        while (!failed && (i = next++) < count)
+        {
+            try
+            {
+                fn(i);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!error)
+                    error = std::current_exception();
+                failed = true;
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (size_t i = 0; i < threads; ++i)
+        pool.push_back(std::thread(work));
+    for (auto& t : pool)
+        t.join();
+    if (error)
+        std::rethrow_exception(error);
+}
+
 } // namespace Utils
 } // namespace pdal
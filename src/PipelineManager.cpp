@@ -64,6 +64,7 @@ Stage& PipelineManager::addReader(const std::string& type)
         throw pdal_error(ss.str());
     }
     reader->setProgressFd(m_progressFd);
+    reader->setProfiling(m_profiling);
     m_stages.push_back(reader);
     return *reader;
 }
@@ -79,6 +80,7 @@ Stage& PipelineManager::addFilter(const std::string& type)
         throw pdal_error(ss.str());
     }
     filter->setProgressFd(m_progressFd);
+    filter->setProfiling(m_profiling);
     m_stages.push_back(filter);
     return *filter;
 }
@@ -94,6 +96,7 @@ Stage& PipelineManager::addWriter(const std::string& type)
         throw pdal_error(ss.str());
     }
     writer->setProgressFd(m_progressFd);
+    writer->setProfiling(m_profiling);
     m_stages.push_back(writer);
     return *writer;
 }
@@ -109,6 +112,13 @@ void PipelineManager::prepare() const
 
 point_count_t PipelineManager::execute()
 {
+    if (m_executed)
+    {
+        m_viewSet.clear();
+        m_table.reset();
+    }
+    m_executed = true;
+
     prepare();
 
     Stage *s = getStage();
@@ -136,4 +146,26 @@ MetadataNode PipelineManager::getMetadata() const
     return output;
 }
 
+
+void PipelineManager::setProfiling(bool profiling)
+{
+    m_profiling = profiling;
+    for (auto s : m_stages)
+        s->setProfiling(profiling);
+}
+
+
+MetadataNode PipelineManager::getProfile() const
+{
+    MetadataNode output("profile");
+
+    for (auto s : m_stages)
+    {
+        MetadataNode stage = s->getProfile().toMetadata("stages");
+        stage.add("type", s->getName());
+        output.addList(stage);
+    }
+    return output;
+}
+
 } // namespace pdal
@@ -477,6 +477,12 @@ bool PipelineReader::readPipeline(const std::string& filename)
     m_inputXmlFile = filename;
 
     std::istream* input = FileUtils::openFile(filename);
+    if (!input)
+    {
+        std::ostringstream oss;
+        oss << "Unable to open pipeline file \"" << filename << "\".";
+        throw pdal_error(oss.str());
+    }
 
     bool isWriter = false;
 
@@ -47,7 +47,12 @@
 
 #include "DynamicLibrary.hpp"
 
+#include <sys/stat.h>
+
+#include <fstream>
 #include <memory>
+#include <random>
+#include <set>
 #include <sstream>
 #include <string>
 
@@ -80,6 +85,89 @@ bool pluginTypeValid(std::string pathname, PF_PluginType type)
             type & PF_PluginType_Writer));
 }
 
+
+// The type of plugin provided by a library, according to its name, or 0
+// if the name isn't that of a plugin.
+int pluginType(const std::string& pathname)
+{
+    const PF_PluginType types[] = { PF_PluginType_Kernel,
+        PF_PluginType_Filter, PF_PluginType_Reader, PF_PluginType_Writer };
+
+    for (PF_PluginType type : types)
+        if (pluginTypeValid(pathname, type))
+            return type;
+    return 0;
+}
+
+
+std::string pluginSearchPath()
+{
+    std::string driver_path("PDAL_DRIVER_PATH");
+    std::string pluginDir = Utils::getenv(driver_path);
+
+    // If we don't have a driver path, defaults are set.
+    if (pluginDir.size() == 0)
+    {
+        std::ostringstream oss;
+        oss << PDAL_PLUGIN_INSTALL_PATH <<
+            ":/usr/local/lib:./lib:../lib:../bin";
+        pluginDir = oss.str();
+    }
+    return pluginDir;
+}
+
+
+// The manifest lives in PDAL_PLUGIN_MANIFEST if set (a value of "off"
+// disables it), otherwise in ~/.pdal.  An empty name means no manifest.
+std::string manifestFilename()
+{
+    std::string manifest_var("PDAL_PLUGIN_MANIFEST");
+    std::string filename = Utils::getenv(manifest_var);
+    if (filename.size())
+        return (Utils::iequals(filename, "off") ? std::string() : filename);
+
+#ifdef _WIN32
+    std::string home_var("USERPROFILE");
+#else
+    std::string home_var("HOME");
+#endif
+    std::string home = Utils::getenv(home_var);
+    if (home.empty())
+        return home;
+    return home + "/.pdal/plugins.manifest";
+}
+
+
+// Modification time and size of a file or directory, used to decide
+// whether the manifest is still current.  "-1" if the path doesn't exist.
+std::string fileStamp(const std::string& path)
+{
+#ifdef _WIN32
+    struct _stat statbuf;
+    if (_stat(path.c_str(), &statbuf) != 0)
+        return "-1";
+#else
+    struct stat statbuf;
+    if (stat(path.c_str(), &statbuf) != 0)
+        return "-1";
+#endif
+    std::ostringstream oss;
+    oss << (long long)statbuf.st_mtime << ":" << (long long)statbuf.st_size;
+    return oss.str();
+}
+
+
+// Tabs and newlines separate manifest fields and records.
+std::string manifestField(std::string s)
+{
+    for (char& c : s)
+        if (c == '\t' || c == '\n' || c == '\r')
+            c = ' ';
+    return s;
+}
+
+const std::string manifestHeader("PDAL plugin manifest 2");
+
 } // unnamed namespace;
 
 
@@ -113,22 +201,220 @@ void PluginManager::loadAll(int type)
 
 void PluginManager::l_loadAll(PF_PluginType type)
 {
-    std::string driver_path("PDAL_DRIVER_PATH");
-    std::string pluginDir = Utils::getenv(driver_path);
+    std::string pluginDir = pluginSearchPath();
+    std::vector<std::string> pluginPathVec = Utils::split2(pluginDir, ':');
 
-    // If we don't have a driver path, defaults are set.
-    if (pluginDir.size() == 0)
+    std::string manifest = manifestFilename();
+    if (manifest.empty())
     {
-        std::ostringstream oss;
-        oss << PDAL_PLUGIN_INSTALL_PATH <<
-            ":/usr/local/lib:./lib:../lib:../bin";
-        pluginDir = oss.str();
+        for (const auto& pluginPath : pluginPathVec)
+            loadAll(pluginPath, type);
+        return;
     }
 
-    std::vector<std::string> pluginPathVec = Utils::split2(pluginDir, ':');
-
+    // With a current manifest, plugins are known by name and a library
+    // is only opened when one of its stages is created.  Otherwise the
+    // libraries of the requested type are loaded and the manifest is
+    // rewritten.  Relative directories depend on the current directory,
+    // so they're always searched directly and left out of the manifest.
+    StringList dirs;
     for (const auto& pluginPath : pluginPathVec)
-        loadAll(pluginPath, type);
+    {
+        if (FileUtils::isAbsolutePath(pluginPath))
+            dirs.push_back(pluginPath);
+        else
+            loadAll(pluginPath, type);
+    }
+    if (!m_manifestValid)
+        readManifest(manifest, dirs);
+    if (!m_manifestValid || (m_manifestTypes & type) != type)
+        buildManifest(manifest, dirs, type);
+}
+
+
+bool PluginManager::readManifest(const std::string& filename,
+    const StringList& dirs)
+{
+    std::ifstream in(filename);
+    std::string line;
+
+    if (!std::getline(in, line) || line != manifestHeader)
+        return false;
+
+    ManifestMap manifest;
+    int types(0);
+    size_t dirCount(0);
+    while (std::getline(in, line))
+    {
+        StringList fields = Utils::split(line, '\t');
+        if (fields[0] == "types" && fields.size() == 2)
+            types = std::atoi(fields[1].c_str());
+        else if (fields[0] == "dir" && fields.size() == 3)
+        {
+            // The search path must be unchanged and no directory may have
+            // gained or lost files.
+            if (dirCount >= dirs.size() || fields[1] != dirs[dirCount] ||
+                    fields[2] != fileStamp(fields[1]))
+                return false;
+            dirCount++;
+        }
+        else if (fields[0] == "lib" && fields.size() == 3)
+        {
+            if (fields[2] != fileStamp(fields[1]))
+                return false;
+        }
+        else if (fields[0] == "stage" && fields.size() == 6)
+        {
+            ManifestEntry& entry = manifest[fields[1]];
+            entry.path = fields[2];
+            entry.type = std::atoi(fields[3].c_str());
+            entry.link = fields[4];
+            entry.description = fields[5];
+        }
+        else
+            return false;
+    }
+    if (dirCount != dirs.size())
+        return false;
+
+    Log("PDAL", "stderr").get(LogLevel::Debug) << "Using plugin manifest '" <<
+        filename << "'." << std::endl;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_manifest.swap(manifest);
+    m_manifestTypes = types;
+    m_manifestValid = true;
+    return true;
+}
+
+
+// Plugins of types already covered by a current manifest are carried over
+// without opening their libraries.  Of the rest, only libraries providing
+// the requested type are opened.  The others are listed so that a change
+// to them is noticed, and their types are left out of the manifest's
+// coverage.
+void PluginManager::buildManifest(const std::string& filename,
+    const StringList& dirs, int type)
+{
+    auto registered([this]()
+    {
+        std::set<std::string> names;
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (auto& p : m_plugins)
+            names.insert(p.first);
+        return names;
+    });
+
+    const int covered = m_manifestValid ? m_manifestTypes : 0;
+    const int types = covered | type;
+
+    ManifestMap manifest;
+    std::ostringstream out;
+    out << manifestHeader << "\n";
+    out << "types\t" << types << "\n";
+    for (const auto& dir : dirs)
+    {
+        out << "dir\t" << dir << "\t" << fileStamp(dir) << "\n";
+        if (!FileUtils::isDirectory(dir))
+            continue;
+
+        StringList files = FileUtils::directoryList(dir);
+        for (auto file : files)
+        {
+            std::string name = Utils::tolower(FileUtils::getFilename(file));
+            int libType = pluginType(name);
+            if ((FileUtils::extension(file) != dynamicLibraryExtension) ||
+                    FileUtils::isDirectory(file) || !libType)
+                continue;
+
+            // Libraries that fail to load are still listed so that they
+            // aren't retried on every run; a change to one invalidates
+            // the manifest.
+            file = FileUtils::toAbsolutePath(file);
+            out << "lib\t" << file << "\t" << fileStamp(file) << "\n";
+
+            if (libType & covered)
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                for (auto& m : m_manifest)
+                    if (m.second.path == file)
+                        manifest.insert(m);
+                continue;
+            }
+            if (!(libType & type))
+                continue;
+
+            std::set<std::string> before = registered();
+            loadByPath(file, libType);
+            for (auto& n : registered())
+            {
+                if (before.count(n))
+                    continue;
+
+                std::lock_guard<std::mutex> lock(m_mutex);
+                const PF_RegisterParams& params = m_plugins[n];
+                ManifestEntry& entry = manifest[n];
+                entry.path = file;
+                entry.type = params.pluginType;
+                entry.description = manifestField(params.description);
+                entry.link = manifestField(params.link);
+            }
+        }
+    }
+    for (auto& m : manifest)
+        out << "stage\t" << m.first << "\t" << m.second.path << "\t" <<
+            m.second.type << "\t" << m.second.link << "\t" <<
+            m.second.description << "\n";
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_manifest.swap(manifest);
+        m_manifestTypes = types;
+        m_manifestValid = true;
+    }
+
+    // Write to a temporary and rename so that concurrent processes never
+    // see a partial manifest.
+    Log log("PDAL", "stderr");
+    std::string tempname = filename + "." +
+        std::to_string(std::random_device()());
+    try
+    {
+        std::string dir = FileUtils::getDirectory(filename);
+        if (dir.size() && !FileUtils::directoryExists(dir))
+            FileUtils::createDirectory(dir);
+        std::ofstream f(tempname);
+        f << out.str();
+        f.close();
+        if (!f)
+            throw pdal_error("Can't write '" + tempname + "'.");
+        FileUtils::renameFile(filename, tempname);
+        log.get(LogLevel::Debug) << "Wrote plugin manifest '" << filename <<
+            "'." << std::endl;
+    }
+    catch (std::exception& err)
+    {
+        FileUtils::deleteFile(tempname);
+        log.get(LogLevel::Debug) << "Unable to write plugin manifest '" <<
+            filename << "': " << err.what() << std::endl;
+    }
+}
+
+
+bool PluginManager::manifestLoad(const std::string& objectType)
+{
+    std::string path;
+    int type;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto mi = m_manifest.find(objectType);
+        if (mi == m_manifest.end())
+            return false;
+        path = mi->second.path;
+        type = mi->second.type;
+    }
+    return loadByPath(path, type);
 }
 
 StringList PluginManager::names(int typeMask)
@@ -139,13 +425,16 @@ StringList PluginManager::names(int typeMask)
 
 StringList PluginManager::l_names(int typeMask)
 {
-    StringList l;
+    std::set<std::string> names;
 
     std::lock_guard<std::mutex> lock(m_mutex);
     for (auto p : m_plugins)
         if (p.second.pluginType & typeMask)
-            l.push_back(p.first);
-    return l;
+            names.insert(p.first);
+    for (auto& m : m_manifest)
+        if (m.second.type & typeMask)
+            names.insert(m.first);
+    return StringList(names.begin(), names.end());
 }
 
 std::string PluginManager::link(const std::string& name)
@@ -162,6 +451,12 @@ std::string PluginManager::l_link(const std::string& name)
     auto ei = m_plugins.find(name);
     if (ei != m_plugins.end())
         link= ei->second.link;
+    else
+    {
+        auto mi = m_manifest.find(name);
+        if (mi != m_manifest.end())
+            link = mi->second.link;
+    }
     return link;
 }
 
@@ -180,6 +475,12 @@ std::string PluginManager::l_description(const std::string& name)
     auto ei = m_plugins.find(name);
     if (ei != m_plugins.end())
         descrip = ei->second.description;
+    else
+    {
+        auto mi = m_manifest.find(name);
+        if (mi != m_manifest.end())
+            descrip = mi->second.description;
+    }
     return descrip;
 }
 
@@ -221,7 +522,7 @@ bool PluginManager::l_initializePlugin(PF_InitFunc initFunc)
 }
 
 
-PluginManager::PluginManager()
+PluginManager::PluginManager() : m_manifestTypes(0), m_manifestValid(false)
 {
     m_version.major = 1;
     m_version.minor = 0;
@@ -271,6 +572,7 @@ bool PluginManager::shutdown()
 
     m_dynamicLibraryMap.clear();
     m_plugins.clear();
+    m_manifest.clear();
     m_exitFuncVec.clear();
 
     return success;
@@ -326,17 +628,7 @@ bool PluginManager::guessLoadByPath(const std::string& driverName)
     std::string pluginName = "libpdal_plugin_" + driverNameVec[0] + "_" +
         driverNameVec[1];
 
-    std::string driver_path("PDAL_DRIVER_PATH");
-    std::string pluginDir = Utils::getenv(driver_path);
-
-    // Default path below if not set.
-    if (pluginDir.size() == 0)
-    {
-        std::ostringstream oss;
-        oss << PDAL_PLUGIN_INSTALL_PATH <<
-            ":/usr/local/lib:./lib:../lib:../bin";
-        pluginDir = oss.str();
-    }
+    std::string pluginDir = pluginSearchPath();
 
     Log("PDAL", "stderr").get(LogLevel::Debug) <<
         "Plugin search path '" << pluginDir << "'" << std::endl;
@@ -445,7 +737,8 @@ void *PluginManager::l_createObject(const std::string& objectType)
 
 
     void *obj(0);
-    if (find() || (guessLoadByPath(objectType) && find()))
+    if (find() || (manifestLoad(objectType) && find()) ||
+        (guessLoadByPath(objectType) && find()))
     {
         PF_CreateFunc f;
         {
@@ -34,6 +34,8 @@
 
 #include <pdal/PointTable.hpp>
 
+#include <algorithm>
+
 namespace pdal
 {
 
@@ -70,17 +72,52 @@ void SimplePointTable::getFieldInternal(Dimension::Id::Enum id, PointId idx,
 PointTable::~PointTable()
 {
     for (auto vi = m_blocks.begin(); vi != m_blocks.end(); ++vi)
-        delete [] *vi;
+        m_allocator->release(*vi, m_blockSize);
 }
 
+
+void PointTable::reset()
+{
+    m_numPts = 0;
+    m_layout = PointLayout();
+    m_metadata.reset(new Metadata());
+    m_spatialRefs.clear();
+}
+
+
+void PointTable::trim(std::size_t maxBytes)
+{
+    std::size_t inUse = (m_numPts + m_blockPtCnt - 1) / m_blockPtCnt;
+    std::size_t keep = m_blockSize ? maxBytes / m_blockSize : 0;
+    keep = (std::max)(keep, inUse);
+    while (m_blocks.size() > keep)
+    {
+        m_allocator->release(m_blocks.back(), m_blockSize);
+        m_blocks.pop_back();
+    }
+}
+
+
 PointId PointTable::addPoint()
 {
     if (m_numPts % m_blockPtCnt == 0)
     {
         size_t size = pointsToBytes(m_blockPtCnt);
-        char *buf = new char[size];
-        memset(buf, 0, size);
-        m_blocks.push_back(buf);
+        size_t block = m_numPts / m_blockPtCnt;
+
+        // Blocks left from before a reset are reused if the point size
+        // hasn't changed.
+        if (block == 0 && size != m_blockSize)
+        {
+            for (auto vi = m_blocks.begin(); vi != m_blocks.end(); ++vi)
+                m_allocator->release(*vi, m_blockSize);
+            m_blocks.clear();
+            m_blockSize = size;
+        }
+        if (block < m_blocks.size())
+            memset(m_blocks[block], 0, size);
+        else
+            m_blocks.push_back(m_allocator->allocate(size));
     }
     return m_numPts++;
 }
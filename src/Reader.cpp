@@ -35,6 +35,8 @@
 #include <pdal/Reader.hpp>
 #include <pdal/PipelineWriter.hpp>
 
+#include <sstream>
+
 namespace pdal
 {
 
@@ -42,6 +44,16 @@ void Reader::readerProcessOptions(const Options& options)
 {
     if (options.hasOption("filename"))
         m_filename = options.getValueOrThrow<std::string>("filename");
+    if (options.hasOption("start"))
+    {
+        if (!supportsStart())
+        {
+            std::ostringstream oss;
+            oss << getName() << ": Option 'start' isn't supported.";
+            throw pdal_error(oss.str());
+        }
+        m_start = options.getValueOrThrow<point_count_t>("start");
+    }
     if (options.hasOption("count"))
         m_count = options.getValueOrThrow<point_count_t>("count");
 }
@@ -56,9 +56,24 @@
 
 #include <pdal/util/Utils.hpp>
 
+#include <map>
+#include <mutex>
+
 namespace pdal
 {
 
+namespace
+{
+
+// Resolving user input (an EPSG code, for instance) requires GDAL to
+// search its support files.  Long-running processes see the same few
+// inputs repeatedly, so the resulting WKT is cached.
+std::mutex s_wktCacheMutex;
+std::map<std::string, std::string> s_wktCache;
+const size_t s_wktCacheSize = 1000;
+
+} // unnamed namespace
+
 SpatialReference::SpatialReference(const std::string& s)
 {
     setFromUserInput(s);
@@ -127,6 +142,16 @@ void SpatialReference::setFromUserInput(std::string const& v)
         return;
     }
 
+    {
+        std::lock_guard<std::mutex> lock(s_wktCacheMutex);
+        auto ci = s_wktCache.find(v);
+        if (ci != s_wktCache.end())
+        {
+            setWKT(ci->second);
+            return;
+        }
+    }
+
     OGRSpatialReference srs(NULL);
 
     CPLErrorReset();
@@ -148,6 +173,11 @@ void SpatialReference::setFromUserInput(std::string const& v)
     std::string tmp(poWKT);
     CPLFree(poWKT);
     setWKT(tmp);
+
+    std::lock_guard<std::mutex> lock(s_wktCacheMutex);
+    if (s_wktCache.size() >= s_wktCacheSize)
+        s_wktCache.clear();
+    s_wktCache[v] = tmp;
 }
 
 
@@ -86,6 +86,8 @@ void Stage::serialize(MetadataNode root, PipelineWriter::TagMap& tags) const
         anon.addList("inputs", tagname(s));
     if (m_metadata.hasChildren())
         anon.add(m_metadata.clone("execution_metadata"));
+    if (!m_profile.empty())
+        anon.add(m_profile.toMetadata());
     root.addList(anon);
 }
 
@@ -96,6 +98,7 @@ void Stage::prepare(PointTableRef table)
         Stage *prev = m_inputs[i];
         prev->prepare(table);
     }
+    m_profile.reset();
     l_processOptions(m_options);
     processOptions(m_options);
     l_initialize(table);
@@ -142,11 +145,16 @@ PointViewSet Stage::execute(PointTableRef table)
 
     // Do the ready operation and then start running all the views
     // through the stage.
-    ready(table);
+    {
+        StageProfile::Timer timer(m_profile, StageProfile::Ready);
+        ready(table);
+    }
     for (auto const& it : views)
     {
         StageRunnerPtr runner(new StageRunner(this, it));
         runners.push_back(runner);
+        m_profile.addPointsIn(it->size());
+        StageProfile::Timer timer(m_profile, StageProfile::Run);
         runner->run();
     }
 
@@ -163,9 +171,15 @@ PointViewSet Stage::execute(PointTableRef table)
         if (!srs.empty())
             for (PointViewPtr v : temp)
                 v->setSpatialReference(srs);
+        for (PointViewPtr v : temp)
+            m_profile.addPointsOut(v->size());
+        m_profile.addViews(temp.size());
         outViews.insert(temp.begin(), temp.end());
     }
-    done(table);
+    {
+        StageProfile::Timer timer(m_profile, StageProfile::Done);
+        done(table);
+    }
     return outViews;
 }
 
@@ -217,6 +231,17 @@ void Stage::execute(StreamPointTable& table)
 }
 
 
+bool Stage::pipelineStreamable() const
+{
+    if (!streamable())
+        return false;
+    for (const Stage *s : m_inputs)
+        if (!s->pipelineStreamable())
+            return false;
+    return true;
+}
+
+
 void Stage::execute(StreamPointTable& table, std::list<Stage *>& stages)
 {
     std::vector<bool> skips(table.capacity());
@@ -234,7 +259,10 @@ void Stage::execute(StreamPointTable& table, std::list<Stage *>& stages)
 
     for (Stage *s : stages)
     {
-        s->ready(table);
+        {
+            StageProfile::Timer timer(s->m_profile, StageProfile::Ready);
+            s->ready(table);
+        }
         srs = s->getSpatialReference();
         if (!srs.empty())
             table.setSpatialReference(srs);
@@ -255,13 +283,18 @@ void Stage::execute(StreamPointTable& table, std::list<Stage *>& stages)
         // When we get false back from a reader, we're done, so set
         // the point limit to the number of points processed in this loop
         // of the table.
-        for (PointId idx = 0; idx < pointLimit; idx++)
         {
-            point.setPointId(idx);
-            finished = !reader->processOne(point);
-            if (finished)
-                pointLimit = idx;
+            StageProfile::Timer timer(reader->m_profile,
+                StageProfile::ProcessOne);
+            for (PointId idx = 0; idx < pointLimit; idx++)
+            {
+                point.setPointId(idx);
+                finished = !reader->processOne(point);
+                if (finished)
+                    pointLimit = idx;
+            }
         }
+        reader->m_profile.addPointsOut(pointLimit);
         srs = reader->getSpatialReference();
         if (!srs.empty())
             table.setSpatialReference(srs);
@@ -271,14 +304,25 @@ void Stage::execute(StreamPointTable& table, std::list<Stage *>& stages)
         // processed by subsequent filters.
         for (Stage *s : filters)
         {
-            for (PointId idx = 0; idx < pointLimit; idx++)
+            point_count_t pointsIn = 0;
+            point_count_t pointsOut = 0;
             {
-                if (skips[idx])
-                    continue;
-                point.setPointId(idx);
-                if (!s->processOne(point))
-                    skips[idx] = true;
+                StageProfile::Timer timer(s->m_profile,
+                    StageProfile::ProcessOne);
+                for (PointId idx = 0; idx < pointLimit; idx++)
+                {
+                    if (skips[idx])
+                        continue;
+                    pointsIn++;
+                    point.setPointId(idx);
+                    if (s->processOne(point))
+                        pointsOut++;
+                    else
+                        skips[idx] = true;
+                }
             }
+            s->m_profile.addPointsIn(pointsIn);
+            s->m_profile.addPointsOut(pointsOut);
             srs = s->getSpatialReference();
             if (!srs.empty())
                 table.setSpatialReference(srs);
@@ -291,7 +335,10 @@ void Stage::execute(StreamPointTable& table, std::list<Stage *>& stages)
     }
 
     for (Stage *s : stages)
+    {
+        StageProfile::Timer timer(s->m_profile, StageProfile::Done);
         s->done(table);
+    }
 }
 
 
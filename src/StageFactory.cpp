@@ -45,12 +45,15 @@
 #include <ferry/FerryFilter.hpp>
 #include <merge/MergeFilter.hpp>
 #include <mortonorder/MortonOrderFilter.hpp>
+#include <outlier/OutlierFilter.hpp>
+#include <pmf/PmfFilter.hpp>
 #include <range/RangeFilter.hpp>
 #include <reprojection/ReprojectionFilter.hpp>
 #include <sort/SortFilter.hpp>
 #include <splitter/SplitterFilter.hpp>
 #include <stats/StatsFilter.hpp>
 #include <transformation/TransformationFilter.hpp>
+#include <voxeldownsize/VoxelDownsizeFilter.hpp>
 
 // readers
 #include <bpf/BpfReader.hpp>
@@ -92,6 +95,7 @@ std::string StageFactory::inferReaderDriver(const std::string& filename)
 
     std::string ext = FileUtils::extension(filename);
     std::map<std::string, std::string> drivers;
+    drivers["arrow"] = "readers.arrow";
     drivers["bin"] = "readers.terrasolid";
     drivers["bpf"] = "readers.bpf";
     drivers["cpd"] = "readers.optech";
@@ -99,9 +103,12 @@ std::string StageFactory::inferReaderDriver(const std::string& filename)
     drivers["icebridge"] = "readers.icebridge";
     drivers["las"] = "readers.las";
     drivers["laz"] = "readers.las";
+    drivers["feather"] = "readers.arrow";
     drivers["nitf"] = "readers.nitf";
     drivers["nsf"] = "readers.nitf";
     drivers["ntf"] = "readers.nitf";
+    drivers["parq"] = "readers.arrow";
+    drivers["parquet"] = "readers.arrow";
     drivers["pcd"] = "readers.pcd";
     drivers["ply"] = "readers.ply";
     drivers["qi"] = "readers.qfit";
@@ -130,13 +137,17 @@ std::string StageFactory::inferWriterDriver(const std::string& filename)
     std::string ext = Utils::tolower(FileUtils::extension(filename));
 
     std::map<std::string, std::string> drivers;
+    drivers["arrow"] = "writers.arrow";
     drivers["bpf"] = "writers.bpf";
     drivers["csv"] = "writers.text";
+    drivers["feather"] = "writers.arrow";
     drivers["json"] = "writers.text";
     drivers["las"] = "writers.las";
     drivers["laz"] = "writers.las";
     drivers["mat"] = "writers.matlab";
     drivers["ntf"] = "writers.nitf";
+    drivers["parq"] = "writers.arrow";
+    drivers["parquet"] = "writers.arrow";
     drivers["pcd"] = "writers.pcd";
     drivers["pclviz"] = "writers.pclvisualizer";
     drivers["ply"] = "writers.ply";
@@ -199,12 +210,15 @@ StageFactory::StageFactory(bool no_plugins)
     PluginManager::initializePlugin(FerryFilter_InitPlugin);
     PluginManager::initializePlugin(MergeFilter_InitPlugin);
     PluginManager::initializePlugin(MortonOrderFilter_InitPlugin);
+    PluginManager::initializePlugin(OutlierFilter_InitPlugin);
+    PluginManager::initializePlugin(PmfFilter_InitPlugin);
     PluginManager::initializePlugin(RangeFilter_InitPlugin);
     PluginManager::initializePlugin(ReprojectionFilter_InitPlugin);
     PluginManager::initializePlugin(SortFilter_InitPlugin);
     PluginManager::initializePlugin(SplitterFilter_InitPlugin);
     PluginManager::initializePlugin(StatsFilter_InitPlugin);
     PluginManager::initializePlugin(TransformationFilter_InitPlugin);
+    PluginManager::initializePlugin(VoxelDownsizeFilter_InitPlugin);
 
     // readers
     PluginManager::initializePlugin(BpfReader_InitPlugin);
@@ -0,0 +1,170 @@
+/******************************************************************************
+* Copyright (c) 2015, Howard Butler (howard@hobu.co)
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+#include <pdal/StageProfile.hpp>
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+#include <algorithm>
+#include <fstream>
+
+namespace pdal
+{
+
+namespace
+{
+
+const char *phaseNames[] = { "ready", "run", "process_one", "done" };
+
+} // unnamed namespace
+
+
+StageProfile::Timer::Timer(StageProfile& profile, Phase phase) :
+    m_profile(profile), m_phase(phase),
+    m_cpuStart(0), m_readStart(0), m_writeStart(0)
+{
+    if (!m_profile.m_enabled)
+        return;
+    m_wallStart = std::chrono::steady_clock::now();
+    m_cpuStart = std::clock();
+    ioCounts(m_readStart, m_writeStart);
+}
+
+
+StageProfile::Timer::~Timer()
+{
+    using namespace std::chrono;
+
+    if (!m_profile.m_enabled)
+        return;
+
+    uint64_t bytesRead, bytesWritten;
+    ioCounts(bytesRead, bytesWritten);
+
+    PhaseStats& stats = m_profile.m_phases[m_phase];
+    stats.m_wallTime +=
+        duration<double>(steady_clock::now() - m_wallStart).count();
+    stats.m_cpuTime += (double)(std::clock() - m_cpuStart) / CLOCKS_PER_SEC;
+    stats.m_calls++;
+    stats.m_bytesRead += bytesRead - m_readStart;
+    stats.m_bytesWritten += bytesWritten - m_writeStart;
+    m_profile.m_peakMemory = (std::max)(m_profile.m_peakMemory, peakMemory());
+}
+
+
+void StageProfile::reset()
+{
+    for (PhaseStats& stats : m_phases)
+        stats = PhaseStats();
+    m_pointsIn = 0;
+    m_pointsOut = 0;
+    m_views = 0;
+    m_peakMemory = 0;
+}
+
+
+bool StageProfile::empty() const
+{
+    for (const PhaseStats& stats : m_phases)
+        if (stats.m_calls)
+            return false;
+    return true;
+}
+
+
+MetadataNode StageProfile::toMetadata(const std::string& name) const
+{
+    MetadataNode root(name);
+
+    for (int i = 0; i < NumPhases; ++i)
+    {
+        const PhaseStats& stats = m_phases[i];
+        if (!stats.m_calls)
+            continue;
+
+        MetadataNode phase = root.add(phaseNames[i]);
+        phase.add("wall_time", stats.m_wallTime, "Elapsed seconds");
+        phase.add("cpu_time", stats.m_cpuTime, "Process CPU seconds");
+        phase.add("calls", stats.m_calls);
+        phase.add("bytes_read", stats.m_bytesRead);
+        phase.add("bytes_written", stats.m_bytesWritten);
+    }
+    root.add("points_in", m_pointsIn);
+    root.add("points_out", m_pointsOut);
+    root.add("views", m_views, "Number of views produced");
+    root.add("peak_memory", m_peakMemory,
+        "Peak resident memory of the process in bytes");
+    return root;
+}
+
+
+// Bytes read and written by the process through any kind of I/O.
+void StageProfile::ioCounts(uint64_t& bytesRead, uint64_t& bytesWritten)
+{
+    bytesRead = 0;
+    bytesWritten = 0;
+#ifdef __linux__
+    std::ifstream in("/proc/self/io");
+    std::string key;
+    uint64_t value;
+    while (in >> key >> value)
+    {
+        if (key == "rchar:")
+            bytesRead = value;
+        else if (key == "wchar:")
+            bytesWritten = value;
+    }
+#endif
+}
+
+
+uint64_t StageProfile::peakMemory()
+{
+#ifdef _WIN32
+    return 0;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+#ifdef __APPLE__
+    return (uint64_t)usage.ru_maxrss;
+#else
+    return (uint64_t)usage.ru_maxrss * 1024;
+#endif
+#endif
+}
+
+} // namespace pdal
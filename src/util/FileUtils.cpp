@@ -33,6 +33,9 @@
 ****************************************************************************/
 
 #include <sys/stat.h>
+#ifndef WIN32
+#include <glob.h>
+#endif
 
 #include <iostream>
 #include <sstream>
@@ -349,7 +352,26 @@ std::string extension(const std::string& filename)
     return filename.substr(idx);
 }
 
+
+StringList glob(const std::string& pattern)
+{
+    StringList filenames;
+
+#ifdef WIN32
+    if (fileExists(pattern))
+        filenames.push_back(pattern);
+#else
+    glob_t glob_result;
+
+    ::glob(pattern.c_str(), GLOB_TILDE, NULL, &glob_result);
+    for (size_t i = 0; i < glob_result.gl_pathc; ++i)
+        filenames.push_back(glob_result.gl_pathv[i]);
+    globfree(&glob_result);
+#endif
+
+    return filenames;
+}
+
 } // namespace FileUtils
 
 } // namespace pdal
-
@@ -34,8 +34,11 @@
 
 #include <pdal/util/Utils.hpp>
 
+#include <algorithm>
 #include <cassert>
+#include <clocale>
 #include <cstdlib>
+#include <cstring>
 #include <cctype>
 #include <memory>
 #include <random>
@@ -528,6 +531,86 @@ std::string Utils::escapeNonprinting(const std::string& s)
     return out;
 }
 
+char *Utils::formatFixed(double v, int precision, char *buf)
+{
+    static const uint64_t pow10[] =
+    {
+        1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL,
+        10000000ULL, 100000000ULL, 1000000000ULL, 10000000000ULL,
+        100000000000ULL, 1000000000000ULL, 10000000000000ULL,
+        100000000000000ULL, 1000000000000000ULL
+    };
+    const int maxPrecision = sizeof(pow10) / sizeof(pow10[0]) - 1;
+
+    if (precision < 0)
+        precision = 6;
+
+    // Scale the value so that the digits we want are an integer.  The
+    // multiplication has a relative error of at most 2^-53, so if the
+    // fraction is that close to one half we can't tell which way the
+    // exact value rounds and leave it to snprintf().
+    if (precision <= maxPrecision && std::isfinite(v))
+    {
+        double scaled = std::fabs(v) * (double)pow10[precision];
+        if (scaled < 9007199254740992.0)  // 2^53
+        {
+            double whole = std::floor(scaled);
+            double frac = scaled - whole;
+            double err = scaled * std::ldexp(1.0, -52);
+            if (std::fabs(frac - .5) > err)
+            {
+                uint64_t r = (uint64_t)whole + (frac > .5 ? 1 : 0);
+                uint64_t ipart = r / pow10[precision];
+                uint64_t fpart = r % pow10[precision];
+
+                char digits[24];
+                char *d = digits;
+                do
+                {
+                    *d++ = '0' + (char)(ipart % 10);
+                    ipart /= 10;
+                } while (ipart);
+
+                if (std::signbit(v))
+                    *buf++ = '-';
+                while (d != digits)
+                    *buf++ = *--d;
+                if (precision)
+                {
+                    *buf++ = '.';
+                    for (int i = precision - 1; i >= 0; --i)
+                    {
+                        buf[i] = '0' + (char)(fpart % 10);
+                        fpart /= 10;
+                    }
+                    buf += precision;
+                }
+                return buf;
+            }
+        }
+    }
+
+    // snprintf() writes the decimal point of the C locale (LC_NUMERIC),
+    // which may not be '.' and may be more than one character long.
+    const char *point = localeconv()->decimal_point;
+    const size_t pointLen = strlen(point);
+    std::vector<char> tmp(fixedBufSize(precision) + pointLen);
+    int cnt = snprintf(tmp.data(), tmp.size(), "%.*f", precision, v);
+    cnt = (std::min)((std::max)(cnt, 0), (int)tmp.size() - 1);
+
+    char *end = tmp.data() + cnt;
+    char *pos = end;
+    if (pointLen)
+        pos = std::search(tmp.data(), end, point, point + pointLen);
+    buf = std::copy(tmp.data(), pos, buf);
+    if (pos != end)
+    {
+        *buf++ = '.';
+        buf = std::copy(pos + pointLen, end, buf);
+    }
+    return buf;
+}
+
 // Useful for debug on occasion.
 std::string Utils::hexDump(const char *buf, size_t count)
 {
@@ -0,0 +1,273 @@
+/******************************************************************************
+* Copyright (c) 2015, Howard Butler (howard@hobu.co)
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+#include "Benchmark.hpp"
+
+#include <pdal/pdal_config.hpp>
+#include <pdal/Metadata.hpp>
+#include <pdal/PDALUtils.hpp>
+#include <pdal/util/FileUtils.hpp>
+#include <pdal/util/ProgramArgs.hpp>
+#include <FauxReader.hpp>
+
+#include "TestConfig.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+
+namespace pdal
+{
+namespace bench
+{
+
+namespace
+{
+
+struct Benchmark
+{
+    std::string m_name;
+    BenchFunc m_func;
+    bool m_synthetic;
+};
+
+std::vector<Benchmark>& benchmarks()
+{
+    static std::vector<Benchmark> s_benchmarks;
+    return s_benchmarks;
+}
+
+} // unnamed namespace
+
+
+int registerBenchmark(const std::string& name, BenchFunc func,
+    bool synthetic)
+{
+    benchmarks().push_back({ name, func, synthetic });
+    return (int)benchmarks().size();
+}
+
+
+PointViewPtr makeView(PointTableRef table, point_count_t count)
+{
+    Options ops;
+    ops.add("bounds", BOX3D(0.0, 0.0, 0.0, 1000.0, 1000.0, 100.0));
+    ops.add("mode", "random");
+    ops.add("num_points", count);
+
+    FauxReader reader;
+    reader.setOptions(ops);
+    reader.prepare(table);
+    PointViewSet viewSet = reader.execute(table);
+    return *viewSet.begin();
+}
+
+
+std::string datapath(const std::string& file)
+{
+    return TestConfig::g_data_path + file;
+}
+
+
+std::string temppath(const std::string& file)
+{
+    return TestConfig::g_data_path + "../temp/" + file;
+}
+
+
+class Runner
+{
+public:
+    Runner(int repetitions) : m_repetitions(repetitions)
+    {}
+
+    // Run a benchmark 'repetitions' times and add the timings to 'root'.
+    void run(const Benchmark& b, point_count_t points, MetadataNode root)
+    {
+        std::vector<double> times;
+        uint64_t items = 0;
+        uint64_t bytes = 0;
+
+        std::cerr << b.m_name;
+        if (b.m_synthetic)
+            std::cerr << "/" << points;
+        std::cerr << " ... " << std::flush;
+
+        for (int i = 0; i < m_repetitions; ++i)
+        {
+            State state(points);
+            auto start = std::chrono::steady_clock::now();
+            b.m_func(state);
+            auto end = std::chrono::steady_clock::now();
+
+            if (state.m_started)
+                start = state.m_start;
+            if (state.m_stopped)
+                end = state.m_end;
+            times.push_back(
+                std::chrono::duration<double>(end - start).count());
+            items = state.m_items;
+            bytes = state.m_bytes;
+        }
+
+        double min = *std::min_element(times.begin(), times.end());
+        double max = *std::max_element(times.begin(), times.end());
+        double mean = 0;
+        for (double t : times)
+            mean += t;
+        mean /= times.size();
+
+        std::cerr << min << "s" << std::endl;
+
+        MetadataNode node = root.addList("benchmarks");
+        node.add("name", b.m_name);
+        if (b.m_synthetic)
+            node.add("points", points);
+        node.add("repetitions", m_repetitions);
+        node.add("min_time", min, "Seconds");
+        node.add("mean_time", mean, "Seconds");
+        node.add("max_time", max, "Seconds");
+        if (items)
+        {
+            node.add("items", items);
+            node.add("items_per_second", items / min);
+        }
+        if (bytes)
+        {
+            node.add("bytes", bytes);
+            node.add("bytes_per_second", bytes / min);
+        }
+    }
+
+private:
+    int m_repetitions;
+};
+
+} // namespace bench
+} // namespace pdal
+
+
+using namespace pdal;
+
+int main(int argc, char *argv[])
+{
+    ProgramArgs args;
+    std::vector<point_count_t> pointCounts;
+    std::string filter;
+    std::string output;
+    int repetitions;
+    bool list;
+    bool help;
+
+    args.add("points", "Number of points generated by synthetic benchmarks. "
+        "May be given more than once [default: 1000000]", pointCounts);
+    args.add("filter", "Run only benchmarks whose name contains this string",
+        filter);
+    args.add("output,o", "File to which JSON results are written "
+        "[default: standard output]", output);
+    args.add("repetitions", "Number of times to run each benchmark",
+        repetitions, 3);
+    args.add("list", "List benchmarks and exit", list);
+    args.add("help,h", "Print help and exit", help);
+
+    std::vector<std::string> s;
+    for (int i = 1; i < argc; ++i)
+        s.push_back(argv[i]);
+    try
+    {
+        args.parse(s);
+    }
+    catch (arg_error& e)
+    {
+        std::cerr << "pdal_bench: " << e.m_error << std::endl;
+        return 1;
+    }
+
+    if (help)
+    {
+        std::cout << "usage: pdal_bench " << args.commandLine() << std::endl;
+        args.dump(std::cout, 2, 80);
+        return 0;
+    }
+    if (repetitions < 1)
+    {
+        std::cerr << "pdal_bench: repetitions must be at least 1." <<
+            std::endl;
+        return 1;
+    }
+    if (pointCounts.empty())
+        pointCounts.push_back(1000000);
+
+    auto& all = bench::benchmarks();
+    std::sort(all.begin(), all.end(),
+        [](const bench::Benchmark& b1, const bench::Benchmark& b2)
+        { return b1.m_name < b2.m_name; });
+
+    MetadataNode root;
+    root.add("pdal_version", GetFullVersionString());
+    bench::Runner runner(repetitions);
+    for (const bench::Benchmark& b : all)
+    {
+        if (b.m_name.find(filter) == std::string::npos)
+            continue;
+        if (list)
+        {
+            std::cout << b.m_name << std::endl;
+            continue;
+        }
+        try
+        {
+            if (b.m_synthetic)
+                for (point_count_t points : pointCounts)
+                    runner.run(b, points, root);
+            else
+                runner.run(b, 0, root);
+        }
+        catch (pdal_error& e)
+        {
+            std::cerr << "failed: " << e.what() << std::endl;
+        }
+    }
+    if (list)
+        return 0;
+
+    if (output.empty())
+        Utils::toJSON(root, std::cout);
+    else
+    {
+        std::ofstream out(output);
+        Utils::toJSON(root, out);
+    }
+    return 0;
+}
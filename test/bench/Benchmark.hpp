@@ -0,0 +1,134 @@
+/******************************************************************************
+* Copyright (c) 2015, Howard Butler (howard@hobu.co)
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+#pragma once
+
+// A small harness for timing PDAL operations.  Benchmarks are registered
+// with PDAL_BENCHMARK and run by pdal_bench, which writes the results
+// as JSON.
+
+#include <pdal/PointTable.hpp>
+#include <pdal/PointView.hpp>
+
+#include <chrono>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace pdal
+{
+namespace bench
+{
+
+class State
+{
+public:
+    State(point_count_t points) : m_points(points), m_items(0), m_bytes(0),
+        m_started(false), m_stopped(false)
+    {}
+
+    /// Number of points a synthetic benchmark should generate.
+    point_count_t points() const
+        { return m_points; }
+
+    /// Begin timing.  Work done before start() is setup and isn't timed.
+    /// If start() isn't called, the whole benchmark is timed.
+    void start()
+    {
+        m_started = true;
+        m_start = std::chrono::steady_clock::now();
+    }
+
+    /// End timing.  Work done after stop() isn't timed.
+    void stop()
+    {
+        m_stopped = true;
+        m_end = std::chrono::steady_clock::now();
+    }
+
+    /// Set the number of items (usually points) processed.
+    void setItems(uint64_t items)
+        { m_items = items; }
+
+    /// Set the number of bytes processed.
+    void setBytes(uint64_t bytes)
+        { m_bytes = bytes; }
+
+private:
+    friend class Runner;
+
+    point_count_t m_points;
+    uint64_t m_items;
+    uint64_t m_bytes;
+    bool m_started;
+    bool m_stopped;
+    std::chrono::steady_clock::time_point m_start;
+    std::chrono::steady_clock::time_point m_end;
+};
+
+typedef std::function<void(State&)> BenchFunc;
+
+/// Register a benchmark.
+/// \param name  Name of the benchmark.
+/// \param func  Function that runs the benchmark.
+/// \param synthetic  Whether the benchmark generates its own data and should
+///     be run once for each requested point count.
+int registerBenchmark(const std::string& name, BenchFunc func,
+    bool synthetic);
+
+/// Create a view of 'count' random points in a 1000 x 1000 x 100 box
+/// with the dimensions created by readers.faux.
+PointViewPtr makeView(PointTableRef table, point_count_t count);
+
+/// Return the path to a file in the test data directory.
+std::string datapath(const std::string& file);
+
+/// Return the path to a file in the temporary directory.
+std::string temppath(const std::string& file);
+
+} // namespace bench
+} // namespace pdal
+
+#define PDAL_BENCH_REGISTER(name, synthetic) \
+    static void bench_##name(pdal::bench::State& state); \
+    static int bench_reg_##name = pdal::bench::registerBenchmark(#name, \
+        bench_##name, synthetic); \
+    static void bench_##name(pdal::bench::State& state)
+
+/// Define a benchmark that generates its own data.  It is run once for
+/// each point count given to pdal_bench.
+#define PDAL_BENCHMARK(name) PDAL_BENCH_REGISTER(name, true)
+
+/// Define a benchmark that processes fixed data, such as a test file.
+#define PDAL_BENCHMARK_DATA(name) PDAL_BENCH_REGISTER(name, false)
@@ -0,0 +1,214 @@
+/******************************************************************************
+* Copyright (c) 2015, Howard Butler (howard@hobu.co)
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+#include "Benchmark.hpp"
+
+#include <pdal/KDIndex.hpp>
+#include <FauxReader.hpp>
+#include <RangeFilter.hpp>
+#include <StreamCallbackFilter.hpp>
+
+using namespace pdal;
+
+PDAL_BENCHMARK(PointView_setField)
+{
+    PointTable table;
+    PointLayoutPtr layout(table.layout());
+    layout->registerDim(Dimension::Id::X);
+    layout->registerDim(Dimension::Id::Y);
+    layout->registerDim(Dimension::Id::Z);
+    table.finalize();
+
+    PointView view(table);
+    state.start();
+    for (PointId i = 0; i < state.points(); ++i)
+    {
+        view.setField(Dimension::Id::X, i, i);
+        view.setField(Dimension::Id::Y, i, i);
+        view.setField(Dimension::Id::Z, i, i);
+    }
+    state.stop();
+    state.setItems(state.points());
+}
+
+PDAL_BENCHMARK(PointView_getField)
+{
+    PointTable table;
+    PointViewPtr view = bench::makeView(table, state.points());
+
+    double sum = 0;
+    state.start();
+    for (PointId i = 0; i < view->size(); ++i)
+    {
+        sum += view->getFieldAs<double>(Dimension::Id::X, i);
+        sum += view->getFieldAs<double>(Dimension::Id::Y, i);
+        sum += view->getFieldAs<double>(Dimension::Id::Z, i);
+    }
+    state.stop();
+    state.setItems(view->size());
+
+    // Keep the reads from being optimized away.
+    volatile double sink = sum;
+    (void)sink;
+}
+
+PDAL_BENCHMARK(PointTable_addPoint)
+{
+    PointTable table;
+    PointLayoutPtr layout(table.layout());
+    layout->registerDim(Dimension::Id::X);
+    table.finalize();
+
+    // Appending through a view is the only public way to add points.
+    PointView view(table);
+    state.start();
+    for (PointId i = 0; i < state.points(); ++i)
+        view.setField(Dimension::Id::X, i, 0.0);
+    state.stop();
+    state.setItems(state.points());
+}
+
+PDAL_BENCHMARK(PointView_appendPoint)
+{
+    PointTable table;
+    PointViewPtr view = bench::makeView(table, state.points());
+
+    state.start();
+    PointViewPtr even = view->makeNew();
+    for (PointId i = 0; i < view->size(); i += 2)
+        even->appendPoint(*view, i);
+    state.stop();
+    state.setItems(view->size() / 2);
+}
+
+namespace
+{
+
+Options executorOptions(point_count_t count)
+{
+    Options ops;
+    ops.add("bounds", BOX3D(0.0, 0.0, 0.0, 1000.0, 1000.0, 100.0));
+    ops.add("mode", "random");
+    ops.add("num_points", count);
+    return ops;
+}
+
+} // unnamed namespace
+
+PDAL_BENCHMARK(Executor_standard)
+{
+    FauxReader reader;
+    reader.setOptions(executorOptions(state.points()));
+
+    Options rangeOps;
+    rangeOps.add("limits", "Z[0:50]");
+    RangeFilter range;
+    range.setOptions(rangeOps);
+    range.setInput(reader);
+
+    PointTable table;
+    range.prepare(table);
+    range.execute(table);
+    state.setItems(state.points());
+}
+
+PDAL_BENCHMARK(Executor_stream)
+{
+    FauxReader reader;
+    reader.setOptions(executorOptions(state.points()));
+
+    Options rangeOps;
+    rangeOps.add("limits", "Z[0:50]");
+    RangeFilter range;
+    range.setOptions(rangeOps);
+    range.setInput(reader);
+
+    StreamCallbackFilter callback;
+    callback.setInput(range);
+
+    FixedPointTable table(10000);
+    callback.prepare(table);
+    callback.execute(table);
+    state.setItems(state.points());
+}
+
+PDAL_BENCHMARK(KD3Index_build)
+{
+    PointTable table;
+    PointViewPtr view = bench::makeView(table, state.points());
+
+    state.start();
+    KD3Index index(*view);
+    index.build();
+    state.stop();
+    state.setItems(view->size());
+}
+
+PDAL_BENCHMARK(KD3Index_knn)
+{
+    PointTable table;
+    PointViewPtr view = bench::makeView(table, state.points());
+    KD3Index index(*view);
+    index.build();
+
+    // Query a bounded number of points so that large runs finish.
+    point_count_t queries = std::min<point_count_t>(view->size(), 100000);
+    std::vector<PointId> indices;
+    std::vector<double> dists;
+    state.start();
+    for (PointId i = 0; i < queries; ++i)
+        index.knnSearch(view->getFieldAs<double>(Dimension::Id::X, i),
+            view->getFieldAs<double>(Dimension::Id::Y, i),
+            view->getFieldAs<double>(Dimension::Id::Z, i), 8,
+            &indices, &dists);
+    state.stop();
+    state.setItems(queries);
+}
+
+PDAL_BENCHMARK(KD3Index_radius)
+{
+    PointTable table;
+    PointViewPtr view = bench::makeView(table, state.points());
+    KD3Index index(*view);
+    index.build();
+
+    point_count_t queries = std::min<point_count_t>(view->size(), 100000);
+    state.start();
+    for (PointId i = 0; i < queries; ++i)
+        index.radius(view->getFieldAs<double>(Dimension::Id::X, i),
+            view->getFieldAs<double>(Dimension::Id::Y, i),
+            view->getFieldAs<double>(Dimension::Id::Z, i), 1.0);
+    state.stop();
+    state.setItems(queries);
+}
@@ -0,0 +1,116 @@
+/******************************************************************************
+* Copyright (c) 2015, Howard Butler (howard@hobu.co)
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+#include "Benchmark.hpp"
+
+#include <pdal/StageFactory.hpp>
+#include <BufferReader.hpp>
+
+using namespace pdal;
+
+namespace
+{
+
+// Time a filter over a view of generated points.  Generating the points
+// isn't timed.
+void runFilter(bench::State& state, const std::string& name,
+    const Options& ops)
+{
+    PointTable table;
+    PointViewPtr view = bench::makeView(table, state.points());
+
+    BufferReader reader;
+    reader.addView(view);
+
+    StageFactory factory;
+    Stage *filter = factory.createStage(name);
+    filter->setOptions(ops);
+    filter->setInput(reader);
+    filter->prepare(table);
+
+    state.start();
+    filter->execute(table);
+    state.stop();
+    state.setItems(view->size());
+}
+
+} // unnamed namespace
+
+PDAL_BENCHMARK(filters_chipper)
+{
+    Options ops;
+    ops.add("capacity", 5000);
+    runFilter(state, "filters.chipper", ops);
+}
+
+PDAL_BENCHMARK(filters_crop)
+{
+    Options ops;
+    ops.add("bounds", BOX2D(100.0, 100.0, 900.0, 900.0));
+    runFilter(state, "filters.crop", ops);
+}
+
+PDAL_BENCHMARK(filters_range)
+{
+    Options ops;
+    ops.add("limits", "Z[0:50], X(500:]");
+    runFilter(state, "filters.range", ops);
+}
+
+PDAL_BENCHMARK(filters_reprojection)
+{
+    Options ops;
+    ops.add("in_srs", "EPSG:32610");
+    ops.add("out_srs", "EPSG:4326");
+    runFilter(state, "filters.reprojection", ops);
+}
+
+PDAL_BENCHMARK(filters_sort)
+{
+    Options ops;
+    ops.add("dimension", "X");
+    runFilter(state, "filters.sort", ops);
+}
+
+PDAL_BENCHMARK(filters_splitter)
+{
+    Options ops;
+    ops.add("length", 100.0);
+    runFilter(state, "filters.splitter", ops);
+}
+
+PDAL_BENCHMARK(filters_stats)
+{
+    runFilter(state, "filters.stats", Options());
+}
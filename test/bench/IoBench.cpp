@@ -0,0 +1,191 @@
+/******************************************************************************
+* Copyright (c) 2015, Howard Butler (howard@hobu.co)
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+#include "Benchmark.hpp"
+
+#include <pdal/pdal_defines.h>
+#include <pdal/StageFactory.hpp>
+#include <pdal/util/FileUtils.hpp>
+#include <BufferReader.hpp>
+
+using namespace pdal;
+
+namespace
+{
+
+// Write a view with a writer.
+void write(PointTableRef table, PointViewPtr view, const std::string& driver,
+    Options ops)
+{
+    BufferReader reader;
+    reader.addView(view);
+
+    StageFactory factory;
+    Stage *writer = factory.createStage(driver);
+    writer->setOptions(ops);
+    writer->setInput(reader);
+    writer->prepare(table);
+    writer->execute(table);
+}
+
+// Time writing generated points.
+void runWrite(bench::State& state, const std::string& driver,
+    const std::string& file, Options ops = Options())
+{
+    std::string filename = bench::temppath(file);
+    ops.add("filename", filename);
+
+    PointTable table;
+    PointViewPtr view = bench::makeView(table, state.points());
+
+    state.start();
+    write(table, view, driver, ops);
+    state.stop();
+    state.setItems(view->size());
+    state.setBytes(FileUtils::fileSize(filename));
+    FileUtils::deleteFile(filename);
+}
+
+// Time reading a file.
+point_count_t read(bench::State& state, const std::string& driver,
+    const std::string& filename)
+{
+    Options ops;
+    ops.add("filename", filename);
+
+    StageFactory factory;
+    Stage *reader = factory.createStage(driver);
+    reader->setOptions(ops);
+
+    PointTable table;
+    reader->prepare(table);
+    state.start();
+    PointViewSet viewSet = reader->execute(table);
+    state.stop();
+
+    point_count_t count = 0;
+    for (auto& view : viewSet)
+        count += view->size();
+    state.setItems(count);
+    state.setBytes(FileUtils::fileSize(filename));
+    return count;
+}
+
+// Time reading generated points that have been written to a file.
+void runRead(bench::State& state, const std::string& writerDriver,
+    const std::string& readerDriver, const std::string& file,
+    Options ops = Options())
+{
+    std::string filename = bench::temppath(file);
+    ops.add("filename", filename);
+    {
+        PointTable table;
+        PointViewPtr view = bench::makeView(table, state.points());
+        write(table, view, writerDriver, ops);
+    }
+    read(state, readerDriver, filename);
+    FileUtils::deleteFile(filename);
+}
+
+} // unnamed namespace
+
+PDAL_BENCHMARK_DATA(las_read_autzen)
+{
+    read(state, "readers.las", bench::datapath("autzen/autzen.las"));
+}
+
+PDAL_BENCHMARK(las_write)
+{
+    runWrite(state, "writers.las", "bench.las");
+}
+
+PDAL_BENCHMARK(las_read)
+{
+    runRead(state, "writers.las", "readers.las", "bench.las");
+}
+
+#ifdef PDAL_HAVE_LASZIP
+PDAL_BENCHMARK(laz_write_laszip)
+{
+    Options ops;
+    ops.add("compression", "laszip");
+    runWrite(state, "writers.las", "bench.laz", ops);
+}
+
+PDAL_BENCHMARK(laz_read_laszip)
+{
+    Options ops;
+    ops.add("compression", "laszip");
+    runRead(state, "writers.las", "readers.las", "bench.laz", ops);
+}
+#endif
+
+#ifdef PDAL_HAVE_LAZPERF
+PDAL_BENCHMARK(laz_write_lazperf)
+{
+    Options ops;
+    ops.add("compression", "lazperf");
+    runWrite(state, "writers.las", "bench.laz", ops);
+}
+
+PDAL_BENCHMARK(laz_read_lazperf)
+{
+    Options ops;
+    ops.add("compression", "lazperf");
+    runRead(state, "writers.las", "readers.las", "bench.laz", ops);
+}
+#endif
+
+PDAL_BENCHMARK(text_write)
+{
+    runWrite(state, "writers.text", "bench.txt");
+}
+
+PDAL_BENCHMARK(text_read)
+{
+    // readers.text doesn't handle quoted headers.
+    Options ops;
+    ops.add("quote_header", false);
+    runRead(state, "writers.text", "readers.text", "bench.txt", ops);
+}
+
+PDAL_BENCHMARK(bpf_write)
+{
+    runWrite(state, "writers.bpf", "bench.bpf");
+}
+
+PDAL_BENCHMARK(bpf_read)
+{
+    runRead(state, "writers.bpf", "readers.bpf", "bench.bpf");
+}
@@ -34,7 +34,9 @@
 
 #include <pdal/pdal_test_main.hpp>
 
+#include <fstream>
 #include <iterator>
+#include <limits>
 #include <sstream>
 #include <iostream>
 #include <string>
@@ -43,6 +45,8 @@
 #include "Support.hpp"
 #include <pdal/Options.hpp>
 #include <pdal/PointView.hpp>
+#include <pdal/util/FileUtils.hpp>
+#include <pdal/util/Inserter.hpp>
 #include <LasReader.hpp>
 #include <pdal/Compression.hpp>
 
@@ -185,6 +189,71 @@ TEST(Compression, types)
     }
 }
 
+
+// Chunks of varying size are read back using the point counts in the
+// chunk table, and a single chunk can be read on its own.
+TEST(Compression, variableChunks)
+{
+    laszip::factory::record_schema schema;
+    schema.push(laszip::factory::record_item::POINT10);
+    laszip::io::laz_vlr zipvlr = laszip::io::laz_vlr::from_schema(schema);
+    zipvlr.chunk_size = (std::numeric_limits<uint32_t>::max)();
+    std::vector<char> vlrData(zipvlr.size());
+    zipvlr.extract(vlrData.data());
+
+    const size_t pointLen = 20;
+    const std::vector<uint32_t> chunkCounts { 3, 7, 1, 5 };
+    std::vector<char> points;
+    for (uint32_t i = 0; i < 16; ++i)
+    {
+        char buf[pointLen];
+        LeInserter out(buf, pointLen);
+        out << (int32_t)(1000 + i * 7) << (int32_t)(2000 - i * 3) <<
+            (int32_t)(i * i) << (uint16_t)(100 + i) << (uint8_t)0x09 <<
+            (uint8_t)2 << (int8_t)0 << (uint8_t)0 << (uint16_t)1;
+        points.insert(points.end(), buf, buf + pointLen);
+    }
+
+    std::string filename(Support::temppath("variable_chunks.laz"));
+    std::fstream stream(filename, std::ios::in | std::ios::out |
+        std::ios::binary | std::ios::trunc);
+
+    // Point data starts with the chunk table offset.
+    std::vector<std::streamoff> chunkOffsets { sizeof(uint64_t) };
+    LazPerfVlrCompressor compressor(stream, schema, zipvlr.chunk_size);
+    const char *pos = points.data();
+    for (uint32_t count : chunkCounts)
+    {
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            compressor.compress(pos);
+            pos += pointLen;
+        }
+        compressor.chunk();
+        chunkOffsets.push_back(stream.tellp());
+    }
+    compressor.done();
+
+    std::vector<char> outbuf(points.size());
+    LazPerfVlrDecompressor decompressor(stream, vlrData.data(), 0);
+    EXPECT_EQ(decompressor.pointSize(), pointLen);
+    for (char *out = outbuf.data(); out < outbuf.data() + outbuf.size();
+        out += pointLen)
+        decompressor.decompress(out);
+    EXPECT_TRUE(outbuf == points);
+
+    // Third chunk, which holds the twelfth point.
+    std::vector<char> chunkbuf(pointLen);
+    LazPerfVlrDecompressor chunkDecompressor(stream, vlrData.data(),
+        chunkOffsets[2], chunkCounts[2]);
+    chunkDecompressor.decompress(chunkbuf.data());
+    EXPECT_EQ(memcmp(chunkbuf.data(), points.data() + 10 * pointLen,
+        pointLen), 0);
+
+    stream.close();
+    FileUtils::deleteFile(filename);
+}
+
 //
 // BOOST_AUTO_TEST_CASE(test_compress_copied_view)
 // {
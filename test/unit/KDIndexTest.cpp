@@ -159,6 +159,15 @@ TEST(KDIndex, neighbors3D)
     EXPECT_EQ(ids[2], 3u);
     EXPECT_EQ(ids[3], 0u);
     EXPECT_EQ(ids[4], 4u);
+
+    std::vector<double> dists;
+    index.knnSearch(0, 0, 0, 2, &ids, &dists);
+    EXPECT_EQ(ids.size(), 2u);
+    EXPECT_EQ(dists.size(), 2u);
+    EXPECT_EQ(ids[0], 0u);
+    EXPECT_EQ(ids[1], 1u);
+    EXPECT_DOUBLE_EQ(dists[0], 0.0);
+    EXPECT_DOUBLE_EQ(dists[1], 3.0);
 }
 
 TEST(KDIndex, neighbordims)
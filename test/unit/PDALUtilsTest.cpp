@@ -33,7 +33,9 @@
 
 #include <pdal/pdal_test_main.hpp>
 
+#include <atomic>
 #include <sstream>
+#include <vector>
 
 #include <pdal/PDALUtils.hpp>
 #include "Support.hpp"
@@ -62,3 +64,64 @@ TEST(PDALUtilsTest, options1)
     EXPECT_TRUE(Support::compare_files(goodfile, testfile));
 }
 
+TEST(PDALUtilsTest, parallelFor)
+{
+    for (size_t threads : { 1, 2, 7 })
+    {
+        std::vector<int> hits(100);
+        Utils::parallelFor(hits.size(), threads,
+            [&hits](size_t i){ hits[i]++; });
+        for (size_t i = 0; i < hits.size(); ++i)
+            EXPECT_EQ(hits[i], 1);
+    }
+
+    // More threads than work and no work at all.
+    std::atomic<size_t> calls(0);
+    Utils::parallelFor(3, 10, [&calls](size_t){ calls++; });
+    EXPECT_EQ(calls, 3u);
+    Utils::parallelFor(0, 4, [&calls](size_t){ calls++; });
+    EXPECT_EQ(calls, 3u);
+}
+
+TEST(PDALUtilsTest, parallelForError)
+{
+    for (size_t threads : { 1, 4 })
+    {
+        std::atomic<size_t> calls(0);
+        auto fn = [&calls](size_t i)
+        {
+            calls++;
+            if (i == 10)
+                throw pdal_error("index 10");
+        };
+
+        try
+        {
+            Utils::parallelFor(1000, threads, fn);
+            FAIL() << "Expected an exception.";
+        }
+        catch (pdal_error& err)
+        {
+            EXPECT_EQ(std::string(err.what()), "index 10");
+        }
+        // Indices aren't handed out once a call has failed.
+        EXPECT_LT(calls, 1000u);
+    }
+}
+
+TEST(PDALUtilsTest, checkThreads)
+{
+    EXPECT_NO_THROW(Utils::checkThreads("filters.test", 1));
+    EXPECT_NO_THROW(Utils::checkThreads("filters.test", 8));
+    try
+    {
+        Utils::checkThreads("filters.test", 0);
+        FAIL() << "Expected an exception.";
+    }
+    catch (pdal_error& err)
+    {
+        EXPECT_EQ(std::string(err.what()),
+            "filters.test: Option 'threads' must be at least 1.");
+    }
+    EXPECT_THROW(Utils::checkThreads("filters.test", -1), pdal_error);
+}
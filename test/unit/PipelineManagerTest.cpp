@@ -37,6 +37,7 @@
 #include "Support.hpp"
 
 #include <pdal/PipelineManager.hpp>
+#include <pdal/PointView.hpp>
 #include <pdal/util/FileUtils.hpp>
 
 using namespace pdal;
@@ -71,6 +72,29 @@ TEST(PipelineManagerTest, basic)
 }
 
 
+TEST(PipelineManagerTest, reexecute)
+{
+    PointTable table;
+    PipelineManager mgr(table);
+
+    Options opts;
+    opts.add("filename", Support::datapath("las/1.2-with-color.las"));
+    Stage& reader = mgr.addReader("readers.las");
+    reader.setOptions(opts);
+
+    EXPECT_EQ(mgr.execute(), 1065u);
+    PointViewPtr view = *mgr.views().begin();
+    double x = view->getFieldAs<double>(Dimension::Id::X, 10);
+
+    // The second run reuses the table rather than adding to it.
+    EXPECT_EQ(mgr.execute(), 1065u);
+    ASSERT_EQ(mgr.views().size(), 1u);
+    view = *mgr.views().begin();
+    EXPECT_EQ(view->size(), 1065u);
+    EXPECT_DOUBLE_EQ(view->getFieldAs<double>(Dimension::Id::X, 10), x);
+    EXPECT_EQ(table.metadata().children("readers.las").size(), 1u);
+}
+
 //ABELL - Mosaic
 /**
 TEST(PipelineManagerTest, PipelineManagerTest_test2)
@@ -36,6 +36,10 @@
 
 #include <pdal/PluginManager.hpp>
 #include <pdal/Filter.hpp>
+#include <pdal/util/FileUtils.hpp>
+#include <pdal/util/Utils.hpp>
+
+#include <fstream>
 
 #include "Support.hpp"
 
@@ -109,5 +113,122 @@ TEST(PluginManagerTest, CreateObject)
     EXPECT_NE(p.get(), nullptr);
 }
 
-} // namespace pdal
+#ifndef _WIN32
+namespace
+{
+
+// The manifest is only read once per process, so these tests run the
+// pdal application with PDAL_DRIVER_PATH pointing at a directory of
+// fake plugins and PDAL_PLUGIN_MANIFEST at a temporary file.
+class PluginManifestTest : public ::testing::Test
+{
+protected:
+    virtual void SetUp()
+    {
+        m_dir = Support::temppath("manifest_plugins");
+        m_manifest = Support::temppath("plugins.manifest");
+        FileUtils::deleteDirectory(m_dir);
+        FileUtils::deleteFile(m_manifest);
+        FileUtils::createDirectory(m_dir);
+
+        // Not libraries, so loading them fails, but they're still listed.
+        m_filterLib = m_dir + "/libpdal_plugin_filter_manifesttest.so";
+        writeFile(m_filterLib, "filter");
+        writeFile(m_dir + "/libpdal_plugin_kernel_manifesttest.so", "kernel");
+    }
+
+    virtual void TearDown()
+    {
+        FileUtils::deleteDirectory(m_dir);
+        FileUtils::deleteFile(m_manifest);
+    }
+
+    void writeFile(const std::string& filename, const std::string& text,
+        bool append = false)
+    {
+        std::ofstream out(filename, append ? std::ios::app : std::ios::out);
+        out << text;
+    }
+
+    // List the drivers with the plugin directory and a relative
+    // directory in the search path.
+    std::string drivers(const std::string& manifest)
+    {
+        std::string cmd = "PDAL_DRIVER_PATH=" + m_dir + ":./lib "
+            "PDAL_PLUGIN_MANIFEST=" + manifest + " " +
+            Support::binpath(Support::exename("pdal")) + " --drivers";
+        std::string output;
+        EXPECT_EQ(Utils::run_shell_command(cmd, output), 0);
+        return output;
+    }
+
+    std::string m_dir;
+    std::string m_manifest;
+    std::string m_filterLib;
+};
 
+} // unnamed namespace
+
+TEST_F(PluginManifestTest, build)
+{
+    drivers(m_manifest);
+    ASSERT_TRUE(FileUtils::fileExists(m_manifest));
+
+    std::string text = FileUtils::readFileIntoString(m_manifest);
+    EXPECT_EQ(text.find("PDAL plugin manifest"), 0u);
+    EXPECT_NE(text.find("libpdal_plugin_filter_manifesttest.so"),
+        std::string::npos);
+    EXPECT_NE(text.find("libpdal_plugin_kernel_manifesttest.so"),
+        std::string::npos);
+
+    // The manifest records which plugin types it covers.
+    int stageTypes = PF_PluginType_Reader | PF_PluginType_Filter |
+        PF_PluginType_Writer;
+    std::string::size_type pos = text.find("types\t");
+    ASSERT_NE(pos, std::string::npos);
+    int types = std::atoi(text.c_str() + pos + 6);
+    EXPECT_EQ(types & stageTypes, stageTypes);
+
+    // Relative directories depend on the current directory, so they
+    // aren't recorded.
+    EXPECT_EQ(text.find("./lib"), std::string::npos);
+}
+
+TEST_F(PluginManifestTest, reuse)
+{
+    drivers(m_manifest);
+
+    // A stage that only the manifest knows about shows up if the manifest
+    // is used rather than rebuilt.
+    writeFile(m_manifest, "stage\tfilters.manifestonly\t" + m_filterLib +
+        "\t" + std::to_string(PF_PluginType_Filter) +
+        "\thttp://pdal.io\tOnly in the manifest\n", true);
+    EXPECT_NE(drivers(m_manifest).find("filters.manifestonly"),
+        std::string::npos);
+}
+
+TEST_F(PluginManifestTest, invalidate)
+{
+    drivers(m_manifest);
+    writeFile(m_manifest, "stage\tfilters.manifestonly\t" + m_filterLib +
+        "\t" + std::to_string(PF_PluginType_Filter) +
+        "\thttp://pdal.io\tOnly in the manifest\n", true);
+
+    // Changing a plugin library rebuilds the manifest.
+    writeFile(m_filterLib, "changed", true);
+    EXPECT_EQ(drivers(m_manifest).find("filters.manifestonly"),
+        std::string::npos);
+    EXPECT_EQ(FileUtils::readFileIntoString(m_manifest).
+        find("filters.manifestonly"), std::string::npos);
+}
+
+TEST_F(PluginManifestTest, off)
+{
+    std::string output = drivers("off");
+    EXPECT_NE(output.find("filters.crop"), std::string::npos);
+    EXPECT_FALSE(FileUtils::fileExists(m_manifest));
+    EXPECT_FALSE(FileUtils::fileExists("off"));
+}
+#endif // _WIN32
+
+} // namespace pdal
@@ -34,7 +34,9 @@
 
 #include <pdal/pdal_test_main.hpp>
 
+#include <pdal/MmapPointTable.hpp>
 #include <pdal/PointTable.hpp>
+#include <pdal/PointView.hpp>
 #include <las/LasReader.hpp>
 #include "Support.hpp"
 
@@ -178,3 +180,133 @@ TEST(PointTable, userView)
     EXPECT_TRUE(called);
 }
 
+
+TEST(PointTable, mmap)
+{
+    // Keep the minimum number of blocks resident so that most of the
+    // points have to come back from the spill file.
+    MmapPointTable table(Support::temppath(), 0);
+    PointLayoutPtr layout(table.layout());
+    layout->registerDim(Dimension::Id::X);
+    layout->registerDim(Dimension::Id::Classification);
+    table.finalize();
+
+    const point_count_t count = 65536 * 5 + 17;
+    PointView view(table);
+    for (PointId i = 0; i < count; ++i)
+    {
+        view.setField(Dimension::Id::X, i, i * 2.5);
+        view.setField(Dimension::Id::Classification, i, (uint8_t)i);
+    }
+    EXPECT_EQ(view.size(), count);
+
+    for (PointId i = 0; i < count; ++i)
+    {
+        EXPECT_DOUBLE_EQ(view.getFieldAs<double>(Dimension::Id::X, i),
+            i * 2.5);
+        EXPECT_EQ(view.getFieldAs<uint8_t>(
+            Dimension::Id::Classification, i), (uint8_t)i);
+    }
+}
+
+TEST(PointTable, mmapRead)
+{
+    Options opts;
+    opts.add("filename", Support::datapath("las/simple.las"));
+
+    LasReader defReader;
+    defReader.setOptions(opts);
+    PointTable defTable;
+    defReader.prepare(defTable);
+    PointViewSet viewSet = defReader.execute(defTable);
+    PointViewPtr defView = *viewSet.begin();
+
+    LasReader reader;
+    reader.setOptions(opts);
+    MmapPointTable table(Support::temppath(), 0);
+    reader.prepare(table);
+    viewSet = reader.execute(table);
+    PointViewPtr view = *viewSet.begin();
+
+    ASSERT_EQ(view->size(), defView->size());
+    Dimension::IdList dims = view->dims();
+    for (PointId i = 0; i < view->size(); ++i)
+        for (auto di = dims.begin(); di != dims.end(); ++di)
+            EXPECT_DOUBLE_EQ(view->getFieldAs<double>(*di, i),
+                defView->getFieldAs<double>(*di, i));
+}
+
+TEST(PointTable, reset)
+{
+    std::shared_ptr<PoolBlockAllocator> pool(new PoolBlockAllocator);
+
+    {
+        PointTable table(pool);
+        table.layout()->registerDim(Dimension::Id::X);
+        table.finalize();
+
+        PointView view(table);
+        for (PointId i = 0; i < 70000; ++i)
+            view.setField(Dimension::Id::X, i, i * 2.5);
+        table.metadata().add("run", 1);
+
+        // A reset table starts over with an empty layout and metadata and
+        // zeroed points.
+        table.reset();
+        EXPECT_FALSE(table.layout()->finalized());
+        EXPECT_FALSE(table.metadata().findChild("run").valid());
+
+        table.layout()->registerDim(Dimension::Id::X);
+        table.layout()->registerDim(Dimension::Id::Y);
+        table.finalize();
+
+        PointView view2(table);
+        for (PointId i = 0; i < 10; ++i)
+            view2.setField(Dimension::Id::Y, i, 1.0);
+        for (PointId i = 0; i < 10; ++i)
+        {
+            EXPECT_DOUBLE_EQ(view2.getFieldAs<double>(Dimension::Id::X, i),
+                0);
+            EXPECT_DOUBLE_EQ(view2.getFieldAs<double>(Dimension::Id::Y, i),
+                1.0);
+        }
+
+        // The blocks sized for the first layout were given back.
+        EXPECT_EQ(pool->pooled(), 2 * 65536 * 8u);
+    }
+    EXPECT_EQ(pool->pooled(), 2 * 65536 * 8u + 65536 * 16u);
+
+    // A new table is served from the pool.
+    PointTable table(pool);
+    table.layout()->registerDim(Dimension::Id::X);
+    table.finalize();
+    PointView view(table);
+    view.setField(Dimension::Id::X, 0, 1.0);
+    EXPECT_EQ(pool->pooled(), 65536 * 8u + 65536 * 16u);
+}
+
+TEST(PointTable, trim)
+{
+    std::shared_ptr<PoolBlockAllocator> pool(new PoolBlockAllocator);
+    PointTable table(pool);
+    table.layout()->registerDim(Dimension::Id::X);
+    table.finalize();
+
+    {
+        PointView view(table);
+        for (PointId i = 0; i < 200000; ++i)
+            view.setField(Dimension::Id::X, i, 1.0);
+    }
+    const std::size_t blockSize = 65536 * 8;
+
+    // Blocks holding points are never given up.
+    table.trim(0);
+    EXPECT_EQ(pool->pooled(), 0u);
+
+    // Keep two of the four blocks once the table is empty.
+    table.reset();
+    table.trim(2 * blockSize + 1);
+    EXPECT_EQ(pool->pooled(), 2 * blockSize);
+    table.trim(0);
+    EXPECT_EQ(pool->pooled(), 4 * blockSize);
+}
@@ -34,6 +34,7 @@
 
 #include <pdal/pdal_test_main.hpp>
 
+#include <algorithm>
 #include <array>
 #include <random>
 
@@ -432,6 +433,83 @@ TEST(PointViewTest, order)
     }
 }
 
+TEST(PointViewTest, appendPoints)
+{
+    PointTable table;
+    PointViewPtr view = makeTestView(table, 17);
+
+    // Contiguous slices.
+    PointViewPtr head = view->makeNew();
+    PointViewPtr tail = view->makeNew();
+    head->appendPoints(*view, 0, 10);
+    tail->appendPoints(*view, 10, 7);
+    EXPECT_EQ(head->size(), 10u);
+    EXPECT_EQ(tail->size(), 7u);
+    for (PointId i = 0; i < tail->size(); ++i)
+        EXPECT_EQ(tail->getFieldAs<int32_t>(Dimension::Id::X, i),
+            (int32_t)((i + 10) * 10));
+
+    // Rejoin the slices.
+    PointViewPtr all = view->makeNew();
+    all->append(*head);
+    all->append(*tail);
+    verifyTestView(*all, 17);
+
+    // Non-contiguous points.
+    PointViewPtr odd = view->makeNew();
+    for (PointId i = 1; i < view->size(); i += 2)
+        odd->appendPoint(*view, i);
+    odd->appendPoints(*tail, 0, 2);
+    EXPECT_EQ(odd->size(), 10u);
+    EXPECT_EQ(odd->getFieldAs<int32_t>(Dimension::Id::X, 0), 10);
+    EXPECT_EQ(odd->getFieldAs<int32_t>(Dimension::Id::X, 7), 150);
+    EXPECT_EQ(odd->getFieldAs<int32_t>(Dimension::Id::X, 8), 100);
+    EXPECT_EQ(odd->getFieldAs<int32_t>(Dimension::Id::X, 9), 110);
+
+    // Sorting a slice reorders only the slice.
+    std::sort(tail->begin(), tail->end(),
+        [](const PointIdxRef& p1, const PointIdxRef& p2)
+        { return p2.compare(Dimension::Id::X, p1); });
+    for (PointId i = 0; i < tail->size(); ++i)
+        EXPECT_EQ(tail->getFieldAs<int32_t>(Dimension::Id::X, i),
+            (int32_t)((16 - i) * 10));
+    verifyTestView(*head, 10);
+    verifyTestView(*view, 17);
+}
+
+TEST(PointViewTest, pointIndex)
+{
+    PointIndex index;
+    EXPECT_TRUE(index.isRange());
+
+    index.appendRange(5, 10);
+    index.push_back(15);
+    EXPECT_TRUE(index.isRange());
+    EXPECT_EQ(index.size(), 11u);
+    EXPECT_EQ(index[0], 5u);
+    EXPECT_EQ(index[10], 15u);
+
+    PointIndex slice;
+    slice.append(index, 3, 4);
+    EXPECT_TRUE(slice.isRange());
+    EXPECT_EQ(slice[0], 8u);
+    EXPECT_EQ(slice[3], 11u);
+
+    index.set(2, 7);
+    EXPECT_TRUE(index.isRange());
+    index.set(2, 100);
+    EXPECT_FALSE(index.isRange());
+    EXPECT_EQ(index.size(), 11u);
+    EXPECT_EQ(index[1], 6u);
+    EXPECT_EQ(index[2], 100u);
+    EXPECT_EQ(index[10], 15u);
+
+    index.truncate(3);
+    EXPECT_EQ(index.size(), 3u);
+    index.push_back(20);
+    EXPECT_EQ(index[3], 20u);
+}
+
 // Per discussions with @abellgithub (https://github.com/gadomski/PDAL/commit/c1d54e56e2de841d37f2a1b1c218ed723053f6a9#commitcomment-14415138)
 // we only do bounds checking on `PointView`s when in debug mode.
 #ifndef NDEBUG
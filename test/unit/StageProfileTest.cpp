@@ -0,0 +1,174 @@
+/******************************************************************************
+* Copyright (c) 2015, Howard Butler (howard@hobu.co)
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+#include <pdal/pdal_test_main.hpp>
+
+#include <pdal/PipelineManager.hpp>
+#include <pdal/StageProfile.hpp>
+#include <DecimationFilter.hpp>
+#include <FauxReader.hpp>
+#include <StreamCallbackFilter.hpp>
+
+using namespace pdal;
+
+namespace
+{
+
+Options readerOptions()
+{
+    Options ops;
+    ops.add("bounds", BOX3D(0.0, 0.0, 0.0, 99.0, 99.0, 99.0));
+    ops.add("mode", "ramp");
+    ops.add("num_points", 100);
+    return ops;
+}
+
+template<typename T>
+T profileValue(const Stage& s, const std::string& path)
+{
+    return s.getProfile().toMetadata().findChild(path).value<T>();
+}
+
+} // unnamed namespace
+
+TEST(StageProfileTest, standard)
+{
+    FauxReader reader;
+    reader.setOptions(readerOptions());
+
+    Options decimationOps;
+    decimationOps.add("step", 2);
+    DecimationFilter filter;
+    filter.setOptions(decimationOps);
+    filter.setInput(reader);
+    reader.setProfiling(true);
+    filter.setProfiling(true);
+
+    PointTable table;
+    filter.prepare(table);
+    EXPECT_TRUE(filter.getProfile().empty());
+    filter.execute(table);
+
+    EXPECT_FALSE(reader.getProfile().empty());
+    EXPECT_EQ(profileValue<point_count_t>(reader, "points_in"), 0u);
+    EXPECT_EQ(profileValue<point_count_t>(reader, "points_out"), 100u);
+    EXPECT_EQ(profileValue<point_count_t>(reader, "views"), 1u);
+    EXPECT_EQ(profileValue<point_count_t>(filter, "points_in"), 100u);
+    EXPECT_EQ(profileValue<point_count_t>(filter, "points_out"), 50u);
+    EXPECT_EQ(profileValue<point_count_t>(filter, "run:calls"), 1u);
+    EXPECT_EQ(profileValue<point_count_t>(filter, "ready:calls"), 1u);
+    EXPECT_EQ(profileValue<point_count_t>(filter, "done:calls"), 1u);
+    EXPECT_GE(profileValue<double>(filter, "run:wall_time"), 0.0);
+    EXPECT_TRUE(filter.getProfile().toMetadata().
+        findChild("process_one").empty());
+
+    // Preparing again clears the statistics.  The layout of a table
+    // can't change once it holds points, so use a new one.
+    PointTable table2;
+    filter.prepare(table2);
+    EXPECT_TRUE(reader.getProfile().empty());
+    EXPECT_TRUE(filter.getProfile().empty());
+}
+
+TEST(StageProfileTest, disabled)
+{
+    FauxReader reader;
+    reader.setOptions(readerOptions());
+
+    Options decimationOps;
+    decimationOps.add("step", 2);
+    DecimationFilter filter;
+    filter.setOptions(decimationOps);
+    filter.setInput(reader);
+
+    // Counts are kept, but no phase is timed.
+    PointTable table;
+    filter.prepare(table);
+    filter.execute(table);
+    EXPECT_TRUE(reader.getProfile().empty());
+    EXPECT_TRUE(filter.getProfile().empty());
+    EXPECT_EQ(profileValue<point_count_t>(filter, "points_out"), 50u);
+    EXPECT_TRUE(filter.getProfile().toMetadata().findChild("run").empty());
+}
+
+TEST(StageProfileTest, stream)
+{
+    FauxReader reader;
+    reader.setOptions(readerOptions());
+
+    Options decimationOps;
+    decimationOps.add("step", 10);
+    DecimationFilter dec;
+    dec.setOptions(decimationOps);
+    dec.setInput(reader);
+
+    StreamCallbackFilter filter;
+    filter.setInput(dec);
+    reader.setProfiling(true);
+    dec.setProfiling(true);
+    filter.setProfiling(true);
+
+    FixedPointTable table(20);
+    filter.prepare(table);
+    filter.execute(table);
+
+    EXPECT_EQ(profileValue<point_count_t>(reader, "points_out"), 100u);
+    EXPECT_EQ(profileValue<point_count_t>(dec, "points_in"), 100u);
+    EXPECT_EQ(profileValue<point_count_t>(dec, "points_out"), 10u);
+    EXPECT_EQ(profileValue<point_count_t>(filter, "points_in"), 10u);
+    EXPECT_GT(profileValue<point_count_t>(dec, "process_one:calls"), 0u);
+    EXPECT_TRUE(dec.getProfile().toMetadata().findChild("run").empty());
+}
+
+TEST(StageProfileTest, pipeline)
+{
+    PipelineManager mgr;
+    mgr.setProfiling(true);
+
+    Stage& reader = mgr.addReader("readers.faux");
+    reader.setOptions(readerOptions());
+    Stage& filter = mgr.addFilter("filters.decimation");
+    Options decimationOps;
+    decimationOps.add("step", 4);
+    filter.setOptions(decimationOps);
+    filter.setInput(reader);
+    mgr.execute();
+
+    MetadataNode profile = mgr.getProfile();
+    MetadataNodeList stages = profile.children("stages");
+    ASSERT_EQ(stages.size(), 2u);
+    EXPECT_EQ(stages[0].findChild("type").value(), "readers.faux");
+    EXPECT_EQ(stages[1].findChild("type").value(), "filters.decimation");
+    EXPECT_EQ(stages[1].findChild("points_out").value<point_count_t>(), 25u);
+}
@@ -34,6 +34,7 @@
 
 #include <pdal/pdal_test_main.hpp>
 
+#include <clocale>
 #include <sstream>
 
 #include <pdal/util/Utils.hpp>
@@ -318,3 +319,60 @@ TEST(UtilsTest, escapeNonprinting)
     std::string out = Utils::escapeNonprinting(s);
     EXPECT_EQ(out, "CTRL-N,A,B,R,V: \\n\\a\\b\\r\\v\\x12\\x0e\\x01");
 }
+
+TEST(UtilsTest, formatFixed)
+{
+    auto fmt = [](double v, int precision)
+    {
+        std::vector<char> buf(Utils::fixedBufSize(precision));
+        char *end = Utils::formatFixed(v, precision, buf.data());
+        return std::string(buf.data(), end);
+    };
+
+    auto stream = [](double v, int precision)
+    {
+        std::ostringstream oss;
+        oss << std::fixed;
+        oss.precision(precision);
+        oss << v;
+        return oss.str();
+    };
+
+    EXPECT_EQ(fmt(0, 3), "0.000");
+    EXPECT_EQ(fmt(-0.0004, 3), "-0.000");
+    EXPECT_EQ(fmt(12.5, 0), "12");
+    EXPECT_EQ(fmt(13.5, 0), "14");
+    EXPECT_EQ(fmt(-1234.56789, 2), "-1234.57");
+    EXPECT_EQ(fmt(1e300, 2), stream(1e300, 2));
+    EXPECT_EQ(fmt(0.125, 2), stream(0.125, 2));
+
+    Utils::random_seed(42);
+    for (int i = 0; i < 100000; ++i)
+    {
+        int precision = i % 10;
+        double v = Utils::random(-1e7, 1e7);
+        EXPECT_EQ(fmt(v, precision), stream(v, precision));
+    }
+}
+
+// Values formatted with snprintf() still use '.' as the decimal point.
+TEST(UtilsTest, formatFixedLocale)
+{
+    auto fmt = [](double v, int precision)
+    {
+        std::vector<char> buf(Utils::fixedBufSize(precision));
+        char *end = Utils::formatFixed(v, precision, buf.data());
+        return std::string(buf.data(), end);
+    };
+
+    std::string old(setlocale(LC_NUMERIC, nullptr));
+    if (!setlocale(LC_NUMERIC, "de_DE.UTF-8") &&
+        !setlocale(LC_NUMERIC, "de_DE"))
+        return;
+    std::string tie = fmt(0.125, 2);
+    std::string big = fmt(1e20, 1);
+    setlocale(LC_NUMERIC, old.c_str());
+
+    EXPECT_EQ(tie, "0.12");
+    EXPECT_EQ(big, "100000000000000000000.0");
+}
@@ -0,0 +1,153 @@
+/******************************************************************************
+* Copyright (c) 2015, Howard Butler (howard@hobu.co)
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+#include <pdal/pdal_test_main.hpp>
+
+#include <pdal/util/FileUtils.hpp>
+#include <pdal/util/Utils.hpp>
+
+#include "Support.hpp"
+
+#include <boost/property_tree/json_parser.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+using namespace pdal;
+
+namespace
+{
+
+std::string appName()
+{
+    return Support::binpath(Support::exename("pdal") + " info");
+}
+
+} // unnamed namespace
+
+TEST(InfoTest, summaryList)
+{
+    std::string list(Support::temppath("info_list.txt"));
+    {
+        std::ofstream out(list);
+        out << Support::datapath("las/1.2-with-color.las") << "\n";
+        out << Support::datapath("las/1.2-with-color.las") << "\n";
+        out << Support::datapath("las/nonexistent.las") << "\n";
+    }
+
+    std::string output;
+    int stat = Utils::run_shell_command(appName() + " --summary --threads 2 "
+        "--aggregate --input-list " + list, output);
+    EXPECT_EQ(stat, 0);
+
+    StringList lines = Utils::split2(output, '\n');
+    ASSERT_EQ(lines.size(), 4u);
+
+    size_t errors = 0;
+    for (size_t i = 0; i < 3; ++i)
+        if (lines[i].find("\"error\":") != std::string::npos)
+            errors++;
+        else
+            EXPECT_NE(lines[i].find("\"num_points\": 1065"),
+                std::string::npos);
+    EXPECT_EQ(errors, 1u);
+
+    EXPECT_NE(lines[3].find("\"aggregate\""), std::string::npos);
+    EXPECT_NE(lines[3].find("\"num_points\": 2130"), std::string::npos);
+    EXPECT_NE(lines[3].find("\"num_files\": 2"), std::string::npos);
+    EXPECT_NE(lines[3].find("\"num_errors\": 1"), std::string::npos);
+
+    FileUtils::deleteFile(list);
+}
+
+// Files that can't be streamed are read whole for statistics.
+TEST(InfoTest, statsPlyText)
+{
+    std::string output;
+    int stat = Utils::run_shell_command(appName() + " --stats " +
+        Support::datapath("ply/simple_text.ply"), output);
+    EXPECT_EQ(stat, 0);
+    EXPECT_NE(output.find("\"count\": 3"), std::string::npos);
+}
+
+// Statistics computed over ranges of points in several threads match those
+// computed in one pass.
+TEST(InfoTest, statsThreads)
+{
+    std::string cmd(appName() + " --stats " +
+        Support::datapath("las/1.2-with-color.las"));
+
+    std::string single;
+    EXPECT_EQ(Utils::run_shell_command(cmd + " --threads 1", single), 0);
+
+    std::string multi;
+    EXPECT_EQ(Utils::run_shell_command(cmd + " --threads 4 "
+        "--min-range-size 100", multi), 0);
+
+    using namespace pdalboost::property_tree;
+
+    ptree singleTree;
+    std::istringstream singleIn(single);
+    json_parser::read_json(singleIn, singleTree);
+
+    ptree multiTree;
+    std::istringstream multiIn(multi);
+    json_parser::read_json(multiIn, multiTree);
+
+    const ptree& singleStats = singleTree.get_child("stats.statistic");
+    const ptree& multiStats = multiTree.get_child("stats.statistic");
+    ASSERT_EQ(singleStats.size(), multiStats.size());
+    EXPECT_GT(singleStats.size(), 0u);
+
+    auto si = singleStats.begin();
+    auto mi = multiStats.begin();
+    for (; si != singleStats.end(); ++si, ++mi)
+    {
+        const ptree& s = si->second;
+        const ptree& m = mi->second;
+        std::string name = s.get<std::string>("name");
+        EXPECT_EQ(name, m.get<std::string>("name"));
+        EXPECT_EQ(s.get<point_count_t>("count"), 1065u) << name;
+        EXPECT_EQ(s.get<point_count_t>("count"),
+            m.get<point_count_t>("count")) << name;
+        EXPECT_EQ(s.get<double>("minimum"), m.get<double>("minimum")) << name;
+        EXPECT_EQ(s.get<double>("maximum"), m.get<double>("maximum")) << name;
+        double avg = s.get<double>("average");
+        EXPECT_NEAR(avg, m.get<double>("average"),
+            (std::max)(std::abs(avg) * 1e-9, 1e-4)) << name;
+    }
+}
@@ -0,0 +1,118 @@
+/******************************************************************************
+* Copyright (c) 2015, Howard Butler (howard@hobu.co)
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+#include <pdal/pdal_test_main.hpp>
+
+#include <pdal/util/FileUtils.hpp>
+#include <pdal/util/Utils.hpp>
+
+#include "Support.hpp"
+
+#include <fstream>
+#include <string>
+
+using namespace pdal;
+
+namespace
+{
+
+std::string appName()
+{
+    return Support::binpath(Support::exename("pdal") + " serve");
+}
+
+size_t count(const std::string& s, const std::string& what)
+{
+    size_t cnt = 0;
+    for (auto pos = s.find(what); pos != std::string::npos;
+            pos = s.find(what, pos + 1))
+        cnt++;
+    return cnt;
+}
+
+} // unnamed namespace
+
+TEST(ServeTest, stdin)
+{
+    std::string requests(Support::temppath("serve_requests.txt"));
+    std::string pipeline(
+        Support::configuredpath("pipeline/pipeline_read.xml"));
+
+    // A pipeline file, inline pipeline XML and a file that doesn't exist.
+    {
+        std::ofstream out(requests);
+        out << pipeline << "\n.\n";
+        out << FileUtils::readFileIntoString(pipeline) << "\n.\n";
+        out << Support::temppath("nonexistent.xml") << "\n";
+    }
+
+    std::string output;
+    int stat = Utils::run_shell_command(appName() + " --threads 2 < " +
+        requests, output);
+    EXPECT_EQ(stat, 0);
+
+    // One line per event: running and a final status for each job.
+    EXPECT_EQ(count(output, "\"status\": \"running\""), 3u);
+    EXPECT_EQ(count(output, "\"status\": \"done\""), 2u);
+    EXPECT_EQ(count(output, "\"status\": \"error\""), 1u);
+    EXPECT_EQ(count(output, "\"points\": 1065"), 2u);
+    EXPECT_EQ(count(output, "\n"), 6u);
+
+    FileUtils::deleteFile(requests);
+}
+
+TEST(ServeTest, retainMemory)
+{
+    std::string requests(Support::temppath("serve_retain.txt"));
+    std::string pipeline(
+        Support::configuredpath("pipeline/pipeline_read.xml"));
+
+    // With nothing retained, a worker's table starts over for each job.
+    {
+        std::ofstream out(requests);
+        out << pipeline << "\n.\n" << pipeline << "\n";
+    }
+
+    std::string output;
+    int stat = Utils::run_shell_command(appName() + " --retain-memory 0 < " +
+        requests, output);
+    EXPECT_EQ(stat, 0);
+    EXPECT_EQ(count(output, "\"points\": 1065"), 2u);
+
+    stat = Utils::run_shell_command(appName() + " --retain-memory -1 < " +
+        requests + " 2>&1", output);
+    EXPECT_NE(stat, 0);
+
+    FileUtils::deleteFile(requests);
+}
@@ -0,0 +1,253 @@
+/******************************************************************************
+* Copyright (c) 2015, Howard Butler (howard@hobu.co)
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+
+#include <pdal/pdal_test_main.hpp>
+
+#include <pdal/PointTable.hpp>
+#include <pdal/StageFactory.hpp>
+#include <pdal/util/FileUtils.hpp>
+#include <pdal/util/Utils.hpp>
+
+#include "Support.hpp"
+
+#include <fstream>
+#include <string>
+
+using namespace pdal;
+
+namespace
+{
+
+std::string appName()
+{
+    return Support::binpath(Support::exename("pdal") + " tindex");
+}
+
+// Write numbered copies of a LAS file to the temp directory and return a
+// pattern that matches them.
+std::string makeTiles(size_t count)
+{
+    std::string src =
+        FileUtils::readFileIntoString(Support::datapath("las/simple.las"));
+    for (size_t i = 0; i < count; ++i)
+    {
+        std::string filename =
+            Support::temppath("tindex_tile_" + std::to_string(i) + ".las");
+        std::ofstream out(filename, std::ios::binary);
+        out << src;
+    }
+    return Support::temppath("tindex_tile_*.las");
+}
+
+void deleteTiles(size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+        FileUtils::deleteFile(
+            Support::temppath("tindex_tile_" + std::to_string(i) + ".las"));
+}
+
+int runTIndex(const std::string& index, const std::string& pattern,
+    const std::string& args)
+{
+    FileUtils::deleteFile(index);
+
+    std::string output;
+    return Utils::run_shell_command(appName() + " " + index + " \"" +
+        pattern + "\" -f GeoJSON --lyr_name tiles --fast_boundary " + args,
+        output);
+}
+
+} // unnamed namespace
+
+// Features are written in input order regardless of how many files are read
+// at once.
+TEST(TIndexTest, threads)
+{
+    const size_t numTiles = 7;
+    std::string pattern = makeTiles(numTiles);
+    std::string index1(Support::temppath("tindex_1.json"));
+    std::string index3(Support::temppath("tindex_3.json"));
+
+    EXPECT_EQ(runTIndex(index1, pattern, "--threads 1"), 0);
+    EXPECT_EQ(runTIndex(index3, pattern, "--threads 3"), 0);
+
+    std::string json1 = FileUtils::readFileIntoString(index1);
+    std::string json3 = FileUtils::readFileIntoString(index3);
+    for (size_t i = 0; i < numTiles; ++i)
+        EXPECT_NE(json1.find("tindex_tile_" + std::to_string(i) + ".las"),
+            std::string::npos);
+    EXPECT_EQ(json1, json3);
+
+    std::string output;
+    EXPECT_NE(Utils::run_shell_command(appName() + " " + index1 + " \"" +
+        pattern + "\" --threads 0", output), 0);
+
+    FileUtils::deleteFile(index1);
+    FileUtils::deleteFile(index3);
+    deleteTiles(numTiles);
+}
+
+TEST(TIndexTest, cache)
+{
+    const size_t numTiles = 3;
+    std::string pattern = makeTiles(numTiles);
+    std::string index(Support::temppath("tindex_cache.json"));
+    std::string cache(Support::temppath("tindex_cache.txt"));
+    FileUtils::deleteFile(cache);
+
+    EXPECT_EQ(runTIndex(index, pattern, "--boundary_cache " + cache), 0);
+    std::string json = FileUtils::readFileIntoString(index);
+
+    // One entry per file: filename, key, SRS and boundary.
+    StringList lines =
+        Utils::split2(FileUtils::readFileIntoString(cache), '\n');
+    ASSERT_EQ(lines.size(), numTiles);
+    for (auto& line : lines)
+    {
+        StringList fields = Utils::split(line, '\t');
+        ASSERT_EQ(fields.size(), 4u);
+        EXPECT_NE(fields[0].find("tindex_tile_"), std::string::npos);
+        EXPECT_NE(fields[1].find("/fast/readers.las:"), std::string::npos);
+        EXPECT_EQ(fields[3].find("POLYGON (("), 0u);
+    }
+
+    // Replace the cached boundaries.  Unchanged files are taken from the
+    // cache, so the index changes.  The entry for a missing file is dropped.
+    const std::string planted("POLYGON ((0 0, 1 0, 1 1, 0 1, 0 0))");
+    const std::string missing(Support::temppath("tindex_missing.las"));
+    FileUtils::deleteFile(missing);
+    {
+        std::ofstream out(cache);
+        for (auto& line : lines)
+        {
+            StringList fields = Utils::split(line, '\t');
+            out << fields[0] << "\t" << fields[1] << "\t" << fields[2] <<
+                "\t" << planted << "\n";
+        }
+        StringList fields = Utils::split(lines[0], '\t');
+        out << missing << "\t" << fields[1] << "\t" << fields[2] <<
+            "\t" << planted << "\n";
+    }
+    EXPECT_EQ(runTIndex(index, pattern, "--boundary_cache " + cache), 0);
+    EXPECT_NE(FileUtils::readFileIntoString(index), json);
+    std::string cached = FileUtils::readFileIntoString(cache);
+    EXPECT_EQ(Utils::split2(cached, '\n').size(), numTiles);
+    EXPECT_EQ(cached.find(missing), std::string::npos);
+
+    // Reader options are part of the key, so the files are read again.
+    EXPECT_EQ(runTIndex(index, pattern, "--boundary_cache " + cache +
+        " --readers.las.count=1000000"), 0);
+    lines = Utils::split2(FileUtils::readFileIntoString(cache), '\n');
+    ASSERT_EQ(lines.size(), numTiles);
+    for (auto& line : lines)
+    {
+        StringList fields = Utils::split(line, '\t');
+        ASSERT_EQ(fields.size(), 4u);
+        EXPECT_NE(fields[1].find("count=1000000;"), std::string::npos);
+        EXPECT_NE(fields[3], planted);
+    }
+    EXPECT_EQ(FileUtils::readFileIntoString(index), json);
+
+    FileUtils::deleteFile(index);
+    FileUtils::deleteFile(cache);
+    deleteTiles(numTiles);
+}
+
+// Merged output holds every point of every indexed file, whatever the
+// number of threads.
+TEST(TIndexTest, merge)
+{
+    const size_t numTiles = 5;
+    const size_t numPoints = 1065;
+    std::string pattern = makeTiles(numTiles);
+    std::string index(Support::temppath("tindex_merge.json"));
+    EXPECT_EQ(runTIndex(index, pattern, ""), 0);
+
+    for (int threads : { 1, 3 })
+    {
+        std::string outfile(Support::temppath("tindex_merge.txt"));
+        FileUtils::deleteFile(outfile);
+
+        std::string output;
+        EXPECT_EQ(Utils::run_shell_command(appName() + " " + index + " " +
+            outfile + " --merge --lyr_name tiles --threads " +
+            std::to_string(threads), output), 0);
+
+        // One header line plus a line per point.
+        StringList lines =
+            Utils::split2(FileUtils::readFileIntoString(outfile), '\n');
+        EXPECT_EQ(lines.size(), 1 + numTiles * numPoints);
+        FileUtils::deleteFile(outfile);
+    }
+
+    std::string output;
+    EXPECT_NE(Utils::run_shell_command(appName() + " " + index + " " +
+        Support::temppath("tindex_merge.txt") + " --merge --threads 0",
+        output), 0);
+
+    FileUtils::deleteFile(index);
+    deleteTiles(numTiles);
+}
+
+TEST(TIndexTest, reader)
+{
+    const size_t numTiles = 4;
+    const size_t numPoints = 1065;
+    std::string pattern = makeTiles(numTiles);
+    std::string index(Support::temppath("tindex_reader.json"));
+    EXPECT_EQ(runTIndex(index, pattern, ""), 0);
+
+    for (int threads : { 1, 3 })
+    {
+        StageFactory f;
+        Stage *reader = f.createStage("readers.tindex");
+        ASSERT_TRUE(reader);
+
+        Options options;
+        options.add("filename", index);
+        options.add("lyr_name", "tiles");
+        options.add("threads", threads);
+        reader->setOptions(options);
+
+        PointTable table;
+        reader->prepare(table);
+        PointViewSet s = reader->execute(table);
+        ASSERT_EQ(s.size(), 1u);
+        EXPECT_EQ((*s.begin())->size(), numTiles * numPoints);
+    }
+
+    FileUtils::deleteFile(index);
+    deleteTiles(numTiles);
+}
@@ -0,0 +1,191 @@
+/******************************************************************************
+* Copyright (c) 2015, Howard Butler (howard@hobu.co)
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+#include <pdal/pdal_test_main.hpp>
+
+#include <pdal/PointView.hpp>
+#include <pdal/StageFactory.hpp>
+#include <BufferReader.hpp>
+#include <OutlierFilter.hpp>
+
+using namespace pdal;
+
+namespace
+{
+
+// A 10 x 10 x 2 lattice of points one unit apart plus one point far away
+// from it.
+PointViewPtr makeCloud(PointTableRef table)
+{
+    using namespace Dimension;
+
+    table.layout()->registerDim(Id::X);
+    table.layout()->registerDim(Id::Y);
+    table.layout()->registerDim(Id::Z);
+    table.layout()->registerDim(Id::Classification);
+
+    PointViewPtr view(new PointView(table));
+    PointId idx = 0;
+    for (int x = 0; x < 10; ++x)
+        for (int y = 0; y < 10; ++y)
+            for (int z = 0; z < 2; ++z)
+            {
+                view->setField(Id::X, idx, x);
+                view->setField(Id::Y, idx, y);
+                view->setField(Id::Z, idx, z);
+                view->setField(Id::Classification, idx, 1);
+                idx++;
+            }
+    view->setField(Id::X, idx, 4.5);
+    view->setField(Id::Y, idx, 4.5);
+    view->setField(Id::Z, idx, 50);
+    view->setField(Id::Classification, idx, 1);
+    return view;
+}
+
+PointViewPtr runFilter(PointTableRef table, Options ops)
+{
+    PointViewPtr view = makeCloud(table);
+
+    BufferReader r;
+    r.addView(view);
+
+    OutlierFilter filter;
+    filter.setOptions(ops);
+    filter.setInput(r);
+    filter.prepare(table);
+    PointViewSet viewSet = filter.execute(table);
+    EXPECT_EQ(viewSet.size(), 1u);
+    return *viewSet.begin();
+}
+
+} // unnamed namespace
+
+TEST(OutlierFilterTest, create)
+{
+    StageFactory f;
+    Stage* filter(f.createStage("filters.outlier"));
+    EXPECT_TRUE(filter);
+}
+
+TEST(OutlierFilterTest, statistical)
+{
+    for (int threads : { 1, 3 })
+    {
+        Options ops;
+        ops.add("threads", threads);
+
+        PointTable table;
+        PointViewPtr view = runFilter(table, ops);
+        EXPECT_EQ(view->size(), 201u);
+        for (PointId idx = 0; idx < view->size(); ++idx)
+            EXPECT_EQ(view->getFieldAs<int>(Dimension::Id::Classification,
+                idx), idx == 200 ? 7 : 1);
+    }
+}
+
+TEST(OutlierFilterTest, radius)
+{
+    Options ops;
+    ops.add("method", "radius");
+    ops.add("radius", 1.5);
+    ops.add("min_k", 2);
+    ops.add("classify", false);
+    ops.add("extract", true);
+
+    PointTable table;
+    PointViewPtr view = runFilter(table, ops);
+    EXPECT_EQ(view->size(), 200u);
+    for (PointId idx = 0; idx < view->size(); ++idx)
+        EXPECT_LT(view->getFieldAs<double>(Dimension::Id::Z, idx), 2);
+}
+
+// Tiling with a halo at least as large as the search radius gives the same
+// result as searching the whole cloud at once.
+TEST(OutlierFilterTest, tiled)
+{
+    Options ops;
+    ops.add("method", "radius");
+    ops.add("radius", 1.1);
+    ops.add("min_k", 4);
+    ops.add("tile_size", 3.0);
+    ops.add("threads", 2);
+
+    PointTable table;
+    PointViewPtr tiled = runFilter(table, ops);
+
+    ops.remove(Option("tile_size", 0));
+    PointTable table2;
+    PointViewPtr whole = runFilter(table2, ops);
+
+    ASSERT_EQ(tiled->size(), whole->size());
+    point_count_t noise = 0;
+    for (PointId idx = 0; idx < whole->size(); ++idx)
+    {
+        int c = whole->getFieldAs<int>(Dimension::Id::Classification, idx);
+        EXPECT_EQ(c,
+            tiled->getFieldAs<int>(Dimension::Id::Classification, idx));
+        if (c == 7)
+            noise++;
+    }
+    // The outlier and the eight lattice corners have too few neighbors.
+    EXPECT_EQ(noise, 9u);
+}
+
+// The statistical method has no natural halo, so tiling requires one.
+TEST(OutlierFilterTest, tiledStatistical)
+{
+    Options ops;
+    ops.add("tile_size", 3.0);
+
+    PointTable table;
+    EXPECT_THROW(runFilter(table, ops), pdal_error);
+
+    ops.add("halo", 2.0);
+    PointTable table2;
+    PointViewPtr view = runFilter(table2, ops);
+    EXPECT_EQ(view->size(), 201u);
+    for (PointId idx = 0; idx < view->size(); ++idx)
+        EXPECT_EQ(view->getFieldAs<int>(Dimension::Id::Classification,
+            idx), idx == 200 ? 7 : 1);
+}
+
+TEST(OutlierFilterTest, threads)
+{
+    Options ops;
+    ops.add("threads", 0);
+
+    PointTable table;
+    EXPECT_THROW(runFilter(table, ops), pdal_error);
+}
@@ -0,0 +1,150 @@
+/******************************************************************************
+* Copyright (c) 2015, Howard Butler (howard@hobu.co)
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+#include <pdal/pdal_test_main.hpp>
+
+#include <pdal/PointView.hpp>
+#include <pdal/StageFactory.hpp>
+#include <BufferReader.hpp>
+#include <PmfFilter.hpp>
+
+using namespace pdal;
+
+namespace
+{
+
+// A flat 20 x 20 surface at Z = 0 with a 3 x 3 "building" 10 units high.
+PointViewPtr makeScene(PointTableRef table)
+{
+    using namespace Dimension;
+
+    table.layout()->registerDim(Id::X);
+    table.layout()->registerDim(Id::Y);
+    table.layout()->registerDim(Id::Z);
+    table.layout()->registerDim(Id::Classification);
+
+    PointViewPtr view(new PointView(table));
+    PointId idx = 0;
+    for (int x = 0; x < 20; ++x)
+        for (int y = 0; y < 20; ++y)
+        {
+            bool building = (x >= 8 && x <= 10 && y >= 8 && y <= 10);
+            view->setField(Id::X, idx, x + .5);
+            view->setField(Id::Y, idx, y + .5);
+            view->setField(Id::Z, idx, building ? 10 : 0);
+            view->setField(Id::Classification, idx, 1);
+            idx++;
+        }
+    return view;
+}
+
+} // unnamed namespace
+
+TEST(PmfFilterTest, create)
+{
+    StageFactory f;
+    Stage* filter(f.createStage("filters.pmf"));
+    EXPECT_TRUE(filter);
+}
+
+TEST(PmfFilterTest, classify)
+{
+    for (int threads : { 1, 4 })
+    {
+        PointTable table;
+        PointViewPtr view = makeScene(table);
+
+        BufferReader r;
+        r.addView(view);
+
+        Options ops;
+        ops.add("threads", threads);
+
+        PmfFilter filter;
+        filter.setOptions(ops);
+        filter.setInput(r);
+        filter.prepare(table);
+        PointViewSet viewSet = filter.execute(table);
+        EXPECT_EQ(viewSet.size(), 1u);
+        PointViewPtr out = *viewSet.begin();
+        EXPECT_EQ(out->size(), 400u);
+
+        for (PointId idx = 0; idx < out->size(); ++idx)
+        {
+            double z = out->getFieldAs<double>(Dimension::Id::Z, idx);
+            int c = out->getFieldAs<int>(Dimension::Id::Classification, idx);
+            EXPECT_EQ(c, z == 0 ? 2 : 1);
+        }
+    }
+}
+
+TEST(PmfFilterTest, extract)
+{
+    PointTable table;
+    PointViewPtr view = makeScene(table);
+
+    BufferReader r;
+    r.addView(view);
+
+    Options ops;
+    ops.add("classify", false);
+    ops.add("extract", true);
+
+    PmfFilter filter;
+    filter.setOptions(ops);
+    filter.setInput(r);
+    filter.prepare(table);
+    PointViewSet viewSet = filter.execute(table);
+    EXPECT_EQ(viewSet.size(), 1u);
+    PointViewPtr out = *viewSet.begin();
+    EXPECT_EQ(out->size(), 391u);
+
+    for (PointId idx = 0; idx < out->size(); ++idx)
+    {
+        EXPECT_EQ(out->getFieldAs<double>(Dimension::Id::Z, idx), 0);
+        EXPECT_EQ(out->getFieldAs<int>(Dimension::Id::Classification, idx),
+            1);
+    }
+}
+
+TEST(PmfFilterTest, threads)
+{
+    Options ops;
+    ops.add("threads", 0);
+
+    PmfFilter filter;
+    filter.setOptions(ops);
+    PointTable table;
+    EXPECT_THROW(filter.prepare(table), pdal_error);
+}
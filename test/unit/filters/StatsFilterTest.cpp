@@ -131,6 +131,65 @@ TEST(Stats, stream)
 }
 
 
+// Statistics on ranges of a file, merged, match those of the whole file.
+TEST(Stats, merge)
+{
+    StageFactory f;
+    std::string filename(Support::datapath("las/1.2-with-color.las"));
+
+    Options ops;
+    ops.add("filename", filename);
+    Stage *reader(f.createStage("readers.las"));
+    reader->setOptions(ops);
+
+    StatsFilter filter;
+    filter.setInput(*reader);
+    PointTable table;
+    filter.prepare(table);
+    filter.execute(table);
+
+    Options ops1;
+    ops1.add("filename", filename);
+    ops1.add("count", 500);
+    Stage *reader1(f.createStage("readers.las"));
+    reader1->setOptions(ops1);
+
+    StatsFilter filter1;
+    filter1.setInput(*reader1);
+    FixedPointTable table1(100);
+    filter1.prepare(table1);
+    filter1.execute(table1);
+
+    Options ops2;
+    ops2.add("filename", filename);
+    ops2.add("start", 500);
+    Stage *reader2(f.createStage("readers.las"));
+    reader2->setOptions(ops2);
+
+    StatsFilter filter2;
+    filter2.setInput(*reader2);
+    FixedPointTable table2(100);
+    filter2.prepare(table2);
+    filter2.execute(table2);
+
+    EXPECT_EQ(filter1.getStats(Dimension::Id::X).count(), 500u);
+    EXPECT_EQ(filter2.getStats(Dimension::Id::X).count(), 565u);
+
+    filter1.merge(filter2);
+    for (Dimension::Id::Enum dim : { Dimension::Id::X, Dimension::Id::Y,
+        Dimension::Id::Z, Dimension::Id::Intensity })
+    {
+        const stats::Summary& all = filter.getStats(dim);
+        const stats::Summary& merged = filter1.getStats(dim);
+        EXPECT_EQ(all.count(), merged.count());
+        EXPECT_DOUBLE_EQ(all.minimum(), merged.minimum());
+        EXPECT_DOUBLE_EQ(all.maximum(), merged.maximum());
+        EXPECT_NEAR(all.average(), merged.average(),
+            std::abs(all.average()) * 1e-12);
+    }
+}
+
+
 TEST(Stats, dimset)
 {
     BOX3D bounds(1.0, 2.0, 3.0, 101.0, 102.0, 103.0);
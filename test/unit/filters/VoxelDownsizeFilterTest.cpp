@@ -0,0 +1,141 @@
+/******************************************************************************
+* Copyright (c) 2015, Howard Butler (howard@hobu.co)
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+#include <pdal/pdal_test_main.hpp>
+
+#include <pdal/PointView.hpp>
+#include <pdal/StageFactory.hpp>
+#include <FauxReader.hpp>
+#include <StreamCallbackFilter.hpp>
+#include <VoxelDownsizeFilter.hpp>
+
+using namespace pdal;
+
+TEST(VoxelDownsizeFilterTest, create)
+{
+    StageFactory f;
+    Stage* filter(f.createStage("filters.voxeldownsize"));
+    EXPECT_TRUE(filter);
+}
+
+TEST(VoxelDownsizeFilterTest, standard)
+{
+    BOX3D srcBounds(0.0, 0.0, 0.0, 99.0, 99.0, 99.0);
+
+    for (int threads : { 1, 3 })
+    {
+        Options ops;
+        ops.add("bounds", srcBounds);
+        ops.add("mode", "ramp");
+        ops.add("count", 100);
+        FauxReader reader;
+        reader.setOptions(ops);
+
+        Options voxelOps;
+        voxelOps.add("leaf_x", 10.0);
+        voxelOps.add("leaf_y", 10.0);
+        voxelOps.add("leaf_z", 10.0);
+        voxelOps.add("threads", threads);
+
+        VoxelDownsizeFilter filter;
+        filter.setOptions(voxelOps);
+        filter.setInput(reader);
+
+        PointTable table;
+        filter.prepare(table);
+        PointViewSet viewSet = filter.execute(table);
+        EXPECT_EQ(viewSet.size(), 1u);
+        PointViewPtr view = *viewSet.begin();
+        EXPECT_EQ(view->size(), 10u);
+
+        // The first point of each voxel is kept, in input order.
+        for (PointId idx = 0; idx < view->size(); ++idx)
+        {
+            EXPECT_EQ(view->getFieldAs<int>(Dimension::Id::X, idx),
+                (int)idx * 10);
+            EXPECT_EQ(view->getFieldAs<int>(Dimension::Id::OffsetTime, idx),
+                (int)idx * 10);
+        }
+    }
+}
+
+TEST(VoxelDownsizeFilterTest, stream)
+{
+    BOX3D srcBounds(0.0, 0.0, 0.0, 99.0, 99.0, 99.0);
+
+    Options ops;
+    ops.add("bounds", srcBounds);
+    ops.add("mode", "ramp");
+    ops.add("count", 100);
+    FauxReader reader;
+    reader.setOptions(ops);
+
+    Options voxelOps;
+    voxelOps.add("leaf_x", 10.0);
+    voxelOps.add("leaf_y", 10.0);
+    voxelOps.add("leaf_z", 10.0);
+
+    VoxelDownsizeFilter voxel;
+    voxel.setOptions(voxelOps);
+    voxel.setInput(reader);
+
+    StreamCallbackFilter filter;
+
+    int i = 0;
+    auto cb = [&i](PointRef& point)
+    {
+        EXPECT_EQ(point.getFieldAs<int>(Dimension::Id::X), i * 10);
+        i++;
+        return true;
+    };
+    filter.setCallback(cb);
+    filter.setInput(voxel);
+
+    FixedPointTable t(7);
+
+    filter.prepare(t);
+    filter.execute(t);
+    EXPECT_EQ(i, 10);
+}
+
+TEST(VoxelDownsizeFilterTest, threads)
+{
+    Options ops;
+    ops.add("threads", 0);
+
+    VoxelDownsizeFilter filter;
+    filter.setOptions(ops);
+    PointTable table;
+    EXPECT_THROW(filter.prepare(table), pdal_error);
+}
@@ -44,6 +44,7 @@
 #include <BpfReader.hpp>
 #include <BpfWriter.hpp>
 #include <BufferReader.hpp>
+#include <FauxReader.hpp>
 
 #include "Support.hpp"
 
@@ -132,14 +133,19 @@ void test_file_type_view(const std::string& filename)
     }
 }
 
-void test_file_type_stream(const std::string& filename)
+// Points are expected to match to float precision unless 'zTolerance' is
+// set, as for files written with a Z scale that loses precision.
+void test_file_type_stream(const std::string& filename, double zTolerance)
 {
     class Checker : public Filter
     {
     public:
-        Checker() : m_cnt(0)
+        Checker(double zTolerance) : m_cnt(0), m_zTolerance(zTolerance)
         {}
 
+        size_t count() const
+            { return m_cnt; }
+
         struct PtData
         {
             float x;
@@ -178,7 +184,10 @@ void test_file_type_stream(const std::string& filename)
 
             EXPECT_FLOAT_EQ(x, d.x);
             EXPECT_FLOAT_EQ(y, d.y);
-            EXPECT_FLOAT_EQ(z, d.z);
+            if (m_zTolerance)
+                EXPECT_NEAR(z, d.z, m_zTolerance);
+            else
+                EXPECT_FLOAT_EQ(z, d.z);
             EXPECT_TRUE(m_cnt < 506) << "Count exceeded amount requested "
                 "in 'count' option.";
 
@@ -188,6 +197,7 @@ void test_file_type_stream(const std::string& filename)
 
     private:
         size_t m_cnt;
+        double m_zTolerance;
     };
 
     FixedPointTable table(50);
@@ -199,22 +209,23 @@ void test_file_type_stream(const std::string& filename)
     BpfReader reader;
     reader.setOptions(ops);
 
-    Checker c;
+    Checker c(zTolerance);
     c.setInput(reader);
 
     c.prepare(table);
     c.execute(table);
+    EXPECT_EQ(c.count(), 506u);
 }
 
 
-void test_file_type(const std::string& filename)
+void test_file_type(const std::string& filename, double zTolerance = 0)
 {
     test_file_type_view(filename);
-    test_file_type_stream(filename);
+    test_file_type_stream(filename, zTolerance);
 }
 
 
-void test_roundtrip(Options& writerOps)
+void test_roundtrip(Options& writerOps, double zTolerance = 0)
 {
     std::string infile(
         Support::datapath("bpf/autzen-utm-chipped-25-v3-interleaved.bpf"));
@@ -237,7 +248,7 @@ void test_roundtrip(Options& writerOps)
     writer.prepare(table);
     writer.execute(table);
 
-    test_file_type(outfile);
+    test_file_type(outfile, zTolerance);
 }
 
 
@@ -332,6 +343,90 @@ TEST(BPFTest, roundtrip_point_compression)
     test_roundtrip(ops);
 }
 
+TEST(BPFTest, roundtrip_dimension_compression_threads)
+{
+    Options ops;
+
+    ops.add("format", "DIMENSION");
+    ops.add("compression", true);
+    ops.add("threads", 4);
+    test_roundtrip(ops);
+}
+
+namespace
+{
+
+// Read a compressed file with one thread and with several and make sure
+// the points match.
+void test_inflate_threads(const std::string& filename, point_count_t count)
+{
+    auto read = [&filename](int threads)
+    {
+        Options ops;
+        ops.add("filename", filename);
+        ops.add("threads", threads);
+
+        std::shared_ptr<PointTable> table(new PointTable);
+        std::shared_ptr<BpfReader> reader(new BpfReader);
+        reader->setOptions(ops);
+        reader->prepare(*table);
+        PointViewSet viewSet = reader->execute(*table);
+        EXPECT_EQ(viewSet.size(), 1u);
+        return std::make_pair(table, *viewSet.begin());
+    };
+
+    auto r1 = read(1);
+    auto r2 = read(3);
+    PointViewPtr v1 = r1.second;
+    PointViewPtr v2 = r2.second;
+    EXPECT_EQ(v1->size(), count);
+    ASSERT_EQ(v1->size(), v2->size());
+    for (PointId i = 0; i < v1->size(); ++i)
+        for (auto d : v1->dims())
+            ASSERT_DOUBLE_EQ(v1->getFieldAs<double>(d, i),
+                v2->getFieldAs<double>(d, i)) << "point " << i;
+
+    EXPECT_THROW(read(0), pdal_error);
+}
+
+} // unnamed namespace
+
+TEST(BPFTest, inflate_threads)
+{
+    test_inflate_threads(
+        Support::datapath("bpf/autzen-utm-chipped-25-v3-deflate.bpf"), 1065);
+}
+
+// Compressed point-major files are written in blocks of 10,000 points.
+// Make sure several blocks inflate the same way in parallel.
+TEST(BPFTest, inflate_threads_blocks)
+{
+    std::string outfile(Support::temppath("tmp_blocks.bpf"));
+
+    Options readerOps;
+    readerOps.add("bounds", BOX3D(0, 0, 0, 1000, 1000, 100));
+    readerOps.add("count", 25000);
+    readerOps.add("mode", "ramp");
+    FauxReader reader;
+    reader.setOptions(readerOps);
+
+    Options writerOps;
+    writerOps.add("filename", outfile);
+    writerOps.add("format", "POINT");
+    writerOps.add("compression", true);
+    BpfWriter writer;
+    writer.setOptions(writerOps);
+    writer.setInput(reader);
+
+    FileUtils::deleteFile(outfile);
+    PointTable table;
+    writer.prepare(table);
+    writer.execute(table);
+
+    test_inflate_threads(outfile, 25000);
+    FileUtils::deleteFile(outfile);
+}
+
 TEST(BPFTest, roundtrip_scaling)
 {
     Options ops;
@@ -343,7 +438,9 @@ TEST(BPFTest, roundtrip_scaling)
     ops.add("scale_x", .001);
     ops.add("scale_y", .01);
     ops.add("scale_z", 10.0);
-    test_roundtrip(ops);
+    // Z is stored as the float (z / scale - offset), which holds less
+    // precision than a float of Z itself.
+    test_roundtrip(ops, 1e-4);
 }
 
 TEST(BPFTest, extra_bytes)
@@ -0,0 +1,366 @@
+/******************************************************************************
+* Copyright (c) 2015, Howard Butler (howard@hobu.co)
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+
+#include <pdal/pdal_test_main.hpp>
+
+#include <pdal/PointView.hpp>
+#include <pdal/StageFactory.hpp>
+#include <pdal/util/FileUtils.hpp>
+#include <BufferReader.hpp>
+#include <GDALReader.hpp>
+
+#include "Support.hpp"
+
+#include <cmath>
+#include <cstring>
+#include <functional>
+
+using namespace pdal;
+
+namespace
+{
+
+typedef std::function<double(int x, int y)> ZFunc;
+typedef std::function<bool(int x, int y)> HoleFunc;
+
+// Points one unit apart with X in [0, cols) and Y in [0, rows).  The writer
+// bins them into a DEM of 'cols' x 'rows' cells where the point at (x, y)
+// lands in column x and row (rows - y), except that points at Y = 0 share
+// the last row with those at Y = 1 and the first row is empty.
+PointViewPtr makeGrid(PointTableRef table, int cols, int rows, ZFunc zFunc,
+    HoleFunc hole = HoleFunc())
+{
+    using namespace Dimension;
+
+    table.layout()->registerDim(Id::X);
+    table.layout()->registerDim(Id::Y);
+    table.layout()->registerDim(Id::Z);
+
+    PointViewPtr view(new PointView(table));
+    PointId idx = 0;
+    for (int x = 0; x < cols; ++x)
+        for (int y = 0; y < rows; ++y)
+        {
+            if (hole && hole(x, y))
+                continue;
+            view->setField(Id::X, idx, x);
+            view->setField(Id::Y, idx, y);
+            view->setField(Id::Z, idx, zFunc(x, y));
+            idx++;
+        }
+    return view;
+}
+
+// Read the single band of a raster, row by row.
+std::vector<float> readRaster(const std::string& filename)
+{
+    Options ro;
+    ro.add("filename", filename);
+    GDALReader r;
+    r.setOptions(ro);
+
+    PointTable t;
+    r.prepare(t);
+    PointViewSet s = r.execute(t);
+    PointViewPtr v = *s.begin();
+    Dimension::Id::Enum band = t.layout()->findDim("band-1");
+
+    // Values are copied raw since some primitives are NaN on flat ground.
+    EXPECT_EQ(t.layout()->dimType(band), Dimension::Type::Double);
+    std::vector<float> values(v->size());
+    for (PointId idx = 0; idx < v->size(); ++idx)
+    {
+        double d;
+        v->getRawField(band, idx, &d);
+        values[idx] = (float)d;
+    }
+    return values;
+}
+
+void runWriter(Stage& input, PointTableRef table, const std::string& filename,
+    const std::string& types, int threads, double gridDist = 1.0)
+{
+    Options wo;
+    wo.add("filename", filename);
+    wo.add("primitive_type", types);
+    wo.add("grid_dist_x", gridDist);
+    wo.add("grid_dist_y", gridDist);
+    wo.add("threads", threads);
+
+    StageFactory f;
+    Stage *writer = f.createStage("writers.derivative");
+    writer->setOptions(wo);
+    writer->setInput(input);
+    writer->prepare(table);
+    writer->execute(table);
+}
+
+// Write one primitive of a grid of points and read it back.
+std::vector<float> derive(int cols, int rows, ZFunc zFunc, HoleFunc hole,
+    const std::string& type, int threads)
+{
+    std::string filename(Support::temppath("derivative.tif"));
+    FileUtils::deleteFile(filename);
+
+    PointTable table;
+    BufferReader r;
+    r.addView(makeGrid(table, cols, rows, zFunc, hole));
+    runWriter(r, table, filename, type, threads);
+
+    std::vector<float> values = readRaster(filename);
+    EXPECT_EQ(values.size(), (size_t)(cols * rows));
+    FileUtils::deleteFile(filename);
+    return values;
+}
+
+} // unnamed namespace
+
+// Every primitive comes out the same regardless of the number of threads
+// used to bin, fill and compute.
+TEST(DerivativeWriterTest, threads)
+{
+    const StringList types { "slope_d8", "slope_fd", "aspect_d8",
+        "aspect_fd", "hillshade", "contour_curvature", "profile_curvature",
+        "tangential_curvature", "total_curvature", "catchment_area" };
+
+    auto write = [&types](int threads)
+    {
+        std::string pattern(Support::temppath("derivative_#.tif"));
+        Options ro;
+        ro.add("filename", Support::datapath("las/1.2-with-color.las"));
+        StageFactory f;
+        Stage *reader = f.createStage("readers.las");
+        reader->setOptions(ro);
+
+        PointTable table;
+        std::string list;
+        for (auto& t : types)
+            list += (list.empty() ? "" : ",") + t;
+        runWriter(*reader, table, pattern, list, threads, 10.0);
+
+        std::vector<std::vector<float>> rasters;
+        for (auto& t : types)
+        {
+            std::string filename(Support::temppath("derivative_" + t +
+                ".tif"));
+            rasters.push_back(readRaster(filename));
+            FileUtils::deleteFile(filename);
+        }
+        return rasters;
+    };
+
+    auto base = write(1);
+    for (int threads : { 2, 7 })
+    {
+        auto rasters = write(threads);
+        ASSERT_EQ(rasters.size(), base.size());
+        for (size_t i = 0; i < base.size(); ++i)
+        {
+            ASSERT_EQ(rasters[i].size(), base[i].size());
+            size_t mismatches = 0;
+            for (size_t j = 0; j < base[i].size(); ++j)
+                if (std::memcmp(&rasters[i][j], &base[i][j], sizeof(float)))
+                    mismatches++;
+            EXPECT_EQ(mismatches, 0u) << types[i] << " with " << threads <<
+                " threads";
+        }
+    }
+
+    std::string filename(Support::temppath("derivative.tif"));
+    PointTable table;
+    BufferReader r;
+    r.addView(makeGrid(table, 4, 4, [](int, int){ return 0.0; }));
+    EXPECT_THROW(runWriter(r, table, filename, "slope_d8", 0), pdal_error);
+}
+
+// Empty cells take the value of the first populated neighbor of the
+// original DEM, looking north, south, east, west, northwest, northeast,
+// southwest and then southeast.
+TEST(DerivativeWriterTest, fillGaps)
+{
+    const int cols = 12;
+    const int rows = 14;
+
+    // A surface whose neighbors all differ, so that the neighbor used to
+    // fill each hole shows in the output.
+    ZFunc zFunc = [](int x, int y) { return x * x + 3.0 * y; };
+
+    // DEM cells (row, column) of the holes.
+    const std::vector<std::pair<int, int>> holes { {3, 3}, {6, 6}, {7, 6},
+        {8, 6}, {5, 9}, {6, 9}, {5, 10}, {6, 10}, {10, 3}, {10, 4},
+        {11, 3}, {11, 4}, {10, 2} };
+    HoleFunc hole = [&holes](int x, int y)
+    {
+        for (auto& h : holes)
+            if (h.first == rows - y && h.second == x)
+                return true;
+        return false;
+    };
+
+    // Build the DEM expected after filling.
+    std::vector<std::vector<double>> dem(rows,
+        std::vector<double>(cols, 0.0));
+    std::vector<std::vector<bool>> set(rows, std::vector<bool>(cols, false));
+    for (int x = 0; x < cols; ++x)
+        for (int y = 1; y < rows; ++y)
+            if (!hole(x, y))
+            {
+                dem[rows - y][x] = zFunc(x, y);
+                set[rows - y][x] = true;
+            }
+    std::vector<std::vector<double>> filled(dem);
+    for (int row = 1; row < rows - 1; ++row)
+        for (int col = 1; col < cols - 1; ++col)
+        {
+            if (set[row][col])
+                continue;
+            const int order[][2] = { {-1, 0}, {1, 0}, {0, 1}, {0, -1},
+                {-1, -1}, {-1, 1}, {1, -1}, {1, 1} };
+            for (auto& o : order)
+                if (set[row + o[0]][col + o[1]])
+                {
+                    filled[row][col] = dem[row + o[0]][col + o[1]];
+                    break;
+                }
+        }
+
+    for (int threads : { 1, 3, 20 })
+    {
+        std::vector<float> values =
+            derive(cols, rows, zFunc, hole, "total_curvature", threads);
+
+        // Rows next to the first (empty) and last (shared) DEM rows
+        // are left out.
+        for (int row = 2; row < rows - 2; ++row)
+            for (int col = 1; col < cols - 1; ++col)
+            {
+                auto z = [&](int dr, int dc)
+                    { return filled[row + dr][col + dc]; };
+                double zXX = z(0, 1) - 2 * z(0, 0) + z(0, -1);
+                double zYY = z(-1, 0) - 2 * z(0, 0) + z(1, 0);
+                double zXY =
+                    (-z(-1, -1) + z(-1, 1) + z(1, -1) - z(1, 1)) / 4;
+                float expected = (float)(zXX * zXX + 2 * zXY * zXY +
+                    zYY * zYY);
+                EXPECT_FLOAT_EQ(values[row * cols + col], expected) <<
+                    "row " << row << ", column " << col << " with " <<
+                    threads << " threads";
+            }
+    }
+}
+
+// Slope, aspect and hillshade of a plane rising one unit per unit east
+// and half a unit per unit north.
+TEST(DerivativeWriterTest, plane)
+{
+    const int cols = 10;
+    const int rows = 10;
+    const double a = 1.0;
+    const double b = 0.5;
+    const double pi = 3.14159265358979323846;
+    ZFunc zFunc = [a, b](int x, int y) { return a * x + b * y; };
+
+    // Hillshade with the sun 45 degrees up and to the northwest.
+    double slope = std::atan(std::sqrt(a * a + b * b));
+    double aspect = std::atan2(-b, -a) + 2 * pi;
+    double zenith = 45.0 * pi / 180.0;
+    double azimuth = 135.0 * pi / 180.0;
+    double hillshade = std::cos(zenith) * std::cos(slope) +
+        std::sin(zenith) * std::sin(slope) * std::cos(azimuth - aspect);
+
+    struct Expected
+    {
+        std::string m_type;
+        double m_value;
+    };
+    const std::vector<Expected> expected {
+        // Percent slope to the steepest neighbor, which is diagonal.
+        { "slope_d8", 100 * (a + b) / std::sqrt(2.0) },
+        // Percent slope of the surface.
+        { "slope_fd", 100 * std::sqrt(a * a + b * b) },
+        // D8 code of the steepest way down: southwest.
+        { "aspect_d8", 16 },
+        { "aspect_fd", 180 - std::atan(b / a) * 180 / pi + 90 },
+        { "hillshade", hillshade }
+    };
+
+    for (auto& e : expected)
+    {
+        std::vector<float> values =
+            derive(cols, rows, zFunc, HoleFunc(), e.m_type, 1);
+        for (int row = 2; row < rows - 2; ++row)
+            for (int col = 1; col < cols - 1; ++col)
+                EXPECT_NEAR(std::fabs(values[row * cols + col]), e.m_value,
+                    1e-4 * e.m_value) << e.m_type << " at row " << row <<
+                    ", column " << col;
+    }
+}
+
+// Curvatures of the paraboloid z = x^2 + y^2 centered in the grid.
+TEST(DerivativeWriterTest, paraboloid)
+{
+    const int cols = 11;
+    const int rows = 12;
+    const double cx = 5.5;
+    const double cy = 6.5;
+    ZFunc zFunc = [cx, cy](int x, int y)
+        { return (x - cx) * (x - cx) + (y - cy) * (y - cy); };
+
+    // With the second derivatives 2, 2 and 0, the curvatures depend only
+    // on the squared gradient 'p'.
+    auto contour = [](double p) { return 2 / std::pow(1 + p, 1.5); };
+    auto tangential = [](double p) { return 2 / std::sqrt(1 + p); };
+    auto total = [](double) { return 8.0; };
+    const std::vector<std::pair<std::string, std::function<double(double)>>>
+        expected { { "contour_curvature", contour },
+            { "profile_curvature", contour },
+            { "tangential_curvature", tangential },
+            { "total_curvature", total } };
+
+    for (auto& e : expected)
+    {
+        std::vector<float> values =
+            derive(cols, rows, zFunc, HoleFunc(), e.first, 1);
+        for (int row = 2; row < rows - 2; ++row)
+            for (int col = 1; col < cols - 1; ++col)
+            {
+                double zX = 2 * (col - cx);
+                double zY = 2 * (rows - row - cy);
+                double v = e.second(zX * zX + zY * zY);
+                EXPECT_NEAR(values[row * cols + col], v, 1e-4 * v) <<
+                    e.first << " at row " << row << ", column " << col;
+            }
+    }
+}
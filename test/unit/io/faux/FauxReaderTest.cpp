@@ -237,3 +237,19 @@ TEST(FauxReaderTest, one_point)
     EXPECT_EQ(2, view->getFieldAs<int>(Dimension::Id::Y, 0));
     EXPECT_EQ(3, view->getFieldAs<int>(Dimension::Id::Z, 0));
 }
+
+
+TEST(FauxReaderTest, start_unsupported)
+{
+    BOX3D bounds(1.0, 2.0, 3.0, 101.0, 102.0, 103.0);
+    Options ops;
+    ops.add("bounds", bounds);
+    ops.add("count", 750);
+    ops.add("start", 100);
+    ops.add("mode", "constant");
+    FauxReader reader;
+    reader.setOptions(ops);
+
+    PointTable table;
+    EXPECT_THROW(reader.prepare(table), pdal_error);
+}
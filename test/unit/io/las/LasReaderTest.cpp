@@ -34,10 +34,22 @@
 
 #include <pdal/pdal_test_main.hpp>
 
+#ifndef WIN32
+#include <atomic>
+#include <fstream>
+#include <thread>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
 #include <pdal/Filter.hpp>
+#include <pdal/util/FileUtils.hpp>
 #include <pdal/PointView.hpp>
 #include <pdal/StageFactory.hpp>
 #include <LasReader.hpp>
+#include <LasWriter.hpp>
 #include "Support.hpp"
 
 using namespace pdal;
@@ -525,3 +537,254 @@ TEST(LasReaderTest, LasHeaderIncorrentPointcount)
 
     EXPECT_EQ(1064u, view->size());
 }
+
+#ifndef WIN32
+namespace
+{
+
+// Minimal HTTP server that serves one file, honoring byte ranges, and
+// counts the bytes of the file that it sends.  Connections are kept alive
+// and each is served by a thread of its own.  Requests for "/redirect" are
+// redirected to the file.
+class RangeServer
+{
+public:
+    enum Mode
+    {
+        Ranged,     // Send requested ranges with a content length.
+        Chunked,    // Send requested ranges with chunked encoding.
+        Whole       // Ignore ranges and send the whole file.
+    };
+
+    RangeServer(const std::string& filename, Mode mode = Ranged) :
+        m_mode(mode), m_served(0), m_connections(0), m_requests(0)
+    {
+        std::ifstream in(filename, std::ios::binary);
+        m_data.assign(std::istreambuf_iterator<char>(in),
+            std::istreambuf_iterator<char>());
+
+        m_fd = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr = {};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = 0;
+        bind(m_fd, (sockaddr *)&addr, sizeof(addr));
+        listen(m_fd, 16);
+        socklen_t len = sizeof(addr);
+        getsockname(m_fd, (sockaddr *)&addr, &len);
+        m_port = ntohs(addr.sin_port);
+        m_thread = std::thread(&RangeServer::run, this);
+    }
+
+    ~RangeServer()
+    {
+        shutdown(m_fd, SHUT_RDWR);
+        close(m_fd);
+        m_thread.join();
+        for (int conn : m_conns)
+            shutdown(conn, SHUT_RDWR);
+        for (auto& t : m_connThreads)
+            t.join();
+        for (int conn : m_conns)
+            close(conn);
+    }
+
+    int port() const
+        { return m_port; }
+    size_t served() const
+        { return m_served; }
+    size_t size() const
+        { return m_data.size(); }
+    size_t connections() const
+        { return m_connections; }
+    size_t requests() const
+        { return m_requests; }
+
+private:
+    void run()
+    {
+        while (true)
+        {
+            int conn = accept(m_fd, NULL, NULL);
+            if (conn < 0)
+                break;
+            m_connections++;
+            m_conns.push_back(conn);
+            m_connThreads.push_back(std::thread(&RangeServer::serve, this,
+                conn));
+        }
+    }
+
+    // Answer requests until the client closes the connection.
+    void serve(int conn)
+    {
+        std::string req;
+        char buf[1024];
+        while (true)
+        {
+            size_t end;
+            ssize_t cnt = 0;
+            while ((end = req.find("\r\n\r\n")) == std::string::npos &&
+                (cnt = recv(conn, buf, sizeof(buf), 0)) > 0)
+                req.append(buf, cnt);
+            if (end == std::string::npos)
+                break;
+            respond(conn, req.substr(0, end));
+            req.erase(0, end + 4);
+        }
+    }
+
+    void respond(int conn, const std::string& req)
+    {
+        m_requests++;
+        std::ostringstream resp;
+        if (req.find("GET /redirect ") == 0)
+        {
+            resp << "HTTP/1.1 302 Found\r\n" <<
+                "Location: /file.las\r\n" <<
+                "Content-Length: 0\r\n\r\n";
+            std::string header = resp.str();
+            send(conn, header.data(), header.size(), 0);
+            return;
+        }
+
+        size_t start = 0;
+        size_t end = m_data.size() - 1;
+        size_t pos = req.find("Range: bytes=");
+        if (pos != std::string::npos && m_mode != Whole)
+            sscanf(req.c_str() + pos, "Range: bytes=%zu-%zu",
+                &start, &end);
+        end = (std::min)(end, m_data.size() - 1);
+        size_t count = end - start + 1;
+
+        if (m_mode == Whole)
+            resp << "HTTP/1.1 200 OK\r\n";
+        else
+            resp << "HTTP/1.1 206 Partial Content\r\n" <<
+                "Content-Range: bytes " << start << "-" << end << "/" <<
+                m_data.size() << "\r\n";
+        if (m_mode == Chunked)
+        {
+            resp << "Transfer-Encoding: chunked\r\n\r\n";
+            for (size_t off = 0; off < count; off += 1000)
+            {
+                size_t len = (std::min)((size_t)1000, count - off);
+                resp << std::hex << len << std::dec << "\r\n";
+                resp.write(m_data.data() + start + off, len);
+                resp << "\r\n";
+            }
+            resp << "0\r\n\r\n";
+        }
+        else
+        {
+            resp << "Content-Length: " << count << "\r\n\r\n";
+            resp.write(m_data.data() + start, count);
+        }
+        std::string data = resp.str();
+        send(conn, data.data(), data.size(), MSG_NOSIGNAL);
+        m_served += count;
+    }
+
+    Mode m_mode;
+    std::vector<char> m_data;
+    int m_fd;
+    int m_port;
+    std::atomic<size_t> m_served;
+    std::atomic<size_t> m_connections;
+    std::atomic<size_t> m_requests;
+    std::vector<int> m_conns;
+    std::vector<std::thread> m_connThreads;
+    std::thread m_thread;
+};
+
+} // unnamed namespace
+
+TEST(LasReaderTest, http)
+{
+    using namespace Dimension;
+
+    std::string infile(Support::datapath("las/autzen_trim.las"));
+    std::string octfile(Support::temppath("octree_http.las"));
+    FileUtils::deleteFile(octfile);
+
+    {
+        Options readerOps;
+        readerOps.add("filename", infile);
+        LasReader reader;
+        reader.setOptions(readerOps);
+
+        Options writerOps;
+        writerOps.add("filename", octfile);
+        writerOps.add("octree", true);
+        LasWriter writer;
+        writer.setOptions(writerOps);
+        writer.setInput(reader);
+
+        PointTable table;
+        writer.prepare(table);
+        writer.execute(table);
+    }
+
+    BOX3D box(636000, 848900, 400, 636500, 849200, 530);
+    auto read = [&box](const std::string& filename)
+    {
+        Options ops;
+        ops.add("filename", filename);
+        ops.add("bounds", box);
+        LasReader r;
+        r.setOptions(ops);
+
+        PointTable t;
+        r.prepare(t);
+        PointViewSet s = r.execute(t);
+        EXPECT_EQ(s.size(), 1u);
+        PointViewPtr v = *s.begin();
+
+        std::vector<double> values;
+        for (PointId idx = 0; idx < v->size(); ++idx)
+        {
+            values.push_back(v->getFieldAs<double>(Id::X, idx));
+            values.push_back(v->getFieldAs<double>(Id::Y, idx));
+            values.push_back(v->getFieldAs<double>(Id::Z, idx));
+        }
+        return values;
+    };
+
+    std::vector<double> local = read(octfile);
+    EXPECT_GT(local.size(), 0u);
+
+    auto base = [](const RangeServer& server)
+    {
+        return "http://127.0.0.1:" + std::to_string(server.port());
+    };
+
+    // Requests share connections.
+    {
+        RangeServer server(octfile);
+        std::vector<double> remote = read(base(server) + "/octree_http.las");
+        EXPECT_TRUE(local == remote);
+        EXPECT_LT(server.served(), server.size());
+        EXPECT_LT(server.connections(), server.requests());
+    }
+
+    {
+        RangeServer server(octfile, RangeServer::Chunked);
+        std::vector<double> remote = read(base(server) + "/octree_http.las");
+        EXPECT_TRUE(local == remote);
+    }
+
+    {
+        RangeServer server(octfile);
+        std::vector<double> remote = read(base(server) + "/redirect");
+        EXPECT_TRUE(local == remote);
+    }
+
+    // A server that ignores ranges would send the whole file each time.
+    {
+        RangeServer server(octfile, RangeServer::Whole);
+        EXPECT_THROW(read(base(server) + "/octree_http.las"), pdal_error);
+    }
+
+    FileUtils::deleteFile(octfile);
+}
+#endif // WIN32
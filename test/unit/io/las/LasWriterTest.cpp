@@ -34,7 +34,10 @@
 
 #include <pdal/pdal_test_main.hpp>
 
+#include <cmath>
 #include <stdlib.h>
+#include <set>
+#include <tuple>
 
 #include <pdal/util/FileUtils.hpp>
 #include <BufferReader.hpp>
@@ -168,6 +171,78 @@ TEST(LasWriterTest, auto_offset)
     FileUtils::deleteFile(FILENAME);
 }
 
+// Auto scale/offset is chosen from the first points when streaming.
+TEST(LasWriterTest, auto_offset_stream)
+{
+    using namespace Dimension;
+
+    std::string infile(Support::datapath("las/autzen_trim.las"));
+    std::string outfile(Support::temppath("offset_stream.las"));
+
+    auto test = [&](int heldPoints)
+    {
+        FileUtils::deleteFile(outfile);
+
+        Options readerOps;
+        readerOps.add("filename", infile);
+        LasReader reader;
+        reader.setOptions(readerOps);
+
+        Options writerOps;
+        writerOps.add("filename", outfile);
+        writerOps.add("offset_x", "auto");
+        writerOps.add("offset_y", "auto");
+        writerOps.add("offset_z", "auto");
+        writerOps.add("scale_x", "auto");
+        writerOps.add("scale_y", "auto");
+        writerOps.add("scale_z", "auto");
+        writerOps.add("auto_xform_points", heldPoints);
+        LasWriter writer;
+        writer.setOptions(writerOps);
+        writer.setInput(reader);
+
+        FixedPointTable table(100);
+        writer.prepare(table);
+        writer.execute(table);
+
+        PointTable t1;
+        LasReader r1;
+        r1.setOptions(readerOps);
+        r1.prepare(t1);
+        PointViewPtr v1 = *r1.execute(t1).begin();
+
+        Options outOps;
+        outOps.add("filename", outfile);
+        PointTable t2;
+        LasReader r2;
+        r2.setOptions(outOps);
+        r2.prepare(t2);
+        EXPECT_NE(r2.header().offsetX(), 0);
+        EXPECT_LT(r2.header().scaleX(), .01);
+        PointViewPtr v2 = *r2.execute(t2).begin();
+
+        ASSERT_EQ(v1->size(), v2->size());
+        for (PointId idx = 0; idx < v1->size(); ++idx)
+        {
+            EXPECT_NEAR(v1->getFieldAs<double>(Id::X, idx),
+                v2->getFieldAs<double>(Id::X, idx), .0001);
+            EXPECT_NEAR(v1->getFieldAs<double>(Id::Y, idx),
+                v2->getFieldAs<double>(Id::Y, idx), .0001);
+            EXPECT_NEAR(v1->getFieldAs<double>(Id::Z, idx),
+                v2->getFieldAs<double>(Id::Z, idx), .0001);
+            EXPECT_EQ(v1->getFieldAs<uint16_t>(Id::Intensity, idx),
+                v2->getFieldAs<uint16_t>(Id::Intensity, idx));
+        }
+    };
+
+    // Scale/offset chosen partway through the stream.
+    test(5000);
+    // Stream ends before enough points have been seen.
+    test(1000000);
+
+    FileUtils::deleteFile(outfile);
+}
+
 TEST(LasWriterTest, extra_dims)
 {
     Options readerOps;
@@ -699,6 +774,142 @@ TEST(LasWriterTest, fix1063_1064_1065)
     EXPECT_EQ(ref.getWKT(), wkt);
 }
 
+namespace
+{
+
+// Write a file with the octree option and read it back whole, by bounds and
+// by resolution.
+void testOctree(const std::string& compression)
+{
+    using namespace Dimension;
+
+    std::string infile(Support::datapath("las/1.2-with-color.las"));
+    std::string outfile(Support::temppath("octree.las"));
+
+    FileUtils::deleteFile(outfile);
+
+    Options readerOps;
+    readerOps.add("filename", infile);
+
+    LasReader reader;
+    reader.setOptions(readerOps);
+
+    Options writerOps;
+    writerOps.add("filename", outfile);
+    writerOps.add("octree", true);
+    writerOps.add("octree_spacing", 500);
+    writerOps.add("compression", compression);
+
+    LasWriter writer;
+    writer.setOptions(writerOps);
+    writer.setInput(reader);
+
+    PointTable table;
+    writer.prepare(table);
+    PointViewSet viewSet = writer.execute(table);
+    PointViewPtr inView = *viewSet.begin();
+
+    auto points = [](PointViewPtr v)
+    {
+        std::multiset<std::tuple<double, double, double>> s;
+        for (PointId idx = 0; idx < v->size(); ++idx)
+            s.insert(std::make_tuple(v->getFieldAs<double>(Id::X, idx),
+                v->getFieldAs<double>(Id::Y, idx),
+                v->getFieldAs<double>(Id::Z, idx)));
+        return s;
+    };
+
+    // The table is the caller's so that the view outlives the reader.
+    auto readOctree = [&outfile, &compression](PointTableRef t,
+        const Options& extra)
+    {
+        Options ops(extra);
+        ops.add("filename", outfile);
+        if (compression != "none")
+            ops.add("compression", compression);
+
+        LasReader r;
+        r.setOptions(ops);
+        r.prepare(t);
+        EXPECT_EQ(r.header().versionMinor(), 4u);
+        PointViewSet s = r.execute(t);
+        EXPECT_EQ(s.size(), 1u);
+        return *s.begin();
+    };
+
+    // Reading the whole file returns every point, reordered.
+    PointTable allTable;
+    PointViewPtr all = readOctree(allTable, Options());
+    EXPECT_EQ(all->size(), 1065u);
+    EXPECT_TRUE(points(inView) == points(all));
+
+    // Reading by bounds returns exactly the points inside.
+    BOX3D full;
+    inView->calculateBounds(full);
+    BOX3D box(std::floor(full.minx), std::floor(full.miny),
+        std::floor(full.minz), std::floor((full.minx + full.maxx) / 2),
+        std::floor((full.miny + full.maxy) / 2), std::ceil(full.maxz));
+
+    point_count_t inside = 0;
+    for (PointId idx = 0; idx < all->size(); ++idx)
+        if (box.contains(all->getFieldAs<double>(Id::X, idx),
+                all->getFieldAs<double>(Id::Y, idx),
+                all->getFieldAs<double>(Id::Z, idx)))
+            inside++;
+
+    Options boundsOps;
+    boundsOps.add("bounds", box);
+    boundsOps.add("threads", 3);
+    PointTable boundedTable;
+    PointViewPtr bounded = readOctree(boundedTable, boundsOps);
+    EXPECT_EQ(bounded->size(), inside);
+    EXPECT_LT(bounded->size(), all->size());
+    for (PointId idx = 0; idx < bounded->size(); ++idx)
+        EXPECT_TRUE(box.contains(bounded->getFieldAs<double>(Id::X, idx),
+            bounded->getFieldAs<double>(Id::Y, idx),
+            bounded->getFieldAs<double>(Id::Z, idx)));
+
+    // A coarse resolution reads only the top two levels of the tree.
+    Options resOps;
+    resOps.add("resolution", 300);
+    PointTable coarseTable;
+    PointViewPtr coarse = readOctree(coarseTable, resOps);
+    EXPECT_GT(coarse->size(), 0u);
+    EXPECT_LT(coarse->size(), all->size());
+
+    // Bounds can't be used with a file that has no hierarchy.
+    Options badOps;
+    badOps.add("filename", infile);
+    badOps.add("bounds", box);
+    LasReader badReader;
+    badReader.setOptions(badOps);
+    PointTable badTable;
+    EXPECT_THROW(badReader.prepare(badTable), pdal_error);
+
+    FileUtils::deleteFile(outfile);
+}
+
+} // unnamed namespace
+
+TEST(LasWriterTest, octree)
+{
+    testOctree("none");
+}
+
+#ifdef PDAL_HAVE_LASZIP
+TEST(LasWriterTest, octreeLaszip)
+{
+    testOctree("laszip");
+}
+#endif
+
+#ifdef PDAL_HAVE_LAZPERF
+TEST(LasWriterTest, octreeLazperf)
+{
+    testOctree("lazperf");
+}
+#endif
+
 /**
 namespace
 {
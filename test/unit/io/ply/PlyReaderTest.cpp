@@ -35,6 +35,7 @@
 #include <pdal/pdal_test_main.hpp>
 
 #include <PlyReader.hpp>
+#include <StreamCallbackFilter.hpp>
 #include "Support.hpp"
 
 
@@ -101,6 +102,52 @@ TEST(PlyReader, ReadBinary)
 }
 
 
+TEST(PlyReader, StreamBinary)
+{
+    PlyReader reader;
+    Options options;
+    options.add("filename", Support::datapath("ply/simple_binary.ply"));
+    reader.setOptions(options);
+
+    double expected[3][3] = { {-1, 0, 0}, {0, 1, 0}, {1, 0, 0} };
+    int cnt = 0;
+    auto cb = [&cnt, &expected](PointRef& point)
+    {
+        EXPECT_DOUBLE_EQ(expected[cnt][0],
+            point.getFieldAs<double>(Dimension::Id::X));
+        EXPECT_DOUBLE_EQ(expected[cnt][1],
+            point.getFieldAs<double>(Dimension::Id::Y));
+        EXPECT_DOUBLE_EQ(expected[cnt][2],
+            point.getFieldAs<double>(Dimension::Id::Z));
+        cnt++;
+        return true;
+    };
+
+    StreamCallbackFilter f;
+    f.setCallback(cb);
+    f.setInput(reader);
+
+    FixedPointTable table(2);
+    f.prepare(table);
+    f.execute(table);
+    EXPECT_EQ(cnt, 3);
+}
+
+
+TEST(PlyReader, StreamText)
+{
+    PlyReader reader;
+    Options options;
+    options.add("filename", Support::datapath("ply/simple_text.ply"));
+    reader.setOptions(options);
+
+    FixedPointTable table(2);
+    reader.prepare(table);
+    EXPECT_FALSE(reader.pipelineStreamable());
+    EXPECT_THROW(reader.execute(table), pdal_error);
+}
+
+
 TEST(PlyReader, NoVertex)
 {
     PlyReader reader;
@@ -0,0 +1,129 @@
+/******************************************************************************
+ * Copyright (c) 2016, Hobu Inc. (info@hobu.co)
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following
+ * conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided
+ *       with the distribution.
+ *     * Neither the name of Hobu, Inc. nor the
+ *       names of its contributors may be used to endorse or promote
+ *       products derived from this software without specific prior
+ *       written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ ****************************************************************************/
+
+#include <pdal/pdal_test_main.hpp>
+
+#include "Support.hpp"
+
+#include <FauxReader.hpp>
+#include <TextWriter.hpp>
+
+using namespace pdal;
+
+namespace
+{
+
+std::string writeText(const std::string& format, int threads)
+{
+    std::string outfile(Support::temppath("textwriter.txt"));
+    FileUtils::deleteFile(outfile);
+
+    Options ro;
+    ro.add("bounds", BOX3D(-1000.0, -1000.0, -1000.0, 1000.0, 1000.0, 1000.0));
+    ro.add("count", 150000);
+    ro.add("mode", "random");
+    FauxReader r;
+    r.setOptions(ro);
+
+    Options wo;
+    wo.add("filename", outfile);
+    wo.add("format", format);
+    wo.add("precision", 4);
+    wo.add("threads", threads);
+    TextWriter w;
+    w.setOptions(wo);
+    w.setInput(r);
+
+    // Random points must be the same from one run to the next.
+    Utils::random_seed(1);
+    PointTable t;
+    w.prepare(t);
+    w.execute(t);
+
+    std::string s = FileUtils::readFileIntoString(outfile);
+    FileUtils::deleteFile(outfile);
+    return s;
+}
+
+} // unnamed namespace
+
+TEST(TextWriterTest, csv)
+{
+    Options ro;
+    ro.add("bounds", BOX3D(-1000.0, -1000.0, -1000.0, 1000.0, 1000.0, 1000.0));
+    ro.add("count", 1000);
+    ro.add("mode", "random");
+    FauxReader r;
+    r.setOptions(ro);
+
+    std::string outfile(Support::temppath("textwriter.csv"));
+    Options wo;
+    wo.add("filename", outfile);
+    wo.add("order", "X,Y,Z");
+    wo.add("keep_unspecified", false);
+    wo.add("precision", 5);
+    TextWriter w;
+    w.setOptions(wo);
+    w.setInput(r);
+
+    PointTable t;
+    w.prepare(t);
+    PointViewSet s = w.execute(t);
+    PointViewPtr v = *s.begin();
+
+    // Output must match what a fixed-format stream produces.
+    std::ostringstream oss;
+    oss << "\"X\",\"Y\",\"Z\"\n";
+    oss << std::fixed;
+    oss.precision(5);
+    for (PointId i = 0; i < v->size(); ++i)
+    {
+        oss << v->getFieldAs<double>(Dimension::Id::X, i) << ",";
+        oss << v->getFieldAs<double>(Dimension::Id::Y, i) << ",";
+        oss << v->getFieldAs<double>(Dimension::Id::Z, i) << "\n";
+    }
+    EXPECT_EQ(oss.str(), FileUtils::readFileIntoString(outfile));
+    FileUtils::deleteFile(outfile);
+}
+
+TEST(TextWriterTest, threads)
+{
+    std::string csv(writeText("csv", 1));
+    EXPECT_EQ(csv, writeText("csv", 4));
+
+    std::string geojson(writeText("geojson", 1));
+    EXPECT_EQ(geojson, writeText("geojson", 3));
+
+    EXPECT_THROW(writeText("csv", 0), pdal_error);
+}
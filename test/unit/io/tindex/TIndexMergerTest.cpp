@@ -0,0 +1,154 @@
+/******************************************************************************
+* Copyright (c) 2015, Howard Butler (howard@hobu.co)
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+
+#include <pdal/pdal_test_main.hpp>
+
+#include <pdal/PointTable.hpp>
+#include <pdal/PointView.hpp>
+#include <pdal/StageFactory.hpp>
+#include <TIndexMerger.hpp>
+
+#include "Support.hpp"
+
+using namespace pdal;
+
+namespace
+{
+
+// Read a file and its points the usual way.
+PointViewPtr readFile(const std::string& filename, PointTable& table,
+    const Options& cropOptions = Options())
+{
+    StageFactory f;
+    Stage *reader = f.createStage(f.inferReaderDriver(filename));
+    Options ops;
+    ops.add("filename", filename);
+    reader->setOptions(ops);
+    Stage *last = reader;
+    if (!cropOptions.empty())
+    {
+        Stage *crop = f.createStage("filters.crop");
+        crop->setOptions(cropOptions);
+        crop->setInput(*reader);
+        last = crop;
+    }
+    last->prepare(table);
+    PointViewSet s = last->execute(table);
+    return *s.begin();
+}
+
+PointViewPtr merge(TIndexMerger& merger, PointTable& table)
+{
+    merger.prepare(table.layout());
+    table.finalize();
+
+    PointViewPtr view(new PointView(table));
+    merger.read(*view);
+    return view;
+}
+
+// LAS files are streamed and QFIT files, whose reader doesn't stream, are
+// read into a view.
+const std::vector<std::string> files { "las/simple.las", "qfit/10-word.qi",
+    "las/1.2-with-color.las", "las/simple.las", "qfit/10-word.qi" };
+
+} // unnamed namespace
+
+TEST(TIndexMergerTest, read)
+{
+    using namespace Dimension;
+
+    for (int threads : { 1, 2, 5 })
+    {
+        TIndexMerger merger;
+        merger.setThreads(threads);
+        for (auto& f : files)
+            merger.addFile(Support::datapath(f), "");
+
+        PointTable table;
+        PointViewPtr view = merge(merger, table);
+
+        // Points are merged in file order.
+        PointId pos = 0;
+        for (auto& f : files)
+        {
+            PointTable t;
+            PointViewPtr v = readFile(Support::datapath(f), t);
+            ASSERT_LE(pos + v->size(), view->size());
+            for (PointId i = 0; i < v->size(); i += 97)
+            {
+                EXPECT_DOUBLE_EQ(view->getFieldAs<double>(Id::X, pos + i),
+                    v->getFieldAs<double>(Id::X, i));
+                EXPECT_DOUBLE_EQ(view->getFieldAs<double>(Id::Z, pos + i),
+                    v->getFieldAs<double>(Id::Z, i));
+            }
+            pos += v->size();
+        }
+        EXPECT_EQ(pos, view->size());
+    }
+}
+
+TEST(TIndexMergerTest, crop)
+{
+    BOX2D bounds(636000, 849000, 637000, 850000);
+    Options cropOptions;
+    cropOptions.add("bounds", bounds);
+
+    PointTable t;
+    PointViewPtr v =
+        readFile(Support::datapath("las/simple.las"), t, cropOptions);
+    ASSERT_GT(v->size(), 0u);
+
+    TIndexMerger merger;
+    merger.setThreads(2);
+    merger.setCropOptions(cropOptions);
+    for (size_t i = 0; i < 3; ++i)
+        merger.addFile(Support::datapath("las/simple.las"), "");
+
+    PointTable table;
+    PointViewPtr view = merge(merger, table);
+    EXPECT_EQ(view->size(), 3 * v->size());
+}
+
+TEST(TIndexMergerTest, error)
+{
+    TIndexMerger merger;
+    merger.setThreads(2);
+    merger.addFile(Support::datapath("las/simple.las"), "");
+    merger.addFile(Support::datapath("las/nonexistent.las"), "");
+
+    PointTable table;
+    EXPECT_THROW(merger.prepare(table.layout()), pdal_error);
+}